@@ -13,117 +13,281 @@ using namespace std::chrono_literals;
 constexpr auto WAVE_SIZE = 16u;
 constexpr auto WAVE_DATA = std::array<byte, WAVE_SIZE>{ 128, 159, 191, 223, 255, 223, 191, 159, 128, 96, 64, 32, 0, 32, 64, 96 };
 
-void MidiAudio::_initialize(HWND windowHandle) noexcept
+// If the sequencer picks up a note within this long after the previous
+// one ended, it's considered part of the same sequence, and is timed
+// relative to the previous note. This prevents the small delays caused by
+// thread scheduling from accumulating over the course of a long tune.
+constexpr auto SEQUENCE_TOLERANCE = 50ms;
+
+namespace
 {
-    _hwnd = windowHandle;
-    _directSoundModule.reset(LoadLibraryExW(L"dsound.dll", nullptr, LOAD_LIBRARY_SEARCH_SYSTEM32));
-    if (_directSoundModule)
+    class DirectSoundOutput final : public MidiAudio::Output
+    {
+    public:
+        void NoteOn(HWND windowHandle, const int noteNumber, const int velocity) noexcept override;
+        void NoteOff() noexcept override;
+
+    private:
+        void _initialize(HWND windowHandle) noexcept;
+        void _createBuffers() noexcept;
+
+        HWND _hwnd = nullptr;
+        wil::unique_hmodule _directSoundModule;
+        wil::com_ptr<IDirectSound8> _directSound;
+        std::array<wil::com_ptr<IDirectSoundBuffer>, 2> _buffers;
+        size_t _activeBufferIndex = 0;
+        DWORD _lastBufferPosition = 0;
+        bool _noteOn = false;
+    };
+
+    void DirectSoundOutput::_initialize(HWND windowHandle) noexcept
     {
-        if (const auto createFunction = GetProcAddressByFunctionDeclaration(_directSoundModule.get(), DirectSoundCreate8))
+        _hwnd = windowHandle;
+        _directSoundModule.reset(LoadLibraryExW(L"dsound.dll", nullptr, LOAD_LIBRARY_SEARCH_SYSTEM32));
+        if (_directSoundModule)
         {
-            if (SUCCEEDED(createFunction(nullptr, &_directSound, nullptr)))
+            if (const auto createFunction = GetProcAddressByFunctionDeclaration(_directSoundModule.get(), DirectSoundCreate8))
             {
-                if (SUCCEEDED(_directSound->SetCooperativeLevel(windowHandle, DSSCL_NORMAL)))
+                if (SUCCEEDED(createFunction(nullptr, &_directSound, nullptr)))
                 {
-                    _createBuffers();
+                    if (SUCCEEDED(_directSound->SetCooperativeLevel(windowHandle, DSSCL_NORMAL)))
+                    {
+                        _createBuffers();
+                    }
                 }
             }
         }
     }
+
+    void DirectSoundOutput::NoteOn(HWND windowHandle, const int noteNumber, const int velocity) noexcept
+    try
+    {
+        if (_hwnd != windowHandle)
+        {
+            _initialize(windowHandle);
+        }
+
+        const auto& buffer = _buffers.at(_activeBufferIndex);
+        if (buffer)
+        {
+            // The formula for frequency is 2^(n/12) * 440Hz, where n is zero for
+            // the A above middle C (A4). In MIDI terms, A4 is note number 69,
+            // which is why we subtract 69. We also need to multiply by the size
+            // of the wave form to determine the frequency that the sound buffer
+            // has to be played to achieve the equivalent note frequency.
+            const auto frequency = std::pow(2.0, (noteNumber - 69.0) / 12.0) * 440.0 * WAVE_SIZE;
+            buffer->SetFrequency(gsl::narrow_cast<DWORD>(frequency));
+            // For the volume, we're using the formula defined in the General
+            // MIDI Level 2 specification: Gain in dB = 40 * log10(v/127). We need
+            // to multiply by 4000, though, because the SetVolume method expects
+            // the volume to be in hundredths of a decibel.
+            const auto volume = 4000.0 * std::log10(velocity / 127.0);
+            buffer->SetVolume(gsl::narrow_cast<LONG>(volume));
+            // Resetting the buffer to a position that is slightly off from the
+            // last position will help to produce a clearer separation between
+            // tones when repeating sequences of the same note.
+            buffer->SetCurrentPosition((_lastBufferPosition + 12) % WAVE_SIZE);
+            _noteOn = true;
+        }
+    }
+    CATCH_LOG()
+
+    void DirectSoundOutput::NoteOff() noexcept
+    try
+    {
+        const auto& buffer = _buffers.at(_activeBufferIndex);
+        if (_noteOn && buffer)
+        {
+            // When the note ends, we just turn the volume down instead of stopping
+            // the sound buffer. This helps reduce unwanted static between notes.
+            buffer->SetVolume(DSBVOLUME_MIN);
+            buffer->GetCurrentPosition(&_lastBufferPosition, nullptr);
+        }
+        _noteOn = false;
+
+        // Cycling between multiple buffers can also help reduce the static.
+        _activeBufferIndex = (_activeBufferIndex + 1) % _buffers.size();
+    }
+    CATCH_LOG()
+
+    void DirectSoundOutput::_createBuffers() noexcept
+    {
+        auto waveFormat = WAVEFORMATEX{};
+        waveFormat.wFormatTag = WAVE_FORMAT_PCM;
+        waveFormat.nChannels = 1;
+        waveFormat.nSamplesPerSec = 8000;
+        waveFormat.wBitsPerSample = 8;
+        waveFormat.nBlockAlign = waveFormat.nChannels * waveFormat.wBitsPerSample / 8;
+        waveFormat.nAvgBytesPerSec = waveFormat.nSamplesPerSec * waveFormat.nBlockAlign;
+
+        auto bufferDescription = DSBUFFERDESC{};
+        bufferDescription.dwSize = sizeof(DSBUFFERDESC);
+        bufferDescription.dwFlags = DSBCAPS_CTRLVOLUME | DSBCAPS_CTRLFREQUENCY | DSBCAPS_GLOBALFOCUS;
+        bufferDescription.dwBufferBytes = WAVE_SIZE;
+        bufferDescription.lpwfxFormat = &waveFormat;
+
+        for (auto& buffer : _buffers)
+        {
+            if (SUCCEEDED(_directSound->CreateSoundBuffer(&bufferDescription, &buffer, nullptr)))
+            {
+                LPVOID bufferPtr;
+                DWORD bufferSize;
+                if (SUCCEEDED(buffer->Lock(0, 0, &bufferPtr, &bufferSize, nullptr, nullptr, DSBLOCK_ENTIREBUFFER)))
+                {
+                    std::memcpy(bufferPtr, WAVE_DATA.data(), WAVE_DATA.size());
+                    buffer->Unlock(bufferPtr, bufferSize, nullptr, 0);
+                }
+                buffer->SetVolume(DSBVOLUME_MIN);
+                buffer->Play(0, 0, DSBPLAY_LOOPING);
+            }
+        }
+    }
+}
+
+MidiAudio::MidiAudio() :
+    MidiAudio{ std::make_unique<DirectSoundOutput>() }
+{
+}
+
+MidiAudio::MidiAudio(std::unique_ptr<Output> output) noexcept :
+    _output{ std::move(output) }
+{
+}
+
+MidiAudio::~MidiAudio()
+{
+    {
+        const std::scoped_lock lock{ _mutex };
+        _shutdown = true;
+        _flush();
+    }
+    if (_thread.joinable())
+    {
+        _thread.join();
+    }
 }
 
+// Routine Description:
+// - Stops the current note, discards the queued ones and ignores any new notes until EndSkip()
+//   is called. This happens for Ctrl+C or during shutdown.
 void MidiAudio::BeginSkip() noexcept
 {
-    _skip.SetEvent();
+    const std::scoped_lock lock{ _mutex };
+    _skip = true;
+    _flush();
 }
 
 void MidiAudio::EndSkip() noexcept
 {
-    _skip.ResetEvent();
+    const std::scoped_lock lock{ _mutex };
+    _skip = false;
+}
+
+// Routine Description:
+// - Stops the current note and discards the queued ones. This happens on a terminal reset.
+void MidiAudio::Flush() noexcept
+{
+    const std::scoped_lock lock{ _mutex };
+    _flush();
 }
 
+void MidiAudio::_flush() noexcept
+{
+    _queue.clear();
+    _generation++;
+    _cv.notify_all();
+}
+
+// Routine Description:
+// - Queues a single MIDI note to be played after any previously queued notes.
+//   This returns immediately instead of blocking for the duration of the note.
+// Arguments:
+// - windowHandle - The window that the sound is associated with.
+// - noteNumber - The MIDI note number to be played (0 - 127).
+// - velocity - The force with which the note should be played (0 - 127).
+//   A velocity of 0 is a rest, which is timed like any other note.
+// - duration - How long the note should be sustained.
 void MidiAudio::PlayNote(HWND windowHandle, const int noteNumber, const int velocity, const std::chrono::milliseconds duration) noexcept
 try
 {
-    if (_skip.is_signaled())
-    {
-        return;
-    }
+    const std::scoped_lock lock{ _mutex };
 
-    if (_hwnd != windowHandle)
+    if (_skip || _shutdown || _queue.size() >= MaxQueuedNotes)
     {
-        _initialize(windowHandle);
+        return;
     }
 
-    const auto& buffer = _buffers.at(_activeBufferIndex);
-    if (velocity && buffer)
+    if (!_thread.joinable())
     {
-        // The formula for frequency is 2^(n/12) * 440Hz, where n is zero for
-        // the A above middle C (A4). In MIDI terms, A4 is note number 69,
-        // which is why we subtract 69. We also need to multiply by the size
-        // of the wave form to determine the frequency that the sound buffer
-        // has to be played to achieve the equivalent note frequency.
-        const auto frequency = std::pow(2.0, (noteNumber - 69.0) / 12.0) * 440.0 * WAVE_SIZE;
-        buffer->SetFrequency(gsl::narrow_cast<DWORD>(frequency));
-        // For the volume, we're using the formula defined in the General
-        // MIDI Level 2 specification: Gain in dB = 40 * log10(v/127). We need
-        // to multiply by 4000, though, because the SetVolume method expects
-        // the volume to be in hundredths of a decibel.
-        const auto volume = 4000.0 * std::log10(velocity / 127.0);
-        buffer->SetVolume(gsl::narrow_cast<LONG>(volume));
-        // Resetting the buffer to a position that is slightly off from the
-        // last position will help to produce a clearer separation between
-        // tones when repeating sequences of the same note.
-        buffer->SetCurrentPosition((_lastBufferPosition + 12) % WAVE_SIZE);
+        _thread = std::thread{ [this]() { _run(); } };
     }
 
-    // By waiting on the skip event with a maximum duration of the note, we'll
-    // either be paused for the appropriate amount of time, or we'll break out early
-    // because BeginSkip() was called. This happens for Ctrl+C or during shutdown.
-    _skip.wait(::base::saturated_cast<DWORD>(duration.count()));
+    _queue.emplace_back(Note{ windowHandle, noteNumber, velocity, duration });
+    _cv.notify_all();
+}
+CATCH_LOG()
 
-    if (velocity && buffer)
-    {
-        // When the note ends, we just turn the volume down instead of stopping
-        // the sound buffer. This helps reduce unwanted static between notes.
-        buffer->SetVolume(DSBVOLUME_MIN);
-        buffer->GetCurrentPosition(&_lastBufferPosition, nullptr);
-    }
+// Routine Description:
+// - Returns the number of notes waiting to be played, not counting the one that's currently playing.
+size_t MidiAudio::QueuedNotes() const noexcept
+{
+    const std::scoped_lock lock{ _mutex };
+    return _queue.size();
+}
 
-    // Cycling between multiple buffers can also help reduce the static.
-    _activeBufferIndex = (_activeBufferIndex + 1) % _buffers.size();
+// Routine Description:
+// - Blocks until all queued notes have been played.
+// Arguments:
+// - timeout - The maximum amount of time to wait.
+// Return Value:
+// - true if the sequencer is idle. false if the timeout expired.
+bool MidiAudio::WaitUntilIdle(const std::chrono::milliseconds timeout) noexcept
+{
+    std::unique_lock lock{ _mutex };
+    return _cv.wait_for(lock, timeout, [&]() { return _queue.empty() && !_playing; });
 }
-CATCH_LOG()
 
-void MidiAudio::_createBuffers() noexcept
+void MidiAudio::_run() noexcept
 {
-    auto waveFormat = WAVEFORMATEX{};
-    waveFormat.wFormatTag = WAVE_FORMAT_PCM;
-    waveFormat.nChannels = 1;
-    waveFormat.nSamplesPerSec = 8000;
-    waveFormat.wBitsPerSample = 8;
-    waveFormat.nBlockAlign = waveFormat.nChannels * waveFormat.wBitsPerSample / 8;
-    waveFormat.nAvgBytesPerSec = waveFormat.nSamplesPerSec * waveFormat.nBlockAlign;
-
-    auto bufferDescription = DSBUFFERDESC{};
-    bufferDescription.dwSize = sizeof(DSBUFFERDESC);
-    bufferDescription.dwFlags = DSBCAPS_CTRLVOLUME | DSBCAPS_CTRLFREQUENCY | DSBCAPS_GLOBALFOCUS;
-    bufferDescription.dwBufferBytes = WAVE_SIZE;
-    bufferDescription.lpwfxFormat = &waveFormat;
-
-    for (auto& buffer : _buffers)
+    std::unique_lock lock{ _mutex };
+
+    for (;;)
     {
-        if (SUCCEEDED(_directSound->CreateSoundBuffer(&bufferDescription, &buffer, nullptr)))
+        _cv.wait(lock, [&]() { return _shutdown || !_queue.empty(); });
+        if (_shutdown)
         {
-            LPVOID bufferPtr;
-            DWORD bufferSize;
-            if (SUCCEEDED(buffer->Lock(0, 0, &bufferPtr, &bufferSize, nullptr, nullptr, DSBLOCK_ENTIREBUFFER)))
-            {
-                std::memcpy(bufferPtr, WAVE_DATA.data(), WAVE_DATA.size());
-                buffer->Unlock(bufferPtr, bufferSize, nullptr, 0);
-            }
-            buffer->SetVolume(DSBVOLUME_MIN);
-            buffer->Play(0, 0, DSBPLAY_LOOPING);
+            break;
         }
+
+        const auto note = _queue.front();
+        _queue.pop_front();
+        _playing = true;
+
+        // DEC terminals play the notes of a DECPS sequence back-to-back. We mirror that by
+        // scheduling each note relative to the end of the previous one, unless the sequencer
+        // was idle in the meantime, in which case the note starts right away.
+        const auto now = clock::now();
+        const auto start = now - _nextNoteTime < SEQUENCE_TOLERANCE ? std::max(now - SEQUENCE_TOLERANCE, _nextNoteTime) : now;
+        const auto end = start + note.duration;
+        const auto generation = _generation;
+
+        lock.unlock();
+        if (note.velocity)
+        {
+            _output->NoteOn(note.windowHandle, note.noteNumber, note.velocity);
+        }
+        lock.lock();
+
+        // We either wait for the duration of the note, or break out early because
+        // the queue got flushed (for instance by BeginSkip()) or we're shutting down.
+        const auto interrupted = _cv.wait_until(lock, end, [&]() { return _shutdown || _generation != generation; });
+        _nextNoteTime = interrupted ? clock::time_point{} : end;
+
+        lock.unlock();
+        _output->NoteOff();
+        lock.lock();
+
+        _playing = false;
+        _cv.notify_all();
     }
 }
@@ -6,33 +6,85 @@ Module Name:
 - MidiAudio.hpp
 
 Abstract:
-  This modules provide basic MIDI support with blocking sound output.
+  This modules provide basic MIDI support with asynchronous sound output.
+  Notes are queued by PlayNote() and played back-to-back on a sequencer
+  thread, so that the caller (usually the VT parser) doesn't block for the
+  duration of each note. The actual sound is produced by an Output, which
+  can be replaced with a NullOutput in tests.
   */
 
 #pragma once
 
-#include <array>
-
-struct IDirectSound8;
-struct IDirectSoundBuffer;
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 class MidiAudio
 {
 public:
+    // Produces the sound for the notes played by the sequencer.
+    // Its methods are only ever called on the sequencer thread.
+    class Output
+    {
+    public:
+        virtual ~Output() = default;
+        virtual void NoteOn(HWND windowHandle, const int noteNumber, const int velocity) noexcept = 0;
+        virtual void NoteOff() noexcept = 0;
+    };
+
+    class NullOutput final : public Output
+    {
+    public:
+        void NoteOn(HWND, const int, const int) noexcept override {}
+        void NoteOff() noexcept override {}
+    };
+
+    // DECPS notes are at most 255/32 seconds long, so this is about 2 hours
+    // of music. Notes that are played while the queue is full are dropped.
+    static constexpr size_t MaxQueuedNotes = 1024;
+
+    MidiAudio();
+    explicit MidiAudio(std::unique_ptr<Output> output) noexcept;
+    ~MidiAudio();
+
+    MidiAudio(const MidiAudio&) = delete;
+    MidiAudio& operator=(const MidiAudio&) = delete;
+
     void BeginSkip() noexcept;
     void EndSkip() noexcept;
+    void Flush() noexcept;
     void PlayNote(HWND windowHandle, const int noteNumber, const int velocity, const std::chrono::milliseconds duration) noexcept;
 
+    size_t QueuedNotes() const noexcept;
+    bool WaitUntilIdle(const std::chrono::milliseconds timeout) noexcept;
+
 private:
-    void _initialize(HWND windowHandle) noexcept;
-    void _createBuffers() noexcept;
+    using clock = std::chrono::steady_clock;
+
+    struct Note
+    {
+        HWND windowHandle;
+        int noteNumber;
+        int velocity;
+        std::chrono::milliseconds duration;
+    };
+
+    void _run() noexcept;
+    void _flush() noexcept;
 
-    wil::slim_event_manual_reset _skip;
+    std::unique_ptr<Output> _output;
 
-    HWND _hwnd = nullptr;
-    wil::unique_hmodule _directSoundModule;
-    wil::com_ptr<IDirectSound8> _directSound;
-    std::array<wil::com_ptr<IDirectSoundBuffer>, 2> _buffers;
-    size_t _activeBufferIndex = 0;
-    DWORD _lastBufferPosition = 0;
+    mutable std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<Note> _queue;
+    // Incremented to interrupt the note that's currently playing.
+    uint64_t _generation = 0;
+    // The time at which the last note ended (or will end).
+    clock::time_point _nextNoteTime;
+    bool _playing = false;
+    bool _skip = false;
+    bool _shutdown = false;
+    // The thread is only started once the first note is played.
+    std::thread _thread;
 };
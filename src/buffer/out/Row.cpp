@@ -135,6 +135,57 @@ void ROW::Reset(const TextAttribute& attr)
     _init();
 }
 
+// Routine Description:
+// - Replaces the contents of this row with the raw storage of another row of the same
+//   width, as returned by its GetText(), GetCharOffsets() and Attributes().runs().
+// - This is a lot faster than writing the text via ReplaceCharacters(), because the
+//   glyphs don't need to be measured again. The data is only validated and copied.
+//   Line rendition and wrap flags are left unchanged.
+// Arguments:
+// - chars - The text of all glyphs in the row.
+// - charOffsets - The offset into chars for every column, plus one for the end of the text.
+// - attributes - The attribute runs of the row. They must add up to the width of the row.
+void ROW::Restore(const std::wstring_view& chars, const std::span<const uint16_t> charOffsets, const std::span<const til::rle_pair<TextAttribute, uint16_t>> attributes)
+{
+    THROW_HR_IF(E_INVALIDARG, charOffsets.size() != _charOffsets.size() || chars.size() > CharOffsetsMask);
+    THROW_HR_IF(E_INVALIDARG, charOffsets.front() != 0 || charOffsets.back() != chars.size());
+
+    // Every column must either start a new glyph of at least one character, or be
+    // the trailing half of the preceding glyph, sharing its offset. Otherwise
+    // we'd later index past the end of _chars or get stuck navigating the row.
+    for (size_t column = 1; column < charOffsets.size(); ++column)
+    {
+        const auto previous = charOffsets[column - 1] & CharOffsetsMask;
+        const auto offset = charOffsets[column] & CharOffsetsMask;
+        const auto isTrailer = (charOffsets[column] & CharOffsetsTrailer) != 0;
+        THROW_HR_IF(E_INVALIDARG, isTrailer ? offset != previous : offset <= previous);
+    }
+
+    size_t attributesLength = 0;
+    for (const auto& run : attributes)
+    {
+        THROW_HR_IF(E_INVALIDARG, run.length == 0);
+        attributesLength += run.length;
+    }
+    THROW_HR_IF(E_INVALIDARG, attributesLength != _columnCount);
+
+    if (chars.size() <= _columnCount)
+    {
+        _charsHeap.reset();
+        _chars = { _charsBuffer, _columnCount };
+    }
+    else
+    {
+        auto charsHeap = std::make_unique_for_overwrite<wchar_t[]>(chars.size());
+        _chars = { charsHeap.get(), chars.size() };
+        _charsHeap = std::move(charsHeap);
+    }
+
+    std::copy_n(chars.data(), chars.size(), _chars.begin());
+    std::copy(charOffsets.begin(), charOffsets.end(), _charOffsets.begin());
+    _attr = decltype(_attr){ decltype(_attr)::container{ attributes.begin(), attributes.end() } };
+}
+
 void ROW::_init() noexcept
 {
     std::fill_n(_chars.begin(), _columnCount, UNICODE_SPACE);
@@ -387,6 +438,72 @@ catch (...)
     }
 }
 
+// Routine Description:
+// - Fills the columns [columnBegin, columnEnd) with the given narrow character.
+//   Wide glyphs that intersect either edge of the range are replaced with whitespace.
+// - This is a lot faster than writing the same character via WriteCells() or ReplaceCharacters() one
+//   column at a time, as it needs to shift the remaining text in the row at most once.
+// Arguments:
+// - columnBegin - The first column to fill.
+// - columnEnd - 1 past the last column to fill.
+// - ch - The character to fill with. It must not be a wide glyph.
+void ROW::FillCharacters(const til::CoordType columnBegin, const til::CoordType columnEnd, const wchar_t ch)
+try
+{
+    const auto colBeg = _clampedColumnInclusive(columnBegin);
+    const auto colEnd = _clampedColumnInclusive(columnEnd);
+    if (colBeg >= colEnd)
+    {
+        return;
+    }
+
+    const auto colBegDirty = _adjustBackward(colBeg);
+    const auto colEndDirty = _adjustForward(colEnd);
+    const auto chBegDirty = _uncheckedCharOffset(colBegDirty);
+    const auto chEndDirtyOld = _uncheckedCharOffset(colEndDirty);
+    // Every column in the dirty range gets exactly 1 character.
+    const size_t chEndDirty = chBegDirty + (colEndDirty - colBegDirty);
+
+    if (chEndDirty != chEndDirtyOld)
+    {
+        _resizeChars(colEndDirty, chBegDirty, chEndDirty, chEndDirtyOld);
+    }
+
+    const auto leadingSpaces = colBeg - colBegDirty;
+    const auto trailingSpaces = colEndDirty - colEnd;
+    const auto chars = _chars.begin() + chBegDirty;
+    fill_n_small(chars, leadingSpaces, L' ');
+    std::fill_n(chars + leadingSpaces, colEnd - colBeg, ch);
+    fill_n_small(chars + leadingSpaces + (colEnd - colBeg), trailingSpaces, L' ');
+    std::iota(_charOffsets.begin() + colBegDirty, _charOffsets.begin() + colEndDirty, chBegDirty);
+
+    // Same as in WriteHelper::Finish(): If the last column now contains the
+    // remnant of a wide glyph, the row counts as being double-byte padded.
+    if (colEndDirty == _columnCount)
+    {
+        SetDoubleBytePadded(colEnd < _columnCount);
+    }
+}
+catch (...)
+{
+    Reset(TextAttribute{});
+    throw;
+}
+
+// Routine Description:
+// - Same as FillCharacters(), but additionally sets the attributes
+//   of the range with a single replacement in the attribute runs.
+// Arguments:
+// - columnBegin - The first column to fill.
+// - columnEnd - 1 past the last column to fill.
+// - ch - The character to fill with. It must not be a wide glyph.
+// - attr - The attributes to fill with.
+void ROW::Fill(const til::CoordType columnBegin, const til::CoordType columnEnd, const wchar_t ch, const TextAttribute& attr)
+{
+    FillCharacters(columnBegin, columnEnd, ch);
+    ReplaceAttributes(columnBegin, columnEnd, attr);
+}
+
 void ROW::ReplaceText(RowWriteState& state)
 try
 {
@@ -746,6 +863,27 @@ std::wstring_view ROW::GetText() const noexcept
     return { _chars.data(), _charSize() };
 }
 
+// Returns the raw offset of every column into GetText(), plus one past the end.
+// Trailing halves of wide glyphs have their most significant bit set.
+// Only intended for serializing the row, see ROW::Restore().
+std::span<const uint16_t> ROW::GetCharOffsets() const noexcept
+{
+    return _charOffsets;
+}
+
+// Returns the text of all glyphs that intersect the columns [columnBegin, columnEnd).
+// Wide glyphs are only contained once, even if both of their columns are in the range.
+std::wstring_view ROW::GetText(til::CoordType columnBegin, til::CoordType columnEnd) const noexcept
+{
+    const auto colBeg = _clampedColumnInclusive(columnBegin);
+    const auto colEnd = std::max(colBeg, _clampedColumnInclusive(columnEnd));
+    // Safety: colBeg and colEnd are [0, _columnCount].
+    const size_t chBeg = _uncheckedCharOffset(_adjustBackward(colBeg));
+    const size_t chEnd = _uncheckedCharOffset(_adjustForward(colEnd));
+#pragma warning(suppress : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+    return { _chars.data() + chBeg, chEnd - chBeg };
+}
+
 DelimiterClass ROW::DelimiterClassAt(til::CoordType column, const std::wstring_view& wordDelimiters) const noexcept
 {
     const auto col = _clampedColumn(column);
@@ -77,6 +77,7 @@ public:
     LineRendition GetLineRendition() const noexcept;
 
     void Reset(const TextAttribute& attr);
+    void Restore(const std::wstring_view& chars, const std::span<const uint16_t> charOffsets, const std::span<const til::rle_pair<TextAttribute, uint16_t>> attributes);
     void TransferAttributes(const til::small_rle<TextAttribute, uint16_t, 1>& attr, til::CoordType newWidth);
 
     til::CoordType NavigateToPrevious(til::CoordType column) const noexcept;
@@ -86,7 +87,11 @@ public:
     OutputCellIterator WriteCells(OutputCellIterator it, til::CoordType columnBegin, std::optional<bool> wrap = std::nullopt, std::optional<til::CoordType> limitRight = std::nullopt);
     bool SetAttrToEnd(til::CoordType columnBegin, TextAttribute attr);
     void ReplaceAttributes(til::CoordType beginIndex, til::CoordType endIndex, const TextAttribute& newAttr);
+    template<typename Func>
+    void TransformAttributes(til::CoordType beginIndex, til::CoordType endIndex, Func&& func);
     void ReplaceCharacters(til::CoordType columnBegin, til::CoordType width, const std::wstring_view& chars);
+    void FillCharacters(til::CoordType columnBegin, til::CoordType columnEnd, wchar_t ch);
+    void Fill(til::CoordType columnBegin, til::CoordType columnEnd, wchar_t ch, const TextAttribute& attr);
     void ReplaceText(RowWriteState& state);
     til::CoordType CopyRangeFrom(til::CoordType columnBegin, til::CoordType columnLimit, const ROW& other, til::CoordType& otherBegin, til::CoordType otherLimit);
 
@@ -102,6 +107,8 @@ public:
     std::wstring_view GlyphAt(til::CoordType column) const noexcept;
     DbcsAttribute DbcsAttrAt(til::CoordType column) const noexcept;
     std::wstring_view GetText() const noexcept;
+    std::wstring_view GetText(til::CoordType columnBegin, til::CoordType columnEnd) const noexcept;
+    std::span<const uint16_t> GetCharOffsets() const noexcept;
     DelimiterClass DelimiterClassAt(til::CoordType column, const std::wstring_view& wordDelimiters) const noexcept;
 
     auto AttrBegin() const noexcept { return _attr.begin(); }
@@ -234,6 +241,27 @@ private:
     bool _doubleBytePadded = false;
 };
 
+// Routine Description:
+// - Calls func(TextAttribute&) to modify the attributes of the columns [beginIndex, endIndex).
+//   The function is called once per attribute run in that range instead of once per column.
+template<typename Func>
+void ROW::TransformAttributes(const til::CoordType beginIndex, const til::CoordType endIndex, Func&& func)
+{
+    const auto beg = gsl::narrow_cast<uint16_t>(std::clamp<til::CoordType>(beginIndex, 0, _columnCount));
+    const auto end = gsl::narrow_cast<uint16_t>(std::clamp<til::CoordType>(endIndex, 0, _columnCount));
+    if (beg >= end)
+    {
+        return;
+    }
+
+    auto runs = _attr.slice(beg, end).runs();
+    for (auto& run : runs)
+    {
+        func(run.value);
+    }
+    _attr.replace(beg, end, std::span<const decltype(_attr)::rle_type>{ runs.data(), runs.size() });
+}
+
 #ifdef UNIT_TESTING
 constexpr bool operator==(const ROW& a, const ROW& b) noexcept
 {
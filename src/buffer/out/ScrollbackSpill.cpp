@@ -0,0 +1,437 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "ScrollbackSpill.hpp"
+
+#include "textBuffer.hpp"
+#include "../../types/inc/utils.hpp"
+
+// Attribute runs are copied into the file byte-for-byte.
+static_assert(std::is_trivially_copyable_v<TextAttribute>);
+
+// The file is grown geometrically, starting at this size.
+static constexpr size_t s_initialCapacity = 1024 * 1024;
+
+namespace
+{
+    template<typename T>
+    void append(std::vector<std::byte>& buffer, const T& value)
+    {
+        const auto bytes = std::as_bytes(std::span{ &value, 1 });
+        buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+    }
+
+    template<typename T>
+    void append(std::vector<std::byte>& buffer, const std::span<const T> values)
+    {
+        const auto bytes = std::as_bytes(values);
+        buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+    }
+
+    template<typename T>
+    T read(const std::byte*& it) noexcept
+    {
+        // Records aren't aligned, which is why we use memcpy.
+        T value;
+        memcpy(&value, it, sizeof(T));
+        it += sizeof(T);
+        return value;
+    }
+
+    // The text buffer's hyperlink map may not contain IDs that were
+    // pruned in the meantime. We treat those as having no URI.
+    std::wstring hyperlinkUri(const TextBuffer& textBuffer, const uint16_t id)
+    {
+        try
+        {
+            return textBuffer.GetHyperlinkUriFromId(id);
+        }
+        catch (const std::out_of_range&)
+        {
+            return {};
+        }
+    }
+}
+
+// Routine Description:
+// - Creates the temporary file that backs the spill. The file is opened with
+//   FILE_FLAG_DELETE_ON_CLOSE, so it's removed when we're destroyed, even if we crash.
+ScrollbackSpill::ScrollbackSpill() :
+    _id{ Microsoft::Console::Utils::CreateGuid() }
+{
+    wchar_t directory[MAX_PATH + 1];
+    THROW_LAST_ERROR_IF(GetTempPathW(ARRAYSIZE(directory), &directory[0]) == 0);
+
+    wchar_t path[MAX_PATH + 1];
+    THROW_LAST_ERROR_IF(GetTempFileNameW(&directory[0], L"wts", 0, &path[0]) == 0);
+
+    _file.reset(CreateFileW(&path[0], GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr));
+    THROW_LAST_ERROR_IF(!_file);
+}
+
+// Routine Description:
+// - Returns the number of rows that have been spilled.
+size_t ScrollbackSpill::Size() const noexcept
+{
+    return _index.size();
+}
+
+// Routine Description:
+// - Returns the number of bytes used by the spilled rows on disk.
+size_t ScrollbackSpill::SizeInBytes() const noexcept
+{
+    return _size;
+}
+
+// Routine Description:
+// - Returns a random ID that's unique to this spill.
+const GUID& ScrollbackSpill::Id() const noexcept
+{
+    return _id;
+}
+
+// Routine Description:
+// - Returns a number that changes whenever previously appended records are discarded.
+//   As long as it and Id() stay the same, Records() only ever grows at the end.
+uint64_t ScrollbackSpill::Generation() const noexcept
+{
+    return _generation;
+}
+
+// Routine Description:
+// - Returns the serialized records of all spilled rows, oldest first.
+//   The returned span is invalidated by the next call to Append().
+std::span<const std::byte> ScrollbackSpill::Records() const noexcept
+{
+    return { _view.get(), _size };
+}
+
+// Routine Description:
+// - Serializes the given row and appends it to the spill.
+// Arguments:
+// - row - The row that's about to be discarded by the text buffer.
+// - textBuffer - The buffer that owns the row. Used to resolve hyperlink IDs into URIs.
+void ScrollbackSpill::Append(const ROW& row, const TextBuffer& textBuffer)
+{
+    // The header is written last, once we know the size of the record.
+    _scratch.resize(sizeof(RecordHeader));
+
+    // Trailing whitespace is not stored. CopyTo() restores it via ROW::Reset().
+    const auto columns = row.size();
+    const auto right = gsl::narrow<uint16_t>(std::clamp<til::CoordType>(row.MeasureRight(), 0, columns));
+
+    uint16_t glyphCount = 0;
+    til::CoordType column = 0;
+    while (column < right)
+    {
+        const auto glyph = row.GlyphAt(column);
+        const auto next = std::max(column + 1, row.NavigateToNext(column));
+        // The length must not spill into the GlyphWide bit.
+        const auto length = gsl::narrow<uint16_t>(glyph.size());
+        THROW_HR_IF(E_UNEXPECTED, length >= GlyphWide);
+        append(_scratch, gsl::narrow_cast<uint16_t>((next - column > 1 ? GlyphWide : 0) | length));
+        glyphCount++;
+        column = next;
+    }
+
+    // The glyphs are stored contiguously in the row, so we can copy their text in one go.
+    const auto text = row.GetText(0, column);
+    append(_scratch, std::span<const wchar_t>{ text });
+
+    const auto& attributes = row.Attributes();
+    std::vector<uint16_t> hyperlinks;
+    for (const auto& run : attributes.runs())
+    {
+        if (run.value.IsHyperlink())
+        {
+            const auto id = run.value.GetHyperlinkId();
+            if (std::find(hyperlinks.begin(), hyperlinks.end(), id) == hyperlinks.end())
+            {
+                hyperlinks.emplace_back(id);
+            }
+        }
+    }
+
+    uint8_t flags = 0;
+    WI_SetFlagIf(flags, FlagWrapForced, row.WasWrapForced());
+    WI_SetFlagIf(flags, FlagDoubleBytePadded, row.WasDoubleBytePadded());
+
+    const RecordHeader header{
+        .columns = columns,
+        .glyphCount = glyphCount,
+        .textLength = gsl::narrow<uint16_t>(text.size()),
+        .attrRunCount = gsl::narrow<uint16_t>(attributes.runs().size()),
+        .hyperlinkCount = gsl::narrow<uint16_t>(hyperlinks.size()),
+        .lineRendition = static_cast<uint8_t>(row.GetLineRendition()),
+        .flags = flags,
+    };
+
+    memcpy(_scratch.data(), &header, sizeof(header));
+
+    for (const auto& run : attributes.runs())
+    {
+        append(_scratch, run.value);
+        append(_scratch, run.length);
+    }
+    for (const auto id : hyperlinks)
+    {
+        const auto uri = hyperlinkUri(textBuffer, id);
+        append(_scratch, id);
+        append(_scratch, gsl::narrow<uint16_t>(uri.size()));
+        append(_scratch, std::span<const wchar_t>{ uri });
+    }
+
+    _reserve(_size + _scratch.size());
+    memcpy(_view.get() + _size, _scratch.data(), _scratch.size());
+    _index.emplace_back(_size);
+    _size += _scratch.size();
+}
+
+// Routine Description:
+// - Appends records that were previously returned by Records(), for instance
+//   when restoring a buffer snapshot. The records are copied as-is.
+// Arguments:
+// - records - The serialized records. Throws if they're malformed, in which case no rows are appended.
+void ScrollbackSpill::AppendRecords(const std::span<const std::byte> records)
+{
+    std::vector<uint64_t> offsets;
+    for (size_t offset = 0; offset < records.size();)
+    {
+        offsets.emplace_back(_size + offset);
+        offset += _validateRecord(records.subspan(offset));
+    }
+
+    _reserve(_size + records.size());
+    memcpy(_view.get() + _size, records.data(), records.size());
+    _index.insert(_index.end(), offsets.begin(), offsets.end());
+    _size += records.size();
+}
+
+// Routine Description:
+// - Discards all spilled rows. The file's capacity is retained.
+void ScrollbackSpill::Clear() noexcept
+{
+    _index.clear();
+    _size = 0;
+    _generation++;
+}
+
+// Routine Description:
+// - Discards all but the oldest count rows.
+// Arguments:
+// - count - The number of rows to keep.
+void ScrollbackSpill::Truncate(const size_t count) noexcept
+{
+    if (count >= _index.size())
+    {
+        return;
+    }
+
+    _size = gsl::narrow_cast<size_t>(_index[count]);
+    _index.resize(count);
+    _generation++;
+}
+
+// Routine Description:
+// - Returns the text of a spilled row, without trailing whitespace.
+// Arguments:
+// - index - The index of the row, where 0 is the oldest spilled row.
+std::wstring ScrollbackSpill::GetText(const size_t index) const
+{
+    RecordHeader header;
+    auto it = _record(index, header);
+    it += header.glyphCount * sizeof(uint16_t);
+
+    std::wstring text;
+    text.resize(header.textLength);
+    memcpy(text.data(), it, header.textLength * sizeof(wchar_t));
+    return text;
+}
+
+// Routine Description:
+// - Returns whether the spilled row wrapped into the next one.
+// Arguments:
+// - index - The index of the row, where 0 is the oldest spilled row.
+bool ScrollbackSpill::WasWrapForced(const size_t index) const
+{
+    RecordHeader header;
+    _record(index, header);
+    return WI_IsFlagSet(header.flags, FlagWrapForced);
+}
+
+// Routine Description:
+// - Restores a spilled row into the given row.
+// - Hyperlinks are re-registered with the given text buffer, because
+//   their IDs may have been pruned since the row was spilled.
+// Arguments:
+// - index - The index of the row, where 0 is the oldest spilled row.
+// - row - The row to restore into. Rows narrower than the spilled one will be truncated.
+// - textBuffer - The buffer that owns the row.
+void ScrollbackSpill::CopyTo(const size_t index, ROW& row, TextBuffer& textBuffer) const
+{
+    RecordHeader header;
+    auto it = _record(index, header);
+
+    const auto glyphs = it;
+    const auto text = glyphs + header.glyphCount * sizeof(uint16_t);
+    const auto runs = text + header.textLength * sizeof(wchar_t);
+    auto links = runs + header.attrRunCount * (sizeof(TextAttribute) + sizeof(uint16_t));
+
+    std::unordered_map<uint16_t, uint16_t> hyperlinkIds;
+    for (uint16_t i = 0; i < header.hyperlinkCount; ++i)
+    {
+        const auto id = read<uint16_t>(links);
+        const auto length = read<uint16_t>(links);
+        std::wstring uri;
+        uri.resize(length);
+        memcpy(uri.data(), links, length * sizeof(wchar_t));
+        links += length * sizeof(wchar_t);
+
+        // Keep the ID if the buffer still maps it to the same URI.
+        auto newId = id;
+        if (uri.empty())
+        {
+            newId = 0;
+        }
+        else if (hyperlinkUri(textBuffer, id) != uri)
+        {
+            newId = textBuffer.GetHyperlinkId(uri, {});
+            textBuffer.AddHyperlinkToMap(uri, newId);
+        }
+        hyperlinkIds.emplace(id, newId);
+    }
+
+    row.Reset(TextAttribute{});
+    row.SetLineRendition(static_cast<LineRendition>(header.lineRendition));
+    row.SetWrapForced(WI_IsFlagSet(header.flags, FlagWrapForced));
+    row.SetDoubleBytePadded(WI_IsFlagSet(header.flags, FlagDoubleBytePadded));
+
+    const til::CoordType width = row.size();
+
+    it = glyphs;
+    auto chars = text;
+    til::CoordType column = 0;
+    for (uint16_t i = 0; i < header.glyphCount; ++i)
+    {
+        const auto glyph = read<uint16_t>(it);
+        const auto glyphWidth = WI_IsFlagSet(glyph, GlyphWide) ? 2 : 1;
+        const auto length = static_cast<size_t>(glyph & ~GlyphWide);
+        if (column + glyphWidth > width)
+        {
+            break;
+        }
+        row.ReplaceCharacters(column, glyphWidth, { reinterpret_cast<const wchar_t*>(chars), length });
+        chars += length * sizeof(wchar_t);
+        column += glyphWidth;
+    }
+
+    it = runs;
+    column = 0;
+    for (uint16_t i = 0; i < header.attrRunCount && column < width; ++i)
+    {
+        auto attr = read<TextAttribute>(it);
+        const auto length = read<uint16_t>(it);
+        if (attr.IsHyperlink())
+        {
+            const auto mapped = hyperlinkIds.find(attr.GetHyperlinkId());
+            attr.SetHyperlinkId(mapped != hyperlinkIds.end() ? mapped->second : 0);
+        }
+        const auto end = std::min(column + length, width);
+        row.ReplaceAttributes(column, end, attr);
+        column = end;
+    }
+}
+
+// Routine Description:
+// - Returns a pointer to the body of the given record and reads its header.
+const std::byte* ScrollbackSpill::_record(const size_t index, RecordHeader& header) const
+{
+    THROW_HR_IF(E_BOUNDS, index >= _index.size());
+    auto it = _view.get() + _index[index];
+    header = read<RecordHeader>(it);
+    return it;
+}
+
+// Routine Description:
+// - Validates the first record in the given span and returns its size in bytes.
+// - Records appended via AppendRecords() may come from a corrupt or foreign snapshot.
+//   GetText() and CopyTo() index into them without any further checks, so everything
+//   they rely on is checked here: the glyphs have to add up to the text and fit into
+//   the row, and the attribute runs have to cover the row exactly.
+//   Throws if the record is truncated or inconsistent.
+size_t ScrollbackSpill::_validateRecord(const std::span<const std::byte> records)
+{
+    static constexpr auto invalid = HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+
+    THROW_HR_IF(invalid, records.size() < sizeof(RecordHeader));
+    auto it = records.data();
+    const auto header = read<RecordHeader>(it);
+    THROW_HR_IF(invalid, header.lineRendition > static_cast<uint8_t>(LineRendition::DoubleHeightBottom));
+
+    auto size = sizeof(RecordHeader);
+    size += header.glyphCount * sizeof(uint16_t);
+    size += header.textLength * sizeof(wchar_t);
+    size += header.attrRunCount * (sizeof(TextAttribute) + sizeof(uint16_t));
+    THROW_HR_IF(invalid, records.size() < size);
+
+    size_t textLength = 0;
+    size_t glyphColumns = 0;
+    for (uint16_t i = 0; i < header.glyphCount; ++i)
+    {
+        const auto glyph = read<uint16_t>(it);
+        const auto length = static_cast<size_t>(glyph & ~GlyphWide);
+        THROW_HR_IF(invalid, length == 0);
+        textLength += length;
+        glyphColumns += WI_IsFlagSet(glyph, GlyphWide) ? 2 : 1;
+    }
+    THROW_HR_IF(invalid, textLength != header.textLength || glyphColumns > header.columns);
+
+    it += header.textLength * sizeof(wchar_t);
+    size_t runColumns = 0;
+    for (uint16_t i = 0; i < header.attrRunCount; ++i)
+    {
+        it += sizeof(TextAttribute);
+        const auto length = read<uint16_t>(it);
+        THROW_HR_IF(invalid, length == 0);
+        runColumns += length;
+    }
+    THROW_HR_IF(invalid, runColumns != header.columns);
+
+    for (uint16_t i = 0; i < header.hyperlinkCount; ++i)
+    {
+        THROW_HR_IF(invalid, records.size() < size + 2 * sizeof(uint16_t));
+        it = records.data() + size + sizeof(uint16_t);
+        size += 2 * sizeof(uint16_t) + read<uint16_t>(it) * sizeof(wchar_t);
+    }
+
+    THROW_HR_IF(invalid, records.size() < size);
+    return size;
+}
+
+// Routine Description:
+// - Ensures that the file and its view are at least the given size in bytes.
+//   The view has to be recreated every time the file grows.
+void ScrollbackSpill::_reserve(const size_t size)
+{
+    if (size <= _capacity)
+    {
+        return;
+    }
+
+    // Grow geometrically, so that appending n rows only remaps the file O(log n) times.
+    // A single large append (like restoring a snapshot) is mapped in one go.
+    THROW_HR_IF(E_OUTOFMEMORY, _capacity > SIZE_MAX / 2);
+    const auto capacity = std::max({ _capacity * 2, s_initialCapacity, size });
+
+    const auto capacity64 = static_cast<uint64_t>(capacity);
+    wil::unique_handle mapping{ CreateFileMappingW(_file.get(), nullptr, PAGE_READWRITE, gsl::narrow_cast<DWORD>(capacity64 >> 32), gsl::narrow_cast<DWORD>(capacity64), nullptr) };
+    THROW_LAST_ERROR_IF(!mapping);
+
+    wil::unique_mapview_ptr<std::byte> view{ static_cast<std::byte*>(MapViewOfFile(mapping.get(), FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, capacity)) };
+    THROW_LAST_ERROR_IF(!view);
+
+    _view = std::move(view);
+    _mapping = std::move(mapping);
+    _capacity = capacity;
+}
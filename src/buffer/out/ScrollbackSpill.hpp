@@ -0,0 +1,89 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- ScrollbackSpill.hpp
+
+Abstract:
+- Stores the rows that scrolled out of a TextBuffer in a temporary, memory-mapped file.
+- The TextBuffer only keeps as many rows in memory as its height (the history size).
+  With a spill attached, every row that would otherwise be discarded is serialized
+  (text, attribute runs, hyperlinks, line rendition and wrap flags) and appended
+  to the file, so that the scrollback is only limited by disk space.
+- Records are never modified once written. An index of record offsets allows
+  looking up any spilled row in O(1). The file is deleted when it's closed.
+- Since records are position independent, they can be copied out via Records()
+  and back in via AppendRecords() as-is, which is what buffer snapshots use.
+- The RAM budget is the buffer's history size: rows are spilled as soon as they
+  scroll out of it. Spilled rows aren't addressable with buffer coordinates, so
+  scrolling, search and selection can't reach them. They're only read back by
+  export (GetText), by buffer snapshots and by TextBuffer::CopySpilledRow.
+  Until that changes, the spill isn't offered as a profile setting. It's enabled
+  via TextBuffer::SetScrollbackSpill or by restoring a snapshot that contains spilled rows.
+
+--*/
+
+#pragma once
+
+#include "Row.hpp"
+
+class TextBuffer;
+
+class ScrollbackSpill final
+{
+public:
+    ScrollbackSpill();
+
+    size_t Size() const noexcept;
+    size_t SizeInBytes() const noexcept;
+    const GUID& Id() const noexcept;
+    uint64_t Generation() const noexcept;
+
+    void Append(const ROW& row, const TextBuffer& textBuffer);
+    void AppendRecords(const std::span<const std::byte> records);
+    void Clear() noexcept;
+    void Truncate(const size_t count) noexcept;
+
+    std::span<const std::byte> Records() const noexcept;
+
+    std::wstring GetText(const size_t index) const;
+    bool WasWrapForced(const size_t index) const;
+    void CopyTo(const size_t index, ROW& row, TextBuffer& textBuffer) const;
+
+private:
+    struct RecordHeader
+    {
+        uint16_t columns;
+        uint16_t glyphCount;
+        uint16_t textLength;
+        uint16_t attrRunCount;
+        uint16_t hyperlinkCount;
+        uint8_t lineRendition;
+        uint8_t flags;
+    };
+
+    static constexpr uint8_t FlagWrapForced = 1 << 0;
+    static constexpr uint8_t FlagDoubleBytePadded = 1 << 1;
+    // Glyph table entries store the glyph's length in characters
+    // and use the most significant bit to indicate wide glyphs.
+    static constexpr uint16_t GlyphWide = 0x8000;
+
+    const std::byte* _record(const size_t index, RecordHeader& header) const;
+    static size_t _validateRecord(const std::span<const std::byte> records);
+    void _reserve(const size_t size);
+
+    wil::unique_hfile _file;
+    wil::unique_handle _mapping;
+    wil::unique_mapview_ptr<std::byte> _view;
+    size_t _capacity = 0;
+    size_t _size = 0;
+    // Together, these identify the records of this spill, even across processes.
+    // The generation changes whenever records are discarded, so that users of
+    // Records() can tell whether the records they've seen before are still valid.
+    GUID _id;
+    uint64_t _generation = 0;
+    std::vector<uint64_t> _index;
+    // Scratch buffer for serializing a record before it's copied into the file.
+    std::vector<std::byte> _scratch;
+};
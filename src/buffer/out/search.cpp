@@ -93,6 +93,20 @@ bool Search::FindNext()
     return false;
 }
 
+// Routine Description:
+// - Checks whether the search term can be found at exactly the given position and
+//   if so, makes it the found location, so that it can be selected or colored.
+// - This is used to verify results of s_FindAllInRows, which were found in a copy
+//   of the buffer that may have become outdated in the meantime.
+// Arguments:
+// - pos - The position in the buffer at which the search term is expected to start.
+// Return Value:
+// - True if the search term is at the given position. False otherwise.
+bool Search::MatchAt(const til::point pos)
+{
+    return _renderData.GetTextBuffer().GetSize().IsInBounds(pos) && _FindNeedleInHaystackAt(pos, _coordSelStart, _coordSelEnd);
+}
+
 // Routine Description:
 // - Takes the found word and selects it in the screen buffer
 void Search::Select() const
@@ -128,6 +142,222 @@ std::pair<til::point, til::point> Search::GetFoundLocation() const noexcept
     return { _coordSelStart, _coordSelEnd };
 }
 
+// Routine Description:
+// - Copies the text of the given range of rows out of the buffer.
+// - The copy can then be searched with s_FindAllInRows without holding the
+//   lock of the buffer, for instance on a background thread.
+// Arguments:
+// - textBuffer - The buffer to copy the rows from
+// - firstRow - The first row to copy
+// - rowCount - The number of rows to copy. Clamped to the size of the buffer.
+// - markLineEnds - If true, a \n is appended to each row that doesn't wrap into the
+//   next one. s_FindAllRegexInRows uses this to search whole logical lines.
+// Return Value:
+// - The text of each of the rows.
+std::vector<std::wstring> Search::s_SnapshotRows(const TextBuffer& textBuffer, const til::CoordType firstRow, const til::CoordType rowCount, const bool markLineEnds)
+{
+    const auto lastRow = std::min(firstRow + rowCount, textBuffer.GetSize().Height());
+
+    std::vector<std::wstring> rows;
+    rows.reserve(gsl::narrow_cast<size_t>(std::max(0, lastRow - firstRow)));
+    for (auto y = firstRow; y < lastRow; ++y)
+    {
+        const auto& row = textBuffer.GetRowByOffset(y);
+        auto& text = rows.emplace_back(row.GetText());
+        if (markLineEnds && !row.WasWrapForced())
+        {
+            text.push_back(L'\n');
+        }
+    }
+    return rows;
+}
+
+// Routine Description:
+// - Turns an offset into the concatenated text of consecutive rows into a buffer position.
+// - For the start of a match we want the cell the glyph at the offset begins in. For the end
+//   of a match we want the last cell of the glyph preceding the offset, as the end is
+//   inclusive in FindNext().
+// Arguments:
+// - rows - The text of consecutive rows of the buffer
+// - rowOffsets - The offset at which each row begins in the concatenated text
+// - firstRow - The buffer row the first item in rows corresponds to
+// - offset - The offset into the concatenated text
+// - inclusiveEnd - Whether the offset is the (exclusive) end of a match
+// Return Value:
+// - The position in the buffer.
+static til::point s_OffsetToPosition(const std::span<const std::wstring> rows,
+                                     const std::vector<size_t>& rowOffsets,
+                                     const til::CoordType firstRow,
+                                     const size_t offset,
+                                     const bool inclusiveEnd)
+{
+    const auto it = std::upper_bound(rowOffsets.begin(), rowOffsets.end(), inclusiveEnd ? offset - 1 : offset) - 1;
+    const auto index = gsl::narrow_cast<size_t>(it - rowOffsets.begin());
+    const std::wstring_view prefix{ til::at(rows, index).data(), offset - *it };
+
+    til::CoordType column = 0;
+    for (const auto& glyph : til::utf16_iterator{ prefix })
+    {
+        column += IsGlyphFullWidth(glyph) ? 2 : 1;
+    }
+    return { inclusiveEnd ? column - 1 : column, firstRow + gsl::narrow_cast<til::CoordType>(index) };
+}
+
+// Routine Description:
+// - Finds all occurrences of the search term in a copy of the buffer's rows, as returned
+//   by s_SnapshotRows. Just like FindNext() this finds matches spanning multiple rows.
+// - Only matches starting in the first searchRowCount rows are returned. Any rows
+//   beyond that are only used to complete matches that begin within them. This allows
+//   callers to split a large buffer into chunks that are searched independently.
+// Arguments:
+// - rows - The text of consecutive rows of the buffer
+// - firstRow - The buffer row the first item in rows corresponds to
+// - searchRowCount - The number of rows in which matches may start
+// - str - The search term
+// - sensitivity - Whether or not you care about case
+// - results - Receives the [start, end] coord positions of each match in buffer order
+void Search::s_FindAllInRows(const std::span<const std::wstring> rows,
+                             const til::CoordType firstRow,
+                             const size_t searchRowCount,
+                             const std::wstring_view str,
+                             const Sensitivity sensitivity,
+                             std::vector<std::pair<til::point, til::point>>& results)
+{
+    if (str.empty() || rows.empty())
+    {
+        return;
+    }
+
+    const auto fold = [&](std::wstring& text) {
+        if (sensitivity == Sensitivity::CaseInsensitive)
+        {
+            std::transform(text.begin(), text.end(), text.begin(), [](const wchar_t wch) { return gsl::narrow_cast<wchar_t>(::towlower(wch)); });
+        }
+    };
+
+    std::wstring needle{ str };
+    fold(needle);
+
+    // Concatenate the rows, remembering where each of them starts.
+    std::wstring haystack;
+    std::vector<size_t> rowOffsets;
+    rowOffsets.reserve(rows.size() + 1);
+    for (const auto& row : rows)
+    {
+        rowOffsets.emplace_back(haystack.size());
+        haystack.append(row);
+    }
+    rowOffsets.emplace_back(haystack.size());
+    fold(haystack);
+
+    const auto searchEnd = rowOffsets.at(std::min(searchRowCount, rows.size()));
+
+    const std::boyer_moore_horspool_searcher searcher{ needle.begin(), needle.end() };
+    for (auto it = haystack.begin();;)
+    {
+        const auto [matchBeg, matchEnd] = searcher(it, haystack.end());
+        if (matchBeg == haystack.end())
+        {
+            break;
+        }
+
+        const auto offset = gsl::narrow_cast<size_t>(matchBeg - haystack.begin());
+        if (offset >= searchEnd)
+        {
+            break;
+        }
+
+        const auto start = s_OffsetToPosition(rows, rowOffsets, firstRow, offset, false);
+        const auto end = s_OffsetToPosition(rows, rowOffsets, firstRow, gsl::narrow_cast<size_t>(matchEnd - haystack.begin()), true);
+        results.emplace_back(start, end);
+        it = matchBeg + 1;
+    }
+}
+
+// Routine Description:
+// - Finds all matches of a regular expression in a copy of the buffer's rows, as returned
+//   by s_SnapshotRows with markLineEnds set. Rows that wrapped into the next one are joined
+//   and each such logical line is matched against the expression on its own, which means
+//   that "^" and "$" match at the start and end of logical lines.
+// - The first row must start a logical line. The last logical line may be incomplete,
+//   in which case it's searched as is.
+// - Empty matches (as produced by "^" or "x*" for instance) are ignored, as there's
+//   nothing to select, and matches don't overlap.
+// Arguments:
+// - rows - The text of consecutive rows of the buffer
+// - firstRow - The buffer row the first item in rows corresponds to
+// - regex - The compiled regular expression
+// - results - Receives the [start, end] coord positions of each match in buffer order
+// - matchedText - If given, receives the text of each match
+void Search::s_FindAllRegexInRows(const std::span<const std::wstring> rows,
+                                  const til::CoordType firstRow,
+                                  const til::linear_regex& regex,
+                                  std::vector<std::pair<til::point, til::point>>& results,
+                                  std::vector<std::wstring>* matchedText)
+{
+    if (regex.empty())
+    {
+        return;
+    }
+
+    std::wstring line;
+    std::vector<size_t> rowOffsets;
+
+    for (size_t begin = 0; begin < rows.size();)
+    {
+        auto end = begin + 1;
+        while (end < rows.size() && !til::at(rows, end - 1).ends_with(L'\n'))
+        {
+            ++end;
+        }
+
+        line.clear();
+        rowOffsets.clear();
+        for (auto i = begin; i < end; ++i)
+        {
+            rowOffsets.emplace_back(line.size());
+            line.append(til::at(rows, i));
+        }
+        rowOffsets.emplace_back(line.size());
+
+        // Drop the line end marker and the unwritten cells at the end of the line,
+        // as they would otherwise prevent "$" from matching after the last word.
+        line.resize(line.find_last_not_of(L" \n") + 1);
+
+        const auto lineRows = rows.subspan(begin, end - begin);
+        const auto lineFirstRow = firstRow + gsl::narrow_cast<til::CoordType>(begin);
+        for (size_t offset = 0; offset <= line.size();)
+        {
+            const auto match = regex.find(line, offset);
+            if (!match)
+            {
+                break;
+            }
+
+            const auto [matchBeg, matchEnd] = *match;
+            if (matchBeg == matchEnd)
+            {
+                if (matchBeg == line.size())
+                {
+                    break;
+                }
+                offset = matchBeg + (til::is_leading_surrogate(til::at(line, matchBeg)) ? 2 : 1);
+                continue;
+            }
+
+            results.emplace_back(s_OffsetToPosition(lineRows, rowOffsets, lineFirstRow, matchBeg, false),
+                                 s_OffsetToPosition(lineRows, rowOffsets, lineFirstRow, matchEnd, true));
+            if (matchedText)
+            {
+                matchedText->emplace_back(line, matchBeg, matchEnd - matchBeg);
+            }
+            offset = matchEnd;
+        }
+
+        begin = end;
+    }
+}
+
 // Routine Description:
 // - Finds the anchor position where we will start searches from.
 // - This position will represent the "wrap around" point in the buffer or where
@@ -21,6 +21,8 @@ Revision History:
 #include "textBuffer.hpp"
 #include "../renderer/inc/IRenderData.hpp"
 
+#include <til/regex.h>
+
 // This used to be in find.h.
 #define SEARCH_STRING_LENGTH (80)
 
@@ -51,11 +53,25 @@ public:
            const til::point anchor);
 
     bool FindNext();
+    bool MatchAt(const til::point pos);
     void Select() const;
     void Color(const TextAttribute attr) const;
 
     std::pair<til::point, til::point> GetFoundLocation() const noexcept;
 
+    static std::vector<std::wstring> s_SnapshotRows(const TextBuffer& textBuffer, const til::CoordType firstRow, const til::CoordType rowCount, const bool markLineEnds = false);
+    static void s_FindAllInRows(const std::span<const std::wstring> rows,
+                                const til::CoordType firstRow,
+                                const size_t searchRowCount,
+                                const std::wstring_view str,
+                                const Sensitivity sensitivity,
+                                std::vector<std::pair<til::point, til::point>>& results);
+    static void s_FindAllRegexInRows(const std::span<const std::wstring> rows,
+                                     const til::CoordType firstRow,
+                                     const til::linear_regex& regex,
+                                     std::vector<std::pair<til::point, til::point>>& results,
+                                     std::vector<std::wstring>* matchedText = nullptr);
+
 private:
     wchar_t _ApplySensitivity(const wchar_t wch) const noexcept;
     bool _FindNeedleInHaystackAt(const til::point pos, til::point& start, til::point& end) const;
@@ -404,6 +404,103 @@ OutputCellIterator TextBuffer::WriteLine(const OutputCellIterator givenIt,
     return newIt;
 }
 
+// Routine Description:
+// - Fills a rectangular area of the buffer with the given character and attributes.
+//   Rows that get filled up to their last column will have their wrap flag unset.
+// - This is the fast path for operations like ED, EL, ECH and DECFRA. Each row is filled
+//   with a single ROW::Fill() call instead of writing the rectangle cell by cell.
+// Arguments:
+// - rect - The area to fill. It's clamped to the buffer size.
+// - ch - The character to fill with.
+// - attr - The attributes to fill with.
+void TextBuffer::FillRect(const til::rect& rect, const wchar_t ch, const TextAttribute& attr)
+{
+    const auto clamped = rect & GetSize().ToExclusive();
+    if (clamped.empty())
+    {
+        return;
+    }
+
+    // ROW::Fill() only supports narrow characters.
+    if (IsGlyphFullWidth(ch))
+    {
+        const auto fillData = OutputCellIterator{ ch, attr, gsl::narrow_cast<size_t>(clamped.width()) };
+        for (auto y = clamped.top; y < clamped.bottom; ++y)
+        {
+            WriteLine(fillData, { clamped.left, y }, false);
+        }
+        return;
+    }
+
+    for (auto y = clamped.top; y < clamped.bottom; ++y)
+    {
+        auto& row = GetRowByOffset(y);
+        row.Fill(clamped.left, clamped.right, ch, attr);
+        if (clamped.right >= row.size())
+        {
+            row.SetWrapForced(false);
+        }
+    }
+
+    TriggerRedraw(Viewport::FromExclusive(clamped));
+}
+
+// Routine Description:
+// - Fills a number of cells, starting at the given position and continuing on the following
+//   rows, with the given character and/or attributes. This is the fast path for the
+//   FillConsoleOutputCharacter and FillConsoleOutputAttribute APIs.
+// - Rows that get their characters filled up to their last column will have their wrap flag unset.
+// Arguments:
+// - target - The position to start filling at.
+// - count - The number of cells to fill.
+// - ch - The character to fill with, or std::nullopt to keep the existing characters.
+// - attr - The attributes to fill with, or std::nullopt to keep the existing attributes.
+// Return Value:
+// - The number of cells that were filled.
+size_t TextBuffer::FillCells(const til::point target, const size_t count, const std::optional<wchar_t> ch, const std::optional<TextAttribute> attr)
+{
+    const auto size = GetSize();
+    if (!size.IsInBounds(target))
+    {
+        return 0;
+    }
+
+    // ROW::FillCharacters() only supports narrow characters.
+    if (ch && IsGlyphFullWidth(*ch))
+    {
+        const auto it = attr ? OutputCellIterator{ *ch, *attr, count } : OutputCellIterator{ *ch, count };
+        return gsl::narrow_cast<size_t>(Write(it, target, false).GetInputDistance(it));
+    }
+
+    auto remaining = count;
+    auto pos = target;
+    while (remaining && pos.y < size.Height())
+    {
+        auto& row = GetRowByOffset(pos.y);
+        const til::CoordType width = row.size();
+        const auto end = gsl::narrow_cast<til::CoordType>(std::min<size_t>(pos.x + remaining, width));
+
+        if (ch)
+        {
+            row.FillCharacters(pos.x, end, *ch);
+            if (end == width)
+            {
+                row.SetWrapForced(false);
+            }
+        }
+        if (attr)
+        {
+            row.ReplaceAttributes(pos.x, end, *attr);
+        }
+
+        TriggerRedraw(Viewport::FromExclusive({ pos.x, pos.y, end, pos.y + 1 }));
+        remaining -= gsl::narrow_cast<size_t>(end - pos.x);
+        pos = { 0, pos.y + 1 };
+    }
+
+    return count - remaining;
+}
+
 //Routine Description:
 // - Inserts one codepoint into the buffer at the current cursor position and advances the cursor as appropriate.
 //Arguments:
@@ -581,6 +678,21 @@ bool TextBuffer::IncrementCircularBuffer(const bool inVtMode)
         _renderer.TriggerFlush(true);
     }
 
+    // Spill the row we're about to discard, before its hyperlinks are pruned.
+    if (_spill)
+    {
+        try
+        {
+            _spill->Append(GetRowByOffset(0), *this);
+        }
+        catch (...)
+        {
+            // Most likely the disk is full. Fall back to regular scrollback.
+            LOG_CAUGHT_EXCEPTION();
+            _spill.reset();
+        }
+    }
+
     // Prune hyperlinks to delete obsolete references
     _PruneHyperlinks();
 
@@ -2314,12 +2426,21 @@ void TextBuffer::_AppendRTFText(std::ostringstream& contentBuilder, const std::w
 // - positionInfo - Optional. The caller can provide a pair of rows in this
 //   parameter and we'll calculate the position of the _end_ of those rows in
 //   the new buffer. The rows's new value is placed back into this parameter.
+//   The new position of the start of every reflowed row is stored in rowStarts.
+// - firstRow - Optional. The first row of the old buffer to reflow. The rows
+//   above it are skipped.
+// - endRow - Optional. If given, only the rows up to (but excluding) this one
+//   are reflowed and the new buffer is left with its cursor at the start of
+//   the next line, so that another buffer can be reflowed after it. The cursor
+//   position and the remaining rows are then the responsibility of the caller.
 // Return Value:
 // - S_OK if we successfully copied the contents to the new buffer, otherwise an appropriate HRESULT.
 HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
                            TextBuffer& newBuffer,
                            const std::optional<Viewport> lastCharacterViewport,
-                           std::optional<std::reference_wrapper<PositionInformation>> positionInfo)
+                           std::optional<std::reference_wrapper<PositionInformation>> positionInfo,
+                           const til::CoordType firstRow,
+                           const std::optional<til::CoordType> endRow)
 {
     const auto& oldCursor = oldBuffer.GetCursor();
     auto& newCursor = newBuffer.GetCursor();
@@ -2330,15 +2451,35 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
     const auto cOldCursorPos = oldCursor.GetPosition();
     const auto cOldLastChar = oldBuffer.GetLastNonSpaceCharacter(lastCharacterViewport);
 
-    const auto cOldRowsTotal = cOldLastChar.y + 1;
+    const auto cOldRowsTotal = endRow.value_or(cOldLastChar.y + 1);
 
     til::point cNewCursorPos;
     auto fFoundCursorPos = false;
     auto foundOldMutable = false;
     auto foundOldVisible = false;
     auto hr = S_OK;
+
+    // The new buffer may have to scroll while we fill it. We count how often
+    // it did, so that we can adjust the row starts we recorded before that.
+    const auto newTotalRows = newBuffer.TotalRowCount();
+    auto newFirstRow = newBuffer._firstRow;
+    til::CoordType newRotations = 0;
+
+    // Spilled rows keep their original width and are restored with CopySpilledRow().
+    // Only a reflow that starts at the top of the old buffer takes them along.
+    // The spill is handed over before any rows are copied, because the new buffer
+    // may discard rows while we fill it, and those need to be spilled as well.
+    // Resolving their hyperlinks requires the old buffer's hyperlink map.
+    const auto spilledRows = oldBuffer._spill ? oldBuffer._spill->Size() : 0;
+    const auto moveSpill = firstRow == 0 && oldBuffer._spill;
+    if (moveSpill)
+    {
+        newBuffer._spill = std::move(oldBuffer._spill);
+        newBuffer.CopyHyperlinkMaps(oldBuffer);
+    }
+
     // Loop through all the rows of the old buffer and reprint them into the new buffer
-    til::CoordType iOldRow = 0;
+    auto iOldRow = firstRow;
     for (; iOldRow < cOldRowsTotal; iOldRow++)
     {
         // Fetch the row and its "right" which is the last printable character.
@@ -2346,9 +2487,16 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
         const auto cOldColsTotal = oldBuffer.GetLineWidth(iOldRow);
         auto iRight = row.MeasureRight();
 
+        const auto newBufferPos = newCursor.GetPosition();
+        if (positionInfo.has_value())
+        {
+            newRotations += (newBuffer._firstRow - newFirstRow + newTotalRows) % newTotalRows;
+            newFirstRow = newBuffer._firstRow;
+            positionInfo.value().get().rowStarts.emplace_back(newBufferPos.x, newBufferPos.y + newRotations);
+        }
+
         // If we're starting a new row, try and preserve the line rendition
         // from the row in the original buffer.
-        const auto newBufferPos = newCursor.GetPosition();
         if (newBufferPos.x == 0)
         {
             auto& newRow = newBuffer.GetRowByOffset(newBufferPos.y);
@@ -2492,7 +2640,7 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
                 // On the final line, we want the cursor to sit
                 // where it is done printing for the cursor
                 // adjustment to follow.
-                if (iOldRow < cOldRowsTotal - 1)
+                if (iOldRow < cOldRowsTotal - 1 || endRow.has_value())
                 {
                     hr = newBuffer.NewlineCursor() ? hr : E_OUTOFMEMORY;
                 }
@@ -2535,6 +2683,28 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
         }
     }
 
+    if (positionInfo.has_value())
+    {
+        newRotations += (newBuffer._firstRow - newFirstRow + newTotalRows) % newTotalRows;
+        for (auto& rowStart : positionInfo.value().get().rowStarts)
+        {
+            rowStart.y -= newRotations;
+        }
+    }
+
+    // If the reflow failed, the old buffer stays in use. Give the spill back,
+    // without the rows that the new buffer spilled in the meantime.
+    if (FAILED(hr) && moveSpill && newBuffer._spill)
+    {
+        newBuffer._spill->Truncate(spilledRows);
+        oldBuffer._spill = std::move(newBuffer._spill);
+    }
+
+    if (endRow.has_value())
+    {
+        return hr;
+    }
+
     // Finish copying buffer attributes to remaining rows below the last
     // printable character. This is to fix the `color 2f` scenario, where you
     // change the buffer colors then resize and everything below the last
@@ -2739,9 +2909,428 @@ void TextBuffer::CopyHyperlinkMaps(const TextBuffer& other)
     _currentHyperlinkId = other._currentHyperlinkId;
 }
 
+// Method Description:
+// - Enables or disables spilling rows that scroll out of the buffer into a
+//   temporary file, which makes the scrollback only limited by disk space.
+// - Disabling the spill discards all spilled rows.
+// Arguments:
+// - enabled - Whether rows should be spilled.
+void TextBuffer::SetScrollbackSpill(const bool enabled)
+{
+    if (!enabled)
+    {
+        _spill.reset();
+    }
+    else if (!_spill)
+    {
+        _spill = std::make_unique<ScrollbackSpill>();
+    }
+}
+
+// Method Description:
+// - Returns the number of rows that were spilled out of the buffer.
+size_t TextBuffer::SpilledRowCount() const noexcept
+{
+    return _spill ? _spill->Size() : 0;
+}
+
+// Method Description:
+// - Returns the text of a spilled row, without trailing whitespace.
+// Arguments:
+// - index - The index of the row, where 0 is the oldest spilled row.
+std::wstring TextBuffer::GetSpilledRowText(const size_t index) const
+{
+    THROW_HR_IF_NULL(E_NOT_VALID_STATE, _spill);
+    return _spill->GetText(index);
+}
+
+// Method Description:
+// - Returns whether a spilled row wrapped into the next one.
+// Arguments:
+// - index - The index of the row, where 0 is the oldest spilled row.
+bool TextBuffer::WasSpilledRowWrapForced(const size_t index) const
+{
+    THROW_HR_IF_NULL(E_NOT_VALID_STATE, _spill);
+    return _spill->WasWrapForced(index);
+}
+
+// Method Description:
+// - Pages a spilled row back into the given row. Hyperlinks
+//   of the spilled row are re-registered with this buffer.
+// Arguments:
+// - index - The index of the row, where 0 is the oldest spilled row.
+// - row - The row to restore into.
+void TextBuffer::CopySpilledRow(const size_t index, ROW& row)
+{
+    THROW_HR_IF_NULL(E_NOT_VALID_STATE, _spill);
+    _spill->CopyTo(index, row, *this);
+}
+
+// Method Description:
+// - Discards all spilled rows, for instance when the scrollback is erased.
+void TextBuffer::ClearScrollbackSpill() noexcept
+{
+    if (_spill)
+    {
+        _spill->Clear();
+    }
+}
+
+namespace
+{
+    // A snapshot consists of a SnapshotHeader, followed by the spilled rows (as stored by the ScrollbackSpill),
+    // followed by a SnapshotBufferHeader, the hyperlink maps and finally the rows of the buffer itself.
+    // The spilled rows come first, so that a snapshot can be updated by only appending the rows that
+    // were spilled in the meantime and rewriting the (comparatively small) tail.
+    // All fields are at most 2-byte aligned and all sections are a multiple of 2 bytes long,
+    // which allows us to use the row storage in a snapshot in-place, without copying it first.
+    constexpr uint32_t SnapshotMagic = 0x53425457; // "WTBS"
+    constexpr uint16_t SnapshotVersion = 2;
+
+    struct SnapshotHeader
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t reserved;
+        GUID spillId;
+        uint64_t spillGeneration;
+        uint64_t historyRows;
+        uint64_t historyBytes;
+    };
+
+    struct SnapshotBufferHeader
+    {
+        int32_t width;
+        int32_t height;
+        int32_t cursorX;
+        int32_t cursorY;
+        uint32_t cursorSize;
+        uint32_t cursorType;
+        uint32_t hyperlinkCount;
+        uint32_t customIdCount;
+        uint16_t currentHyperlinkId;
+        uint8_t cursorFlags;
+        uint8_t reserved;
+        TextAttribute currentAttributes;
+    };
+
+    struct SnapshotRowHeader
+    {
+        uint16_t charsLength;
+        uint16_t attrRunCount;
+        uint8_t lineRendition;
+        uint8_t flags;
+    };
+
+    using SnapshotRun = til::rle_pair<TextAttribute, uint16_t>;
+
+    constexpr uint8_t SnapshotCursorVisible = 1 << 0;
+    constexpr uint8_t SnapshotCursorBlinking = 1 << 1;
+    constexpr uint8_t SnapshotRowWrapForced = 1 << 0;
+    constexpr uint8_t SnapshotRowDoubleBytePadded = 1 << 1;
+
+    static_assert(std::is_trivially_copyable_v<SnapshotRun>);
+    static_assert(alignof(SnapshotRun) <= alignof(uint16_t) && sizeof(SnapshotRun) % alignof(uint16_t) == 0);
+    static_assert(sizeof(SnapshotHeader) % alignof(uint16_t) == 0);
+    static_assert(sizeof(SnapshotBufferHeader) % alignof(uint16_t) == 0);
+    static_assert(sizeof(SnapshotRowHeader) % alignof(uint16_t) == 0);
+
+    template<typename T>
+    void appendSnapshot(std::vector<std::byte>& snapshot, const T& value)
+    {
+        const auto bytes = std::as_bytes(std::span{ &value, 1 });
+        snapshot.insert(snapshot.end(), bytes.begin(), bytes.end());
+    }
+
+    template<typename T>
+    void appendSnapshot(std::vector<std::byte>& snapshot, const std::span<const T> values)
+    {
+        const auto bytes = std::as_bytes(values);
+        snapshot.insert(snapshot.end(), bytes.begin(), bytes.end());
+    }
+
+    void appendSnapshot(std::vector<std::byte>& snapshot, const std::wstring_view& str)
+    {
+        appendSnapshot(snapshot, gsl::narrow<uint32_t>(str.size()));
+        appendSnapshot(snapshot, std::span<const wchar_t>{ str });
+    }
+
+    // Reads the sections of a snapshot, throwing if it's truncated.
+    class SnapshotReader
+    {
+    public:
+        explicit SnapshotReader(const std::span<const std::byte> snapshot) noexcept :
+            _it{ snapshot.data() },
+            _end{ snapshot.data() + snapshot.size() }
+        {
+        }
+
+        template<typename T>
+        T Read()
+        {
+            T value;
+            memcpy(&value, _take(sizeof(T)), sizeof(T));
+            return value;
+        }
+
+        template<typename T>
+        std::span<const T> ReadSpan(const size_t count)
+        {
+            static_assert(alignof(T) <= alignof(uint16_t));
+            THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), count > PTRDIFF_MAX / sizeof(T));
+            return { reinterpret_cast<const T*>(_take(count * sizeof(T))), count };
+        }
+
+        std::wstring ReadString()
+        {
+            const auto str = ReadSpan<wchar_t>(Read<uint32_t>());
+            return { str.begin(), str.end() };
+        }
+
+    private:
+        const std::byte* _take(const size_t size)
+        {
+            THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_DATA), size > gsl::narrow_cast<size_t>(_end - _it));
+            const auto it = _it;
+            _it += size;
+            return it;
+        }
+
+        const std::byte* _it;
+        const std::byte* _end;
+    };
+}
+
+// Method Description:
+// - Serializes the buffer into a compact binary snapshot: the spilled rows, the rows of the buffer
+//   with their raw text and attribute runs, the hyperlink maps, the current attributes and the cursor.
+// - If the given snapshot already contains a previous snapshot of this buffer, the spilled rows in it
+//   are kept and only the ones that were spilled since then are appended. Everything else is rewritten.
+// Arguments:
+// - snapshot - The snapshot to write into. It's overwritten, unless it can be updated as described above.
+void TextBuffer::SaveSnapshot(std::vector<std::byte>& snapshot) const
+{
+    const auto history = _spill ? _spill->Records() : std::span<const std::byte>{};
+    const auto id = _spill ? _spill->Id() : GUID{};
+    const auto generation = _spill ? _spill->Generation() : 0;
+
+    size_t historyKept = 0;
+    if (snapshot.size() >= sizeof(SnapshotHeader))
+    {
+        SnapshotHeader previous;
+        memcpy(&previous, snapshot.data(), sizeof(previous));
+        if (previous.magic == SnapshotMagic &&
+            previous.version == SnapshotVersion &&
+            previous.spillId == id &&
+            previous.spillGeneration == generation &&
+            previous.historyBytes <= history.size() &&
+            previous.historyBytes <= snapshot.size() - sizeof(SnapshotHeader))
+        {
+            historyKept = gsl::narrow_cast<size_t>(previous.historyBytes);
+        }
+    }
+
+    const SnapshotHeader header{
+        .magic = SnapshotMagic,
+        .version = SnapshotVersion,
+        .spillId = id,
+        .spillGeneration = generation,
+        .historyRows = _spill ? _spill->Size() : 0,
+        .historyBytes = history.size(),
+    };
+
+    snapshot.resize(sizeof(SnapshotHeader) + historyKept);
+    memcpy(snapshot.data(), &header, sizeof(header));
+    appendSnapshot(snapshot, history.subspan(historyKept));
+
+    const auto size = GetSize().Dimensions();
+    const auto cursorPosition = _cursor.GetPosition();
+    uint8_t cursorFlags = 0;
+    WI_SetFlagIf(cursorFlags, SnapshotCursorVisible, _cursor.IsVisible());
+    WI_SetFlagIf(cursorFlags, SnapshotCursorBlinking, _cursor.IsBlinkingAllowed());
+
+    const SnapshotBufferHeader bufferHeader{
+        .width = size.width,
+        .height = size.height,
+        .cursorX = cursorPosition.x,
+        .cursorY = cursorPosition.y,
+        .cursorSize = _cursor.GetSize(),
+        .cursorType = static_cast<uint32_t>(_cursor.GetType()),
+        .hyperlinkCount = gsl::narrow<uint32_t>(_hyperlinkMap.size()),
+        .customIdCount = gsl::narrow<uint32_t>(_hyperlinkCustomIdMap.size()),
+        .currentHyperlinkId = _currentHyperlinkId,
+        .cursorFlags = cursorFlags,
+        .currentAttributes = _currentAttributes,
+    };
+    appendSnapshot(snapshot, bufferHeader);
+
+    for (const auto& [id, uri] : _hyperlinkMap)
+    {
+        appendSnapshot(snapshot, id);
+        appendSnapshot(snapshot, std::wstring_view{ uri });
+    }
+    for (const auto& [customId, id] : _hyperlinkCustomIdMap)
+    {
+        appendSnapshot(snapshot, id);
+        appendSnapshot(snapshot, std::wstring_view{ customId });
+    }
+
+    for (til::CoordType y = 0; y < size.height; ++y)
+    {
+        const auto& row = GetRowByOffset(y);
+        const auto text = row.GetText();
+        const auto& runs = row.Attributes().runs();
+
+        uint8_t flags = 0;
+        WI_SetFlagIf(flags, SnapshotRowWrapForced, row.WasWrapForced());
+        WI_SetFlagIf(flags, SnapshotRowDoubleBytePadded, row.WasDoubleBytePadded());
+
+        const SnapshotRowHeader rowHeader{
+            .charsLength = gsl::narrow<uint16_t>(text.size()),
+            .attrRunCount = gsl::narrow<uint16_t>(runs.size()),
+            .lineRendition = static_cast<uint8_t>(row.GetLineRendition()),
+            .flags = flags,
+        };
+        appendSnapshot(snapshot, rowHeader);
+        appendSnapshot(snapshot, std::span<const wchar_t>{ text });
+        appendSnapshot(snapshot, row.GetCharOffsets());
+        appendSnapshot(snapshot, std::span<const SnapshotRun>{ runs.data(), runs.size() });
+    }
+}
+
+// Method Description:
+// - Replaces the contents of this buffer with a snapshot written by SaveSnapshot().
+//   The buffer is resized to the size of the snapshot if necessary.
+// - The rows are restored by copying their raw storage, without measuring or parsing any
+//   of the text again. If the snapshot contains spilled rows, the spill is enabled.
+// - The snapshot is only what the TextBuffer itself holds. Marks and terminal modes
+//   belong to the Terminal and aren't part of it.
+// - Throws if the snapshot is malformed, in which case the buffer is left unchanged.
+// Arguments:
+// - snapshot - The snapshot to restore.
+void TextBuffer::LoadSnapshot(std::span<const std::byte> snapshot)
+{
+    static constexpr auto invalid = HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+
+    // The row storage is used in-place, which requires the snapshot to be 2-byte aligned.
+    std::vector<uint16_t> aligned;
+    if (reinterpret_cast<uintptr_t>(snapshot.data()) % alignof(uint16_t) != 0)
+    {
+        aligned.resize((snapshot.size() + 1) / sizeof(uint16_t));
+        memcpy(aligned.data(), snapshot.data(), snapshot.size());
+        snapshot = std::as_bytes(std::span{ aligned }).first(snapshot.size());
+    }
+
+    SnapshotReader reader{ snapshot };
+
+    const auto header = reader.Read<SnapshotHeader>();
+    THROW_HR_IF(invalid, header.magic != SnapshotMagic || header.version != SnapshotVersion);
+    const auto history = reader.ReadSpan<std::byte>(gsl::narrow<size_t>(header.historyBytes));
+
+    const auto bufferHeader = reader.Read<SnapshotBufferHeader>();
+    THROW_HR_IF(invalid, bufferHeader.width <= 0 || bufferHeader.width > UINT16_MAX);
+    THROW_HR_IF(invalid, bufferHeader.height <= 0 || bufferHeader.height > UINT16_MAX);
+    THROW_HR_IF(invalid, bufferHeader.cursorType > static_cast<uint32_t>(CursorType::DoubleUnderscore));
+
+    decltype(_hyperlinkMap) hyperlinkMap;
+    for (uint32_t i = 0; i < bufferHeader.hyperlinkCount; ++i)
+    {
+        const auto id = reader.Read<uint16_t>();
+        hyperlinkMap.insert_or_assign(id, reader.ReadString());
+    }
+    decltype(_hyperlinkCustomIdMap) hyperlinkCustomIdMap;
+    for (uint32_t i = 0; i < bufferHeader.customIdCount; ++i)
+    {
+        const auto id = reader.Read<uint16_t>();
+        hyperlinkCustomIdMap.insert_or_assign(reader.ReadString(), id);
+    }
+
+    // Every hyperlink ID that's in use has to resolve to a URI in the restored map.
+    const auto validateHyperlinkId = [&](const uint16_t id) {
+        THROW_HR_IF(invalid, id != 0 && !hyperlinkMap.contains(id));
+    };
+    for (const auto& [customId, id] : hyperlinkCustomIdMap)
+    {
+        validateHyperlinkId(id);
+    }
+    // This is the next ID to be handed out, which is never 0.
+    THROW_HR_IF(invalid, bufferHeader.currentHyperlinkId == 0);
+    // The hyperlink that's currently being written may have been pruned from the map if all
+    // of its rows scrolled out. It can't be restored then, but that's no reason to fail.
+    auto currentAttributes = bufferHeader.currentAttributes;
+    if (!hyperlinkMap.contains(currentAttributes.GetHyperlinkId()))
+    {
+        currentAttributes.SetHyperlinkId(0);
+    }
+
+    // The rows are restored into new storage, which only replaces ours once the entire
+    // snapshot turned out to be valid. ROW::Restore() validates the text and attributes.
+    const til::size size{ bufferHeader.width, bufferHeader.height };
+    std::vector<ROW> storage;
+    auto charBuffer = _allocateBuffer(size, currentAttributes, storage);
+
+    const auto charOffsetsCount = gsl::narrow_cast<size_t>(size.width) + 1;
+    for (auto& row : storage)
+    {
+        const auto rowHeader = reader.Read<SnapshotRowHeader>();
+        const auto chars = reader.ReadSpan<wchar_t>(rowHeader.charsLength);
+        const auto charOffsets = reader.ReadSpan<uint16_t>(charOffsetsCount);
+        const auto runs = reader.ReadSpan<SnapshotRun>(rowHeader.attrRunCount);
+        THROW_HR_IF(invalid, rowHeader.lineRendition > static_cast<uint8_t>(LineRendition::DoubleHeightBottom));
+        for (const auto& run : runs)
+        {
+            validateHyperlinkId(run.value.GetHyperlinkId());
+        }
+
+        row.Restore({ chars.data(), chars.size() }, charOffsets, runs);
+        row.SetLineRendition(static_cast<LineRendition>(rowHeader.lineRendition));
+        row.SetWrapForced(WI_IsFlagSet(rowHeader.flags, SnapshotRowWrapForced));
+        row.SetDoubleBytePadded(WI_IsFlagSet(rowHeader.flags, SnapshotRowDoubleBytePadded));
+    }
+
+    // Spilled rows carry their own hyperlinks. AppendRecords() validates each of them.
+    std::unique_ptr<ScrollbackSpill> spill;
+    if (!history.empty())
+    {
+        spill = std::make_unique<ScrollbackSpill>();
+        spill->AppendRecords(history);
+        THROW_HR_IF(invalid, spill->Size() != header.historyRows);
+    }
+
+    // Nothing below throws anymore, so the buffer is either entirely restored or left alone.
+    _charBuffer = std::move(charBuffer);
+    _storage = std::move(storage);
+    _SetFirstRowIndex(0);
+    _UpdateSize();
+
+    _hyperlinkMap = std::move(hyperlinkMap);
+    _hyperlinkCustomIdMap = std::move(hyperlinkCustomIdMap);
+    _currentHyperlinkId = bufferHeader.currentHyperlinkId;
+    _currentAttributes = currentAttributes;
+
+    if (spill)
+    {
+        _spill = std::move(spill);
+    }
+    else
+    {
+        ClearScrollbackSpill();
+    }
+
+    _cursor.SetStyle(bufferHeader.cursorSize, static_cast<CursorType>(bufferHeader.cursorType));
+    _cursor.SetIsVisible(WI_IsFlagSet(bufferHeader.cursorFlags, SnapshotCursorVisible));
+    _cursor.SetBlinkingAllowed(WI_IsFlagSet(bufferHeader.cursorFlags, SnapshotCursorBlinking));
+    til::point cursorPosition{ bufferHeader.cursorX, bufferHeader.cursorY };
+    GetSize().Clamp(cursorPosition);
+    _cursor.SetPosition(cursorPosition);
+
+    TriggerRedrawAll();
+}
+
 // Method Description:
 // - Adds a regex pattern we should search for
-// - The searching does not happen here, we only search when asked to by TerminalCore
+// - The searching does not happen here, we only search when asked to by TerminalCore.
+//   The pattern is compiled once up front though, since GetPatterns() is called frequently.
 // Arguments:
 // - The regex pattern
 // Return value:
@@ -2749,7 +3338,7 @@ void TextBuffer::CopyHyperlinkMaps(const TextBuffer& other)
 const size_t TextBuffer::AddPatternRecognizer(const std::wstring_view regexString)
 {
     ++_currentPatternId;
-    _idsAndPatterns.emplace(std::make_pair(_currentPatternId, regexString));
+    _idsAndPatterns.emplace(_currentPatternId, std::wregex{ regexString.begin(), regexString.end() });
     return _currentPatternId;
 }
 
@@ -2797,10 +3386,8 @@ PointTree TextBuffer::GetPatterns(const til::CoordType firstRow, const til::Coor
     // for each pattern we know of, iterate through the string
     for (const auto& idAndPattern : _idsAndPatterns)
     {
-        std::wregex regexObj{ idAndPattern.second };
-
         // search through the run with our regex object
-        auto words_begin = std::wsregex_iterator(concatAll.begin(), concatAll.end(), regexObj);
+        auto words_begin = std::wsregex_iterator(concatAll.begin(), concatAll.end(), idAndPattern.second);
         auto words_end = std::wsregex_iterator();
 
         til::CoordType lenUpToThis = 0;
@@ -53,6 +53,7 @@ filling in the last row, and updating the screen.
 
 #include "cursor.h"
 #include "Row.hpp"
+#include "ScrollbackSpill.hpp"
 #include "TextAttribute.hpp"
 #include "../types/inc/Viewport.hpp"
 
@@ -103,6 +104,9 @@ public:
                                  const std::optional<bool> setWrap = std::nullopt,
                                  const std::optional<til::CoordType> limitRight = std::nullopt);
 
+    void FillRect(const til::rect& rect, const wchar_t ch, const TextAttribute& attr);
+    size_t FillCells(const til::point target, const size_t count, const std::optional<wchar_t> ch, const std::optional<TextAttribute> attr);
+
     bool InsertCharacter(const wchar_t wch, const DbcsAttribute dbcsAttribute, const TextAttribute attr);
     bool InsertCharacter(const std::wstring_view chars, const DbcsAttribute dbcsAttribute, const TextAttribute attr);
     bool IncrementCursor();
@@ -174,6 +178,16 @@ public:
     std::wstring GetCustomIdFromId(uint16_t id) const;
     void CopyHyperlinkMaps(const TextBuffer& OtherBuffer);
 
+    void SetScrollbackSpill(const bool enabled);
+    size_t SpilledRowCount() const noexcept;
+    std::wstring GetSpilledRowText(const size_t index) const;
+    bool WasSpilledRowWrapForced(const size_t index) const;
+    void CopySpilledRow(const size_t index, ROW& row);
+    void ClearScrollbackSpill() noexcept;
+
+    void SaveSnapshot(std::vector<std::byte>& snapshot) const;
+    void LoadSnapshot(std::span<const std::byte> snapshot);
+
     class TextAndColor
     {
     public:
@@ -206,12 +220,16 @@ public:
     {
         til::CoordType mutableViewportTop{ 0 };
         til::CoordType visibleViewportTop{ 0 };
+        // The new position of the first cell of each reflowed row.
+        std::vector<til::point> rowStarts;
     };
 
     static HRESULT Reflow(TextBuffer& oldBuffer,
                           TextBuffer& newBuffer,
                           const std::optional<Microsoft::Console::Types::Viewport> lastCharacterViewport,
-                          std::optional<std::reference_wrapper<PositionInformation>> positionInfo);
+                          std::optional<std::reference_wrapper<PositionInformation>> positionInfo,
+                          const til::CoordType firstRow = 0,
+                          const std::optional<til::CoordType> endRow = std::nullopt);
 
     const size_t AddPatternRecognizer(const std::wstring_view regexString);
     void ClearPatternRecognizers() noexcept;
@@ -246,9 +264,12 @@ private:
     std::unordered_map<std::wstring, uint16_t> _hyperlinkCustomIdMap;
     uint16_t _currentHyperlinkId = 1;
 
-    std::unordered_map<size_t, std::wstring> _idsAndPatterns;
+    std::unordered_map<size_t, std::wregex> _idsAndPatterns;
     size_t _currentPatternId = 0;
 
+    // Rows that scrolled out of the buffer, if spilling is enabled.
+    std::unique_ptr<ScrollbackSpill> _spill;
+
     wil::unique_virtualalloc_ptr<std::byte> _charBuffer;
     std::vector<ROW> _storage;
     TextAttribute _currentAttributes;
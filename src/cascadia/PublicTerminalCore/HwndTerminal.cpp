@@ -326,6 +326,9 @@ IRawElementProviderSimple* HwndTerminal::_GetUiaProvider() noexcept
             auto lock = _terminal->LockForWriting();
             LOG_IF_FAILED(::Microsoft::WRL::MakeAndInitialize<HwndTerminalAutomationPeer>(&_uiaProvider, this->GetRenderData(), this));
             _uiaEngine = std::make_unique<::Microsoft::Console::Render::UiaEngine>(_uiaProvider.Get());
+            // _uiaEngine is destroyed before _renderer, which
+            // also waits for any pending redraw callback.
+            _uiaEngine->SetRedrawCallback([this]() { _renderer->NotifyPaintFrame(); });
             LOG_IF_FAILED(_uiaEngine->Enable());
             _renderer->AddRenderEngine(_uiaEngine.get());
         }
@@ -381,9 +384,45 @@ void HwndTerminal::SendOutput(std::wstring_view data)
     {
         return;
     }
+
+    const auto lock = _terminal->LockForWriting();
+    // UTF-16 output can't complete a character that the UTF-8 output ended in the middle of.
+    // It's dropped, so that its remainder isn't glued onto whatever UTF-8 output comes next.
+    _u8State.reset();
     _terminal->Write(data);
 }
 
+// Routine Description:
+// - Writes UTF-8 output to the terminal. The chunks are converted one after another
+//   into the same reusable buffer and parsed right away, without concatenating them.
+// - A chunk may end in the middle of a character. The remainder is held on to
+//   until the next chunk arrives, even if that's in a later call.
+// Arguments:
+// - chunks - The UTF-8 output, in order.
+void HwndTerminal::SendOutputUtf8(const std::span<const TerminalOutputChunk> chunks)
+{
+    if (!_terminal)
+    {
+        return;
+    }
+
+    // Terminal::Write acquires the lock as well, but it's recursive.
+    // Holding it for the whole batch avoids acquiring it once per chunk.
+    const auto lock = _terminal->LockForWriting();
+    for (const auto& chunk : chunks)
+    {
+        if (!chunk.Data || !chunk.Length)
+        {
+            continue;
+        }
+
+        if (SUCCEEDED(LOG_IF_FAILED(til::u8u16({ chunk.Data, chunk.Length }, _u16Buffer, _u8State))))
+        {
+            _terminal->Write(_u16Buffer);
+        }
+    }
+}
+
 HRESULT _stdcall CreateTerminal(HWND parentHwnd, _Out_ void** hwnd, _Out_ void** terminal)
 {
     auto _terminal = std::make_unique<HwndTerminal>(parentHwnd);
@@ -413,6 +452,34 @@ void _stdcall TerminalSendOutput(void* terminal, LPCWSTR data)
     publicTerminal->SendOutput(data);
 }
 
+/// <summary>
+/// Writes UTF-8 output to the terminal. Unlike TerminalSendOutput, the data
+/// doesn't need to be converted to UTF-16 or null-terminated by the caller.
+/// </summary>
+/// <param name="terminal">Terminal pointer.</param>
+/// <param name="data">The UTF-8 output. It may end in the middle of a character, which is completed by the next call.
+/// If TerminalSendOutput is called before that, the unfinished character is dropped.</param>
+/// <param name="length">The length of data in bytes.</param>
+void _stdcall TerminalSendOutputUtf8(void* terminal, const char* data, size_t length)
+{
+    const auto publicTerminal = static_cast<HwndTerminal*>(terminal);
+    const TerminalOutputChunk chunk{ data, length };
+    publicTerminal->SendOutputUtf8({ &chunk, 1 });
+}
+
+/// <summary>
+/// Writes several chunks of UTF-8 output to the terminal at once,
+/// as if TerminalSendOutputUtf8 was called for each of them in order.
+/// </summary>
+/// <param name="terminal">Terminal pointer.</param>
+/// <param name="chunks">The chunks of UTF-8 output.</param>
+/// <param name="count">The number of chunks.</param>
+void _stdcall TerminalSendOutputUtf8Batch(void* terminal, const TerminalOutputChunk* chunks, size_t count)
+{
+    const auto publicTerminal = static_cast<HwndTerminal*>(terminal);
+    publicTerminal->SendOutputUtf8({ chunks, count });
+}
+
 /// <summary>
 /// Triggers a terminal resize using the new width and height in pixel.
 /// </summary>
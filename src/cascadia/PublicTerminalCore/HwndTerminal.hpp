@@ -23,9 +23,18 @@ typedef struct _TerminalTheme
     COLORREF ColorTable[16];
 } TerminalTheme, *LPTerminalTheme;
 
+// A chunk of UTF-8 output for TerminalSendOutputUtf8Batch. It doesn't need to be null-terminated.
+typedef struct _TerminalOutputChunk
+{
+    const char* Data;
+    size_t Length;
+} TerminalOutputChunk, *LPTerminalOutputChunk;
+
 extern "C" {
 __declspec(dllexport) HRESULT _stdcall CreateTerminal(HWND parentHwnd, _Out_ void** hwnd, _Out_ void** terminal);
 __declspec(dllexport) void _stdcall TerminalSendOutput(void* terminal, LPCWSTR data);
+__declspec(dllexport) void _stdcall TerminalSendOutputUtf8(void* terminal, const char* data, size_t length);
+__declspec(dllexport) void _stdcall TerminalSendOutputUtf8Batch(void* terminal, const TerminalOutputChunk* chunks, size_t count);
 __declspec(dllexport) void _stdcall TerminalRegisterScrollCallback(void* terminal, void __stdcall callback(int, int, int));
 __declspec(dllexport) HRESULT _stdcall TerminalTriggerResize(_In_ void* terminal, _In_ til::CoordType width, _In_ til::CoordType height, _Out_ til::size* dimensions);
 __declspec(dllexport) HRESULT _stdcall TerminalTriggerResizeWithDimension(_In_ void* terminal, _In_ til::size dimensions, _Out_ til::size* dimensionsInPixels);
@@ -46,6 +55,13 @@ __declspec(dllexport) void _stdcall TerminalSetFocus(void* terminal);
 __declspec(dllexport) void _stdcall TerminalKillFocus(void* terminal);
 };
 
+#ifdef UNIT_TESTING
+namespace TerminalCoreUnitTests
+{
+    class HwndTerminalTests;
+};
+#endif
+
 struct HwndTerminal : ::Microsoft::Console::Types::IControlAccessibilityInfo
 {
 public:
@@ -60,6 +76,7 @@ public:
     HRESULT Initialize();
     void Teardown() noexcept;
     void SendOutput(std::wstring_view data);
+    void SendOutputUtf8(std::span<const TerminalOutputChunk> chunks);
     HRESULT Refresh(const til::size windowSize, _Out_ til::size* dimensions);
     void RegisterScrollCallback(std::function<void(int, int, int)> callback);
     void RegisterWriteCallback(const void _stdcall callback(wchar_t*));
@@ -78,6 +95,12 @@ private:
 
     std::unique_ptr<::Microsoft::Terminal::Core::Terminal> _terminal;
 
+    // The state of the UTF-8 output, which may end in the middle of a character,
+    // and the buffer it's converted into. Both are protected by the terminal's lock.
+    // UTF-16 output in between drops an unfinished character (see SendOutput).
+    til::u8state _u8State{};
+    std::wstring _u16Buffer;
+
     std::unique_ptr<::Microsoft::Console::Render::Renderer> _renderer;
     std::unique_ptr<::Microsoft::Console::Render::DxEngine> _renderEngine;
     std::unique_ptr<::Microsoft::Console::Render::UiaEngine> _uiaEngine;
@@ -107,6 +130,10 @@ private:
     friend void _stdcall TerminalSetFocus(void* terminal);
     friend void _stdcall TerminalKillFocus(void* terminal);
 
+#ifdef UNIT_TESTING
+    friend class TerminalCoreUnitTests::HwndTerminalTests;
+#endif
+
     void _UpdateFont(int newDpi);
     void _WriteTextToConnection(const std::wstring_view text) noexcept;
     HRESULT _CopyTextToSystemClipboard(const TextBuffer::TextAndColor& rows, const bool fAlsoCopyFormatting);
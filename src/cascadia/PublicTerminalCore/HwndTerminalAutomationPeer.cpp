@@ -157,3 +157,15 @@ void HwndTerminalAutomationPeer::NotifyNewOutput(std::wstring_view newOutput)
     static auto activityId = wil::make_bstr_nothrow(L"TerminalTextOutput");
     LOG_IF_FAILED(UiaRaiseNotificationEvent(this, NotificationKind_ActionCompleted, NotificationProcessing_All, sanitizedBstr.get(), activityId.get()));
 }
+
+// Method Description:
+// - Announces that some output scrolled by too fast to be read out.
+//   PublicTerminalCore has no string resources, so this isn't localized.
+// Arguments:
+// - omittedLength: the number of characters that were skipped
+// Return Value:
+// - <none>
+void HwndTerminalAutomationPeer::NotifyOutputOmitted(size_t omittedLength)
+{
+    NotifyNewOutput(fmt::format(L"{} characters of output were skipped.", omittedLength));
+}
@@ -36,6 +36,7 @@ public:
     void SignalTextChanged() override;
     void SignalCursorChanged() override;
     void NotifyNewOutput(std::wstring_view newOutput) override;
+    void NotifyOutputOmitted(size_t omittedLength) override;
 #pragma endregion
 private:
     std::deque<wchar_t> _keyEvents;
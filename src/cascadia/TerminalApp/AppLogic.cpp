@@ -494,8 +494,19 @@ namespace winrt::TerminalApp::implementation
         //  - don't change the settings (and don't actually apply the new settings)
         //  - don't persist them.
         //  - display a loading error
+        const auto start = std::chrono::steady_clock::now();
         _settingsLoadedResult = _TryLoadSettings();
 
+        const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+        TraceLoggingWrite(
+            g_hTerminalAppProvider,
+            "SettingsLoaded",
+            TraceLoggingDescription("Event emitted after the settings were (re)loaded from disk"),
+            TraceLoggingHResult(_settingsLoadedResult, "result"),
+            TraceLoggingFloat64(duration.count(), "durationMs"),
+            TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+            TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+
         const auto initialLoad = !_loadedInitialSettings;
         _loadedInitialSettings = true;
 
@@ -3017,6 +3017,8 @@ namespace winrt::TerminalApp::implementation
     //   finally create the tab flyout
     void TerminalPage::_RefreshUIForSettingsReload()
     {
+        const auto start = std::chrono::steady_clock::now();
+
         // Re-wire the keybindings to their handlers, as we'll have created a
         // new AppKeyBindings object.
         _HookupKeyBindings(_settings.ActionMap());
@@ -3040,6 +3042,7 @@ namespace winrt::TerminalApp::implementation
             profileGuidSettingsMap.insert_or_assign(newProfile.Guid(), std::pair{ newProfile, nullptr });
         }
 
+        uint32_t paneCount = 0;
         for (const auto& tab : _tabs)
         {
             if (auto terminalTab{ _GetTerminalTabImpl(tab) })
@@ -3063,7 +3066,10 @@ namespace winrt::TerminalApp::implementation
                             {
                                 pair.second = TerminalSettings::CreateWithProfile(_settings, pair.first, *_bindings);
                             }
+                            // The control compares these with its current settings, and only
+                            // applies the ones that changed. See ControlCore::UpdateSettings.
                             pane->UpdateSettings(pair.second, pair.first);
+                            paneCount++;
                         }
                     }
                 });
@@ -3085,6 +3091,16 @@ namespace winrt::TerminalApp::implementation
             tabImpl->SetActionMap(_settings.ActionMap());
         }
 
+        const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+        TraceLoggingWrite(
+            g_hTerminalAppProvider,
+            "SettingsReloadAppliedToPanes",
+            TraceLoggingDescription("Event emitted after the reloaded settings were handed to all panes"),
+            TraceLoggingUInt32(paneCount, "paneCount"),
+            TraceLoggingFloat64(duration.count(), "durationMs"),
+            TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+            TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+
         if (const auto focusedTab{ _GetFocusedTabImpl() })
         {
             if (const auto profile{ focusedTab->GetFocusedProfile() })
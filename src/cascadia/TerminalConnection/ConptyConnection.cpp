@@ -230,6 +230,13 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         CATCH_LOG()
     }
 
+    ConptyConnection::~ConptyConnection()
+    {
+        // The input thread doesn't keep us alive, unlike the output thread,
+        // because it would never exit on its own if we're never Close()d.
+        _stopInputThread();
+    }
+
     // Function Description:
     // - Helper function for constructing a ValueSet that we can use to get our settings from.
     Windows::Foundation::Collections::ValueSet ConptyConnection::CreateSettings(const winrt::hstring& cmdline,
@@ -415,6 +422,27 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         LOG_IF_FAILED(SetThreadDescription(_hOutputThread.get(), L"ConptyConnection Output Thread"));
 
+        _input.Restart();
+
+        _hInputThread.reset(CreateThread(
+            nullptr,
+            0,
+            [](LPVOID lpParameter) noexcept {
+                const auto pInstance = static_cast<ConptyConnection*>(lpParameter);
+                if (pInstance)
+                {
+                    return pInstance->_InputThread();
+                }
+                return gsl::narrow_cast<DWORD>(E_INVALIDARG);
+            },
+            this,
+            0,
+            nullptr));
+
+        THROW_LAST_ERROR_IF_NULL(_hInputThread);
+
+        LOG_IF_FAILED(SetThreadDescription(_hInputThread.get(), L"ConptyConnection Input Thread"));
+
         _transitionToState(ConnectionState::Connected);
     }
     catch (...)
@@ -478,6 +506,13 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
     }
     CATCH_LOG()
 
+    // Method Description:
+    // - Queues the given input to be written to the pipe by the input thread.
+    //   This never blocks on the pipe and never drops any input. If the client
+    //   isn't keeping up, InputPendingChanged is raised, so that the UI can
+    //   indicate that the input is still being written.
+    // Arguments:
+    // - data: the input to write, which is converted to UTF-8 as ConPTY expects.
     void ConptyConnection::WriteInput(const hstring& data)
     {
         if (!_isConnected())
@@ -486,9 +521,25 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         }
 
         // convert from UTF-16LE to UTF-8 as ConPty expects UTF-8
-        // TODO GH#3378 reconcile and unify UTF-8 converters
-        auto str = winrt::to_string(data);
-        LOG_IF_WIN32_BOOL_FALSE(WriteFile(_inPipe.get(), str.c_str(), (DWORD)str.length(), nullptr, nullptr));
+        auto buffer = _input.TakeBuffer();
+        if (FAILED_LOG(til::u16u8(data, buffer)))
+        {
+            return;
+        }
+
+        if (_input.PushText(std::move(buffer)))
+        {
+            _InputPendingChangedHandlers(*this, nullptr);
+        }
+    }
+
+    // Method Description:
+    // - Returns true if the client isn't keeping up with the input written by
+    //   WriteInput(), for instance during a large paste into a slow application.
+    //   It stays true until all of the pending input has been written.
+    bool ConptyConnection::InputPending() const
+    {
+        return _input.Backlogged();
     }
 
     void ConptyConnection::Resize(uint32_t rows, uint32_t columns)
@@ -499,7 +550,10 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         if (_isConnected())
         {
-            THROW_IF_FAILED(ConptyResizePseudoConsole(_hPC.get(), { Utils::ClampToShortMax(columns, 1), Utils::ClampToShortMax(rows, 1) }));
+            const COORD size{ Utils::ClampToShortMax(columns, 1), Utils::ClampToShortMax(rows, 1) };
+            _runInOrderWithInput([this, size]() {
+                THROW_IF_FAILED(ConptyResizePseudoConsole(_hPC.get(), size));
+            });
         }
     }
 
@@ -509,7 +563,9 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         // anything. The connection should already start clear!
         if (_isConnected())
         {
-            THROW_IF_FAILED(ConptyClearPseudoConsole(_hPC.get()));
+            _runInOrderWithInput([this]() {
+                THROW_IF_FAILED(ConptyClearPseudoConsole(_hPC.get()));
+            });
         }
     }
 
@@ -518,7 +574,9 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         // If we haven't connected yet, then stash for when we do connect.
         if (_isConnected())
         {
-            THROW_IF_FAILED(ConptyShowHidePseudoConsole(_hPC.get(), show));
+            _runInOrderWithInput([this, show]() {
+                THROW_IF_FAILED(ConptyShowHidePseudoConsole(_hPC.get(), show));
+            });
         }
         else
         {
@@ -542,11 +600,53 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         }
     }
 
+    // Method Description:
+    // - Runs the given signal, like a resize, after any input that's still pending.
+    //   If there isn't any, it runs right away and any exception is propagated to
+    //   the caller. Otherwise it's run (and any exception logged) by the input thread.
+    void ConptyConnection::_runInOrderWithInput(std::function<void()> signal)
+    {
+        if (!_input.PushSignal(signal))
+        {
+            signal();
+        }
+    }
+
+    // Method Description:
+    // - Stops the input thread, discarding any input that hasn't been written yet.
+    void ConptyConnection::_stopInputThread() noexcept
+    {
+        if (!_hInputThread)
+        {
+            return;
+        }
+
+        _input.Shutdown();
+
+        // The input thread might be stuck in WriteFile() if the client isn't reading.
+        // Same as with the output thread in Close(), we loop in case we missed it.
+        for (;;)
+        {
+            CancelSynchronousIo(_hInputThread.get());
+
+            const auto result = WaitForSingleObject(_hInputThread.get(), 100);
+            if (result == WAIT_OBJECT_0)
+            {
+                break;
+            }
+        }
+
+        _hInputThread.reset();
+    }
+
     void ConptyConnection::Close() noexcept
     try
     {
         _transitionToState(ConnectionState::Closing);
 
+        // The input thread uses _inPipe and _hPC, so it needs to be gone before we reset them.
+        _stopInputThread();
+
         // .reset()ing either of these two will signal ConPTY to send out a CTRL_CLOSE_EVENT to all attached clients.
         // FYI: The other members of this class are concurrently read by the _hOutputThread
         // thread running in the background and so they're not safe to be .reset().
@@ -620,6 +720,40 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         return commandline.to_hstring();
     }
 
+    DWORD ConptyConnection::_InputThread()
+    {
+        for (;;)
+        {
+            auto input = _input.Pop();
+            if (!input)
+            {
+                return 0;
+            }
+
+            if (input->signal)
+            {
+                try
+                {
+                    input->signal();
+                }
+                CATCH_LOG();
+            }
+            else
+            {
+                // This blocks until the client has read the input. When we call
+                // CancelSynchronousIo() in _stopInputThread() this fails and we
+                // exit once Pop() notices the shutdown.
+                DWORD written{};
+                LOG_IF_WIN32_BOOL_FALSE(WriteFile(_inPipe.get(), input->text.data(), gsl::narrow_cast<DWORD>(input->text.size()), &written, nullptr));
+            }
+
+            if (_input.Done(std::move(*input)))
+            {
+                _InputPendingChangedHandlers(*this, nullptr);
+            }
+        }
+    }
+
     DWORD ConptyConnection::_OutputThread()
     {
         // Keep us alive until the output thread terminates; the destructor
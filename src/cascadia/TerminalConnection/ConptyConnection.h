@@ -8,6 +8,8 @@
 
 #include "ITerminalHandoff.h"
 
+#include <PendingInputQueue.h>
+
 namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 {
     struct ConptyConnection : ConptyConnectionT<ConptyConnection>, ConnectionStateHolder<ConptyConnection>
@@ -21,12 +23,14 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                          TERMINAL_STARTUP_INFO startupInfo);
 
         ConptyConnection() noexcept = default;
+        ~ConptyConnection();
         void Initialize(const Windows::Foundation::Collections::ValueSet& settings);
 
         static winrt::fire_and_forget final_release(std::unique_ptr<ConptyConnection> connection);
 
         void Start();
         void WriteInput(const hstring& data);
+        bool InputPending() const;
         void Resize(uint32_t rows, uint32_t columns);
         void Close() noexcept;
         void ClearBuffer();
@@ -56,6 +60,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                                                                          const winrt::guid& profileGuid);
 
         WINRT_CALLBACK(TerminalOutput, TerminalOutputHandler);
+        TYPED_EVENT(InputPendingChanged, TerminalConnection::ConptyConnection, winrt::Windows::Foundation::IInspectable);
 
     private:
         static void closePseudoConsoleAsync(HPCON hPC) noexcept;
@@ -65,6 +70,8 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         HRESULT _LaunchAttachedClient() noexcept;
         void _indicateExitWithStatus(unsigned int status) noexcept;
         void _LastConPtyClientDisconnected() noexcept;
+        void _runInOrderWithInput(std::function<void()> signal);
+        void _stopInputThread() noexcept;
 
         til::CoordType _rows{};
         til::CoordType _cols{};
@@ -102,7 +109,15 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         } _startupInfo{};
 
+        // Input is written to the pipe by a dedicated thread, so that a client that isn't
+        // reading its input (because it hangs, or is still busy with a huge paste) can't
+        // block the thread calling WriteInput(), which is usually the UI thread.
+        // Resize and other signals are queued behind any pending input to keep their order.
+        wil::unique_handle _hInputThread;
+        PendingInputQueue _input;
+
         DWORD _OutputThread();
+        DWORD _InputThread();
     };
 }
 
@@ -11,6 +11,46 @@ Licensed under the MIT license.
 
 namespace winrt::Microsoft::Terminal::Control::implementation
 {
+    // Compares two setting values. Most of them can simply be compared with ==,
+    // but references and collections are compared by value, because reloading
+    // the settings always produces new instances of them.
+    template<typename T>
+    bool SettingEquals(const T& lhs, const T& rhs)
+    {
+        return lhs == rhs;
+    }
+
+    template<typename T>
+    bool SettingEquals(const winrt::Windows::Foundation::IReference<T>& lhs, const winrt::Windows::Foundation::IReference<T>& rhs)
+    {
+        if (!lhs || !rhs)
+        {
+            return !lhs && !rhs;
+        }
+        return lhs.Value() == rhs.Value();
+    }
+
+    template<typename K, typename V>
+    bool SettingEquals(const winrt::Windows::Foundation::Collections::IMap<K, V>& lhs, const winrt::Windows::Foundation::Collections::IMap<K, V>& rhs)
+    {
+        if (!lhs || !rhs)
+        {
+            return !lhs && !rhs;
+        }
+        if (lhs.Size() != rhs.Size())
+        {
+            return false;
+        }
+        for (const auto& pair : lhs)
+        {
+            if (!rhs.HasKey(pair.Key()) || rhs.Lookup(pair.Key()) != pair.Value())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
     struct ControlAppearance : public winrt::implements<ControlAppearance, Microsoft::Terminal::Core::ICoreAppearance, Microsoft::Terminal::Control::IControlAppearance>
     {
 #define SETTINGS_GEN(type, name, ...) WINRT_PROPERTY(type, name, __VA_ARGS__);
@@ -45,5 +85,19 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                 _ColorTable[i] = appearance.GetColorTableEntry(static_cast<int32_t>(i));
             }
         }
+
+        bool Equals(const ControlAppearance& other) const
+        {
+#define COMPARE_SETTING(type, name, ...)        \
+    if (!SettingEquals(_##name, other._##name)) \
+    {                                           \
+        return false;                           \
+    }
+            CORE_APPEARANCE_SETTINGS(COMPARE_SETTING)
+            CONTROL_APPEARANCE_SETTINGS(COMPARE_SETTING)
+#undef COMPARE_SETTING
+
+            return _ColorTable == other._ColorTable;
+        }
     };
 }
@@ -39,6 +39,10 @@ constexpr const auto TsfRedrawInterval = std::chrono::milliseconds(100);
 // The minimum delay between updating the locations of regex patterns
 constexpr const auto UpdatePatternLocationsInterval = std::chrono::milliseconds(500);
 
+// The delay after which a coalesced mouse motion report is sent.
+// This is about one frame, which is as often as the position is displayed anyway.
+constexpr const auto MouseMotionFlushInterval = std::chrono::milliseconds(16);
+
 namespace winrt::Microsoft::Terminal::Control::implementation
 {
     static winrt::Microsoft::Terminal::Core::OptionalColor OptionalFromColor(const til::color& c)
@@ -94,6 +98,16 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // This event is explicitly revoked in the destructor: does not need weak_ref
         _connectionOutputEventToken = _connection.TerminalOutput({ this, &ControlCore::_connectionOutputHandler });
 
+        // If the application isn't reading its input, for instance while a large paste is
+        // written into a slow REPL, the input is kept and we show an indeterminate progress.
+        if (const auto conpty{ _connection.try_as<TerminalConnection::ConptyConnection>() })
+        {
+            _connectionInputPendingRevoker = conpty.InputPendingChanged(winrt::auto_revoke, [this](auto&& sender, auto&& /*args*/) {
+                _inputPending = sender.InputPending();
+                _TaskbarProgressChangedHandlers(*this, nullptr);
+            });
+        }
+
         _terminal->SetWriteInputCallback([this](std::wstring_view wstr) {
             _sendInputToConnection(wstr);
         });
@@ -125,6 +139,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         auto pfnPlayMidiNote = std::bind(&ControlCore::_terminalPlayMidiNote, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
         _terminal->SetPlayMidiNoteCallback(pfnPlayMidiNote);
 
+        _terminal->SetFlushMidiNotesCallback([this]() { _midiAudio.Flush(); });
+
         // MSFT 33353327: Initialize the renderer in the ctor instead of Initialize().
         // We need the renderer to be ready to accept new engines before the SwapChainPanel is ready to go.
         // If we wait, a screen reader may try to get the AutomationPeer (aka the UIA Engine), and we won't be able to attach
@@ -152,11 +168,18 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                 }
             });
 
+            _renderer->SetBlinkingResumedCallback([weakThis = get_weak()]() {
+                if (auto strongThis{ weakThis.get() })
+                {
+                    strongThis->_BlinkingResumedHandlers(*strongThis, nullptr);
+                }
+            });
+
             THROW_IF_FAILED(localPointerToThread->Initialize(_renderer.get()));
         }
         _setupDispatcherAndCallbacks();
 
-        UpdateSettings(settings, unfocusedAppearance);
+        _applySettings(Control::SettingsChanges::Core | Control::SettingsChanges::Control | Control::SettingsChanges::Font | Control::SettingsChanges::Appearance);
     }
 
     void ControlCore::_setupDispatcherAndCallbacks()
@@ -186,6 +209,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         //   need to hop across the process boundary every time text is output.
         //   We can throttle this to once every 8ms, which will get us out of
         //   the way of the main output & rendering threads.
+        // * _flushMouseMotion: When mouse motion is coalesced, the latest
+        //   motion report is sent about once per frame. Mouse input is handled
+        //   on the UI thread and so is this, which is why we don't lock here.
         _tsfTryRedrawCanvas = std::make_shared<ThrottledFuncTrailing<>>(
             _dispatcher,
             TsfRedrawInterval,
@@ -217,6 +243,16 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                     core->_ScrollPositionChangedHandlers(*core, update);
                 }
             });
+
+        _flushMouseMotion = std::make_shared<ThrottledFuncTrailing<>>(
+            _dispatcher,
+            MouseMotionFlushInterval,
+            [weakThis = get_weak()]() {
+                if (auto core{ weakThis.get() }; !core->_IsClosing())
+                {
+                    core->_terminal->FlushMouseMotion();
+                }
+            });
     }
 
     ControlCore::~ControlCore()
@@ -241,6 +277,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _tsfTryRedrawCanvas.reset();
         _updatePatternLocations.reset();
         _updateScrollBar.reset();
+        _flushMouseMotion.reset();
     }
 
     void ControlCore::AttachToNewControl(const Microsoft::Terminal::Control::IKeyBindings& keyBindings)
@@ -400,13 +437,16 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     }
 
     // Method Description:
-    // - Writes the given sequence as input to the active terminal connection,
+    // - Writes the given sequence as input to the active terminal connection. This is
+    //   used for IME compositions and the sendInput action, and like any other input,
+    //   it must not overtake a mouse motion report that's been held back.
     // Arguments:
     // - wstr: the string of characters to write to the terminal connection.
     // Return Value:
     // - <none>
     void ControlCore::SendInput(const winrt::hstring& wstr)
     {
+        _terminal->FlushMouseMotion();
         _sendInputToConnection(wstr);
     }
 
@@ -595,7 +635,12 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                      const short wheelDelta,
                                      const TerminalInput::MouseButtonState state)
     {
-        return _terminal->SendMouseEvent(viewportPos, uiButton, states, wheelDelta, state);
+        const auto handled = _terminal->SendMouseEvent(viewportPos, uiButton, states, wheelDelta, state);
+        if (!_inUnitTests && _flushMouseMotion && _terminal->HasPendingMouseMotion())
+        {
+            _flushMouseMotion->Run();
+        }
+        return handled;
     }
 
     void ControlCore::UserScrollViewport(const int viewTop)
@@ -756,25 +801,92 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     }
 
     // Method Description:
-    // - Updates the settings of the current terminal.
+    // - Updates the settings of the current terminal. The new settings are compared
+    //   with the current ones, and only the groups of settings that actually
+    //   changed are applied. Most importantly, the font is only reloaded if it
+    //   changed, which is by far the most expensive part of this.
     // - INVARIANT: This method can only be called if the caller DOES NOT HAVE writing lock on the terminal.
-    void ControlCore::UpdateSettings(const IControlSettings& settings, const IControlAppearance& newAppearance)
+    // Arguments:
+    // - settings: the new settings
+    // - newAppearance: the new unfocused appearance
+    // Return Value:
+    // - The groups of settings that changed. The caller only needs to update
+    //   its UI if this isn't SettingsChanges::None.
+    Control::SettingsChanges ControlCore::UpdateSettings(const IControlSettings& settings, const IControlAppearance& newAppearance)
     {
-        _settings = winrt::make_self<implementation::ControlSettings>(settings, newAppearance);
+        const auto start = std::chrono::steady_clock::now();
+
+        auto newSettings = winrt::make_self<implementation::ControlSettings>(settings, newAppearance);
+        std::vector<std::wstring_view> changedKeys;
+        const auto changes = _settings->Diff(*newSettings, changedKeys);
+
+        // Even if nothing changed, the new settings may still hold new
+        // instances of things we don't compare, like the key bindings.
+        _settings = std::move(newSettings);
+        _applySettings(changes);
+
+        if (TraceLoggingProviderEnabled(g_hTerminalControlProvider, WINEVENT_LEVEL_VERBOSE, TIL_KEYWORD_TRACE))
+        {
+            std::wstring keys;
+            for (const auto& key : changedKeys)
+            {
+                keys.append(keys.empty() ? L"" : L",").append(key);
+            }
+
+            const std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - start;
+            TraceLoggingWrite(
+                g_hTerminalControlProvider,
+                "ControlCore_UpdateSettings",
+                TraceLoggingDescription("The settings of a control were reloaded"),
+                TraceLoggingValue(static_cast<uint32_t>(changes), "changes"),
+                TraceLoggingWideString(keys.c_str(), "changedKeys"),
+                TraceLoggingFloat64(duration.count(), "durationMs"),
+                TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+                TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+        }
+
+        return changes;
+    }
+
+    // Method Description:
+    // - Applies the given groups of settings from _settings.
+    // - The font is only reloaded if it changed, and the terminal core is only
+    //   updated if its settings changed, because that resets the URL detection.
+    // Arguments:
+    // - changes: the groups of settings to apply.
+    void ControlCore::_applySettings(const Control::SettingsChanges changes)
+    {
+        if (changes == Control::SettingsChanges::None)
+        {
+            return;
+        }
 
         auto lock = _terminal->LockForWriting();
 
-        _cellWidth = CSSLengthPercentage::FromString(_settings->CellWidth().c_str());
-        _cellHeight = CSSLengthPercentage::FromString(_settings->CellHeight().c_str());
         _runtimeOpacity = std::nullopt;
 
         // Manually turn off acrylic if they turn off transparency.
         _runtimeUseAcrylic = _settings->Opacity() < 1.0 && _settings->UseAcrylic();
 
-        const auto sizeChanged = _setFontSizeUnderLock(_settings->FontSize());
+        auto sizeChanged = false;
+        if (WI_IsFlagSet(changes, Control::SettingsChanges::Font))
+        {
+            _cellWidth = CSSLengthPercentage::FromString(_settings->CellWidth().c_str());
+            _cellHeight = CSSLengthPercentage::FromString(_settings->CellHeight().c_str());
+            sizeChanged = _setFontSizeUnderLock(_settings->FontSize());
+        }
 
-        // Update the terminal core with its new Core settings
-        _terminal->UpdateSettings(*_settings);
+        // Update the terminal core with its new Core settings. This also applies
+        // the focused appearance, which the control corrects via ApplyAppearance().
+        if (WI_IsFlagSet(changes, Control::SettingsChanges::Core))
+        {
+            _terminal->UpdateSettings(*_settings);
+        }
+
+        if (WI_IsFlagSet(changes, Control::SettingsChanges::Control))
+        {
+            _applyUiaSettings();
+        }
 
         if (!_initializedTerminal)
         {
@@ -995,10 +1107,53 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         // If this function succeeds with S_FALSE, then the terminal didn't
         // actually change size. No need to notify the connection of this no-op.
-        const auto hr = _terminal->UserResize({ vp.Width(), vp.Height() });
+        // Only the rows around the viewport are reflowed here. The rest of
+        // the scrollback is reflowed once the size has stopped changing.
+        const auto hr = _terminal->InteractiveResize({ vp.Width(), vp.Height() });
         if (SUCCEEDED(hr) && hr != S_FALSE)
         {
             _connection.Resize(vp.Height(), vp.Width());
+            _scheduleFinishInteractiveResize();
+        }
+    }
+
+    // Method Description:
+    // - (Re)starts the timer that finishes an interactive resize. Every size
+    //   change restarts it, so the full reflow only happens once the user has
+    //   stopped dragging the window border.
+    void ControlCore::_scheduleFinishInteractiveResize()
+    {
+        if (!_interactiveResizeTimer)
+        {
+            _interactiveResizeTimer = _dispatcher.CreateTimer();
+            _interactiveResizeTimer.Interval(std::chrono::milliseconds(250));
+            _interactiveResizeTimer.IsRepeating(false);
+            _interactiveResizeTimer.Tick([weakSelf = get_weak()](auto&&, auto&&) {
+                if (const auto self = weakSelf.get())
+                {
+                    self->_finishInteractiveResize();
+                }
+            });
+        }
+
+        _interactiveResizeTimer.Stop();
+        _interactiveResizeTimer.Start();
+    }
+
+    // Method Description:
+    // - Reflows the part of the scrollback that was skipped during an
+    //   interactive resize. This can take a while with a large scrollback,
+    //   so it's done on a background thread instead of the UI thread.
+    winrt::fire_and_forget ControlCore::_finishInteractiveResize()
+    {
+        auto weakThis{ get_weak() };
+
+        co_await winrt::resume_background();
+
+        if (const auto core = weakThis.get(); core && !core->_IsClosing())
+        {
+            const auto lock = core->_terminal->LockForWriting();
+            LOG_IF_FAILED(core->_terminal->FinishInteractiveResize());
         }
     }
 
@@ -1305,11 +1460,18 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
     // Method Description:
     // - Gets the internal taskbar state value
+    // - While the connection is still writing a backlog of input, this reports an
+    //   indeterminate progress, unless the application reports its own progress.
     // Return Value:
     // - The taskbar state of this control
     const size_t ControlCore::TaskbarState() const noexcept
     {
-        return _terminal->GetTaskbarState();
+        const auto state = _terminal->GetTaskbarState();
+        if (state == static_cast<size_t>(DispatchTypes::TaskbarState::Clear) && _inputPending)
+        {
+            return static_cast<size_t>(DispatchTypes::TaskbarState::Indeterminate);
+        }
+        return state;
     }
 
     // Method Description:
@@ -1441,17 +1603,14 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     }
 
     // Method Description:
-    // - Plays a single MIDI note, blocking for the duration.
+    // - Queues a single MIDI note to be played by the MIDI sequencer.
+    //   This doesn't block the output thread for the duration of the note.
     // Arguments:
     // - noteNumber - The MIDI note number to be played (0 - 127).
     // - velocity - The force with which the note should be played (0 - 127).
     // - duration - How long the note should be sustained (in microseconds).
     void ControlCore::_terminalPlayMidiNote(const int noteNumber, const int velocity, const std::chrono::microseconds duration)
     {
-        // The UI thread might try to acquire the console lock from time to time.
-        // --> Unlock it, so the UI doesn't hang while we're busy.
-        const auto suspension = _terminal->SuspendLock();
-        // This call will block for the duration, unless shutdown early.
         _midiAudio.PlayNote(reinterpret_cast<HWND>(_owningHwnd), noteNumber, velocity, std::chrono::duration_cast<std::chrono::milliseconds>(duration));
     }
 
@@ -1491,32 +1650,290 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - text: the text to search
     // - goForward: boolean that represents if the current search direction is forward
     // - caseSensitive: boolean that represents if the current search is case sensitive
+    // - regex: boolean that represents if the text is a regular expression
     // Return Value:
     // - <none>
     void ControlCore::Search(const winrt::hstring& text,
                              const bool goForward,
-                             const bool caseSensitive)
+                             const bool caseSensitive,
+                             const bool regex)
     {
         if (text.size() == 0)
         {
             return;
         }
 
+        // If nothing was written since the last search for the same text
+        // finished, we can simply step to the next of its matches.
+        if (const auto results = _searchResults;
+            results && results->complete &&
+            results->outputSequence == _outputSequence.load(std::memory_order_relaxed) &&
+            results->caseSensitive == caseSensitive &&
+            results->regex == regex &&
+            results->text == std::wstring_view{ text })
+        {
+            if (_selectSearchResult(*results, goForward))
+            {
+                return;
+            }
+        }
+
+        _searchAsync(std::wstring{ text }, goForward, caseSensitive, regex);
+    }
+
+    // Method Description:
+    // - Searches the entire buffer for the given text on background threads.
+    //   The rows are copied out of the buffer a slice at a time, so that the
+    //   terminal lock is never held for longer than it takes to copy a slice,
+    //   and the copy is then searched in parallel, one chunk per worker.
+    // - Progress is reported through FoundMatch while the search is running.
+    //   Once it completes, the match closest to the current selection is selected.
+    // - Starting a new search cancels the one that's still running, if any.
+    // - Regular expressions are matched against whole logical lines (rows joined
+    //   where they wrapped), so each chunk is extended to the end of its last line.
+    // Arguments:
+    // - text: the text to search
+    // - goForward: boolean that represents if the current search direction is forward
+    // - caseSensitive: boolean that represents if the current search is case sensitive
+    // - regex: boolean that represents if the text is a regular expression
+    // Return Value:
+    // - <none>
+    winrt::fire_and_forget ControlCore::_searchAsync(std::wstring text, const bool goForward, const bool caseSensitive, const bool regex)
+    {
+        // The number of rows we copy out of the buffer under a single lock,
+        // which is also the number of rows each worker searches at a time.
+        static constexpr size_t sliceRows = 1024;
+        // How often (in chunks) the progress is reported to the search box.
+        static constexpr size_t progressInterval = 16;
+
+        if (_searchResults)
+        {
+            _searchResults->cancelled = true;
+            _searchResults.reset();
+        }
+
+        // The expression is compiled once and shared by all workers.
+        std::optional<til::linear_regex> pattern;
+        if (regex)
+        {
+            try
+            {
+                pattern.emplace(text, !caseSensitive);
+            }
+            catch (const std::invalid_argument&)
+            {
+                _FoundMatchHandlers(*this, winrt::make<implementation::FoundResultsArgs>(false, 0, true));
+                co_return;
+            }
+        }
+
+        const auto results = std::make_shared<SearchResults>();
+        results->text = text;
+        results->caseSensitive = caseSensitive;
+        results->regex = regex;
+        results->outputSequence = _outputSequence.load(std::memory_order_relaxed);
+        _searchResults = results;
+
+        _FoundMatchHandlers(*this, winrt::make<implementation::FoundResultsArgs>(false, 0, false));
+
+        const auto sensitivity = caseSensitive ?
+                                     Search::Sensitivity::CaseSensitive :
+                                     Search::Sensitivity::CaseInsensitive;
+        const auto dispatcher = _dispatcher;
+        auto weakThis{ get_weak() };
+
+        co_await winrt::resume_background();
+
+        std::vector<std::wstring> rows;
+        til::CoordType bufferWidth = 1;
+        for (til::CoordType row = 0;; row += gsl::narrow_cast<til::CoordType>(sliceRows))
+        {
+            const auto core = weakThis.get();
+            if (!core || results->cancelled)
+            {
+                co_return;
+            }
+
+            const auto lock = core->_terminal->LockForReading();
+            const auto& textBuffer = core->_terminal->GetTextBuffer();
+            const auto endRow = core->_terminal->GetTextBufferEndPosition().y + 1;
+            if (row >= endRow)
+            {
+                break;
+            }
+
+            bufferWidth = textBuffer.GetSize().Width();
+            auto slice = Search::s_SnapshotRows(textBuffer, row, std::min(gsl::narrow_cast<til::CoordType>(sliceRows), endRow - row), regex);
+            rows.insert(rows.end(), std::make_move_iterator(slice.begin()), std::make_move_iterator(slice.end()));
+        }
+
+        // The [first, first + count) rows each worker searches.
+        std::vector<std::pair<size_t, size_t>> chunks;
+        if (pattern)
+        {
+            // Regex matches can't span logical lines, but chunks mustn't split them.
+            for (size_t first = 0; first < rows.size();)
+            {
+                auto end = std::min(first + sliceRows, rows.size());
+                while (end < rows.size() && !til::at(rows, end - 1).ends_with(L'\n'))
+                {
+                    ++end;
+                }
+                chunks.emplace_back(first, end - first);
+                first = end;
+            }
+        }
+        else
+        {
+            for (size_t first = 0; first < rows.size(); first += sliceRows)
+            {
+                chunks.emplace_back(first, std::min(sliceRows, rows.size() - first));
+            }
+        }
+
+        // For literal searches every chunk also gets to see the rows following it, so
+        // that matches wrapping across the chunk boundary are found. A row holds at
+        // least half its width in characters, as no glyph is wider than 2 columns.
+        const auto overlapRows = text.size() / std::max<size_t>(1, gsl::narrow_cast<size_t>(bufferWidth) / 2) + 1;
+        const auto chunkCount = chunks.size();
+        std::vector<std::vector<std::pair<til::point, til::point>>> chunkMatches(chunkCount);
+        std::vector<std::vector<std::wstring>> chunkMatchedText(chunkCount);
+        std::atomic<size_t> nextChunk{ 0 };
+        std::atomic<size_t> finishedChunks{ 0 };
+        std::atomic<size_t> matchCount{ 0 };
+
+        const auto worker = [&]() {
+            for (auto chunk = nextChunk++; chunk < chunkCount && !results->cancelled; chunk = nextChunk++)
+            {
+                const auto [firstRow, rowCount] = til::at(chunks, chunk);
+                const auto firstRowY = gsl::narrow_cast<til::CoordType>(firstRow);
+                auto& matches = til::at(chunkMatches, chunk);
+                if (pattern)
+                {
+                    Search::s_FindAllRegexInRows({ rows.data() + firstRow, rowCount }, firstRowY, *pattern, matches, &til::at(chunkMatchedText, chunk));
+                }
+                else
+                {
+                    const auto overlappingRowCount = std::min(rows.size() - firstRow, rowCount + overlapRows);
+                    Search::s_FindAllInRows({ rows.data() + firstRow, overlappingRowCount }, firstRowY, rowCount, text, sensitivity, matches);
+                }
+                const auto total = matchCount += matches.size();
+
+                if (++finishedChunks % progressInterval == 0)
+                {
+                    dispatcher.TryEnqueue([weakThis, results, total]() {
+                        if (const auto core = weakThis.get(); core && !results->cancelled)
+                        {
+                            core->_FoundMatchHandlers(*core, winrt::make<implementation::FoundResultsArgs>(total != 0, gsl::narrow_cast<int32_t>(total), false));
+                        }
+                    });
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        const auto workerCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, std::max<size_t>(1, chunkCount));
+        for (size_t i = 1; i < workerCount; ++i)
+        {
+            workers.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : workers)
+        {
+            thread.join();
+        }
+
+        if (results->cancelled)
+        {
+            co_return;
+        }
+
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+        {
+            const auto& matches = til::at(chunkMatches, chunk);
+            auto& matchedText = til::at(chunkMatchedText, chunk);
+            results->matches.insert(results->matches.end(), matches.begin(), matches.end());
+            results->matchedText.insert(results->matchedText.end(), std::make_move_iterator(matchedText.begin()), std::make_move_iterator(matchedText.end()));
+        }
+
+        co_await wil::resume_foreground(dispatcher);
+
+        if (const auto core = weakThis.get(); core && !results->cancelled)
+        {
+            results->complete = true;
+
+            // If the buffer changed so much in the meantime that none of the
+            // matches are still there, report that nothing was found.
+            if (!core->_selectSearchResult(*results, goForward))
+            {
+                core->_FoundMatchHandlers(*core, winrt::make<implementation::FoundResultsArgs>(false, 0, true));
+            }
+        }
+    }
+
+    // Method Description:
+    // - Selects the match of a finished search that follows (or precedes) the
+    //   current selection, wrapping around the buffer. Since the buffer may have
+    //   changed since the search ran, matches are verified before selecting them.
+    // Arguments:
+    // - results: the results of a finished search
+    // - goForward: boolean that represents if the current search direction is forward
+    // Return Value:
+    // - false if the results were out of date and the search should be repeated.
+    bool ControlCore::_selectSearchResult(const SearchResults& results, const bool goForward)
+    {
+        const auto& matches = results.matches;
         const auto direction = goForward ?
                                    Search::Direction::Forward :
                                    Search::Direction::Backward;
 
-        const auto sensitivity = caseSensitive ?
+        const auto sensitivity = results.caseSensitive ?
                                      Search::Sensitivity::CaseSensitive :
                                      Search::Sensitivity::CaseInsensitive;
 
-        ::Search search(*GetRenderData(), text.c_str(), direction, sensitivity);
         auto lock = _terminal->LockForWriting();
-        const auto foundMatch{ search.FindNext() };
-        if (foundMatch)
+        auto foundMatch = false;
+
+        if (!matches.empty())
         {
+            // Like ::Search, continue from the selection anchor if there is one,
+            // or start from either end of the buffer otherwise.
+            const auto count = matches.size();
+            auto first = goForward ? size_t{ 0 } : count - 1;
+            if (_terminal->IsSelectionActive())
+            {
+                const auto anchor = _terminal->GetTextBuffer().ScreenToBufferPosition(_terminal->GetSelectionAnchor());
+                const auto byStart = [](const auto& match, const auto& pos) { return match.first < pos; };
+                const auto it = goForward ?
+                                    std::upper_bound(matches.begin(), matches.end(), anchor, [](const auto& pos, const auto& match) { return pos < match.first; }) :
+                                    std::lower_bound(matches.begin(), matches.end(), anchor, byStart);
+                const auto index = gsl::narrow_cast<size_t>(it - matches.begin());
+                first = goForward ? index % count : (index + count - 1) % count;
+            }
+
+            // Regex matches are verified by looking for the exact text they matched.
+            std::optional<::Search> search;
+            for (size_t i = 0; i < count && !foundMatch; ++i)
+            {
+                const auto index = goForward ? (first + i) % count : (first + count - i) % count;
+                if (results.regex)
+                {
+                    search.emplace(*GetRenderData(), til::at(results.matchedText, index), direction, Search::Sensitivity::CaseSensitive);
+                }
+                else if (!search)
+                {
+                    search.emplace(*GetRenderData(), results.text, direction, sensitivity);
+                }
+                foundMatch = search->MatchAt(til::at(matches, index).first);
+            }
+
+            if (!foundMatch)
+            {
+                return false;
+            }
+
             _terminal->SetBlockSelection(false);
-            search.Select();
+            search->Select();
 
             // this is used for search,
             // DO NOT call _updateSelectionUI() here.
@@ -1527,8 +1944,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         // Raise a FoundMatch event, which the control will use to notify
         // narrator if there was any results in the buffer
-        auto foundResults = winrt::make_self<implementation::FoundResultsArgs>(foundMatch);
+        auto foundResults = winrt::make_self<implementation::FoundResultsArgs>(foundMatch, gsl::narrow_cast<int32_t>(matches.size()), true);
         _FoundMatchHandlers(*this, *foundResults);
+        return true;
     }
 
     void ControlCore::Close()
@@ -1537,12 +1955,18 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         {
             _closing = true;
 
+            if (_searchResults)
+            {
+                _searchResults->cancelled = true;
+            }
+
             // Ensure Close() doesn't hang, waiting for MidiAudio to finish playing an hour long song.
             _midiAudio.BeginSkip();
 
             // Stop accepting new output and state changes before we disconnect everything.
             _connection.TerminalOutput(_connectionOutputEventToken);
             _connectionStateChangedRevoker.revoke();
+            _connectionInputPendingRevoker.revoke();
             _connection.Close();
         }
     }
@@ -1590,16 +2014,25 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _TabColorChangedHandlers(*this, nullptr);
     }
 
-    void ControlCore::BlinkAttributeTick()
+    // Method Description:
+    // - Toggles the rendition of blinking text. Called by the control's blink timer.
+    // Return Value:
+    // - false if there's no blinking text left. The timer should then be stopped
+    //   until the BlinkingResumed event is raised.
+    bool ControlCore::BlinkAttributeTick()
     {
+        ::Microsoft::Console::Render::WakeupCounter::Increment();
+
         auto lock = _terminal->LockForWriting();
 
         auto& renderSettings = _terminal->GetRenderSettings();
-        renderSettings.ToggleBlinkRendition(*_renderer);
+        return renderSettings.ToggleBlinkRendition(*_renderer);
     }
 
     void ControlCore::BlinkCursor()
     {
+        ::Microsoft::Console::Render::WakeupCounter::Increment();
+
         if (!_terminal->IsCursorBlinkingAllowed() &&
             _terminal->IsCursorVisible())
         {
@@ -1719,14 +2152,40 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _UpdateSelectionMarkersHandlers(*this, winrt::make<implementation::UpdateSelectionMarkersEventArgs>(!showMarkers));
     }
 
-    void ControlCore::AttachUiaEngine(::Microsoft::Console::Render::IRenderEngine* const pEngine)
+    void ControlCore::AttachUiaEngine(::Microsoft::Console::Render::UiaEngine* const pEngine)
     {
+        // The engine holds back output that it can't announce yet
+        // and asks for another frame once it's allowed to.
+        pEngine->SetRedrawCallback([weakThis = get_weak()]() {
+            if (auto strongThis{ weakThis.get() })
+            {
+                strongThis->_renderer->NotifyPaintFrame();
+            }
+        });
+        _uiaEngine = pEngine;
+        _applyUiaSettings();
+
         // _renderer will always exist since it's introduced in the ctor
         _renderer->AddRenderEngine(pEngine);
     }
-    void ControlCore::DetachUiaEngine(::Microsoft::Console::Render::IRenderEngine* const pEngine)
+    void ControlCore::DetachUiaEngine(::Microsoft::Console::Render::UiaEngine* const pEngine)
     {
         _renderer->RemoveRenderEngine(pEngine);
+        if (_uiaEngine == pEngine)
+        {
+            _uiaEngine = nullptr;
+        }
+    }
+
+    // Method Description:
+    // - Applies the accessibility settings to the attached UIA engine, if any.
+    void ControlCore::_applyUiaSettings()
+    {
+        if (_uiaEngine)
+        {
+            _uiaEngine->SetMaxQueuedOutput(gsl::narrow_cast<size_t>(std::max(1, _settings->MaxAnnouncedOutput())));
+            _uiaEngine->SetNotificationInterval(std::chrono::milliseconds{ std::max(0, _settings->AnnouncementInterval()) });
+        }
     }
 
     bool ControlCore::IsInReadOnlyMode() const
@@ -1754,6 +2213,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         try
         {
             _terminal->Write(hstr);
+            _outputSequence.fetch_add(1, std::memory_order_relaxed);
 
             // Start the throttled update of where our hyperlinks are.
             if (_updatePatternLocations)
@@ -1812,9 +2272,24 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     {
         auto terminalLock = _terminal->LockForWriting();
 
+        // The scrollback is incomplete until an interactive resize is finished.
+        LOG_IF_FAILED(_terminal->FinishInteractiveResize());
+
         const auto& textBuffer = _terminal->GetTextBuffer();
 
         std::wstring str;
+
+        // Rows that were spilled to disk come before the ones still in the buffer.
+        const auto spilledRows = textBuffer.SpilledRowCount();
+        for (size_t i = 0; i < spilledRows; ++i)
+        {
+            str.append(textBuffer.GetSpilledRowText(i));
+            if (!textBuffer.WasSpilledRowWrapForced(i))
+            {
+                str.append(L"\r\n");
+            }
+        }
+
         const auto lastRow = textBuffer.GetLastNonSpaceCharacter().y;
         for (auto rowIndex = 0; rowIndex <= lastRow; rowIndex++)
         {
@@ -20,6 +20,8 @@
 #include "ControlSettings.h"
 #include "../../audio/midi/MidiAudio.hpp"
 #include "../../renderer/base/Renderer.hpp"
+#include "../../renderer/uia/UiaRenderer.hpp"
+#include "../../renderer/inc/WakeupCounter.hpp"
 #include "../../cascadia/TerminalCore/Terminal.hpp"
 #include "../buffer/out/search.h"
 #include "../buffer/out/TextColor.h"
@@ -71,7 +73,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         void Detach();
 
-        void UpdateSettings(const Control::IControlSettings& settings, const IControlAppearance& newAppearance);
+        Control::SettingsChanges UpdateSettings(const Control::IControlSettings& settings, const IControlAppearance& newAppearance);
         void ApplyAppearance(const bool& focused);
         Control::IControlSettings Settings() { return *_settings; };
         Control::IControlAppearance FocusedAppearance() const { return *_settings->FocusedAppearance(); };
@@ -175,7 +177,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
 #pragma endregion
 
-        void BlinkAttributeTick();
+        bool BlinkAttributeTick();
         void BlinkCursor();
         bool CursorOn() const;
         void CursorOn(const bool isCursorOn);
@@ -193,7 +195,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         void Search(const winrt::hstring& text,
                     const bool goForward,
-                    const bool caseSensitive);
+                    const bool caseSensitive,
+                    const bool regex);
 
         void LeftClickOnTerminal(const til::point terminalPosition,
                                  const int numberOfClicks,
@@ -202,8 +205,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
                                  const bool isOnOriginalPosition,
                                  bool& selectionNeedsToBeCopied);
 
-        void AttachUiaEngine(::Microsoft::Console::Render::IRenderEngine* const pEngine);
-        void DetachUiaEngine(::Microsoft::Console::Render::IRenderEngine* const pEngine);
+        void AttachUiaEngine(::Microsoft::Console::Render::UiaEngine* const pEngine);
+        void DetachUiaEngine(::Microsoft::Console::Render::UiaEngine* const pEngine);
 
         bool IsInReadOnlyMode() const;
         void ToggleReadOnlyMode();
@@ -238,6 +241,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         TYPED_EVENT(ConnectionStateChanged,    IInspectable, IInspectable);
         TYPED_EVENT(HoveredHyperlinkChanged,   IInspectable, IInspectable);
         TYPED_EVENT(RendererEnteredErrorState, IInspectable, IInspectable);
+        TYPED_EVENT(BlinkingResumed,           IInspectable, IInspectable);
         TYPED_EVENT(SwapChainChanged,          IInspectable, IInspectable);
         TYPED_EVENT(RendererWarning,           IInspectable, Control::RendererWarningArgs);
         TYPED_EVENT(RaiseNotice,               IInspectable, Control::NoticeEventArgs);
@@ -259,6 +263,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         TerminalConnection::ITerminalConnection _connection{ nullptr };
         event_token _connectionOutputEventToken;
         TerminalConnection::ITerminalConnection::StateChanged_revoker _connectionStateChangedRevoker;
+        TerminalConnection::ConptyConnection::InputPendingChanged_revoker _connectionInputPendingRevoker;
+        std::atomic<bool> _inputPending{ false };
 
         winrt::com_ptr<ControlSettings> _settings{ nullptr };
 
@@ -271,6 +277,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // (C++ class members are destroyed in reverse order.)
         std::unique_ptr<::Microsoft::Console::Render::IRenderEngine> _renderEngine{ nullptr };
         std::unique_ptr<::Microsoft::Console::Render::Renderer> _renderer{ nullptr };
+        // Owned by ControlInteractivity, see AttachUiaEngine.
+        ::Microsoft::Console::Render::UiaEngine* _uiaEngine{ nullptr };
 
         winrt::handle _lastSwapChainHandle{ nullptr };
 
@@ -303,9 +311,35 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         std::shared_ptr<ThrottledFuncTrailing<>> _tsfTryRedrawCanvas;
         std::unique_ptr<til::throttled_func_trailing<>> _updatePatternLocations;
         std::shared_ptr<ThrottledFuncTrailing<Control::ScrollPositionChangedArgs>> _updateScrollBar;
+        std::shared_ptr<ThrottledFuncTrailing<>> _flushMouseMotion;
+
+        // The results of the last search. Searches run in the background and
+        // their results are cached, so that stepping through the matches with
+        // the search box doesn't have to walk the buffer again.
+        struct SearchResults
+        {
+            std::wstring text;
+            bool caseSensitive{ false };
+            bool regex{ false };
+            // Only accessed on the main thread.
+            bool complete{ false };
+            // The value of _outputSequence when the search started.
+            uint64_t outputSequence{ 0 };
+            // Set when a newer search supersedes this one, or when we're closing.
+            std::atomic<bool> cancelled{ false };
+            std::vector<std::pair<til::point, til::point>> matches;
+            // For regex searches: the text of each match, used to verify it before selecting it.
+            std::vector<std::wstring> matchedText;
+        };
+        std::shared_ptr<SearchResults> _searchResults;
+        // Incremented every time we receive output, to invalidate _searchResults.
+        std::atomic<uint64_t> _outputSequence{ 0 };
 
         void _setupDispatcherAndCallbacks();
 
+        winrt::fire_and_forget _searchAsync(std::wstring text, const bool goForward, const bool caseSensitive, const bool regex);
+        bool _selectSearchResult(const SearchResults& results, const bool goForward);
+
         bool _setFontSizeUnderLock(float fontSize);
         void _updateFont(const bool initialUpdate = false);
         void _refreshSizeUnderLock();
@@ -333,6 +367,10 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         MidiAudio _midiAudio;
         winrt::Windows::System::DispatcherQueueTimer _midiAudioSkipTimer{ nullptr };
 
+        winrt::Windows::System::DispatcherQueueTimer _interactiveResizeTimer{ nullptr };
+        void _scheduleFinishInteractiveResize();
+        winrt::fire_and_forget _finishInteractiveResize();
+
 #pragma region RendererCallbacks
         void _rendererWarning(const HRESULT hr);
         winrt::fire_and_forget _renderEngineSwapChainChanged(const HANDLE handle);
@@ -340,6 +378,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void _rendererTabColorChanged();
 #pragma endregion
 
+        void _applySettings(const Control::SettingsChanges changes);
+        void _applyUiaSettings();
         void _raiseReadOnlyWarning();
         void _updateAntiAliasingMode();
         void _connectionOutputHandler(const hstring& hstr);
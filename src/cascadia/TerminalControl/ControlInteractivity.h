@@ -102,7 +102,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     private:
         // NOTE: _uiaEngine must be ordered before _core.
         //
-        // ControlCore::AttachUiaEngine receives a IRenderEngine as a raw pointer, which we own.
+        // ControlCore::AttachUiaEngine receives a UiaEngine as a raw pointer, which we own.
         // We must ensure that we first destroy the ControlCore before the UiaEngine instance
         // in order to safely resolve this unsafe pointer dependency. Otherwise a deallocated
         // IRenderEngine is accessed when ControlCore calls Renderer::TriggerTeardown.
@@ -15,6 +15,14 @@ using IFontAxesMap = winrt::Windows::Foundation::Collections::IMap<winrt::hstrin
 
 namespace winrt::Microsoft::Terminal::Control::implementation
 {
+    // The key bindings are only ever queried when a key is pressed, so there's nothing to
+    // apply when they change. Every settings reload creates a new instance of them, which
+    // we thus don't want to report as a change.
+    inline bool SettingEquals(const Control::IKeyBindings&, const Control::IKeyBindings&) noexcept
+    {
+        return true;
+    }
+
     struct ControlSettings : public winrt::implements<ControlSettings, Microsoft::Terminal::Control::IControlSettings, Microsoft::Terminal::Control::IControlAppearance, Microsoft::Terminal::Core::ICoreSettings, Microsoft::Terminal::Core::ICoreAppearance>
     {
         // Getters and setters for each *Setting member. We're not using
@@ -49,6 +57,49 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 #undef COPY_SETTING
         }
 
+        // Compares every setting with the given ones, and returns which groups of them differ.
+        // The names of the settings that differ are appended to changedKeys.
+        Control::SettingsChanges Diff(const ControlSettings& other, std::vector<std::wstring_view>& changedKeys) const
+        {
+            static constexpr std::array fontSettings{
+                std::wstring_view{ L"FontFace" },
+                std::wstring_view{ L"FontSize" },
+                std::wstring_view{ L"FontWeight" },
+                std::wstring_view{ L"FontFeatures" },
+                std::wstring_view{ L"FontAxes" },
+                std::wstring_view{ L"CellWidth" },
+                std::wstring_view{ L"CellHeight" },
+            };
+
+            auto changes = Control::SettingsChanges::None;
+
+#define DIFF_SETTING(group, name)                                                                           \
+    if (!SettingEquals(_##name, other._##name))                                                             \
+    {                                                                                                       \
+        constexpr std::wstring_view key{ L"" #name };                                                       \
+        const auto isFont = std::find(fontSettings.begin(), fontSettings.end(), key) != fontSettings.end(); \
+        changes |= isFont ? Control::SettingsChanges::Font : group;                                         \
+        changedKeys.emplace_back(key);                                                                      \
+    }
+#define DIFF_CORE_SETTING(type, name, ...) DIFF_SETTING(Control::SettingsChanges::Core, name)
+#define DIFF_CONTROL_SETTING(type, name, ...) DIFF_SETTING(Control::SettingsChanges::Control, name)
+            CORE_SETTINGS(DIFF_CORE_SETTING)
+            CONTROL_SETTINGS(DIFF_CONTROL_SETTING)
+#undef DIFF_CONTROL_SETTING
+#undef DIFF_CORE_SETTING
+#undef DIFF_SETTING
+
+            if (_hasUnfocusedAppearance != other._hasUnfocusedAppearance ||
+                !_focusedAppearance->Equals(*other._focusedAppearance) ||
+                !_unfocusedAppearance->Equals(*other._unfocusedAppearance))
+            {
+                changes |= Control::SettingsChanges::Appearance;
+                changedKeys.emplace_back(L"Appearance");
+            }
+
+            return changes;
+        }
+
         winrt::com_ptr<ControlAppearance> UnfocusedAppearance() { return _unfocusedAppearance; }
         winrt::com_ptr<ControlAppearance> FocusedAppearance() { return _focusedAppearance; }
         bool HasUnfocusedAppearance() { return _hasUnfocusedAppearance; }
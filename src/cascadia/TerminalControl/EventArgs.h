@@ -150,12 +150,16 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     struct FoundResultsArgs : public FoundResultsArgsT<FoundResultsArgs>
     {
     public:
-        FoundResultsArgs(const bool foundMatch) :
-            _FoundMatch(foundMatch)
+        FoundResultsArgs(const bool foundMatch, const int32_t totalMatches, const bool searchComplete) :
+            _FoundMatch(foundMatch),
+            _TotalMatches(totalMatches),
+            _SearchComplete(searchComplete)
         {
         }
 
         WINRT_PROPERTY(bool, FoundMatch);
+        WINRT_PROPERTY(int32_t, TotalMatches);
+        WINRT_PROPERTY(bool, SearchComplete);
     };
 
     struct ShowWindowArgs : public ShowWindowArgsT<ShowWindowArgs>
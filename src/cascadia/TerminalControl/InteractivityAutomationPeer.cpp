@@ -98,6 +98,18 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         _NewOutputHandlers(*this, hstring{ newOutput });
     }
 
+    // Method Description:
+    // - Announces that some output scrolled by too fast to be read out.
+    //   It's raised as regular output, right before the most recent output.
+    // Arguments:
+    // - omittedLength: the number of characters that were skipped
+    // Return Value:
+    // - <none>
+    void InteractivityAutomationPeer::NotifyOutputOmitted(size_t omittedLength)
+    {
+        _NewOutputHandlers(*this, hstring{ fmt::format(std::wstring_view{ RS_(L"OutputOmittedNotification") }, omittedLength) });
+    }
+
 #pragma region ITextProvider
     com_array<XamlAutomation::ITextRangeProvider> InteractivityAutomationPeer::GetSelection()
     {
@@ -50,6 +50,18 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         return CaseSensitivityButton().IsChecked().GetBoolean();
     }
 
+    // Method Description:
+    // - Check if the current search text is a regular expression
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - bool: whether the search text is a regular expression (regex button is checked)
+    //   or not
+    bool SearchBoxControl::_Regex()
+    {
+        return RegexButton().IsChecked().GetBoolean();
+    }
+
     // Method Description:
     // - Handler for pressing Enter on TextBox, trigger
     //   text search
@@ -65,11 +77,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             const auto state = CoreWindow::GetForCurrentThread().GetKeyState(winrt::Windows::System::VirtualKey::Shift);
             if (WI_IsFlagSet(state, CoreVirtualKeyStates::Down))
             {
-                _SearchHandlers(TextBox().Text(), !_GoForward(), _CaseSensitive());
+                _SearchHandlers(TextBox().Text(), !_GoForward(), _CaseSensitive(), _Regex());
             }
             else
             {
-                _SearchHandlers(TextBox().Text(), _GoForward(), _CaseSensitive());
+                _SearchHandlers(TextBox().Text(), _GoForward(), _CaseSensitive(), _Regex());
             }
             e.Handled(true);
         }
@@ -124,6 +136,22 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
     }
 
+    // Method Description:
+    // - Shows the number of matches of the current search. While the search
+    //   is still running in the background, the count is marked as partial.
+    // Arguments:
+    // - totalMatches: the number of matches found so far
+    // - searchComplete: whether the whole buffer has been searched
+    // Return Value:
+    // - <none>
+    void SearchBoxControl::SetStatus(int32_t totalMatches, bool searchComplete)
+    {
+        if (StatusBox())
+        {
+            StatusBox().Text(searchComplete ? fmt::format(L"{}", totalMatches) : fmt::format(L"{}\u2026", totalMatches));
+        }
+    }
+
     // Method Description:
     // - Check if the current focus is on any element within the
     //   search box
@@ -160,7 +188,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
 
         // kick off search
-        _SearchHandlers(TextBox().Text(), _GoForward(), _CaseSensitive());
+        _SearchHandlers(TextBox().Text(), _GoForward(), _CaseSensitive(), _Regex());
     }
 
     // Method Description:
@@ -181,7 +209,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
 
         // kick off search
-        _SearchHandlers(TextBox().Text(), _GoForward(), _CaseSensitive());
+        _SearchHandlers(TextBox().Text(), _GoForward(), _CaseSensitive(), _Regex());
     }
 
     // Method Description:
@@ -71,6 +71,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         // This event is specifically triggered by the renderer thread, a BG thread. Use a weak ref here.
         _revokers.RendererEnteredErrorState = _core.RendererEnteredErrorState(winrt::auto_revoke, { get_weak(), &TermControl::_RendererEnteredErrorState });
+        // Same goes for this one, which is raised while painting a frame.
+        _revokers.BlinkingResumed = _core.BlinkingResumed(winrt::auto_revoke, { get_weak(), &TermControl::_coreBlinkingResumed });
 
         // IMPORTANT! Set this callback up sooner rather than later. If we do it
         // after Enable, then it'll be possible to paint the frame once
@@ -358,7 +360,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         }
         else
         {
-            _core.Search(_searchBox->TextBox().Text(), goForward, false);
+            _core.Search(_searchBox->TextBox().Text(), goForward, false, false);
         }
     }
 
@@ -383,13 +385,15 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - text: the text to search
     // - goForward: boolean that represents if the current search direction is forward
     // - caseSensitive: boolean that represents if the current search is case sensitive
+    // - regex: boolean that represents if the text is a regular expression
     // Return Value:
     // - <none>
     void TermControl::_Search(const winrt::hstring& text,
                               const bool goForward,
-                              const bool caseSensitive)
+                              const bool caseSensitive,
+                              const bool regex)
     {
-        _core.Search(text, goForward, caseSensitive);
+        _core.Search(text, goForward, caseSensitive, regex);
     }
 
     // Method Description:
@@ -426,11 +430,33 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         // terminal.
         co_await wil::resume_foreground(Dispatcher());
 
-        _core.UpdateSettings(settings, unfocusedAppearance);
+        // The core tells us which settings actually changed. For most panes,
+        // nothing will have changed when the settings are reloaded, and we can
+        // avoid reloading their background image, brushes and so on.
+        const auto changes = _core.UpdateSettings(settings, unfocusedAppearance);
+        if (changes == SettingsChanges::None)
+        {
+            co_return;
+        }
 
-        _UpdateSettingsFromUIThread();
+        if (WI_IsFlagSet(changes, SettingsChanges::Control))
+        {
+            _UpdateSettingsFromUIThread();
+        }
+        else if (WI_IsFlagSet(changes, SettingsChanges::Appearance) && !_IsClosing())
+        {
+            // The opacity is part of the appearance, but the background brush
+            // is only set up by _ApplyUISettings(). This also switches between
+            // an acrylic and a solid color brush if needed.
+            _changeBackgroundOpacity();
+        }
 
-        _UpdateAppearanceFromUIThread(_focused ? _core.FocusedAppearance() : _core.UnfocusedAppearance());
+        // Updating the core settings resets the terminal to the focused
+        // appearance, so we need to reapply the current one in that case too.
+        if (WI_IsAnyFlagSet(changes, SettingsChanges::Control | SettingsChanges::Core | SettingsChanges::Appearance))
+        {
+            _UpdateAppearanceFromUIThread(_focused ? _core.FocusedAppearance() : _core.UnfocusedAppearance());
+        }
     }
 
     // Method Description:
@@ -1004,7 +1030,12 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             DispatcherTimer blinkTimer;
             blinkTimer.Interval(std::chrono::milliseconds(blinkTime));
             blinkTimer.Tick({ get_weak(), &TermControl::_BlinkTimerTick });
-            blinkTimer.Start();
+            // Like the cursor timer, this one only runs while we're focused
+            // and visible, so that an idle, unfocused terminal never wakes up.
+            if (_focused && _windowVisible)
+            {
+                blinkTimer.Start();
+            }
             _blinkTimer.emplace(std::move(blinkTimer));
         }
         else
@@ -1813,16 +1844,9 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             TSFInputControl().NotifyFocusEnter();
         }
 
-        if (_cursorTimer)
-        {
-            // When the terminal focuses, show the cursor immediately
-            _core.CursorOn(_core.SelectionMode() != SelectionInteractionMode::Mark);
-            _cursorTimer->Start();
-        }
-
-        if (_blinkTimer)
+        if (_windowVisible)
         {
-            _blinkTimer->Start();
+            _startBlinkTimers();
         }
 
         // Only update the appearance here if an unfocused config exists - if an
@@ -1863,17 +1887,12 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             TSFInputControl().NotifyFocusLeave();
         }
 
+        _stopBlinkTimers();
         if (_cursorTimer)
         {
-            _cursorTimer->Stop();
             _core.CursorOn(false);
         }
 
-        if (_blinkTimer)
-        {
-            _blinkTimer->Stop();
-        }
-
         // Check if there is an unfocused config we should set the appearance to
         // upon losing focus
         if (_core.HasUnfocusedAppearance())
@@ -1961,9 +1980,62 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     void TermControl::_BlinkTimerTick(const Windows::Foundation::IInspectable& /* sender */,
                                       const Windows::Foundation::IInspectable& /* e */)
     {
-        if (!_IsClosing())
+        if (!_IsClosing() && !_core.BlinkAttributeTick() && _blinkTimer)
+        {
+            // Nothing is blinking anymore. _coreBlinkingResumed will
+            // restart the timer once blinking text gets painted again.
+            _blinkTimer->Stop();
+        }
+    }
+
+    // Method Description:
+    // - Restarts the blink timer after it stopped itself, because the renderer
+    //   painted blinking text again. This is raised on the render thread.
+    winrt::fire_and_forget TermControl::_coreBlinkingResumed(IInspectable /*sender*/,
+                                                             IInspectable /*args*/)
+    {
+        auto weakThis{ get_weak() };
+        co_await wil::resume_foreground(Dispatcher());
+        if (auto control{ weakThis.get() })
+        {
+            if (!_IsClosing() && _blinkTimer && _focused && _windowVisible)
+            {
+                _blinkTimer->Start();
+            }
+        }
+    }
+
+    // Method Description:
+    // - Shows the cursor and starts the cursor and attribute blink timers.
+    //   This happens when we gain focus, or when our window is restored.
+    void TermControl::_startBlinkTimers()
+    {
+        if (_cursorTimer)
         {
-            _core.BlinkAttributeTick();
+            // Show the cursor immediately
+            _core.CursorOn(_core.SelectionMode() != SelectionInteractionMode::Mark);
+            _cursorTimer->Start();
+        }
+
+        if (_blinkTimer)
+        {
+            _blinkTimer->Start();
+        }
+    }
+
+    // Method Description:
+    // - Stops the cursor and attribute blink timers, so that we don't wake
+    //   up periodically while we're unfocused or our window is minimized.
+    void TermControl::_stopBlinkTimers()
+    {
+        if (_cursorTimer)
+        {
+            _cursorTimer->Stop();
+        }
+
+        if (_blinkTimer)
+        {
+            _blinkTimer->Stop();
         }
     }
 
@@ -2377,6 +2449,21 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - <none>
     void TermControl::WindowVisibilityChanged(const bool showOrHide)
     {
+        _windowVisible = showOrHide;
+
+        // There's no point in blinking anything while the window is minimized.
+        if (_focused)
+        {
+            if (showOrHide)
+            {
+                _startBlinkTimers();
+            }
+            else
+            {
+                _stopBlinkTimers();
+            }
+        }
+
         _core.WindowVisibilityChanged(showOrHide);
     }
 
@@ -3283,6 +3370,18 @@ namespace winrt::Microsoft::Terminal::Control::implementation
     // - <none>
     void TermControl::_coreFoundMatch(const IInspectable& /*sender*/, const Control::FoundResultsArgs& args)
     {
+        if (_searchBox)
+        {
+            _searchBox->SetStatus(args.TotalMatches(), args.SearchComplete());
+        }
+
+        // The search runs in the background and reports its progress as it goes.
+        // Only announce the final result to narrator.
+        if (!args.SearchComplete())
+        {
+            return;
+        }
+
         if (auto automationPeer{ Automation::Peers::FrameworkElementAutomationPeer::FromElement(*this) })
         {
             automationPeer.RaiseNotificationEvent(
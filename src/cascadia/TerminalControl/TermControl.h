@@ -100,6 +100,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void RenderEngineSwapChainChanged(IInspectable sender, IInspectable args);
         void _AttachDxgiSwapChainToXaml(HANDLE swapChainHandle);
         winrt::fire_and_forget _RendererEnteredErrorState(IInspectable sender, IInspectable args);
+        winrt::fire_and_forget _coreBlinkingResumed(IInspectable sender, IInspectable args);
 
         void _RenderRetryButton_Click(const IInspectable& button, const IInspectable& args);
         winrt::fire_and_forget _RendererWarning(IInspectable sender,
@@ -181,7 +182,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         // NOTE: _uiaEngine must be ordered before _core.
         //
-        // ControlCore::AttachUiaEngine receives a IRenderEngine as a raw pointer, which we own.
+        // ControlCore::AttachUiaEngine receives a UiaEngine as a raw pointer, which we own.
         // We must ensure that we first destroy the ControlCore before the UiaEngine instance
         // in order to safely resolve this unsafe pointer dependency. Otherwise a deallocated
         // IRenderEngine is accessed when ControlCore calls Renderer::TriggerTeardown.
@@ -195,6 +196,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         bool _closing{ false };
         bool _focused{ false };
+        bool _windowVisible{ true };
         bool _initializedTerminal{ false };
 
         std::shared_ptr<ThrottledFuncLeading> _playWarningBell;
@@ -291,6 +293,8 @@ namespace winrt::Microsoft::Terminal::Control::implementation
 
         void _CursorTimerTick(const Windows::Foundation::IInspectable& sender, const Windows::Foundation::IInspectable& e);
         void _BlinkTimerTick(const Windows::Foundation::IInspectable& sender, const Windows::Foundation::IInspectable& e);
+        void _startBlinkTimers();
+        void _stopBlinkTimers();
         void _BellLightOff(const Windows::Foundation::IInspectable& sender, const Windows::Foundation::IInspectable& e);
 
         void _SetEndSelectionPointAtCursor(const Windows::Foundation::Point& cursorPosition);
@@ -319,7 +323,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         const til::point _toTerminalOrigin(winrt::Windows::Foundation::Point cursorPosition);
         double _GetAutoScrollSpeed(double cursorDistanceFromBorder) const;
 
-        void _Search(const winrt::hstring& text, const bool goForward, const bool caseSensitive);
+        void _Search(const winrt::hstring& text, const bool goForward, const bool caseSensitive, const bool regex);
         void _CloseSearchBoxControl(const winrt::Windows::Foundation::IInspectable& sender, const Windows::UI::Xaml::RoutedEventArgs& args);
 
         // TSFInputControl Handlers
@@ -353,6 +357,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
             Control::ControlCore::WarningBell_revoker WarningBell;
             Control::ControlCore::CursorPositionChanged_revoker CursorPositionChanged;
             Control::ControlCore::RendererEnteredErrorState_revoker RendererEnteredErrorState;
+            Control::ControlCore::BlinkingResumed_revoker BlinkingResumed;
             Control::ControlCore::BackgroundColorChanged_revoker BackgroundColorChanged;
             Control::ControlCore::FontSizeChanged_revoker FontSizeChanged;
             Control::ControlCore::TransparencyChanged_revoker TransparencyChanged;
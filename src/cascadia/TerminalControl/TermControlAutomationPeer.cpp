@@ -270,6 +270,11 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         });
     }
 
+    void TermControlAutomationPeer::NotifyOutputOmitted(size_t omittedLength)
+    {
+        NotifyNewOutput(fmt::format(std::wstring_view{ RS_(L"OutputOmittedNotification") }, omittedLength));
+    }
+
     hstring TermControlAutomationPeer::GetClassNameCore() const
     {
         // IMPORTANT: Do NOT change the name. Screen readers like JAWS may be dependent on this being "TermControl".
@@ -67,6 +67,7 @@ namespace winrt::Microsoft::Terminal::Control::implementation
         void SignalTextChanged() override;
         void SignalCursorChanged() override;
         void NotifyNewOutput(std::wstring_view newOutput) override;
+        void NotifyOutputOmitted(size_t omittedLength) override;
 #pragma endregion
 
 #pragma region ITextProvider Pattern
@@ -7,6 +7,7 @@
 
 // For g_hCTerminalCoreProvider
 #include "../../cascadia/TerminalCore/tracing.hpp"
+#include "../../renderer/inc/WakeupCounter.hpp"
 
 // Note: Generate GUID using TlgGuid.exe tool
 TRACELOGGING_DEFINE_PROVIDER(
@@ -16,6 +17,20 @@ TRACELOGGING_DEFINE_PROVIDER(
     (0x28c82e50, 0x57af, 0x5a86, 0xc2, 0x5b, 0xe3, 0x9c, 0xd9, 0x90, 0x03, 0x2b),
     TraceLoggingOptionMicrosoftTelemetry());
 
+// Logs the average number of wakeups per second of the whole process, which
+// includes the render threads and blink timers of all controls. It's called
+// from whichever of them is awake anyway, at most once a second.
+static void ReportWakeups(const double wakeupsPerSecond) noexcept
+{
+    TraceLoggingWrite(
+        g_hTerminalControlProvider,
+        "TerminalControl_Wakeups",
+        TraceLoggingDescription("The average number of wakeups per second since the last event"),
+        TraceLoggingFloat64(wakeupsPerSecond, "wakeupsPerSecond"),
+        TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+        TraceLoggingKeyword(TIL_KEYWORD_TRACE));
+}
+
 BOOL WINAPI DllMain(HINSTANCE hInstDll, DWORD reason, LPVOID /*reserved*/)
 {
     switch (reason)
@@ -25,8 +40,10 @@ BOOL WINAPI DllMain(HINSTANCE hInstDll, DWORD reason, LPVOID /*reserved*/)
         TraceLoggingRegister(g_hTerminalControlProvider);
         TraceLoggingRegister(g_hCTerminalCoreProvider);
         Microsoft::Console::ErrorReporting::EnableFallbackFailureReporting(g_hTerminalControlProvider);
+        Microsoft::Console::Render::WakeupCounter::SetReporter(&ReportWakeups);
         break;
     case DLL_PROCESS_DETACH:
+        Microsoft::Console::Render::WakeupCounter::SetReporter(nullptr);
         if (g_hTerminalControlProvider)
         {
             TraceLoggingUnregister(g_hTerminalControlProvider);
@@ -10,6 +10,8 @@
 #include "../../types/inc/colorTable.hpp"
 #include "../../buffer/out/search.h"
 
+#include <til/hash.h>
+
 #include <winrt/Microsoft.Terminal.Core.h>
 
 using namespace winrt::Microsoft::Terminal::Core;
@@ -21,34 +23,18 @@ using namespace Microsoft::Console::VirtualTerminal;
 
 using PointTree = interval_tree::IntervalTree<til::point, size_t>;
 
-static std::wstring _KeyEventsToText(std::deque<std::unique_ptr<IInputEvent>>& inEventsToWrite)
-{
-    std::wstring wstr = L"";
-    for (const auto& ev : inEventsToWrite)
-    {
-        if (ev->EventType() == InputEventType::KeyEvent)
-        {
-            const auto& k = static_cast<KeyEvent&>(*ev);
-            const auto wch = k.GetCharData();
-            wstr += wch;
-        }
-    }
-    return wstr;
-}
-
 #pragma warning(suppress : 26455) // default constructor is throwing, too much effort to rearrange at this time.
 Terminal::Terminal()
 {
-    auto passAlongInput = [&](std::deque<std::unique_ptr<IInputEvent>>& inEventsToWrite) {
-        if (!_pfnWriteInput)
+    // We don't need the input as key events, since it's passed straight
+    // along to the connection. The text sender avoids converting back and forth.
+    _terminalInput = std::make_unique<TerminalInput>(nullptr);
+    _terminalInput->SetTextSender([this](const std::wstring_view sequence) {
+        if (_pfnWriteInput)
         {
-            return;
+            _pfnWriteInput(sequence);
         }
-        const auto wstr = _KeyEventsToText(inEventsToWrite);
-        _pfnWriteInput(wstr);
-    };
-
-    _terminalInput = std::make_unique<TerminalInput>(passAlongInput);
+    });
 
     _renderSettings.SetColorAlias(ColorAlias::DefaultForeground, TextColor::DEFAULT_FOREGROUND, RGB(255, 255, 255));
     _renderSettings.SetColorAlias(ColorAlias::DefaultBackground, TextColor::DEFAULT_BACKGROUND, RGB(0, 0, 0));
@@ -112,6 +98,7 @@ void Terminal::UpdateSettings(ICoreSettings settings)
     _autoMarkPrompts = settings.AutoMarkPrompts();
 
     _terminalInput->ForceDisableWin32InputMode(settings.ForceVTInput());
+    _terminalInput->SetMouseMotionCoalescing(settings.CoalesceMouseMotion());
 
     if (settings.TabColor() == nullptr)
     {
@@ -136,6 +123,9 @@ void Terminal::UpdateSettings(ICoreSettings settings)
     // Regenerate the pattern tree for the new buffer size
     if (_mainBuffer)
     {
+        // The settings apply to the main buffer, not to that of an unfinished interactive resize.
+        LOG_IF_FAILED(FinishInteractiveResize());
+
         // Clear the patterns first
         _mainBuffer->ClearPatternRecognizers();
         _detectURLs = settings.DetectURLs();
@@ -244,6 +234,60 @@ std::wstring_view Terminal::GetWorkingDirectory() noexcept
     return _workingDirectory;
 }
 
+// Routine Description:
+// - Applies the given transformation to all the positions of the given marks,
+//   and drops the marks that ended up above the top of the buffer.
+template<typename T>
+static void _remapMarks(std::vector<DispatchTypes::ScrollMark>& marks, T&& remap)
+{
+    for (auto& mark : marks)
+    {
+        mark.start = remap(mark.start);
+        mark.end = remap(mark.end);
+        if (mark.commandEnd.has_value())
+        {
+            *mark.commandEnd = remap(*mark.commandEnd);
+        }
+        if (mark.outputEnd.has_value())
+        {
+            *mark.outputEnd = remap(*mark.outputEnd);
+        }
+    }
+
+    marks.erase(std::remove_if(marks.begin(),
+                               marks.end(),
+                               [](const auto& m) { return m.start.y < 0; }),
+                marks.end());
+}
+
+// Routine Description:
+// - Moves the marks to where their text ended up after a reflow.
+// Arguments:
+// - marks: the marks to remap
+// - rowStarts: the new position of the start of each reflowed row, as returned by TextBuffer::Reflow
+// - firstRow: the old row that corresponds to the first entry in rowStarts
+// - width: the width of the new buffer
+static void _remapMarks(std::vector<DispatchTypes::ScrollMark>& marks, const std::vector<til::point>& rowStarts, const til::CoordType firstRow, const til::CoordType width)
+{
+    if (rowStarts.empty())
+    {
+        return;
+    }
+
+    const auto lastRow = gsl::narrow_cast<til::CoordType>(rowStarts.size()) - 1;
+    _remapMarks(marks, [&](const til::point pos) noexcept {
+        const auto row = std::max(pos.y - firstRow, 0);
+        // The empty rows below the text aren't reflowed. They just follow the last one that was.
+        if (row > lastRow)
+        {
+            return til::point{ std::min(pos.x, width - 1), til::at(rowStarts, lastRow).y + row - lastRow };
+        }
+        const auto start = til::at(rowStarts, row);
+        const auto offset = start.x + pos.x;
+        return til::point{ offset % width, start.y + offset / width };
+    });
+}
+
 // Method Description:
 // - Resize the terminal as the result of some user interaction.
 // Arguments:
@@ -254,6 +298,10 @@ std::wstring_view Terminal::GetWorkingDirectory() noexcept
 //      appropriate HRESULT for failing to resize.
 [[nodiscard]] HRESULT Terminal::UserResize(const til::size viewportSize) noexcept
 {
+    // We're going to reflow the entire buffer, so we might as well finish
+    // an interactive resize first. Otherwise its rows would be left behind.
+    RETURN_IF_FAILED(FinishInteractiveResize());
+
     const auto oldDimensions = _GetMutableViewport().Dimensions();
     if (viewportSize == oldDimensions)
     {
@@ -286,6 +334,186 @@ std::wstring_view Terminal::GetWorkingDirectory() noexcept
         return S_OK;
     }
 
+    std::unique_ptr<TextBuffer> oldBuffer;
+    return _resizeMainBuffer(viewportSize, 0, oldBuffer);
+}
+
+// Method Description:
+// - Resize the terminal while the user is dragging the window border. With a
+//   lot of scrollback, reflowing the entire buffer for every intermediate size
+//   makes resizing janky. Instead, only the rows from one screen above the
+//   visible viewport onwards are reflowed here. The rows above that are kept
+//   as they are, until FinishInteractiveResize() reflows them once.
+// - The caller is responsible for calling FinishInteractiveResize() after the
+//   size has settled. Until then, the scrollback only contains the reflowed rows.
+// Arguments:
+// - viewportSize: the new size of the viewport, in chars
+// Return Value:
+// - S_OK if we successfully resized the terminal, S_FALSE if there was
+//      nothing to do (the viewportSize is the same as our current size), or an
+//      appropriate HRESULT for failing to resize.
+[[nodiscard]] HRESULT Terminal::InteractiveResize(const til::size viewportSize) noexcept
+try
+{
+    // The alt buffer doesn't have any scrollback to begin with.
+    if (_inAltBuffer())
+    {
+        return UserResize(viewportSize);
+    }
+
+    if (viewportSize == _mutableViewport.Dimensions())
+    {
+        return S_FALSE;
+    }
+
+    // If we're already in the middle of an interactive resize, the main
+    // buffer only contains the rows around the viewport. It's cheap to
+    // reflow the whole thing.
+    std::unique_ptr<TextBuffer> oldBuffer;
+    if (_deferredReflow)
+    {
+        return _resizeMainBuffer(viewportSize, 0, oldBuffer);
+    }
+
+    // Start reflowing one screen above the visible viewport, but at the
+    // beginning of a line, so that the rows above it can be reflowed on their own.
+    auto firstRow = std::max(0, _VisibleStartIndex() - _mutableViewport.Height());
+    while (firstRow > 0 && _mainBuffer->GetRowByOffset(firstRow - 1).WasWrapForced())
+    {
+        firstRow--;
+    }
+
+    // Nothing to be gained from deferring anything.
+    if (firstRow == 0)
+    {
+        return UserResize(viewportSize);
+    }
+
+    // The marks above firstRow stay in the coordinates of the old buffer
+    // until we get around to reflowing their rows.
+    std::vector<DispatchTypes::ScrollMark> skippedMarks;
+    const auto firstTailMark = std::stable_partition(_scrollMarks.begin(), _scrollMarks.end(), [&](const auto& mark) {
+        return mark.start.y < firstRow;
+    });
+    skippedMarks.assign(_scrollMarks.begin(), firstTailMark);
+    _scrollMarks.erase(_scrollMarks.begin(), firstTailMark);
+    auto restoreMarks = wil::scope_exit([&]() {
+        _scrollMarks.insert(_scrollMarks.begin(), skippedMarks.begin(), skippedMarks.end());
+    });
+
+    RETURN_IF_FAILED(_resizeMainBuffer(viewportSize, firstRow, oldBuffer));
+
+    restoreMarks.release();
+    _deferredReflow.emplace(DeferredReflow{ std::move(oldBuffer), firstRow, std::move(skippedMarks) });
+    return S_OK;
+}
+CATCH_RETURN()
+
+// Method Description:
+// - Finishes an interactive resize by reflowing the rows that
+//   InteractiveResize() skipped. They're reflowed into a new buffer, followed
+//   by the rows of the current main buffer, which already have the right width.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK if we finished an interactive resize, S_FALSE if there was nothing
+//   to do, or an appropriate HRESULT for failing to reflow.
+[[nodiscard]] HRESULT Terminal::FinishInteractiveResize() noexcept
+try
+{
+    if (!_deferredReflow)
+    {
+        return S_FALSE;
+    }
+
+    // Even if this fails, we won't try it again.
+    auto deferred = std::move(*_deferredReflow);
+    _deferredReflow.reset();
+
+    auto& currentBuffer = *_mainBuffer;
+    const auto bufferSize = currentBuffer.GetSize().Dimensions();
+
+    currentBuffer.GetCursor().StartDeferDrawing();
+    auto endDefer = wil::scope_exit([this]() noexcept { _mainBuffer->GetCursor().EndDeferDrawing(); });
+
+    auto newTextBuffer = std::make_unique<TextBuffer>(bufferSize,
+                                                      TextAttribute{},
+                                                      0, // temporarily set size to 0 so it won't render.
+                                                      currentBuffer.IsActiveBuffer(),
+                                                      currentBuffer.GetRenderer());
+    newTextBuffer->GetCursor().StartDeferDrawing();
+
+    // The skipped rows go first. firstRow starts a new line,
+    // so this leaves the cursor at the start of the next row.
+    TextBuffer::PositionInformation skippedRows;
+    RETURN_IF_FAILED(TextBuffer::Reflow(*deferred.source,
+                                        *newTextBuffer,
+                                        std::nullopt,
+                                        { skippedRows },
+                                        0,
+                                        deferred.firstRow));
+
+    // The current buffer has the same width as the new one, so
+    // its rows are just shifted down by the rows we added above.
+    const auto oldCursorY = currentBuffer.GetCursor().GetPosition().y;
+    const auto appendY = newTextBuffer->GetCursor().GetPosition().y;
+    TextBuffer::PositionInformation currentRows;
+    RETURN_IF_FAILED(TextBuffer::Reflow(currentBuffer, *newTextBuffer, _mutableViewport, { currentRows }));
+    const auto delta = newTextBuffer->GetCursor().GetPosition().y - oldCursorY;
+
+    // If the scrollback is full, the new buffer discarded rows from the top while
+    // the current buffer's rows were appended. The skipped rows moved up by as many.
+    const auto rotation = currentRows.rowStarts.empty() ? 0 : appendY - currentRows.rowStarts.front().y;
+
+    newTextBuffer->SetCurrentAttributes(currentBuffer.GetCurrentAttributes());
+
+    _remapMarks(deferred.marks, skippedRows.rowStarts, 0, bufferSize.width);
+    _remapMarks(deferred.marks, [=](const til::point pos) noexcept { return til::point{ pos.x, pos.y - rotation }; });
+    _remapMarks(_scrollMarks, [=](const til::point pos) noexcept { return til::point{ pos.x, pos.y + delta }; });
+    _scrollMarks.insert(_scrollMarks.begin(), deferred.marks.begin(), deferred.marks.end());
+
+    const auto newTop = std::clamp(_mutableViewport.Top() + delta, 0, bufferSize.height - _mutableViewport.Height());
+    _mutableViewport = Viewport::FromDimensions({ 0, newTop }, _mutableViewport.Dimensions());
+
+    _mainBuffer.swap(newTextBuffer);
+
+    if (!_inAltBuffer())
+    {
+        // The scroll offset is relative to the viewport, which moved along
+        // with everything else. It just mustn't point above the buffer.
+        _scrollOffset = std::min(_scrollOffset, newTop);
+
+        if (_selection)
+        {
+            _selection->start.y += delta;
+            _selection->end.y += delta;
+            _selection->pivot.y += delta;
+            if (_selection->start.y < 0)
+            {
+                _selection.reset();
+            }
+        }
+
+        _activeBuffer().TriggerRedrawAll();
+    }
+    _NotifyScrollEvent();
+
+    return S_OK;
+}
+CATCH_RETURN()
+
+// Method Description:
+// - Reflows the main buffer into a new one with the given viewport size and
+//   places the viewport in it. Shared by UserResize() and InteractiveResize().
+// Arguments:
+// - viewportSize: the new size of the viewport, in chars
+// - firstRow: the first row of the main buffer to reflow. The rows above it are dropped.
+// - oldBuffer: receives the previous main buffer
+// Return Value:
+// - S_OK if we successfully resized the terminal, or an appropriate HRESULT for failing to resize.
+[[nodiscard]] HRESULT Terminal::_resizeMainBuffer(const til::size viewportSize, const til::CoordType firstRow, std::unique_ptr<TextBuffer>& oldBuffer) noexcept
+{
+    const auto oldDimensions = _mutableViewport.Dimensions();
     const auto dx = viewportSize.width - oldDimensions.width;
     const auto newBufferHeight = std::clamp(viewportSize.height + _scrollbackLines, 0, SHRT_MAX);
 
@@ -307,6 +535,7 @@ std::wstring_view Terminal::GetWorkingDirectory() noexcept
 
     // First allocate a new text buffer to take the place of the current one.
     std::unique_ptr<TextBuffer> newTextBuffer;
+    TextBuffer::PositionInformation oldRows;
     try
     {
         // GH#3848 - Stash away the current attributes the old text buffer is
@@ -334,15 +563,14 @@ std::wstring_view Terminal::GetWorkingDirectory() noexcept
         // * the new value of visibleViewportTop will be used to calculate the
         //   new scrollOffset in the new buffer, so that the visible lines on
         //   the screen remain roughly the same.
-        TextBuffer::PositionInformation oldRows{ 0 };
         oldRows.mutableViewportTop = oldViewportTop;
         oldRows.visibleViewportTop = newVisibleTop;
 
-        const std::optional oldViewStart{ oldViewportTop };
         RETURN_IF_FAILED(TextBuffer::Reflow(*_mainBuffer.get(),
                                             *newTextBuffer.get(),
                                             _mutableViewport,
-                                            { oldRows }));
+                                            { oldRows },
+                                            firstRow));
 
         newViewportTop = oldRows.mutableViewportTop;
         newVisibleTop = oldRows.visibleViewportTop;
@@ -455,7 +683,10 @@ std::wstring_view Terminal::GetWorkingDirectory() noexcept
 
     _mutableViewport = Viewport::FromDimensions({ 0, proposedTop }, viewportSize);
 
+    _remapMarks(_scrollMarks, oldRows.rowStarts, firstRow, viewportSize.width);
+
     _mainBuffer.swap(newTextBuffer);
+    oldBuffer = std::move(newTextBuffer);
 
     // GH#3494: Maintain scrollbar position during resize
     // Make sure that we don't scroll past the mutableViewport at the bottom of the buffer
@@ -509,6 +740,9 @@ void Terminal::WritePastedText(std::wstring_view stringView)
         filtered.append(L"\x1b[201~");
     }
 
+    // The paste must not overtake a mouse motion report that's been held back.
+    _terminalInput->FlushMouseMotion();
+
     if (_pfnWriteInput)
     {
         _pfnWriteInput(filtered);
@@ -558,6 +792,21 @@ bool Terminal::ShouldSendAlternateScroll(const unsigned int uiButton,
     return _terminalInput->ShouldSendAlternateScroll(uiButton, ::base::saturated_cast<short>(delta));
 }
 
+// Routine Description:
+// - Relays if a mouse motion report is being held back by the motion coalescing.
+bool Terminal::HasPendingMouseMotion() const noexcept
+{
+    return _terminalInput->HasPendingMouseMotion();
+}
+
+// Routine Description:
+// - Sends the mouse motion report that's being held back by the motion coalescing, if any.
+//   This should be called once per frame while HasPendingMouseMotion() returns true.
+void Terminal::FlushMouseMotion() noexcept
+{
+    _terminalInput->FlushMouseMotion();
+}
+
 // Method Description:
 // - Given a coord, get the URI at that location
 // Arguments:
@@ -1194,6 +1443,15 @@ void Terminal::SetPlayMidiNoteCallback(std::function<void(const int, const int,
     _pfnPlayMidiNote.swap(pfn);
 }
 
+// Method Description:
+// - Allows setting a callback for discarding MIDI notes that are yet to be played.
+// Arguments:
+// - pfn: a function callback that takes no arguments
+void Terminal::SetFlushMidiNotesCallback(std::function<void()> pfn) noexcept
+{
+    _pfnFlushMidiNotes.swap(pfn);
+}
+
 // Method Description:
 // - Sets the cursor to be currently on. On/Off is tracked independently of
 //   cursor visibility (hidden/visible). On/off is controlled by the cursor
@@ -1221,20 +1479,53 @@ bool Terminal::IsCursorBlinkingAllowed() const noexcept
 // - INVARIANT: this function can only be called if the caller has the writing lock on the terminal
 void Terminal::UpdatePatternsUnderLock()
 {
-    auto oldTree = _patternIntervalTree;
-    _patternIntervalTree = _activeBuffer().GetPatterns(_VisibleStartIndex(), _VisibleEndIndex());
+    // Scanning the viewport holds the write lock, which stalls both the output
+    // and hover lookups. The tree is relative to the viewport, so if none of the
+    // visible rows changed since the last scan it's still accurate as it is.
+    if (!_updatePatternRowCache())
+    {
+        return;
+    }
+
+    const auto oldTree = std::exchange(_patternIntervalTree, _activeBuffer().GetPatterns(_VisibleStartIndex(), _VisibleEndIndex()));
     _InvalidatePatternTree(oldTree);
     _InvalidatePatternTree(_patternIntervalTree);
 }
 
+// Method Description:
+// - Updates the hashes of the visible rows that the pattern tree was built from.
+//   Hashing the rows in place avoids copying the entire viewport under the lock.
+// Return Value:
+// - true if any visible row differs from what the pattern tree was built from
+bool Terminal::_updatePatternRowCache()
+{
+    const auto firstRow = _VisibleStartIndex();
+    const auto rowCount = gsl::narrow_cast<size_t>(std::max(0, _VisibleEndIndex() - firstRow + 1));
+    auto changed = _patternRowCache.size() != rowCount;
+    _patternRowCache.resize(rowCount);
+
+    for (size_t i = 0; i < rowCount; ++i)
+    {
+        const auto hash = til::hash(_activeBuffer().GetRowByOffset(firstRow + gsl::narrow_cast<til::CoordType>(i)).GetText());
+        auto& cached = til::at(_patternRowCache, i);
+        if (cached != hash)
+        {
+            cached = hash;
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
 // Method Description:
 // - Clears and invalidates the interval pattern tree
 // - This is called to prevent the renderer from rendering patterns while the
 //   visible region is changing
 void Terminal::ClearPatternTree()
 {
-    auto oldTree = _patternIntervalTree;
-    _patternIntervalTree = {};
+    const auto oldTree = std::exchange(_patternIntervalTree, {});
+    _patternRowCache.clear();
     _InvalidatePatternTree(oldTree);
 }
 
@@ -1350,6 +1641,7 @@ void Terminal::_updateUrlDetection()
         // Add regex pattern recognizers to the buffer
         // For now, we only add the URI regex pattern
         _hyperlinkPatternId = _activeBuffer().AddPatternRecognizer(linkPattern);
+        _patternRowCache.clear();
         UpdatePatternsUnderLock();
     }
     else
@@ -1421,6 +1713,10 @@ void Terminal::ClearMark()
 void Terminal::ClearAllMarks() noexcept
 {
     _scrollMarks.clear();
+    if (_deferredReflow)
+    {
+        _deferredReflow->marks.clear();
+    }
     // Tell the control that the scrollbar has somehow changed. Used as a
     // workaround to force the control to redraw any scrollbar marks
     _NotifyScrollEvent();
@@ -126,6 +126,7 @@ public:
     void SetTaskbarProgress(const ::Microsoft::Console::VirtualTerminal::DispatchTypes::TaskbarState state, const size_t progress) override;
     void SetWorkingDirectory(std::wstring_view uri) override;
     void PlayMidiNote(const int noteNumber, const int velocity, const std::chrono::microseconds duration) override;
+    void FlushMidiNotes() override;
     void ShowWindow(bool showOrHide) override;
     void UseAlternateScreenBuffer() override;
     void UseMainScreenBuffer() override;
@@ -139,6 +140,7 @@ public:
     bool IsVtInputEnabled() const noexcept override;
     void NotifyAccessibilityChange(const til::rect& changedRect) noexcept override;
     void NotifyBufferRotation(const int delta) override;
+    void NotifyScrollbackErased() noexcept override;
 #pragma endregion
 
     void ClearMark();
@@ -152,12 +154,16 @@ public:
     bool SendCharEvent(const wchar_t ch, const WORD scanCode, const ControlKeyStates states) override;
 
     [[nodiscard]] HRESULT UserResize(const til::size viewportSize) noexcept override;
+    [[nodiscard]] HRESULT InteractiveResize(const til::size viewportSize) noexcept;
+    [[nodiscard]] HRESULT FinishInteractiveResize() noexcept;
     void UserScrollViewport(const int viewTop) override;
     int GetScrollOffset() noexcept override;
 
     void TrySnapOnInput() override;
     bool IsTrackingMouseInput() const noexcept;
     bool ShouldSendAlternateScroll(const unsigned int uiButton, const int32_t delta) const noexcept;
+    bool HasPendingMouseMotion() const noexcept;
+    void FlushMouseMotion() noexcept;
 
     void FocusChanged(const bool focused) noexcept override;
 
@@ -212,6 +218,7 @@ public:
     void TaskbarProgressChangedCallback(std::function<void()> pfn) noexcept;
     void SetShowWindowCallback(std::function<void(bool)> pfn) noexcept;
     void SetPlayMidiNoteCallback(std::function<void(const int, const int, const std::chrono::microseconds)> pfn) noexcept;
+    void SetFlushMidiNotesCallback(std::function<void()> pfn) noexcept;
 
     void SetCursorOn(const bool isOn);
     bool IsCursorBlinkingAllowed() const noexcept;
@@ -309,6 +316,7 @@ private:
     std::function<void()> _pfnTaskbarProgressChanged;
     std::function<void(bool)> _pfnShowWindowChanged;
     std::function<void(const int, const int, const std::chrono::microseconds)> _pfnPlayMidiNote;
+    std::function<void()> _pfnFlushMidiNotes;
 
     RenderSettings _renderSettings;
     std::unique_ptr<::Microsoft::Console::VirtualTerminal::StateMachine> _stateMachine;
@@ -367,6 +375,19 @@ private:
     til::size _altBufferSize;
     std::optional<til::size> _deferredResize;
 
+    // During an interactive resize, only the rows from firstRow onwards are
+    // reflowed into the main buffer. The ones above it are reflowed by
+    // FinishInteractiveResize() once the size has settled.
+    struct DeferredReflow
+    {
+        // The main buffer as it was before the resize started.
+        std::unique_ptr<TextBuffer> source;
+        til::CoordType firstRow = 0;
+        // The marks that start above firstRow, in the coordinates of source.
+        std::vector<Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark> marks;
+    };
+    std::optional<DeferredReflow> _deferredReflow;
+
     // _scrollOffset is the number of lines above the viewport that are currently visible
     // If _scrollOffset is 0, then the visible region of the buffer is the viewport.
     til::CoordType _scrollOffset = 0;
@@ -384,6 +405,9 @@ private:
     //      Either way, we should make this behavior controlled by a setting.
 
     interval_tree::IntervalTree<til::point, size_t> _patternIntervalTree;
+    // The hash of each visible row's text as of the last time we scanned for patterns.
+    std::vector<size_t> _patternRowCache;
+    bool _updatePatternRowCache();
     void _InvalidatePatternTree(const interval_tree::IntervalTree<til::point, size_t>& tree);
     void _InvalidateFromCoords(const til::point start, const til::point end);
 
@@ -427,6 +451,7 @@ private:
 
     bool _inAltBuffer() const noexcept;
     TextBuffer& _activeBuffer() const noexcept;
+    [[nodiscard]] HRESULT _resizeMainBuffer(const til::size viewportSize, const til::CoordType firstRow, std::unique_ptr<TextBuffer>& oldBuffer) noexcept;
     void _updateUrlDetection();
 
 #pragma region TextSelection
@@ -202,6 +202,14 @@ void Terminal::PlayMidiNote(const int noteNumber, const int velocity, const std:
     _pfnPlayMidiNote(noteNumber, velocity, duration);
 }
 
+void Terminal::FlushMidiNotes()
+{
+    if (_pfnFlushMidiNotes)
+    {
+        _pfnFlushMidiNotes();
+    }
+}
+
 void Terminal::UseAlternateScreenBuffer()
 {
     // the new alt buffer is exactly the size of the viewport.
@@ -211,6 +219,7 @@ void Terminal::UseAlternateScreenBuffer()
 
     ClearSelection();
     _mainBuffer->ClearPatternRecognizers();
+    ClearPatternTree();
 
     // Create a new alt buffer
     _altBuffer = std::make_unique<TextBuffer>(_altBufferSize,
@@ -449,6 +458,13 @@ void Terminal::NotifyAccessibilityChange(const til::rect& /*changedRect*/) noexc
     // This is only needed in conhost. Terminal handles accessibility in another way.
 }
 
+void Terminal::NotifyScrollbackErased() noexcept
+{
+    // The rows that an interactive resize hasn't reflowed yet are part of
+    // the scrollback, so there's no point in reflowing them anymore.
+    _deferredReflow.reset();
+}
+
 void Terminal::NotifyBufferRotation(const int delta)
 {
     // Update our selection, so it doesn't move as the buffer is cycled
@@ -474,6 +490,7 @@ void Terminal::NotifyBufferRotation(const int delta)
 
     // manually erase our pattern intervals since the locations have changed now
     _patternIntervalTree = {};
+    _patternRowCache.clear();
 
     const auto hasScrollMarks = _scrollMarks.size() > 0;
     if (hasScrollMarks)
@@ -89,6 +89,9 @@ Author(s):
     X(bool, Elevate, "elevate", false)                                                                                                                         \
     X(bool, VtPassthrough, "experimental.connection.passthroughMode", false)                                                                                   \
     X(bool, AutoMarkPrompts, "experimental.autoMarkPrompts", false)                                                                                            \
+    X(bool, CoalesceMouseMotion, "experimental.input.coalesceMouseMotion", false)                                                                              \
+    X(int32_t, MaxAnnouncedOutput, "experimental.accessibility.maxAnnouncedOutput", 4000)                                                                      \
+    X(int32_t, AnnouncementInterval, "experimental.accessibility.announcementInterval", 100)                                                                   \
     X(bool, ShowMarks, "experimental.showMarksOnScrollbar", false)
 
 // Intentionally omitted Profile settings:
@@ -265,6 +265,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         _HistorySize = profile.HistorySize();
         _SnapOnInput = profile.SnapOnInput();
         _AltGrAliasing = profile.AltGrAliasing();
+        _CoalesceMouseMotion = profile.CoalesceMouseMotion();
 
         // Fill in the remaining properties from the profile
         _ProfileName = profile.Name();
@@ -323,6 +324,8 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         _Elevate = profile.Elevate();
         _AutoMarkPrompts = Feature_ScrollbarMarks::IsEnabled() && profile.AutoMarkPrompts();
         _ShowMarks = Feature_ScrollbarMarks::IsEnabled() && profile.ShowMarks();
+        _MaxAnnouncedOutput = profile.MaxAnnouncedOutput();
+        _AnnouncementInterval = profile.AnnouncementInterval();
 
         _RightClickContextMenu = profile.RightClickContextMenu();
     }
@@ -81,6 +81,7 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
         INHERITABLE_SETTING(Model::TerminalSettings, til::color, DefaultBackground, DEFAULT_BACKGROUND);
         INHERITABLE_SETTING(Model::TerminalSettings, til::color, SelectionBackground, DEFAULT_FOREGROUND);
         INHERITABLE_SETTING(Model::TerminalSettings, int32_t, HistorySize, DEFAULT_HISTORY_SIZE);
+        INHERITABLE_SETTING(Model::TerminalSettings, bool, CoalesceMouseMotion, false);
         INHERITABLE_SETTING(Model::TerminalSettings, int32_t, InitialRows, 30);
         INHERITABLE_SETTING(Model::TerminalSettings, int32_t, InitialCols, 80);
 
@@ -163,6 +164,8 @@ namespace winrt::Microsoft::Terminal::Settings::Model::implementation
 
         INHERITABLE_SETTING(Model::TerminalSettings, bool, AutoMarkPrompts, false);
         INHERITABLE_SETTING(Model::TerminalSettings, bool, ShowMarks, false);
+        INHERITABLE_SETTING(Model::TerminalSettings, int32_t, MaxAnnouncedOutput, 4000);
+        INHERITABLE_SETTING(Model::TerminalSettings, int32_t, AnnouncementInterval, 100);
         INHERITABLE_SETTING(Model::TerminalSettings, bool, RightClickContextMenu, false);
 
     private:
@@ -32,6 +32,7 @@ namespace ControlUnitTests
         TEST_METHOD(TestFreeAfterClose);
 
         TEST_METHOD(TestFontInitializedInCtor);
+        TEST_METHOD(TestUpdateSettingsOnlyAppliesChanges);
 
         TEST_METHOD(TestClearScrollback);
         TEST_METHOD(TestClearScreen);
@@ -41,6 +42,8 @@ namespace ControlUnitTests
         TEST_METHOD(TestSelectCommandSimple);
         TEST_METHOD(TestSelectOutputSimple);
 
+        TEST_METHOD(MeasureKeystrokeLatency);
+
         TEST_CLASS_SETUP(ModuleSetup)
         {
             winrt::init_apartment(winrt::apartment_type::single_threaded);
@@ -226,6 +229,43 @@ namespace ControlUnitTests
         VERIFY_ARE_EQUAL(L"Impact", std::wstring_view{ core->_actualFont.GetFaceName() });
     }
 
+    void ControlCoreTests::TestUpdateSettingsOnlyAppliesChanges()
+    {
+        auto [settings, conn] = _createSettingsAndConnection();
+        auto core = createCore(*settings, *conn);
+        VERIFY_IS_NOT_NULL(core);
+        _standardInit(core);
+
+        Log::Comment(L"Reloading the same settings shouldn't change anything");
+        VERIFY_ARE_EQUAL(Control::SettingsChanges::None, core->UpdateSettings(*settings, *settings));
+
+        Log::Comment(L"Equal font features should compare equal, even if they're different instances");
+        auto features = winrt::single_threaded_map<winrt::hstring, uint32_t>();
+        features.Insert(L"calt", 0);
+        settings->FontFeatures(features);
+        VERIFY_ARE_EQUAL(Control::SettingsChanges::Font, core->UpdateSettings(*settings, *settings));
+        auto sameFeatures = winrt::single_threaded_map<winrt::hstring, uint32_t>();
+        sameFeatures.Insert(L"calt", 0);
+        settings->FontFeatures(sameFeatures);
+        VERIFY_ARE_EQUAL(Control::SettingsChanges::None, core->UpdateSettings(*settings, *settings));
+
+        Log::Comment(L"Changing the font face should only reload the font");
+        settings->FontFace(L"Impact");
+        VERIFY_ARE_EQUAL(Control::SettingsChanges::Font, core->UpdateSettings(*settings, *settings));
+        VERIFY_ARE_EQUAL(L"Impact", std::wstring_view{ core->_actualFont.GetFaceName() });
+
+        Log::Comment(L"Changing a color should only change the appearance");
+        settings->DefaultBackground(til::color{ 0x12, 0x34, 0x56 });
+        VERIFY_ARE_EQUAL(Control::SettingsChanges::Appearance, core->UpdateSettings(*settings, *settings));
+
+        Log::Comment(L"Changing a core setting should be reported as such");
+        settings->SnapOnInput(!settings->SnapOnInput());
+        VERIFY_ARE_EQUAL(Control::SettingsChanges::Core, core->UpdateSettings(*settings, *settings));
+
+        Log::Comment(L"Dropping the unfocused appearance should change the appearance");
+        VERIFY_ARE_EQUAL(Control::SettingsChanges::Appearance, core->UpdateSettings(*settings, nullptr));
+    }
+
     void ControlCoreTests::TestClearScrollback()
     {
         auto [settings, conn] = _createSettingsAndConnection();
@@ -499,4 +539,71 @@ namespace ControlUnitTests
             VERIFY_ARE_EQUAL(expectedEnd, end);
         }
     }
+
+    void ControlCoreTests::MeasureKeystrokeLatency()
+    {
+        using clock = std::chrono::steady_clock;
+        static constexpr size_t iterations = 1000;
+
+        auto [settings, conn] = _createSettingsAndConnection();
+        Log::Comment(L"Create ControlCore object");
+        auto core = createCore(*settings, *conn);
+        VERIFY_IS_NOT_NULL(core);
+        _standardInit(core);
+
+        // Every key press goes through the same stages: the key event is encoded
+        // by the Terminal, written to the (echo) connection, the echo is parsed
+        // into the buffer, and finally the frame is painted.
+        clock::time_point written;
+        clock::time_point parsed;
+        conn->InputWritten = [&](auto&&) { written = clock::now(); };
+        conn->InputEchoed = [&](auto&&) { parsed = clock::now(); };
+
+        std::vector<clock::duration> toWritten;
+        std::vector<clock::duration> toParsed;
+        std::vector<clock::duration> toPainted;
+        toWritten.reserve(iterations);
+        toParsed.reserve(iterations);
+        toPainted.reserve(iterations);
+
+        for (size_t i = 0; i < iterations; i++)
+        {
+            // Cycle through a-z, with a carriage return in between, so that
+            // the text keeps wrapping around the same line.
+            const auto ch = i % 27 == 26 ? L'\r' : gsl::narrow_cast<wchar_t>(L'a' + i % 27);
+
+            const auto pressed = clock::now();
+            VERIFY_IS_TRUE(core->SendCharEvent(ch, 0, {}));
+            LOG_IF_FAILED(core->_renderer->PaintFrame());
+            const auto painted = clock::now();
+
+            toWritten.emplace_back(written - pressed);
+            toParsed.emplace_back(parsed - pressed);
+            toPainted.emplace_back(painted - pressed);
+        }
+
+        const auto percentile = [](std::vector<clock::duration>& samples, const size_t p) {
+            const auto nth = samples.begin() + (samples.size() - 1) * p / 100;
+            std::nth_element(samples.begin(), nth, samples.end());
+            return std::chrono::duration<double, std::micro>(*nth).count();
+        };
+        const auto report = [&](const wchar_t* stage, std::vector<clock::duration>& samples) {
+            const auto p50 = percentile(samples, 50);
+            const auto p99 = percentile(samples, 99);
+            Log::Comment(NoThrowString().Format(L"key -> %s: p50 = %.1fus, p99 = %.1fus", stage, p50, p99));
+            return p50;
+        };
+
+        const auto writtenP50 = report(L"written", toWritten);
+        const auto parsedP50 = report(L"parsed", toParsed);
+        const auto paintedP50 = report(L"painted", toPainted);
+
+        Log::Comment(L"The stages must have happened in order.");
+        VERIFY_IS_LESS_THAN_OR_EQUAL(writtenP50, parsedP50);
+        VERIFY_IS_LESS_THAN_OR_EQUAL(parsedP50, paintedP50);
+
+        Log::Comment(L"The echoed keys must have ended up in the buffer.");
+        const auto text = core->ReadEntireBuffer();
+        VERIFY_ARE_NOT_EQUAL(std::wstring_view::npos, std::wstring_view{ text }.find(L"abcdefghijklmnopqrstuvwxyz"));
+    }
 }
@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "../../audio/midi/MidiAudio.hpp"
+#include "../../cascadia/TerminalCore/Terminal.hpp"
+#include "../../renderer/inc/DummyRenderer.hpp"
+
+using namespace std::chrono_literals;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+using namespace WEX::Common;
+using namespace Microsoft::Terminal::Core;
+
+namespace ControlUnitTests
+{
+    class MidiAudioTests
+    {
+        TEST_CLASS(MidiAudioTests);
+
+        TEST_METHOD(PlaysNotesBackToBack);
+        TEST_METHOD(DropsNotesBeyondLimit);
+        TEST_METHOD(SkipIgnoresNotes);
+        TEST_METHOD(HardResetFlushesNotes);
+
+        static std::unique_ptr<MidiAudio::Output> _nullOutput()
+        {
+            return std::make_unique<MidiAudio::NullOutput>();
+        }
+
+        // Waits for the sequencer to pick up the notes that were queued so far.
+        static void _waitUntilDequeued(const MidiAudio& midiAudio)
+        {
+            for (auto i = 0; i < 5000 && midiAudio.QueuedNotes() != 0; ++i)
+            {
+                Sleep(1);
+            }
+            VERIFY_ARE_EQUAL(0u, midiAudio.QueuedNotes());
+        }
+    };
+
+    void MidiAudioTests::PlaysNotesBackToBack()
+    {
+        MidiAudio midiAudio{ _nullOutput() };
+
+        Log::Comment(L"Queuing notes doesn't wait for them to be played.");
+        const auto start = std::chrono::steady_clock::now();
+        for (auto i = 0; i < 4; ++i)
+        {
+            midiAudio.PlayNote(nullptr, 72 + i, 127, 25ms);
+        }
+        VERIFY_IS_FALSE(midiAudio.WaitUntilIdle(0ms));
+
+        Log::Comment(L"They're played one after another for their full duration.");
+        VERIFY_IS_TRUE(midiAudio.WaitUntilIdle(5s));
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        VERIFY_IS_GREATER_THAN_OR_EQUAL(elapsed.count(), 100);
+    }
+
+    void MidiAudioTests::DropsNotesBeyondLimit()
+    {
+        MidiAudio midiAudio{ _nullOutput() };
+
+        // This note keeps the sequencer busy for the rest of the test.
+        midiAudio.PlayNote(nullptr, 72, 127, 1h);
+        _waitUntilDequeued(midiAudio);
+
+        Log::Comment(L"Notes played while the queue is full are dropped.");
+        for (size_t i = 0; i < MidiAudio::MaxQueuedNotes + 10; ++i)
+        {
+            midiAudio.PlayNote(nullptr, 72, 127, 1ms);
+        }
+        VERIFY_ARE_EQUAL(MidiAudio::MaxQueuedNotes, midiAudio.QueuedNotes());
+        VERIFY_IS_FALSE(midiAudio.WaitUntilIdle(50ms));
+
+        Log::Comment(L"Flushing discards the queue and interrupts the current note.");
+        midiAudio.Flush();
+        VERIFY_ARE_EQUAL(0u, midiAudio.QueuedNotes());
+        VERIFY_IS_TRUE(midiAudio.WaitUntilIdle(5s));
+
+        Log::Comment(L"Afterwards, notes are played as usual.");
+        midiAudio.PlayNote(nullptr, 72, 127, 1ms);
+        VERIFY_IS_TRUE(midiAudio.WaitUntilIdle(5s));
+    }
+
+    void MidiAudioTests::SkipIgnoresNotes()
+    {
+        MidiAudio midiAudio{ _nullOutput() };
+
+        midiAudio.PlayNote(nullptr, 72, 127, 1h);
+        midiAudio.PlayNote(nullptr, 72, 127, 1h);
+
+        Log::Comment(L"Skipping interrupts the current note, like Flush().");
+        midiAudio.BeginSkip();
+        VERIFY_ARE_EQUAL(0u, midiAudio.QueuedNotes());
+        VERIFY_IS_TRUE(midiAudio.WaitUntilIdle(5s));
+
+        Log::Comment(L"Notes are ignored until the skip ends.");
+        midiAudio.PlayNote(nullptr, 72, 127, 1h);
+        VERIFY_ARE_EQUAL(0u, midiAudio.QueuedNotes());
+        VERIFY_IS_TRUE(midiAudio.WaitUntilIdle(0ms));
+
+        midiAudio.EndSkip();
+        midiAudio.PlayNote(nullptr, 72, 127, 1ms);
+        VERIFY_IS_TRUE(midiAudio.WaitUntilIdle(5s));
+    }
+
+    void MidiAudioTests::HardResetFlushesNotes()
+    {
+        MidiAudio midiAudio{ _nullOutput() };
+
+        // This is how ControlCore connects the terminal to its MidiAudio.
+        Terminal term;
+        DummyRenderer renderer{ &term };
+        term.Create({ 80, 32 }, 0, renderer);
+        term.SetPlayMidiNoteCallback([&](const int noteNumber, const int velocity, const std::chrono::microseconds duration) {
+            midiAudio.PlayNote(nullptr, noteNumber, velocity, std::chrono::duration_cast<std::chrono::milliseconds>(duration));
+        });
+        term.SetFlushMidiNotesCallback([&]() { midiAudio.Flush(); });
+
+        Log::Comment(L"DECPS queues about a minute of music.");
+        term.Write(L"\x1b[7;255;1;3;5;6;8;10;12;13,~");
+        VERIFY_IS_FALSE(midiAudio.WaitUntilIdle(50ms));
+
+        Log::Comment(L"RIS stops it right away.");
+        term.Write(L"\x1b"
+                   L"c");
+        VERIFY_ARE_EQUAL(0u, midiAudio.QueuedNotes());
+        VERIFY_IS_TRUE(midiAudio.WaitUntilIdle(5s));
+    }
+}
@@ -18,13 +18,26 @@ namespace ControlUnitTests
         void Start() noexcept {};
         void WriteInput(const winrt::hstring& data)
         {
+            if (InputWritten)
+            {
+                InputWritten(data);
+            }
             _TerminalOutputHandlers(data);
+            if (InputEchoed)
+            {
+                InputEchoed(data);
+            }
         }
         void Resize(uint32_t /*rows*/, uint32_t /*columns*/) noexcept {}
         void Close() noexcept {}
 
         winrt::Microsoft::Terminal::TerminalConnection::ConnectionState State() const noexcept { return winrt::Microsoft::Terminal::TerminalConnection::ConnectionState::Connected; }
 
+        // Optional hooks for tests that want to observe the input. InputWritten is
+        // called when the input arrives, InputEchoed once the echo has been handled.
+        std::function<void(const winrt::hstring&)> InputWritten;
+        std::function<void(const winrt::hstring&)> InputEchoed;
+
         WINRT_CALLBACK(TerminalOutput, winrt::Microsoft::Terminal::TerminalConnection::TerminalOutputHandler);
         TYPED_EVENT(StateChanged, winrt::Microsoft::Terminal::TerminalConnection::ITerminalConnection, IInspectable);
     };
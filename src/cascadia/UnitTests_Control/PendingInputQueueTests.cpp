@@ -0,0 +1,152 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include <PendingInputQueue.h>
+
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+using namespace WEX::Common;
+
+namespace ControlUnitTests
+{
+    class PendingInputQueueTests
+    {
+        TEST_CLASS(PendingInputQueueTests);
+
+        TEST_METHOD(CoalescesText);
+        TEST_METHOD(SignalsKeepTheirOrder);
+        TEST_METHOD(BacklogKeepsAllInput);
+        TEST_METHOD(ShutdownDiscardsInput);
+
+        // Writes all pending items the way ConptyConnection's input thread does and returns their text.
+        // The callback is invoked for every item that ends the backlog.
+        static std::string _drain(PendingInputQueue& queue, const std::function<void()>& backlogEnded = nullptr)
+        {
+            std::string written;
+            while (queue.PendingBytes() != 0)
+            {
+                auto item = queue.Pop();
+                VERIFY_IS_TRUE(item.has_value());
+                if (item->signal)
+                {
+                    item->signal();
+                }
+                written.append(item->text);
+                if (queue.Done(std::move(*item)) && backlogEnded)
+                {
+                    backlogEnded();
+                }
+            }
+            return written;
+        }
+    };
+
+    void PendingInputQueueTests::CoalescesText()
+    {
+        PendingInputQueue queue;
+
+        Log::Comment(L"Keystrokes that the client didn't read yet are written at once.");
+        for (const auto ch : std::string_view{ "hello" })
+        {
+            auto buffer = queue.TakeBuffer();
+            buffer.push_back(ch);
+            VERIFY_IS_FALSE(queue.PushText(std::move(buffer)));
+        }
+        VERIFY_ARE_EQUAL(5u, queue.PendingBytes());
+
+        auto item = queue.Pop();
+        VERIFY_IS_TRUE(item.has_value());
+        VERIFY_ARE_EQUAL(std::string{ "hello" }, item->text);
+        VERIFY_IS_FALSE(queue.Done(std::move(*item)));
+        VERIFY_ARE_EQUAL(0u, queue.PendingBytes());
+
+        Log::Comment(L"Buffers passed to Done() are reused.");
+        const auto buffer = queue.TakeBuffer();
+        VERIFY_IS_TRUE(buffer.empty());
+        VERIFY_IS_GREATER_THAN_OR_EQUAL(buffer.capacity(), 5u);
+    }
+
+    void PendingInputQueueTests::SignalsKeepTheirOrder()
+    {
+        PendingInputQueue queue;
+        std::string order;
+
+        Log::Comment(L"Without any pending input, signals run right away.");
+        std::function<void()> signal = [&]() { order.append("1"); };
+        VERIFY_IS_FALSE(queue.PushSignal(signal));
+        signal();
+
+        Log::Comment(L"Otherwise they run after the input that was written before them.");
+        queue.PushText("a");
+        signal = [&]() { order.append("2"); };
+        VERIFY_IS_TRUE(queue.PushSignal(signal));
+        queue.PushText("b");
+
+        for (auto i = 0; i < 3; ++i)
+        {
+            auto item = queue.Pop();
+            VERIFY_IS_TRUE(item.has_value());
+            if (item->signal)
+            {
+                item->signal();
+            }
+            order.append(item->text);
+            queue.Done(std::move(*item));
+        }
+        VERIFY_ARE_EQUAL(std::string{ "1a2b" }, order);
+        VERIFY_ARE_EQUAL(0u, queue.PendingBytes());
+    }
+
+    void PendingInputQueueTests::BacklogKeepsAllInput()
+    {
+        PendingInputQueue queue;
+
+        Log::Comment(L"A paste that's larger than the backlog limit is kept in full.");
+        std::string expected;
+        auto backlogs = 0;
+        for (size_t i = 0; expected.size() <= 4 * PendingInputQueue::BacklogBytes; ++i)
+        {
+            auto line = std::to_string(i);
+            line.append(1000, 'x').append("\r");
+            expected.append(line);
+            backlogs += queue.PushText(std::move(line)) ? 1 : 0;
+        }
+
+        Log::Comment(L"The queue became backlogged exactly once.");
+        VERIFY_ARE_EQUAL(1, backlogs);
+        VERIFY_IS_TRUE(queue.Backlogged());
+        VERIFY_ARE_EQUAL(expected.size(), queue.PendingBytes());
+
+        Log::Comment(L"It stays backlogged until everything has been written.");
+        auto ended = 0;
+        const auto written = _drain(queue, [&]() {
+            VERIFY_ARE_EQUAL(0u, queue.PendingBytes());
+            ++ended;
+        });
+        VERIFY_ARE_EQUAL(1, ended);
+        VERIFY_IS_FALSE(queue.Backlogged());
+        VERIFY_ARE_EQUAL(expected, written);
+    }
+
+    void PendingInputQueueTests::ShutdownDiscardsInput()
+    {
+        PendingInputQueue queue;
+        while (!queue.PushText(std::string(1024, 'x')))
+        {
+        }
+        VERIFY_IS_TRUE(queue.Backlogged());
+
+        queue.Shutdown();
+        VERIFY_IS_FALSE(queue.Backlogged());
+        VERIFY_ARE_EQUAL(0u, queue.PendingBytes());
+        VERIFY_IS_FALSE(queue.Pop().has_value());
+
+        Log::Comment(L"Input written after the shutdown is ignored until the queue is restarted.");
+        VERIFY_IS_FALSE(queue.PushText("a"));
+        VERIFY_ARE_EQUAL(0u, queue.PendingBytes());
+        queue.Restart();
+        queue.PushText("a");
+        VERIFY_ARE_EQUAL(std::string{ "a" }, _drain(queue));
+    }
+}
@@ -0,0 +1,185 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include "../../renderer/uia/UiaRenderer.hpp"
+#include "../../types/IUiaEventDispatcher.h"
+
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+using namespace WEX::Common;
+using namespace Microsoft::Console::Render;
+
+namespace ControlUnitTests
+{
+    // Records the notifications an automation client would receive.
+    struct MockUiaEventDispatcher : Microsoft::Console::Types::IUiaEventDispatcher
+    {
+        void SignalSelectionChanged() override {}
+        void SignalTextChanged() override {}
+        void SignalCursorChanged() override {}
+        void NotifyNewOutput(std::wstring_view newOutput) override
+        {
+            announced.append(newOutput);
+            ++notifications;
+        }
+        void NotifyOutputOmitted(size_t omittedLength) override
+        {
+            omitted += omittedLength;
+        }
+
+        std::wstring announced;
+        size_t notifications = 0;
+        size_t omitted = 0;
+    };
+
+    class UiaEngineTests
+    {
+        TEST_CLASS(UiaEngineTests);
+
+        TEST_METHOD(AnnouncesNewOutput);
+        TEST_METHOD(SummarizesOmittedOutput);
+        TEST_METHOD(SchedulesSingleRedraw);
+        TEST_METHOD(SustainedOutputStaysBounded);
+
+        // Runs a frame the way the Renderer does.
+        static void _paint(UiaEngine& engine)
+        {
+            const auto hr = engine.StartPaint();
+            VERIFY_SUCCEEDED(hr);
+            if (hr == S_FALSE)
+            {
+                return;
+            }
+            VERIFY_SUCCEEDED(engine.EndPaint());
+            VERIFY_SUCCEEDED(engine.Present());
+        }
+    };
+
+    void UiaEngineTests::AnnouncesNewOutput()
+    {
+        MockUiaEventDispatcher dispatcher;
+        UiaEngine engine{ &dispatcher };
+        engine.SetNotificationInterval(std::chrono::milliseconds::zero());
+
+        VERIFY_SUCCEEDED(engine.NotifyNewText(L"hello"));
+        VERIFY_SUCCEEDED(engine.NotifyNewText(L"world"));
+        _paint(engine);
+        VERIFY_ARE_EQUAL(std::wstring{ L"hello\nworld\n" }, dispatcher.announced);
+        VERIFY_ARE_EQUAL(0u, dispatcher.omitted);
+
+        Log::Comment(L"Without new output there's nothing to announce.");
+        VERIFY_ARE_EQUAL(S_FALSE, engine.StartPaint());
+        VERIFY_ARE_EQUAL(1u, dispatcher.notifications);
+    }
+
+    void UiaEngineTests::SummarizesOmittedOutput()
+    {
+        MockUiaEventDispatcher dispatcher;
+        UiaEngine engine{ &dispatcher };
+        engine.SetNotificationInterval(std::chrono::milliseconds::zero());
+        engine.SetMaxQueuedOutput(100);
+
+        Log::Comment(L"Only the most recent lines are kept, starting at a line break.");
+        std::wstring expected;
+        for (auto i = 0; i < 50; ++i)
+        {
+            const auto line = fmt::format(L"line {:04}", i);
+            VERIFY_SUCCEEDED(engine.NotifyNewText(line));
+            expected.append(line).push_back(L'\n');
+        }
+        _paint(engine);
+
+        VERIFY_IS_LESS_THAN_OR_EQUAL(dispatcher.announced.size(), 100u);
+        VERIFY_IS_TRUE(expected.ends_with(dispatcher.announced));
+        VERIFY_IS_TRUE(dispatcher.announced.starts_with(L"line "));
+
+        Log::Comment(L"Everything else is summarized.");
+        VERIFY_ARE_EQUAL(expected.size() - dispatcher.announced.size(), dispatcher.omitted);
+
+        Log::Comment(L"A single large write supersedes everything before it.");
+        dispatcher = {};
+        VERIFY_SUCCEEDED(engine.NotifyNewText(L"before"));
+        VERIFY_SUCCEEDED(engine.NotifyNewText(std::wstring(150, L'x') + L"y"));
+        _paint(engine);
+        VERIFY_ARE_EQUAL(std::wstring(98, L'x') + L"y\n", dispatcher.announced);
+        VERIFY_ARE_EQUAL(7u + 52u, dispatcher.omitted);
+    }
+
+    void UiaEngineTests::SchedulesSingleRedraw()
+    {
+        static constexpr std::chrono::milliseconds interval{ 200 };
+
+        MockUiaEventDispatcher dispatcher;
+        UiaEngine engine{ &dispatcher };
+        engine.SetNotificationInterval(interval);
+
+        std::atomic<int> redraws{ 0 };
+        wil::unique_event redrawn{ wil::EventOptions::None };
+        engine.SetRedrawCallback([&]() {
+            ++redraws;
+            redrawn.SetEvent();
+        });
+
+        VERIFY_SUCCEEDED(engine.NotifyNewText(L"a"));
+        _paint(engine);
+        VERIFY_ARE_EQUAL(std::wstring{ L"a\n" }, dispatcher.announced);
+
+        Log::Comment(L"Output within the interval is held back and merged.");
+        VERIFY_SUCCEEDED(engine.NotifyNewText(L"b"));
+        _paint(engine);
+        VERIFY_SUCCEEDED(engine.NotifyNewText(L"c"));
+        _paint(engine);
+        VERIFY_ARE_EQUAL(1u, dispatcher.notifications);
+        VERIFY_ARE_EQUAL(0, redraws.load());
+
+        Log::Comment(L"A single redraw is requested once the interval has passed.");
+        VERIFY_IS_TRUE(redrawn.wait(5000));
+        _paint(engine);
+        VERIFY_ARE_EQUAL(std::wstring{ L"a\nb\nc\n" }, dispatcher.announced);
+        VERIFY_ARE_EQUAL(2u, dispatcher.notifications);
+
+        Log::Comment(L"No further redraws are requested after the output was announced.");
+        Sleep(static_cast<DWORD>(2 * interval.count()));
+        VERIFY_ARE_EQUAL(1, redraws.load());
+        VERIFY_ARE_EQUAL(S_FALSE, engine.StartPaint());
+    }
+
+    void UiaEngineTests::SustainedOutputStaysBounded()
+    {
+        // One second of 100 MB/s of UTF-16 output, rendered at 60 FPS.
+        static constexpr size_t frames = 60;
+        static constexpr size_t writeSize = 1000;
+        static constexpr size_t writesPerFrame = 100'000'000 / sizeof(wchar_t) / frames / writeSize;
+        static constexpr size_t maxQueuedOutput = 4000;
+        // Neither buffer ever holds more than a few times the budget, no matter how much is written.
+        static constexpr size_t maxCapacity = 6 * (maxQueuedOutput + writeSize);
+
+        MockUiaEventDispatcher dispatcher;
+        UiaEngine engine{ &dispatcher };
+        engine.SetMaxQueuedOutput(maxQueuedOutput);
+
+        const std::wstring line(writeSize - 1, L'x');
+        size_t written = 0;
+        for (size_t frame = 0; frame < frames; ++frame)
+        {
+            for (size_t i = 0; i < writesPerFrame; ++i)
+            {
+                VERIFY_SUCCEEDED(engine.NotifyNewText(line));
+                written += writeSize;
+            }
+            VERIFY_IS_LESS_THAN_OR_EQUAL(engine._newOutput.size(), 2 * maxQueuedOutput);
+            VERIFY_IS_LESS_THAN_OR_EQUAL(engine._newOutput.capacity(), maxCapacity);
+
+            _paint(engine);
+            VERIFY_IS_LESS_THAN_OR_EQUAL(engine._queuedOutput.size(), maxQueuedOutput);
+            VERIFY_IS_LESS_THAN_OR_EQUAL(engine._queuedOutput.capacity(), maxCapacity);
+        }
+
+        Log::Comment(L"Every character was either announced or counted as omitted.");
+        engine.SetNotificationInterval(std::chrono::milliseconds::zero());
+        _paint(engine);
+        VERIFY_IS_TRUE(engine._queuedOutput.empty());
+        VERIFY_ARE_EQUAL(written, dispatcher.announced.size() + dispatcher.omitted);
+    }
+}
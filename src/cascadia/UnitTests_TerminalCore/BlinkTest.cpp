@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include <WexTestClass.h>
+
+#include "../renderer/inc/DummyRenderer.hpp"
+#include "../renderer/base/Renderer.hpp"
+
+#include "../cascadia/TerminalCore/Terminal.hpp"
+#include "consoletaeftemplates.hpp"
+
+using namespace Microsoft::Terminal::Core;
+using namespace Microsoft::Console::Render;
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace
+{
+    // Like the real engines, this one resolves the colors of every attribute
+    // it's asked to draw, which is how the RenderSettings find out that
+    // blinking cells are being painted.
+    class MockBlinkRenderEngine final : public RenderEngineBase
+    {
+    public:
+        HRESULT StartPaint() noexcept { return S_OK; }
+        HRESULT EndPaint() noexcept { return S_OK; }
+        HRESULT Present() noexcept { return S_OK; }
+        HRESULT PrepareForTeardown(_Out_ bool* /*pForcePaint*/) noexcept { return S_OK; }
+        HRESULT ScrollFrame() noexcept { return S_OK; }
+        HRESULT Invalidate(const til::rect* /*psrRegion*/) noexcept { return S_OK; }
+        HRESULT InvalidateCursor(const til::rect* /*psrRegion*/) noexcept { return S_OK; }
+        HRESULT InvalidateSystem(const til::rect* /*prcDirtyClient*/) noexcept { return S_OK; }
+        HRESULT InvalidateSelection(const std::vector<til::rect>& /*rectangles*/) noexcept { return S_OK; }
+        HRESULT InvalidateScroll(const til::point* /*pcoordDelta*/) noexcept { return S_OK; }
+        HRESULT InvalidateAll() noexcept { return S_OK; }
+        HRESULT InvalidateCircling(_Out_ bool* /*pForcePaint*/) noexcept { return S_OK; }
+        HRESULT PaintBackground() noexcept { return S_OK; }
+        HRESULT PaintBufferLine(std::span<const Cluster> /*clusters*/, til::point /*coord*/, bool /*fTrimLeft*/, bool /*lineWrapped*/) noexcept { return S_OK; }
+        HRESULT PaintBufferGridLines(GridLineSet /*lines*/, COLORREF /*color*/, size_t /*cchLine*/, til::point /*coordTarget*/) noexcept { return S_OK; }
+        HRESULT PaintSelection(const til::rect& /*rect*/) noexcept { return S_OK; }
+        HRESULT PaintCursor(const CursorOptions& /*options*/) noexcept { return S_OK; }
+        HRESULT UpdateDrawingBrushes(const TextAttribute& textAttributes, const RenderSettings& renderSettings, gsl::not_null<IRenderData*> /*pData*/, bool /*usingSoftFont*/, bool /*isSettingDefaultBrushes*/) noexcept
+        {
+            renderSettings.GetAttributeColors(textAttributes);
+            return S_OK;
+        }
+        HRESULT UpdateFont(const FontInfoDesired& /*FontInfoDesired*/, _Out_ FontInfo& /*FontInfo*/) noexcept { return S_OK; }
+        HRESULT UpdateDpi(int /*iDpi*/) noexcept { return S_OK; }
+        HRESULT UpdateViewport(const til::inclusive_rect& /*srNewViewport*/) noexcept { return S_OK; }
+        HRESULT GetProposedFont(const FontInfoDesired& /*FontInfoDesired*/, _Out_ FontInfo& /*FontInfo*/, int /*iDpi*/) noexcept { return S_OK; }
+        HRESULT GetDirtyArea(std::span<const til::rect>& area) noexcept
+        {
+            area = { &_dirtyArea, 1 };
+            return S_OK;
+        }
+        HRESULT GetFontSize(_Out_ til::size* /*pFontSize*/) noexcept { return S_OK; }
+        HRESULT IsGlyphWideByFont(std::wstring_view /*glyph*/, _Out_ bool* /*pResult*/) noexcept { return S_OK; }
+
+    protected:
+        HRESULT _DoUpdateTitle(const std::wstring_view /*newTitle*/) noexcept { return S_OK; }
+
+    private:
+        til::rect _dirtyArea{ 0, 0, 80, 32 };
+    };
+}
+
+namespace TerminalCoreUnitTests
+{
+    class BlinkTest;
+};
+using namespace TerminalCoreUnitTests;
+
+class TerminalCoreUnitTests::BlinkTest final
+{
+    TEST_CLASS(BlinkTest);
+
+    TEST_METHOD(IdleBlinkTimerResumesOnce);
+};
+
+void BlinkTest::IdleBlinkTimerResumesOnce()
+{
+    Terminal term;
+    MockBlinkRenderEngine engine;
+    DummyRenderer renderer{ &term };
+    renderer.AddRenderEngine(&engine);
+    term.Create({ 80, 32 }, 0, renderer);
+
+    auto& renderSettings = renderer._renderSettings;
+    auto resumed = 0;
+    renderer.SetBlinkingResumedCallback([&]() { resumed++; });
+
+    Log::Comment(L"Painting blinking cells asks for the stopped blink timer to be started, once.");
+    term.Write(L"\x1b[5mX\x1b[m");
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+    VERIFY_ARE_EQUAL(1, resumed);
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+    VERIFY_ARE_EQUAL(1, resumed);
+
+    Log::Comment(L"While the cells are there, the timer keeps running.");
+    for (auto i = 0; i < 8; i++)
+    {
+        VERIFY_IS_TRUE(renderSettings.ToggleBlinkRendition(renderer));
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+    }
+
+    Log::Comment(L"Once they're gone, it stops at the end of the next cycle.");
+    term.Write(L"\x1b[2J");
+    auto ticks = 0;
+    while (renderSettings.ToggleBlinkRendition(renderer))
+    {
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+        VERIFY_IS_LESS_THAN(++ticks, 4);
+    }
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+    VERIFY_ARE_EQUAL(1, resumed);
+
+    Log::Comment(L"New blinking cells ask for it to be started again, once.");
+    term.Write(L"\x1b[5mY\x1b[m");
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+    VERIFY_ARE_EQUAL(2, resumed);
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+    VERIFY_ARE_EQUAL(2, resumed);
+
+    Log::Comment(L"After it was restarted, it blinks as before.");
+    VERIFY_IS_TRUE(renderSettings.ToggleBlinkRendition(renderer));
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+    VERIFY_ARE_EQUAL(2, resumed);
+}
@@ -0,0 +1,148 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "pch.h"
+#include <WexTestClass.h>
+
+#include "../PublicTerminalCore/HwndTerminal.hpp"
+#include "consoletaeftemplates.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace
+{
+    // "a", "é", "b", "€", "c", "😀", "d": characters that are 1, 2, 3 and 4 bytes long in UTF-8.
+    constexpr std::string_view output{ "a\xc3\xa9"
+                                       "b\xe2\x82\xac"
+                                       "c\xf0\x9f\x98\x80"
+                                       "d" };
+    const std::wstring expected{ L"a\u00e9b\u20acc\U0001F600d" };
+}
+
+namespace TerminalCoreUnitTests
+{
+    class HwndTerminalTests;
+};
+using namespace TerminalCoreUnitTests;
+
+class TerminalCoreUnitTests::HwndTerminalTests final
+{
+    TEST_CLASS(HwndTerminalTests);
+
+    TEST_CLASS_SETUP(ClassSetup)
+    {
+        _parent.reset(CreateWindowExW(0, L"STATIC", nullptr, WS_OVERLAPPEDWINDOW, 0, 0, 800, 600, nullptr, nullptr, nullptr, nullptr));
+        return _parent.is_valid();
+    }
+
+    TEST_METHOD_SETUP(MethodSetup)
+    {
+        void* hwnd = nullptr;
+        void* terminal = nullptr;
+        VERIFY_SUCCEEDED(CreateTerminal(_parent.get(), &hwnd, &terminal));
+        _hwndTerminal = static_cast<HwndTerminal*>(terminal);
+        return true;
+    }
+
+    TEST_METHOD_CLEANUP(MethodCleanup)
+    {
+        DestroyTerminal(std::exchange(_hwndTerminal, nullptr));
+        return true;
+    }
+
+    TEST_METHOD(SplitSequencesSingleChunk);
+    TEST_METHOD(SplitSequencesBatch);
+    TEST_METHOD(Utf16OutputDropsUnfinishedSequence);
+
+private:
+    // Clears the screen through the UTF-16 export, which also drops
+    // anything the previous UTF-8 output might have left unfinished.
+    void _clear() const
+    {
+        TerminalSendOutput(_hwndTerminal, L"\x1b[2J\x1b[H");
+    }
+
+    std::wstring _cursorRowText() const
+    {
+        const auto lock = _hwndTerminal->_terminal->LockForReading();
+        const auto& buffer = _hwndTerminal->_terminal->GetTextBuffer();
+        const auto text = buffer.GetRowByOffset(buffer.GetCursor().GetPosition().y).GetText();
+        return std::wstring{ text.substr(0, text.find_last_not_of(L' ') + 1) };
+    }
+
+    wil::unique_hwnd _parent;
+    HwndTerminal* _hwndTerminal = nullptr;
+};
+
+void HwndTerminalTests::SplitSequencesSingleChunk()
+{
+    Log::Comment(L"Split the output in two at every offset.");
+    for (size_t split = 1; split < output.size(); split++)
+    {
+        _clear();
+        TerminalSendOutputUtf8(_hwndTerminal, output.data(), split);
+        TerminalSendOutputUtf8(_hwndTerminal, output.data() + split, output.size() - split);
+        VERIFY_ARE_EQUAL(expected, _cursorRowText(), NoThrowString().Format(L"split at %zu", split));
+    }
+
+    Log::Comment(L"Write the output one byte at a time.");
+    _clear();
+    for (const auto& ch : output)
+    {
+        TerminalSendOutputUtf8(_hwndTerminal, &ch, 1);
+    }
+    VERIFY_ARE_EQUAL(expected, _cursorRowText());
+}
+
+void HwndTerminalTests::SplitSequencesBatch()
+{
+    Log::Comment(L"Split the output in three chunks at every pair of offsets, written in one batch.");
+    for (size_t first = 1; first < output.size(); first++)
+    {
+        for (size_t second = first; second < output.size(); second++)
+        {
+            const std::array<TerminalOutputChunk, 3> chunks{ {
+                { output.data(), first },
+                { output.data() + first, second - first },
+                { output.data() + second, output.size() - second },
+            } };
+            _clear();
+            TerminalSendOutputUtf8Batch(_hwndTerminal, chunks.data(), chunks.size());
+            VERIFY_ARE_EQUAL(expected, _cursorRowText(), NoThrowString().Format(L"split at %zu and %zu", first, second));
+        }
+    }
+
+    Log::Comment(L"Write the output one byte per chunk, with empty chunks in between.");
+    std::vector<TerminalOutputChunk> chunks;
+    for (const auto& ch : output)
+    {
+        chunks.push_back({ &ch, 1 });
+        chunks.push_back({ nullptr, 0 });
+    }
+    _clear();
+    TerminalSendOutputUtf8Batch(_hwndTerminal, chunks.data(), chunks.size());
+    VERIFY_ARE_EQUAL(expected, _cursorRowText());
+
+    Log::Comment(L"A character may also be split across two batches.");
+    for (size_t split = 1; split < chunks.size(); split++)
+    {
+        _clear();
+        TerminalSendOutputUtf8Batch(_hwndTerminal, chunks.data(), split);
+        TerminalSendOutputUtf8Batch(_hwndTerminal, chunks.data() + split, chunks.size() - split);
+        VERIFY_ARE_EQUAL(expected, _cursorRowText(), NoThrowString().Format(L"split at chunk %zu", split));
+    }
+}
+
+void HwndTerminalTests::Utf16OutputDropsUnfinishedSequence()
+{
+    _clear();
+    // The UTF-8 output ends in the middle of "€"...
+    TerminalSendOutputUtf8(_hwndTerminal, "x\xe2\x82", 3);
+    // ...which UTF-16 output can't complete.
+    TerminalSendOutput(_hwndTerminal, L"y");
+    // The unfinished "€" is dropped, instead of turning the next character into garbage.
+    TerminalSendOutputUtf8(_hwndTerminal, "z", 1);
+    VERIFY_ARE_EQUAL(std::wstring{ L"xyz" }, _cursorRowText());
+}
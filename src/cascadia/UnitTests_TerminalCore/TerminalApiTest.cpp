@@ -41,6 +41,8 @@ namespace TerminalCoreUnitTests
 
         TEST_METHOD(SetTaskbarProgress);
         TEST_METHOD(SetWorkingDirectory);
+
+        TEST_METHOD(PatternRescanSkipsUnchangedRows);
     };
 };
 
@@ -476,3 +478,55 @@ void TerminalCoreUnitTests::TerminalApiTest::SetWorkingDirectory()
     stateMachine.ProcessString(L"\x1b]9;9;D:\\中文\x1b\\");
     VERIFY_ARE_EQUAL(term.GetWorkingDirectory(), L"D:\\中文");
 }
+
+void TerminalApiTest::PatternRescanSkipsUnchangedRows()
+{
+    Terminal term;
+    DummyRenderer renderer{ &term };
+    term.Create({ 80, 32 }, 0, renderer);
+    term.UpdateSettings(winrt::make<MockTermSettings>(0, 32, 80));
+
+    auto& stateMachine = *(term._stateMachine);
+    const auto hasLinkAt = [&](const til::CoordType row) {
+        return term.GetHyperlinkIntervalFromViewportPosition({ 2, row }).has_value();
+    };
+
+    stateMachine.ProcessString(L"\r\nhttps://example.com\r\n");
+    term.UpdatePatternsUnderLock();
+    VERIFY_IS_TRUE(hasLinkAt(1));
+
+    Log::Comment(L"Without any changed rows the viewport isn't scanned again.");
+    // Removing the recognizers behind the terminal's back makes a rescan observable.
+    term._mainBuffer->ClearPatternRecognizers();
+    term.UpdatePatternsUnderLock();
+    VERIFY_IS_TRUE(hasLinkAt(1));
+
+    Log::Comment(L"A changed row triggers a rescan.");
+    stateMachine.ProcessString(L"foo");
+    term.UpdatePatternsUnderLock();
+    VERIFY_IS_FALSE(hasLinkAt(1));
+
+    Log::Comment(L"Changing the patterns drops the cache.");
+    term._updateUrlDetection();
+    VERIFY_IS_TRUE(hasLinkAt(1));
+
+    Log::Comment(L"Clearing the tree drops the cache.");
+    term.ClearPatternTree();
+    VERIFY_IS_FALSE(hasLinkAt(1));
+    VERIFY_IS_TRUE(term._patternRowCache.empty());
+    term.UpdatePatternsUnderLock();
+    VERIFY_IS_TRUE(hasLinkAt(1));
+
+    Log::Comment(L"Scrolling the link up drops the cache.");
+    stateMachine.ProcessString(std::wstring(30, L'\n'));
+    VERIFY_IS_FALSE(hasLinkAt(1));
+    VERIFY_IS_TRUE(term._patternRowCache.empty());
+    term.UpdatePatternsUnderLock();
+    VERIFY_IS_TRUE(hasLinkAt(0));
+    VERIFY_IS_FALSE(hasLinkAt(1));
+
+    Log::Comment(L"Switching to the alternate buffer drops the cache.");
+    stateMachine.ProcessString(L"\x1b[?1049h");
+    VERIFY_IS_FALSE(hasLinkAt(0));
+    VERIFY_IS_TRUE(term._patternRowCache.empty());
+}
@@ -53,6 +53,9 @@ class TerminalCoreUnitTests::TerminalBufferTests final
 
     TEST_METHOD(TestCursorNotifications);
 
+    TEST_METHOD(TestInteractiveResizeStorm);
+    TEST_METHOD(TestInteractiveResizeStormFullBuffer);
+
     TEST_METHOD_SETUP(MethodSetup)
     {
         // STEP 1: Set up the Terminal
@@ -72,6 +75,7 @@ class TerminalCoreUnitTests::TerminalBufferTests final
 private:
     void _SetTabStops(std::list<til::CoordType> columns, bool replace);
     std::list<til::CoordType> _GetTabStops();
+    void _InteractiveResizeStorm(const til::CoordType lineCount, const std::span<const til::CoordType> widths, const size_t expectedMarkCount);
 
     std::unique_ptr<DummyRenderer> emptyRenderer;
     std::unique_ptr<Terminal> term;
@@ -636,3 +640,111 @@ void TerminalBufferTests::TestCursorNotifications()
     VERIFY_ARE_EQUAL(0, expectedCallbacks);
     VERIFY_IS_TRUE(callbackWasCalled);
 }
+
+void TerminalBufferTests::TestInteractiveResizeStorm()
+{
+    static constexpr std::array<til::CoordType, 12> widths{ 78, 75, 71, 66, 60, 55, 58, 64, 72, 85, 96, 100 };
+    _InteractiveResizeStorm(5000, widths, 3);
+}
+
+void TerminalBufferTests::TestInteractiveResizeStormFullBuffer()
+{
+    // The scrollback is full and the final size is narrower than the initial one,
+    // so the buffer has to discard rows from the top when the resize is finished.
+    // The widths never get narrower than the final one before that, because
+    // rows that are discarded in between can't be restored by a full reflow either.
+    static constexpr std::array<til::CoordType, 6> widths{ 85, 96, 100, 90, 72, 60 };
+    Log::Comment(L"The mark at the top of the buffer is discarded along with its row.");
+    _InteractiveResizeStorm(12000, widths, 2);
+}
+
+void TerminalBufferTests::_InteractiveResizeStorm(const til::CoordType lineCount, const std::span<const til::CoordType> widths, const size_t expectedMarkCount)
+{
+    // This resizes two terminals through the same series of sizes, like
+    // dragging the window border would. One of them reflows its entire buffer
+    // every time, the other one only the rows around the viewport, until the
+    // interactive resize is finished. Both have to end up the same.
+    Terminal expected;
+    DummyRenderer expectedRenderer{ &expected };
+    expected.Create({ TerminalViewWidth, TerminalViewHeight }, 8000, expectedRenderer);
+
+    Terminal actual;
+    DummyRenderer actualRenderer{ &actual };
+    actual.Create({ TerminalViewWidth, TerminalViewHeight }, 8000, actualRenderer);
+
+    std::wstring output;
+    for (auto i = 0; i < lineCount; i++)
+    {
+        // Every 7th line is long enough to wrap in the narrower sizes.
+        output.append(L"line ");
+        output.append(std::to_wstring(i));
+        output.append(i % 7 == 0 ? 60 : 0, L'x');
+        output.append(L"\r\n");
+    }
+    expected.Write(output);
+    actual.Write(output);
+
+    // One mark near the top, one in the rows that the interactive resize
+    // skips and one in the rows around the viewport that it reflows right away.
+    const auto lastRow = actual.GetTextBuffer().GetCursor().GetPosition().y;
+    Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark mark;
+    for (auto terminal : { &expected, &actual })
+    {
+        for (const auto y : { 10, lastRow / 4, lastRow - 10 })
+        {
+            terminal->AddMark(mark, { 0, y }, { 4, y }, false);
+        }
+    }
+
+    const auto measure = [&](const wchar_t* name, auto&& resize) {
+        using namespace std::chrono;
+        duration<double, std::milli> total{};
+        duration<double, std::milli> slowest{};
+        for (const auto width : widths)
+        {
+            const auto start = steady_clock::now();
+            VERIFY_SUCCEEDED(resize(til::size{ width, TerminalViewHeight }));
+            const auto frame = steady_clock::now() - start;
+            total += frame;
+            slowest = std::max<duration<double, std::milli>>(slowest, frame);
+        }
+        Log::Comment(NoThrowString().Format(L"%s: %.2fms per resize on average, %.2fms at most",
+                                            name,
+                                            total.count() / widths.size(),
+                                            slowest.count()));
+    };
+
+    measure(L"Full reflow", [&](const til::size size) { return expected.UserResize(size); });
+    measure(L"Interactive resize", [&](const til::size size) { return actual.InteractiveResize(size); });
+
+    Log::Comment(L"During the interactive resize, only the rows around the viewport were reflowed.");
+    VERIFY_IS_TRUE(actual._deferredReflow.has_value());
+    VERIFY_IS_LESS_THAN(actual.GetTextBuffer().GetLastNonSpaceCharacter().y, 200);
+
+    VERIFY_SUCCEEDED(actual.FinishInteractiveResize());
+    VERIFY_IS_FALSE(actual._deferredReflow.has_value());
+
+    Log::Comment(L"Afterwards, both buffers have to be the same.");
+    const auto& expectedBuffer = expected.GetTextBuffer();
+    const auto& actualBuffer = actual.GetTextBuffer();
+    VERIFY_ARE_EQUAL(expectedBuffer.GetSize(), actualBuffer.GetSize());
+    VERIFY_ARE_EQUAL(expectedBuffer.GetCursor().GetPosition(), actualBuffer.GetCursor().GetPosition());
+    VERIFY_ARE_EQUAL(expected.GetViewport(), actual.GetViewport());
+    for (til::CoordType y = 0; y < expectedBuffer.TotalRowCount(); y++)
+    {
+        const auto& expectedRow = expectedBuffer.GetRowByOffset(y);
+        const auto& actualRow = actualBuffer.GetRowByOffset(y);
+        VERIFY_ARE_EQUAL(expectedRow.GetText(), actualRow.GetText());
+        VERIFY_ARE_EQUAL(expectedRow.WasWrapForced(), actualRow.WasWrapForced());
+    }
+
+    const auto& expectedMarks = expected.GetScrollMarks();
+    const auto& actualMarks = actual.GetScrollMarks();
+    VERIFY_ARE_EQUAL(expectedMarkCount, expectedMarks.size());
+    VERIFY_ARE_EQUAL(expectedMarkCount, actualMarks.size());
+    for (size_t i = 0; i < expectedMarks.size(); i++)
+    {
+        VERIFY_ARE_EQUAL(expectedMarks[i].start, actualMarks[i].start);
+        VERIFY_ARE_EQUAL(expectedMarks[i].end, actualMarks[i].end);
+    }
+}
@@ -0,0 +1,181 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+
+// PendingInputQueue holds the input that a connection has accepted, but
+// that its writer thread couldn't write yet, because the client isn't
+// reading it. Input is never dropped, no matter how much of it is pending.
+// Instead, once more than BacklogBytes are pending, the queue is considered
+// backlogged until it has been drained completely. The connection reports
+// this to the UI, so that the user can tell why nothing seems to happen.
+class PendingInputQueue
+{
+public:
+    // Either text to write or a signal (like a resize) to run in order with it.
+    struct Item
+    {
+        std::string text;
+        std::function<void()> signal;
+    };
+
+    // Once more than this much input is pending, the queue is backlogged.
+    static constexpr size_t BacklogBytes = 64 * 1024;
+    // Consecutive text is coalesced into a single item up to this size.
+    static constexpr size_t MaxCoalescedBytes = 4096;
+    static constexpr size_t MaxPooledBuffers = 8;
+
+    // Returns an empty buffer for the next call to PushText(), reusing
+    // the capacity of the ones that were passed to Done() before.
+    std::string TakeBuffer()
+    {
+        const std::scoped_lock lock{ _mutex };
+        if (_pool.empty())
+        {
+            return {};
+        }
+        auto buffer = std::move(_pool.back());
+        _pool.pop_back();
+        return buffer;
+    }
+
+    // Queues the given text. Returns true if the queue just became backlogged.
+    bool PushText(std::string&& text)
+    {
+        const std::scoped_lock lock{ _mutex };
+        if (_shutdown)
+        {
+            _recycle(std::move(text));
+            return false;
+        }
+
+        _bytes += text.size();
+
+        // Keystrokes arrive one at a time, but if the client is slow to read them,
+        // there's no point in writing them individually either.
+        if (!_items.empty() && !_items.back().signal && _items.back().text.size() + text.size() <= MaxCoalescedBytes)
+        {
+            _items.back().text.append(text);
+            _recycle(std::move(text));
+        }
+        else
+        {
+            _items.emplace_back(Item{ std::move(text), nullptr });
+        }
+
+        _cv.notify_one();
+
+        if (!_backlogged && _bytes > BacklogBytes)
+        {
+            _backlogged = true;
+            return true;
+        }
+        return false;
+    }
+
+    // Queues the given signal behind the pending input. Returns false if nothing is
+    // pending, in which case the signal is left untouched and should be run right away.
+    bool PushSignal(std::function<void()>& signal)
+    {
+        const std::scoped_lock lock{ _mutex };
+        if (!_busy && _items.empty())
+        {
+            return false;
+        }
+
+        _items.emplace_back(Item{ {}, std::move(signal) });
+        _cv.notify_one();
+        return true;
+    }
+
+    // Blocks until an item is pending and returns it, or nothing after Shutdown().
+    // The item counts as pending until it's passed to Done().
+    std::optional<Item> Pop()
+    {
+        std::unique_lock lock{ _mutex };
+        _cv.wait(lock, [&]() { return _shutdown || !_items.empty(); });
+        if (_shutdown)
+        {
+            return std::nullopt;
+        }
+
+        auto item = std::move(_items.front());
+        _items.pop_front();
+        _busy = true;
+        return item;
+    }
+
+    // Marks an item returned by Pop() as written. Returns true if this ended the backlog.
+    bool Done(Item&& item)
+    {
+        const std::scoped_lock lock{ _mutex };
+        _busy = false;
+        _bytes -= item.text.size();
+        _recycle(std::move(item.text));
+
+        if (_backlogged && _items.empty())
+        {
+            _backlogged = false;
+            return true;
+        }
+        return false;
+    }
+
+    bool Backlogged() const
+    {
+        const std::scoped_lock lock{ _mutex };
+        return _backlogged;
+    }
+
+    size_t PendingBytes() const
+    {
+        const std::scoped_lock lock{ _mutex };
+        return _bytes;
+    }
+
+    // Discards everything that's pending and makes Pop() return nothing until Restart().
+    void Shutdown()
+    {
+        {
+            const std::scoped_lock lock{ _mutex };
+            _shutdown = true;
+            _backlogged = false;
+            for (const auto& item : _items)
+            {
+                _bytes -= item.text.size();
+            }
+            _items.clear();
+        }
+        _cv.notify_all();
+    }
+
+    void Restart()
+    {
+        const std::scoped_lock lock{ _mutex };
+        _shutdown = false;
+    }
+
+private:
+    // Must be called with _mutex held.
+    void _recycle(std::string&& buffer)
+    {
+        if (_pool.size() < MaxPooledBuffers && buffer.capacity() <= MaxCoalescedBytes)
+        {
+            buffer.clear();
+            _pool.emplace_back(std::move(buffer));
+        }
+    }
+
+    mutable std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<Item> _items;
+    std::vector<std::string> _pool;
+    size_t _bytes = 0;
+    bool _busy = false;
+    bool _backlogged = false;
+    bool _shutdown = false;
+};
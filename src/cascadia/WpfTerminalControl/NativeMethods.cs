@@ -185,6 +185,12 @@ namespace Microsoft.Terminal.Wpf
         [DllImport("PublicTerminalCore.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.StdCall)]
         public static extern void TerminalSendOutput(IntPtr terminal, string lpdata);
 
+        [DllImport("PublicTerminalCore.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void TerminalSendOutputUtf8(IntPtr terminal, byte[] data, UIntPtr length);
+
+        [DllImport("PublicTerminalCore.dll", CallingConvention = CallingConvention.StdCall)]
+        public static extern void TerminalSendOutputUtf8Batch(IntPtr terminal, TerminalOutputChunk[] chunks, UIntPtr count);
+
         [DllImport("PublicTerminalCore.dll", CharSet = CharSet.Unicode, CallingConvention = CallingConvention.StdCall)]
         public static extern uint TerminalTriggerResize(IntPtr terminal, int width, int height, out TilSize dimensions);
 
@@ -298,6 +304,20 @@ namespace Microsoft.Terminal.Wpf
             /// </summary>
             public int Y;
         }
+
+        [StructLayout(LayoutKind.Sequential)]
+        public struct TerminalOutputChunk
+        {
+            /// <summary>
+            /// A pointer to the UTF-8 output, which must stay pinned for the duration of the call.
+            /// </summary>
+            public IntPtr Data;
+
+            /// <summary>
+            /// The length of the output in bytes.
+            /// </summary>
+            public UIntPtr Length;
+        }
     }
 #pragma warning restore SA1600 // Elements should be documented
 }
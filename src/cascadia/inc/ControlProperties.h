@@ -44,6 +44,7 @@
     X(bool, TrimBlockSelection, true)                                                                             \
     X(bool, SuppressApplicationTitle)                                                                             \
     X(bool, ForceVTInput, false)                                                                                  \
+    X(bool, CoalesceMouseMotion, false)                                                                           \
     X(winrt::hstring, StartingTitle)                                                                              \
     X(bool, DetectURLs, true)                                                                                     \
     X(bool, VtPassthrough, false)                                                                                 \
@@ -73,4 +74,6 @@
     X(bool, UseAtlasEngine, false)                                                                                                                       \
     X(bool, UseBackgroundImageForWindow, false)                                                                                                          \
     X(bool, ShowMarks, false)                                                                                                                            \
+    X(int32_t, MaxAnnouncedOutput, 4000)                                                                                                                 \
+    X(int32_t, AnnouncementInterval, 100)                                                                                                                \
     X(bool, RightClickContextMenu, false)
@@ -4,6 +4,7 @@
 #include "precomp.h"
 #include "../host/scrolling.hpp"
 #include "../interactivity/inc/ServiceLocator.hpp"
+#include "../renderer/inc/WakeupCounter.hpp"
 #pragma hdrstop
 
 using namespace Microsoft::Console;
@@ -19,6 +20,8 @@ static void CALLBACK CursorTimerRoutineWrapper(_Inout_ PTP_CALLBACK_INSTANCE /*I
     // But I'm not too concerned that this will lead to issues at the time of writing,
     // as CursorBlinker is allocated as a static variable through the Globals class.
     // It'd be nice to fix this, but realistically it'll likely not lead to issues.
+    WakeupCounter::Increment();
+
     gci.LockConsole();
     gci.GetCursorBlinker().TimerRoutine(gci.GetActiveOutputBuffer());
     gci.UnlockConsole();
@@ -55,17 +58,22 @@ void CursorBlinker::SettingsChanged() noexcept
     {
         KillCaretTimer();
         _uCaretBlinkTime = dwCaretBlinkTime;
-        SetCaretTimer();
+        if (_hasFocus)
+        {
+            SetCaretTimer();
+        }
     }
 }
 
-void CursorBlinker::FocusEnd() const noexcept
+void CursorBlinker::FocusEnd() noexcept
 {
+    _hasFocus = false;
     KillCaretTimer();
 }
 
-void CursorBlinker::FocusStart() const noexcept
+void CursorBlinker::FocusStart() noexcept
 {
+    _hasFocus = true;
     SetCaretTimer();
 }
 
@@ -20,8 +20,8 @@ namespace Microsoft::Console
         CursorBlinker();
         ~CursorBlinker();
 
-        void FocusStart() const noexcept;
-        void FocusEnd() const noexcept;
+        void FocusStart() noexcept;
+        void FocusEnd() noexcept;
 
         void UpdateSystemMetrics() noexcept;
         void SettingsChanged() noexcept;
@@ -33,5 +33,7 @@ namespace Microsoft::Console
 
         wil::unique_threadpool_timer_nowait _timer;
         UINT _uCaretBlinkTime;
+        // The timer only runs while we have focus, so that we don't wake up in the background.
+        bool _hasFocus = false;
     };
 }
@@ -3,6 +3,7 @@
 
 #include "precomp.h"
 #include "VtApiRoutines.h"
+#include "handle.h"
 #include "../interactivity/inc/ServiceLocator.hpp"
 #include "../types/inc/convert.hpp"
 
@@ -39,8 +40,70 @@ VtApiRoutines::VtApiRoutines() :
     m_outputMode(),
     m_pUsualRoutines(),
     m_pVtEngine(),
-    m_listeningForDSR(false)
+    m_listeningForDSR(false),
+    m_pipeWrites(0)
 {
+    _flushTimer = std::make_unique<til::throttled_func_trailing<>>(
+        s_flushDeadline,
+        [this]() {
+            FlushPending();
+        });
+}
+
+// Routine Description:
+// - Writes out the output that's still held back by the flush timer, so that the
+//   final writes of a client aren't lost.
+// - Must not be called with the console lock held: Destroying the timer waits for
+//   a callback that may be running, and that callback acquires the console lock.
+VtApiRoutines::~VtApiRoutines()
+{
+    assert(!ServiceLocator::LocateGlobals().getConsoleInformation().IsConsoleLocked());
+
+    _flushTimer.reset();
+    FlushPending();
+}
+
+// Routine Description:
+// - Writes any VT output accumulated by previous API calls to the pipe.
+// - This is called from the flush timer's threadpool thread as well, so the
+//   console lock guards the engine's buffer against concurrent API calls.
+void VtApiRoutines::FlushPending() noexcept
+{
+    LockConsole();
+    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
+    if (m_pVtEngine && !m_pVtEngine->_buffer.empty())
+    {
+        ++m_pipeWrites;
+        (void)m_pVtEngine->_Flush();
+    }
+}
+
+// Routine Description:
+// - Called at the end of every API that produces output. Instead of writing to
+//   the pipe immediately, we let output from consecutive calls accumulate in the
+//   engine's buffer and write it out once it grows past s_flushThreshold,
+//   s_flushDeadline has passed, or the client transitions into a read or wait.
+// - Ordering with input replies is preserved, because requests like DSR are
+//   appended to the same buffer and flushed along with everything before them.
+void VtApiRoutines::_FlushDeferred() noexcept
+{
+    if (m_pVtEngine->_buffer.size() >= s_flushThreshold)
+    {
+        FlushPending();
+    }
+    else
+    {
+        try
+        {
+            (*_flushTimer)();
+        }
+        catch (...)
+        {
+            LOG_CAUGHT_EXCEPTION();
+            FlushPending();
+        }
+    }
 }
 
 #pragma warning(push)
@@ -89,11 +152,16 @@ void VtApiRoutines::GetConsoleOutputModeImpl(SCREEN_INFORMATION& context,
 [[nodiscard]] HRESULT VtApiRoutines::GetNumberOfConsoleInputEventsImpl(const InputBuffer& context,
                                                                        ULONG& events) noexcept
 {
+    // Clients polling for input are at a read transition: push out pending output first.
+    FlushPending();
     return m_pUsualRoutines->GetNumberOfConsoleInputEventsImpl(context, events);
 }
 
 void VtApiRoutines::_SynchronizeCursor(std::unique_ptr<IWaitRoutine>& waiter) noexcept
 {
+    // A client about to read or wait expects everything it wrote so far to be visible.
+    FlushPending();
+
     // If we're about to tell the caller to wait, let's synchronize the cursor we have with what
     // the terminal is presenting in case there's a cooked read going on.
     // TODO GH#10001: we only need to do this in cooked read mode.
@@ -164,6 +232,7 @@ void VtApiRoutines::_SynchronizeCursor(std::unique_ptr<IWaitRoutine>& waiter) no
     // If we're about to tell the caller to wait, let's synchronize the cursor we have with what
     // the terminal is presenting in case there's a cooked read going on.
     // TODO GH10001: we only need to do this in cooked read mode.
+    FlushPending();
     if (clientHandle)
     {
         m_listeningForDSR = true;
@@ -188,6 +257,7 @@ void VtApiRoutines::_SynchronizeCursor(std::unique_ptr<IWaitRoutine>& waiter) no
     // If we're about to tell the caller to wait, let's synchronize the cursor we have with what
     // the terminal is presenting in case there's a cooked read going on.
     // TODO GH10001: we only need to do this in cooked read mode.
+    FlushPending();
     if (clientHandle)
     {
         m_listeningForDSR = true;
@@ -203,6 +273,9 @@ void VtApiRoutines::_SynchronizeCursor(std::unique_ptr<IWaitRoutine>& waiter) no
                                                        bool requiresVtQuirk,
                                                        std::unique_ptr<IWaitRoutine>& waiter) noexcept
 {
+    LockConsole();
+    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
     if (CP_UTF8 == m_outputCodepage)
     {
         (void)m_pVtEngine->WriteTerminalUtf8(buffer);
@@ -212,7 +285,7 @@ void VtApiRoutines::_SynchronizeCursor(std::unique_ptr<IWaitRoutine>& waiter) no
         (void)m_pVtEngine->WriteTerminalW(ConvertToW(m_outputCodepage, buffer));
     }
 
-    (void)m_pVtEngine->_Flush();
+    _FlushDeferred();
     read = buffer.size();
     return S_OK;
 }
@@ -223,8 +296,11 @@ void VtApiRoutines::_SynchronizeCursor(std::unique_ptr<IWaitRoutine>& waiter) no
                                                        bool requiresVtQuirk,
                                                        std::unique_ptr<IWaitRoutine>& waiter) noexcept
 {
+    LockConsole();
+    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
     (void)m_pVtEngine->WriteTerminalW(buffer);
-    (void)m_pVtEngine->_Flush();
+    _FlushDeferred();
     read = buffer.size();
     return S_OK;
 }
@@ -240,11 +316,14 @@ void VtApiRoutines::_SynchronizeCursor(std::unique_ptr<IWaitRoutine>& waiter) no
                                                                     const til::point startingCoordinate,
                                                                     size_t& cellsModified) noexcept
 {
+    LockConsole();
+    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
     (void)m_pVtEngine->_CursorPosition(startingCoordinate);
     (void)m_pVtEngine->_SetGraphicsRendition16Color(static_cast<BYTE>(attribute), true);
     (void)m_pVtEngine->_SetGraphicsRendition16Color(static_cast<BYTE>(attribute >> 4), false);
     (void)m_pVtEngine->_WriteFill(lengthToWrite, s_readBackAscii.Char.AsciiChar);
-    (void)m_pVtEngine->_Flush();
+    _FlushDeferred();
     cellsModified = lengthToWrite;
     return S_OK;
 }
@@ -255,13 +334,16 @@ void VtApiRoutines::_SynchronizeCursor(std::unique_ptr<IWaitRoutine>& waiter) no
                                                                      const til::point startingCoordinate,
                                                                      size_t& cellsModified) noexcept
 {
+    LockConsole();
+    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
     // I mean... if you get your jollies by using UTF8 for single byte codepoints...
     // we may as well skip a lot of conversion work and just write it out.
     if (m_outputCodepage == CP_UTF8 && character <= 0x7F)
     {
         (void)m_pVtEngine->_CursorPosition(startingCoordinate);
         (void)m_pVtEngine->_WriteFill(lengthToWrite, character);
-        (void)m_pVtEngine->_Flush();
+        _FlushDeferred();
         cellsModified = lengthToWrite;
         return S_OK;
     }
@@ -279,6 +361,9 @@ void VtApiRoutines::_SynchronizeCursor(std::unique_ptr<IWaitRoutine>& waiter) no
                                                                      size_t& cellsModified,
                                                                      const bool enablePowershellShim) noexcept
 {
+    LockConsole();
+    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
     (void)m_pVtEngine->_CursorPosition(startingCoordinate);
     const std::wstring_view sv{ &character, 1 };
 
@@ -289,7 +374,7 @@ void VtApiRoutines::_SynchronizeCursor(std::unique_ptr<IWaitRoutine>& waiter) no
         (void)m_pVtEngine->WriteTerminalW(sv);
     }
 
-    (void)m_pVtEngine->_Flush();
+    _FlushDeferred();
     cellsModified = lengthToWrite;
     return S_OK;
 }
@@ -333,8 +418,11 @@ void VtApiRoutines::GetConsoleCursorInfoImpl(const SCREEN_INFORMATION& context,
                                                               const ULONG size,
                                                               const bool isVisible) noexcept
 {
+    LockConsole();
+    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
     isVisible ? (void)m_pVtEngine->_ShowCursor() : (void)m_pVtEngine->_HideCursor();
-    (void)m_pVtEngine->_Flush();
+    _FlushDeferred();
     return S_OK;
 }
 
@@ -349,6 +437,9 @@ void VtApiRoutines::GetConsoleScreenBufferInfoExImpl(const SCREEN_INFORMATION& c
 [[nodiscard]] HRESULT VtApiRoutines::SetConsoleScreenBufferInfoExImpl(SCREEN_INFORMATION& context,
                                                                       const CONSOLE_SCREEN_BUFFER_INFOEX& data) noexcept
 {
+    LockConsole();
+    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
     (void)m_pVtEngine->_ResizeWindow(data.srWindow.Right - data.srWindow.Left, data.srWindow.Bottom - data.srWindow.Top);
     (void)m_pVtEngine->_CursorPosition(til::wrap_coord(data.dwCursorPosition));
     (void)m_pVtEngine->_SetGraphicsRendition16Color(static_cast<BYTE>(data.wAttributes), true);
@@ -356,7 +447,7 @@ void VtApiRoutines::GetConsoleScreenBufferInfoExImpl(const SCREEN_INFORMATION& c
     //color table?
     // popup attributes... hold internally?
     // TODO GH10001: popups are gonna erase the stuff behind them... deal with that somehow.
-    (void)m_pVtEngine->_Flush();
+    _FlushDeferred();
     return S_OK;
 }
 
@@ -370,6 +461,9 @@ void VtApiRoutines::GetConsoleScreenBufferInfoExImpl(const SCREEN_INFORMATION& c
 [[nodiscard]] HRESULT VtApiRoutines::SetConsoleCursorPositionImpl(SCREEN_INFORMATION& context,
                                                                   const til::point position) noexcept
 {
+    LockConsole();
+    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
     if (m_listeningForDSR)
     {
         context.GetActiveBuffer().GetTextBuffer().GetCursor().SetPosition(position);
@@ -378,7 +472,7 @@ void VtApiRoutines::GetConsoleScreenBufferInfoExImpl(const SCREEN_INFORMATION& c
     else
     {
         (void)m_pVtEngine->_CursorPosition(position);
-        (void)m_pVtEngine->_Flush();
+        _FlushDeferred();
     }
     return S_OK;
 }
@@ -416,9 +510,12 @@ void VtApiRoutines::GetLargestConsoleWindowSizeImpl(const SCREEN_INFORMATION& co
 [[nodiscard]] HRESULT VtApiRoutines::SetConsoleTextAttributeImpl(SCREEN_INFORMATION& context,
                                                                  const WORD attribute) noexcept
 {
+    LockConsole();
+    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
     (void)m_pVtEngine->_SetGraphicsRendition16Color(static_cast<BYTE>(attribute), true);
     (void)m_pVtEngine->_SetGraphicsRendition16Color(static_cast<BYTE>(attribute >> 4), false);
-    (void)m_pVtEngine->_Flush();
+    _FlushDeferred();
     return S_OK;
 }
 
@@ -426,8 +523,11 @@ void VtApiRoutines::GetLargestConsoleWindowSizeImpl(const SCREEN_INFORMATION& co
                                                               const bool isAbsolute,
                                                               const til::inclusive_rect& windowRect) noexcept
 {
+    LockConsole();
+    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
     (void)m_pVtEngine->_ResizeWindow(windowRect.right - windowRect.left + 1, windowRect.bottom - windowRect.top + 1);
-    (void)m_pVtEngine->_Flush();
+    _FlushDeferred();
     return S_OK;
 }
 
@@ -498,6 +598,9 @@ extern HRESULT _ConvertCellsToWInplace(const UINT codepage,
                                                              const Microsoft::Console::Types::Viewport& requestRectangle,
                                                              Microsoft::Console::Types::Viewport& writtenRectangle) noexcept
 {
+    LockConsole();
+    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
     auto cursor = requestRectangle.Origin();
 
     const size_t width = requestRectangle.Width();
@@ -520,7 +623,7 @@ extern HRESULT _ConvertCellsToWInplace(const UINT codepage,
         pos += width;
     }
 
-    (void)m_pVtEngine->_Flush();
+    _FlushDeferred();
 
     //TODO GH10001: trim to buffer size?
     writtenRectangle = requestRectangle;
@@ -532,6 +635,9 @@ extern HRESULT _ConvertCellsToWInplace(const UINT codepage,
                                                                      const til::point target,
                                                                      size_t& used) noexcept
 {
+    LockConsole();
+    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
     (void)m_pVtEngine->_CursorPosition(target);
 
     for (const auto& attr : attrs)
@@ -541,7 +647,7 @@ extern HRESULT _ConvertCellsToWInplace(const UINT codepage,
         (void)m_pVtEngine->WriteTerminalUtf8(std::string_view{ &s_readBackAscii.Char.AsciiChar, 1 });
     }
 
-    (void)m_pVtEngine->_Flush();
+    _FlushDeferred();
 
     used = attrs.size();
     return S_OK;
@@ -552,11 +658,14 @@ extern HRESULT _ConvertCellsToWInplace(const UINT codepage,
                                                                       const til::point target,
                                                                       size_t& used) noexcept
 {
+    LockConsole();
+    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
     if (m_outputCodepage == CP_UTF8)
     {
         (void)m_pVtEngine->_CursorPosition(target);
         (void)m_pVtEngine->WriteTerminalUtf8(text);
-        (void)m_pVtEngine->_Flush();
+        _FlushDeferred();
         return S_OK;
     }
     else
@@ -570,9 +679,12 @@ extern HRESULT _ConvertCellsToWInplace(const UINT codepage,
                                                                       const til::point target,
                                                                       size_t& used) noexcept
 {
+    LockConsole();
+    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
     (void)m_pVtEngine->_CursorPosition(target);
     (void)m_pVtEngine->WriteTerminalW(text);
-    (void)m_pVtEngine->_Flush();
+    _FlushDeferred();
     return S_OK;
 }
 
@@ -663,8 +775,11 @@ extern HRESULT _ConvertCellsToWInplace(const UINT codepage,
 
 [[nodiscard]] HRESULT VtApiRoutines::SetConsoleTitleWImpl(const std::wstring_view title) noexcept
 {
+    LockConsole();
+    auto Unlock = wil::scope_exit([&] { UnlockConsole(); });
+
     (void)m_pVtEngine->UpdateTitle(title);
-    (void)m_pVtEngine->_Flush();
+    _FlushDeferred();
     return S_OK;
 }
 
@@ -20,10 +20,13 @@ Revision History:
 #include "../server/IApiRoutines.h"
 #include "../renderer/vt/Xterm256Engine.hpp"
 
+#include <til/throttled_func.h>
+
 class VtApiRoutines : public IApiRoutines
 {
 public:
     VtApiRoutines();
+    ~VtApiRoutines();
 
 #pragma region ObjectManagement
     /*HRESULT CreateInitialObjects(_Out_ InputBuffer** const ppInputObject,
@@ -387,6 +390,20 @@ public:
     bool m_listeningForDSR;
     Microsoft::Console::Render::Xterm256Engine* m_pVtEngine;
 
+    // The number of times we've actually written to the pipe. Consecutive API
+    // calls are coalesced into a single write, see _FlushDeferred().
+    size_t m_pipeWrites;
+
+    // Output is written to the pipe once either this many bytes are pending,
+    // or s_flushDeadline has passed since the first pending write.
+    static constexpr size_t s_flushThreshold = 16 * 1024;
+    static constexpr std::chrono::milliseconds s_flushDeadline{ 8 };
+
+    void FlushPending() noexcept;
+
 private:
     void _SynchronizeCursor(std::unique_ptr<IWaitRoutine>& waiter) noexcept;
+    void _FlushDeferred() noexcept;
+
+    std::unique_ptr<til::throttled_func_trailing<>> _flushTimer;
 };
@@ -215,10 +215,8 @@ void WriteToScreen(SCREEN_INFORMATION& screenInfo, const Viewport& region)
 
     try
     {
-        TextAttribute useThisAttr(attribute);
-        const OutputCellIterator it(useThisAttr, lengthToWrite);
-        const auto done = screenBuffer.Write(it, startingCoordinate);
-        const auto cellsModifiedCoord = done.GetCellDistance(it);
+        const TextAttribute useThisAttr(attribute);
+        const auto cellsModifiedCoord = gsl::narrow_cast<til::CoordType>(screenBuffer.GetTextBuffer().FillCells(startingCoordinate, lengthToWrite, std::nullopt, useThisAttr));
 
         cellsModified = cellsModifiedCoord;
 
@@ -277,12 +275,9 @@ void WriteToScreen(SCREEN_INFORMATION& screenInfo, const Viewport& region)
     auto hr = S_OK;
     try
     {
-        const OutputCellIterator it(character, lengthToWrite);
-
         // when writing to the buffer, specifically unset wrap if we get to the last column.
         // a fill operation should UNSET wrap in that scenario. See GH #1126 for more details.
-        const auto done = screenInfo.Write(it, startingCoordinate, false);
-        const auto cellsModifiedCoord = done.GetInputDistance(it);
+        const auto cellsModifiedCoord = gsl::narrow_cast<til::CoordType>(screenInfo.GetTextBuffer().FillCells(startingCoordinate, lengthToWrite, character, std::nullopt));
 
         cellsModified = cellsModifiedCoord;
 
@@ -28,6 +28,58 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
 // Used by WriteCharsLegacy.
 #define IS_GLYPH_CHAR(wch) (((wch) >= L' ') && ((wch) != 0x007F))
 
+#ifdef UNIT_TESTING
+static bool g_writeCharsLegacyFastPath = true;
+
+void SetWriteCharsLegacyFastPath(const bool enabled) noexcept
+{
+    g_writeCharsLegacyFastPath = enabled;
+}
+#endif
+
+// Routine Description:
+// - Returns the number of leading characters in text that are printable ASCII (0x20-0x7E).
+//   Those are always narrow and have no special meaning to WriteCharsLegacy,
+//   which means that each of them maps to exactly one column.
+// Arguments:
+// - text - The string to scan.
+// Return Value:
+// - The length of the printable ASCII prefix of text.
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+static size_t CountPrintableAscii(const std::wstring_view& text) noexcept
+{
+    const auto beg = text.data();
+    const auto end = beg + text.size();
+    auto it = beg;
+
+#if defined(_M_AMD64) || defined(_M_IX86)
+    // Check 8 characters at a time. SSE2 only has signed 16-bit comparisons, but since
+    // code units >= 0x8000 are negative when treated as signed, they fail the first test.
+    const auto lowerBound = _mm_set1_epi16(0x1f);
+    const auto upperBound = _mm_set1_epi16(0x7f);
+    for (; end - it >= 8; it += 8)
+    {
+        const auto vec = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        const auto printable = _mm_and_si128(_mm_cmpgt_epi16(vec, lowerBound), _mm_cmplt_epi16(vec, upperBound));
+        const auto mask = static_cast<unsigned long>(_mm_movemask_epi8(printable));
+        if (mask != 0xffff)
+        {
+            // Each character corresponds to 2 bits in the mask.
+            unsigned long index;
+            _BitScanForward(&index, ~mask);
+            return gsl::narrow_cast<size_t>(it - beg) + index / 2;
+        }
+    }
+#endif
+
+    for (; it != end && *it >= L' ' && *it < 0x7f; ++it)
+    {
+    }
+    return gsl::narrow_cast<size_t>(it - beg);
+}
+#pragma warning(pop)
+
 // Routine Description:
 // - This routine updates the cursor position.  Its input is the non-special
 //   cased new location of the cursor.  For example, if the cursor were being
@@ -167,6 +219,12 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
     static constexpr til::CoordType LOCAL_BUFFER_SIZE = 1024;
     WCHAR LocalBuffer[LOCAL_BUFFER_SIZE];
 
+#ifdef UNIT_TESTING
+    const auto fFastPath = g_writeCharsLegacyFastPath;
+#else
+    static constexpr auto fFastPath = true;
+#endif
+
     while (*pcb < BufferSize)
     {
         // correct for delayed EOL
@@ -186,6 +244,63 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
             }
         }
 
+        // Printable ASCII doesn't need any of the per-character handling below: it's always
+        // a single column wide and never a control character. So we find the longest run of it
+        // and write it straight into the row, the same way the VT adapter prints text.
+        // The result is identical to what collecting the characters into LocalBuffer would produce.
+        if (fFastPath)
+        {
+            CursorPosition = cursor.GetPosition();
+            const auto columnsLeft = std::max(0, coordScreenBufferSize.width - CursorPosition.x);
+            const auto run = std::min(CountPrintableAscii({ pwchRealUnicode, (BufferSize - *pcb) / sizeof(WCHAR) }), gsl::narrow_cast<size_t>(columnsLeft));
+            if (run != 0)
+            {
+                const auto cch = gsl::narrow_cast<til::CoordType>(run);
+                RowWriteState state{
+                    .text = { pwchRealUnicode, run },
+                    .columnBegin = CursorPosition.x,
+                    .columnLimit = coordScreenBufferSize.width,
+                };
+
+                try
+                {
+                    auto& row = textBuffer.GetRowByOffset(CursorPosition.y);
+                    row.ReplaceText(state);
+                    row.ReplaceAttributes(state.columnBegin, state.columnEnd, Attributes);
+                    textBuffer.TriggerRedraw(Viewport::FromExclusive({ state.columnBeginDirty, CursorPosition.y, state.columnEndDirty, CursorPosition.y + 1 }));
+                }
+                catch (...)
+                {
+                    return NTSTATUS_FROM_HRESULT(wil::ResultFromCaughtException());
+                }
+
+                // Notify accessibility
+                if (screenInfo.HasAccessibilityEventing())
+                {
+                    screenInfo.NotifyAccessibilityEventing(CursorPosition.x, CursorPosition.y, CursorPosition.x + cch - 1, CursorPosition.y);
+                }
+
+                TempNumSpaces += run;
+                pwchBuffer += run;
+                lpString += run;
+                pwchRealUnicode += run;
+                *pcb += run * sizeof(WCHAR);
+
+                CursorPosition.x += cch;
+                Status = AdjustCursorPosition(screenInfo, CursorPosition, WI_IsFlagSet(dwFlags, WC_KEEP_CURSOR_VISIBLE), psScrollY);
+
+                if (*pcb == BufferSize)
+                {
+                    if (nullptr != pcSpaces)
+                    {
+                        *pcSpaces = TempNumSpaces;
+                    }
+                    return STATUS_SUCCESS;
+                }
+                continue;
+            }
+        }
+
         // As an optimization, collect characters in buffer and print out all at once.
         XPosition = cursor.GetPosition().x;
         til::CoordType i = 0;
@@ -930,8 +1045,9 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
         const auto codepage{ consoleInfo.OutputCP };
         auto leadByteCaptured{ false };
         auto leadByteConsumed{ false };
-        std::wstring wstr{};
-        static til::u8state u8State{};
+        auto isSingleByte{ false };
+        auto& wstr{ screenInfo.WriteConsoleConversionBuffer };
+        auto& u8State{ screenInfo.WriteConsoleUtf8State };
 
         // Convert our input parameters to Unicode
         if (codepage == CP_UTF8)
@@ -939,6 +1055,19 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
             RETURN_IF_FAILED(til::u8u16(buffer, wstr, u8State));
             read = buffer.size();
         }
+        else if (screenInfo.WriteConsoleSbcsDecoder.Initialize(codepage))
+        {
+            // In case the codepage changes from UTF-8 to another,
+            // we discard partials that might still be cached.
+            u8State.reset();
+            screenInfo.WriteConsoleDbcsLeadByte[0] = 0;
+
+            // Single-byte codepages map every byte to exactly one character.
+            // There are no lead bytes to carry over and no lengths to compute.
+            isSingleByte = true;
+            wstr.resize(buffer.size());
+            screenInfo.WriteConsoleSbcsDecoder.Decode(buffer, wstr.data());
+        }
         else
         {
             // In case the codepage changes from UTF-8 to another,
@@ -963,18 +1092,14 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
                 // and write the wide char to wcPtr[0]
                 screenInfo.WriteConsoleDbcsLeadByte[1] = gsl::narrow_cast<byte>(*mbPtr);
 
-                try
+                // Convert straight into our buffer instead of going through ConvertToW.
+                // A lead/trail byte pair that doesn't decode to exactly one character is treated as a failure.
+                if (MultiByteToWideChar(codepage, 0, reinterpret_cast<LPCCH>(screenInfo.WriteConsoleDbcsLeadByte), ARRAYSIZE(screenInfo.WriteConsoleDbcsLeadByte), wcPtr, 1) == 1)
                 {
-                    const auto wFromComplemented{
-                        ConvertToW(codepage, { reinterpret_cast<const char*>(screenInfo.WriteConsoleDbcsLeadByte), ARRAYSIZE(screenInfo.WriteConsoleDbcsLeadByte) })
-                    };
-
-                    FAIL_FAST_IF(wFromComplemented.size() != 1);
                     dbcsLength = sizeof(wchar_t);
-                    wcPtr[0] = wFromComplemented.at(0);
                     mbPtr++;
                 }
-                catch (...)
+                else
                 {
                     dbcsLength = 0;
                 }
@@ -1027,7 +1152,11 @@ using Microsoft::Console::VirtualTerminal::StateMachine;
         {
             // Calculate how many bytes of the original A buffer were consumed in the W version of the call to satisfy mbBufferRead.
             // For UTF-8 conversions, we've already returned this information above.
-            if (CP_UTF8 != codepage)
+            if (isSingleByte)
+            {
+                read = wcBufferWritten;
+            }
+            else if (CP_UTF8 != codepage)
             {
                 size_t mbBufferRead{};
 
@@ -77,6 +77,12 @@ Note:
                                         const DWORD dwFlags,
                                         _Inout_opt_ til::CoordType* const psScrollY);
 
+#ifdef UNIT_TESTING
+// Turns the printable ASCII fast path of WriteCharsLegacy on and off,
+// so that tests can compare it against the per-character implementation.
+void SetWriteCharsLegacyFastPath(const bool enabled) noexcept;
+#endif
+
 // The new entry point for WriteChars to act as an intercept in case we place a Virtual Terminal processor in the way.
 [[nodiscard]] NTSTATUS WriteChars(SCREEN_INFORMATION& screenInfo,
                                   _In_range_(<=, pwchBuffer) const wchar_t* const pwchBufferBackupLimit,
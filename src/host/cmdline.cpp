@@ -197,105 +197,184 @@ void CommandLine::EndAllPopups()
     }
 }
 
+// Routine Description:
+// - Blanks the echoed command line on the screen and moves the cursor back to where it started.
+// Arguments:
+// - cookedReadData - The cooked read data to operate on
+// - fUpdateFields - If true, the contents of the command line are discarded as well.
+//   Otherwise they're kept, so that RedrawCommandLine can bring the command line back.
 void DeleteCommandLine(COOKED_READ_DATA& cookedReadData, const bool fUpdateFields)
 {
-    auto CharsToWrite = cookedReadData.VisibleCharCount();
-    auto coordOriginalCursor = cookedReadData.OriginalCursorPosition();
-    const auto coordBufferSize = cookedReadData.ScreenInfo().GetBufferSize().Dimensions();
+    const auto visibleCharCount = cookedReadData.VisibleCharCount();
+    UpdateCommandLine(cookedReadData, {}, visibleCharCount, 0, WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS);
 
-    // catch the case where the current command has scrolled off the top of the screen.
-    if (coordOriginalCursor.y < 0)
+    if (fUpdateFields)
     {
-        CharsToWrite += coordBufferSize.width * coordOriginalCursor.y;
-        CharsToWrite += cookedReadData.OriginalCursorPosition().x; // account for prompt
-        cookedReadData.OriginalCursorPosition().x = 0;
-        cookedReadData.OriginalCursorPosition().y = 0;
-        coordOriginalCursor.x = 0;
-        coordOriginalCursor.y = 0;
+        cookedReadData.Erase();
     }
-
-    if (!CheckBisectStringW(cookedReadData.BufferStartPtr(),
-                            CharsToWrite,
-                            coordBufferSize.width - cookedReadData.OriginalCursorPosition().x))
+    else
     {
-        CharsToWrite++;
+        // The command line only got hidden, it still has the same length.
+        cookedReadData.VisibleCharCount() = visibleCharCount;
     }
+}
 
-    try
+// Routine Description:
+// - Moves the cursor from the end of the displayed command line back to the insertion point.
+// Arguments:
+// - cookedReadData - The cooked read data to operate on
+static void MoveCursorToInsertionPoint(COOKED_READ_DATA& cookedReadData)
+{
+    auto CursorPosition = cookedReadData.OriginalCursorPosition();
+    CursorPosition.x += RetrieveTotalNumberOfSpaces(cookedReadData.OriginalCursorPosition().x,
+                                                    cookedReadData.BufferStartPtr(),
+                                                    cookedReadData.InsertionPoint());
+    if (CheckBisectStringW(cookedReadData.BufferStartPtr(),
+                           cookedReadData.InsertionPoint(),
+                           cookedReadData.ScreenInfo().GetBufferSize().Width() - cookedReadData.OriginalCursorPosition().x))
     {
-        cookedReadData.ScreenInfo().Write(OutputCellIterator(UNICODE_SPACE, CharsToWrite), coordOriginalCursor);
+        CursorPosition.x++;
     }
-    CATCH_LOG();
+    FAIL_FAST_IF_NTSTATUS_FAILED(AdjustCursorPosition(cookedReadData.ScreenInfo(), CursorPosition, TRUE, nullptr));
+}
 
-    if (fUpdateFields)
+// Routine Description:
+// - Draws the command line at the current cursor position, after DeleteCommandLine hid it,
+//   and moves the cursor back to the insertion point.
+// Arguments:
+// - cookedReadData - The cooked read data to operate on
+void RedrawCommandLine(COOKED_READ_DATA& cookedReadData)
+{
+    if (cookedReadData.IsEchoInput())
     {
-        cookedReadData.Erase();
+        // Draw the command line. Nothing of it is on the screen anymore, so all of it is written.
+        cookedReadData.OriginalCursorPosition() = cookedReadData.ScreenInfo().GetTextBuffer().GetCursor().GetPosition();
+        UpdateCommandLine(cookedReadData, {}, 0);
+        MoveCursorToInsertionPoint(cookedReadData);
     }
+}
 
-    LOG_IF_FAILED(cookedReadData.ScreenInfo().SetCursorPosition(cookedReadData.OriginalCursorPosition(), true));
+// Routine Description:
+// - Brings the echoed command line on the screen up to date with the contents of the
+//   cooked read buffer, given what the buffer contained when it was last drawn.
+// - Only the cells starting at the first character that differs are rewritten and any
+//   leftover cells of the previous, longer command line are blanked. This keeps both the
+//   invalidated region and the amount of VT emitted over conpty proportional to the edit,
+//   instead of erasing and redrawing the whole (possibly multi-row) command line.
+// - On return the cursor is placed after the end of the command line.
+// Arguments:
+// - cookedReadData - The cooked read data to operate on. Its buffer holds the new contents.
+// - previous - The command line as it is currently displayed, or any prefix thereof.
+// - previousVisibleCharCount - The number of cells the displayed command line occupies.
+// Return Value:
+// - The number of rows the buffer scrolled by while writing the command line.
+til::CoordType UpdateCommandLine(COOKED_READ_DATA& cookedReadData,
+                                 const std::wstring_view previous,
+                                 const size_t previousVisibleCharCount) noexcept
+{
+    return UpdateCommandLine(cookedReadData,
+                             previous,
+                             previousVisibleCharCount,
+                             cookedReadData.BytesRead() / sizeof(WCHAR),
+                             WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS);
 }
 
-void RedrawCommandLine(COOKED_READ_DATA& cookedReadData)
+// Routine Description:
+// - Like the above, but only displays the first currentLength characters of the cooked read
+//   buffer, and passes the given flags on to WriteCharsLegacy.
+til::CoordType UpdateCommandLine(COOKED_READ_DATA& cookedReadData,
+                                 const std::wstring_view previous,
+                                 const size_t previousVisibleCharCount,
+                                 const size_t currentLength,
+                                 const DWORD dwFlags) noexcept
 {
+    auto& screenInfo = cookedReadData.ScreenInfo();
+    const auto bufferSize = screenInfo.GetBufferSize().Dimensions();
+    const std::wstring_view current{ cookedReadData.BufferStartPtr(), currentLength };
+    auto& originalCursorPosition = cookedReadData.OriginalCursorPosition();
+    auto oldCells = previousVisibleCharCount;
+
+    // The common prefix stays on screen as-is. We only skip over printable ASCII
+    // though, because every such character occupies exactly one cell. Tabs, control
+    // characters and wide glyphs depend on their column, so we rewrite from there on.
+    size_t prefix = 0;
     if (cookedReadData.IsEchoInput())
     {
-        // Draw the command line
-        cookedReadData.OriginalCursorPosition() = cookedReadData.ScreenInfo().GetTextBuffer().GetCursor().GetPosition();
+        const auto maxPrefix = std::min(previous.size(), current.size());
+        while (prefix < maxPrefix && previous[prefix] == current[prefix] && previous[prefix] >= L' ' && previous[prefix] <= L'~')
+        {
+            prefix++;
+        }
+    }
 
-        til::CoordType ScrollY = 0;
-#pragma prefast(suppress : 28931, "Status is not unused. It's used in debug assertions.")
-        auto Status = WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                       cookedReadData.BufferStartPtr(),
-                                       cookedReadData.BufferStartPtr(),
-                                       cookedReadData.BufferStartPtr(),
-                                       &cookedReadData.BytesRead(),
-                                       &cookedReadData.VisibleCharCount(),
-                                       cookedReadData.OriginalCursorPosition().x,
-                                       WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
-                                       &ScrollY);
-        FAIL_FAST_IF_NTSTATUS_FAILED(Status);
+    // catch the case where the current command has scrolled off the top of the screen.
+    if (originalCursorPosition.y < 0)
+    {
+        const auto offscreen = gsl::narrow_cast<size_t>(-originalCursorPosition.y) * bufferSize.width - originalCursorPosition.x;
+        oldCells = oldCells > offscreen ? oldCells - offscreen : 0;
+        originalCursorPosition = {};
+        prefix = 0;
+    }
+
+    const auto offset = originalCursorPosition.x + gsl::narrow_cast<til::CoordType>(prefix);
+    til::point position{ offset % bufferSize.width, originalCursorPosition.y + offset / bufferSize.width };
+    if (position.y >= bufferSize.height)
+    {
+        position = originalCursorPosition;
+        prefix = 0;
+    }
+    LOG_IF_FAILED(screenInfo.SetCursorPosition(position, true));
 
-        cookedReadData.OriginalCursorPosition().y += ScrollY;
+    size_t tailCells = 0;
+    til::CoordType ScrollY = 0;
+    if (cookedReadData.IsEchoInput() && current.size() > prefix)
+    {
+        auto bytesToWrite = (current.size() - prefix) * sizeof(WCHAR);
+        FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(screenInfo,
+                                                      cookedReadData.BufferStartPtr(),
+                                                      cookedReadData.BufferStartPtr() + prefix,
+                                                      cookedReadData.BufferStartPtr() + prefix,
+                                                      &bytesToWrite,
+                                                      &tailCells,
+                                                      originalCursorPosition.x,
+                                                      dwFlags,
+                                                      &ScrollY));
+        originalCursorPosition.y += ScrollY;
+    }
 
-        // Move the cursor back to the right position
-        auto CursorPosition = cookedReadData.OriginalCursorPosition();
-        CursorPosition.x += RetrieveTotalNumberOfSpaces(cookedReadData.OriginalCursorPosition().x,
-                                                        cookedReadData.BufferStartPtr(),
-                                                        cookedReadData.InsertionPoint());
-        if (CheckBisectStringW(cookedReadData.BufferStartPtr(),
-                               cookedReadData.InsertionPoint(),
-                               cookedReadData.ScreenInfo().GetBufferSize().Width() - cookedReadData.OriginalCursorPosition().x))
+    // Blank whatever is left of the previous command line. We clear one additional
+    // cell in case a wide glyph got bisected at the end of a row.
+    const auto newCells = prefix + tailCells;
+    if (oldCells != 0)
+    {
+        oldCells += 1;
+    }
+    if (oldCells > newCells)
+    {
+        try
         {
-            CursorPosition.x++;
+            const auto end = screenInfo.GetTextBuffer().GetCursor().GetPosition();
+            screenInfo.Write(OutputCellIterator(UNICODE_SPACE, oldCells - newCells), end);
         }
-        Status = AdjustCursorPosition(cookedReadData.ScreenInfo(), CursorPosition, TRUE, nullptr);
-        FAIL_FAST_IF_NTSTATUS_FAILED(Status);
+        CATCH_LOG();
     }
+
+    cookedReadData.VisibleCharCount() = newCells;
+    return ScrollY;
 }
 
 // Routine Description:
 // - This routine copies the commandline specified by Index into the cooked read buffer
 void SetCurrentCommandLine(COOKED_READ_DATA& cookedReadData, _In_ SHORT Index) // index, not command number
 {
-    DeleteCommandLine(cookedReadData, TRUE);
+    const std::wstring previous{ cookedReadData.BufferStartPtr(), cookedReadData.BytesRead() / sizeof(WCHAR) };
+    const auto previousVisibleCharCount = cookedReadData.VisibleCharCount();
+    cookedReadData.Erase();
     FAIL_FAST_IF_FAILED(cookedReadData.History().RetrieveNth(Index,
                                                              cookedReadData.SpanWholeBuffer(),
                                                              cookedReadData.BytesRead()));
     FAIL_FAST_IF(!(cookedReadData.BufferStartPtr() == cookedReadData.BufferCurrentPtr()));
-    if (cookedReadData.IsEchoInput())
-    {
-        til::CoordType ScrollY = 0;
-        FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                                      cookedReadData.BufferStartPtr(),
-                                                      cookedReadData.BufferCurrentPtr(),
-                                                      cookedReadData.BufferCurrentPtr(),
-                                                      &cookedReadData.BytesRead(),
-                                                      &cookedReadData.VisibleCharCount(),
-                                                      cookedReadData.OriginalCursorPosition().x,
-                                                      WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
-                                                      &ScrollY));
-        cookedReadData.OriginalCursorPosition().y += ScrollY;
-    }
+    UpdateCommandLine(cookedReadData, previous, previousVisibleCharCount);
 
     const auto CharsToWrite = cookedReadData.BytesRead() / sizeof(WCHAR);
     cookedReadData.InsertionPoint() = CharsToWrite;
@@ -441,25 +520,14 @@ void CommandLine::_processHistoryCycling(COOKED_READ_DATA& cookedReadData,
         return;
     }
 
-    DeleteCommandLine(cookedReadData, true);
+    const std::wstring previous{ cookedReadData.BufferStartPtr(), cookedReadData.BytesRead() / sizeof(WCHAR) };
+    const auto previousVisibleCharCount = cookedReadData.VisibleCharCount();
+    cookedReadData.Erase();
     THROW_IF_FAILED(cookedReadData.History().Retrieve(searchDirection,
                                                       cookedReadData.SpanWholeBuffer(),
                                                       cookedReadData.BytesRead()));
     FAIL_FAST_IF(!(cookedReadData.BufferStartPtr() == cookedReadData.BufferCurrentPtr()));
-    if (cookedReadData.IsEchoInput())
-    {
-        til::CoordType ScrollY = 0;
-        FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                                      cookedReadData.BufferStartPtr(),
-                                                      cookedReadData.BufferCurrentPtr(),
-                                                      cookedReadData.BufferCurrentPtr(),
-                                                      &cookedReadData.BytesRead(),
-                                                      &cookedReadData.VisibleCharCount(),
-                                                      cookedReadData.OriginalCursorPosition().x,
-                                                      WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
-                                                      &ScrollY));
-        cookedReadData.OriginalCursorPosition().y += ScrollY;
-    }
+    UpdateCommandLine(cookedReadData, previous, previousVisibleCharCount);
     const auto CharsToWrite = cookedReadData.BytesRead() / sizeof(WCHAR);
     cookedReadData.InsertionPoint() = CharsToWrite;
     cookedReadData.SetBufferCurrentPtr(cookedReadData.BufferStartPtr() + CharsToWrite);
@@ -475,26 +543,15 @@ void CommandLine::_setPromptToOldestCommand(COOKED_READ_DATA& cookedReadData)
 {
     if (cookedReadData.HasHistory() && cookedReadData.History().GetNumberOfCommands())
     {
-        DeleteCommandLine(cookedReadData, true);
+        const std::wstring previous{ cookedReadData.BufferStartPtr(), cookedReadData.BytesRead() / sizeof(WCHAR) };
+        const auto previousVisibleCharCount = cookedReadData.VisibleCharCount();
+        cookedReadData.Erase();
         const short commandNumber = 0;
         THROW_IF_FAILED(cookedReadData.History().RetrieveNth(commandNumber,
                                                              cookedReadData.SpanWholeBuffer(),
                                                              cookedReadData.BytesRead()));
         FAIL_FAST_IF(!(cookedReadData.BufferStartPtr() == cookedReadData.BufferCurrentPtr()));
-        if (cookedReadData.IsEchoInput())
-        {
-            til::CoordType ScrollY = 0;
-            FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                                          cookedReadData.BufferStartPtr(),
-                                                          cookedReadData.BufferCurrentPtr(),
-                                                          cookedReadData.BufferCurrentPtr(),
-                                                          &cookedReadData.BytesRead(),
-                                                          &cookedReadData.VisibleCharCount(),
-                                                          cookedReadData.OriginalCursorPosition().x,
-                                                          WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
-                                                          &ScrollY));
-            cookedReadData.OriginalCursorPosition().y += ScrollY;
-        }
+        UpdateCommandLine(cookedReadData, previous, previousVisibleCharCount);
         auto CharsToWrite = cookedReadData.BytesRead() / sizeof(WCHAR);
         cookedReadData.InsertionPoint() = CharsToWrite;
         cookedReadData.SetBufferCurrentPtr(cookedReadData.BufferStartPtr() + CharsToWrite);
@@ -509,32 +566,25 @@ void CommandLine::_setPromptToOldestCommand(COOKED_READ_DATA& cookedReadData)
 // - May throw exceptions
 void CommandLine::_setPromptToNewestCommand(COOKED_READ_DATA& cookedReadData)
 {
-    DeleteCommandLine(cookedReadData, true);
     if (cookedReadData.HasHistory() && cookedReadData.History().GetNumberOfCommands())
     {
+        const std::wstring previous{ cookedReadData.BufferStartPtr(), cookedReadData.BytesRead() / sizeof(WCHAR) };
+        const auto previousVisibleCharCount = cookedReadData.VisibleCharCount();
+        cookedReadData.Erase();
         const auto commandNumber = (SHORT)(cookedReadData.History().GetNumberOfCommands() - 1);
         THROW_IF_FAILED(cookedReadData.History().RetrieveNth(commandNumber,
                                                              cookedReadData.SpanWholeBuffer(),
                                                              cookedReadData.BytesRead()));
         FAIL_FAST_IF(!(cookedReadData.BufferStartPtr() == cookedReadData.BufferCurrentPtr()));
-        if (cookedReadData.IsEchoInput())
-        {
-            til::CoordType ScrollY = 0;
-            FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                                          cookedReadData.BufferStartPtr(),
-                                                          cookedReadData.BufferCurrentPtr(),
-                                                          cookedReadData.BufferCurrentPtr(),
-                                                          &cookedReadData.BytesRead(),
-                                                          &cookedReadData.VisibleCharCount(),
-                                                          cookedReadData.OriginalCursorPosition().x,
-                                                          WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
-                                                          &ScrollY));
-            cookedReadData.OriginalCursorPosition().y += ScrollY;
-        }
+        UpdateCommandLine(cookedReadData, previous, previousVisibleCharCount);
         auto CharsToWrite = cookedReadData.BytesRead() / sizeof(WCHAR);
         cookedReadData.InsertionPoint() = CharsToWrite;
         cookedReadData.SetBufferCurrentPtr(cookedReadData.BufferStartPtr() + CharsToWrite);
     }
+    else
+    {
+        DeleteCommandLine(cookedReadData, true);
+    }
 }
 
 // Routine Description:
@@ -543,20 +593,10 @@ void CommandLine::_setPromptToNewestCommand(COOKED_READ_DATA& cookedReadData)
 // - cookedReadData - The cooked read data to operate on
 void CommandLine::DeletePromptAfterCursor(COOKED_READ_DATA& cookedReadData) noexcept
 {
-    DeleteCommandLine(cookedReadData, false);
+    // Everything up to the cursor stays where it is on screen.
+    const std::wstring_view previous{ cookedReadData.BufferStartPtr(), cookedReadData.InsertionPoint() };
     cookedReadData.BytesRead() = cookedReadData.InsertionPoint() * sizeof(WCHAR);
-    if (cookedReadData.IsEchoInput())
-    {
-        FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                                      cookedReadData.BufferStartPtr(),
-                                                      cookedReadData.BufferStartPtr(),
-                                                      cookedReadData.BufferStartPtr(),
-                                                      &cookedReadData.BytesRead(),
-                                                      &cookedReadData.VisibleCharCount(),
-                                                      cookedReadData.OriginalCursorPosition().x,
-                                                      WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
-                                                      nullptr));
-    }
+    UpdateCommandLine(cookedReadData, previous, cookedReadData.VisibleCharCount());
 }
 
 // Routine Description:
@@ -567,23 +607,12 @@ void CommandLine::DeletePromptAfterCursor(COOKED_READ_DATA& cookedReadData) noex
 // - The new cursor position
 til::point CommandLine::_deletePromptBeforeCursor(COOKED_READ_DATA& cookedReadData) noexcept
 {
-    DeleteCommandLine(cookedReadData, false);
     cookedReadData.BytesRead() -= cookedReadData.InsertionPoint() * sizeof(WCHAR);
     cookedReadData.InsertionPoint() = 0;
     memmove(cookedReadData.BufferStartPtr(), cookedReadData.BufferCurrentPtr(), cookedReadData.BytesRead());
     cookedReadData.SetBufferCurrentPtr(cookedReadData.BufferStartPtr());
-    if (cookedReadData.IsEchoInput())
-    {
-        FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                                      cookedReadData.BufferStartPtr(),
-                                                      cookedReadData.BufferStartPtr(),
-                                                      cookedReadData.BufferStartPtr(),
-                                                      &cookedReadData.BytesRead(),
-                                                      &cookedReadData.VisibleCharCount(),
-                                                      cookedReadData.OriginalCursorPosition().x,
-                                                      WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
-                                                      nullptr));
-    }
+    // The whole line shifted to the left, so there's no common prefix to keep.
+    UpdateCommandLine(cookedReadData, {}, cookedReadData.VisibleCharCount());
     return cookedReadData.OriginalCursorPosition();
 }
 
@@ -852,38 +881,19 @@ til::point CommandLine::_moveCursorRight(COOKED_READ_DATA& cookedReadData) noexc
     // if at the end of the line, copy a character from the same position in the last command
     else if (cookedReadData.HasHistory())
     {
-        size_t NumSpaces;
         const auto LastCommand = cookedReadData.History().GetLastCommand();
         if (!LastCommand.empty() && LastCommand.size() > cookedReadData.InsertionPoint())
         {
+            // We're at the end of the line, so everything before the new character stays.
+            const std::wstring_view previous{ cookedReadData.BufferStartPtr(), cookedReadData.InsertionPoint() };
             *cookedReadData.BufferCurrentPtr() = LastCommand[cookedReadData.InsertionPoint()];
             cookedReadData.BytesRead() += sizeof(WCHAR);
             cookedReadData.InsertionPoint()++;
             if (cookedReadData.IsEchoInput())
             {
-                til::CoordType ScrollY = 0;
-                auto CharsToWrite = sizeof(WCHAR);
-                FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                                              cookedReadData.BufferStartPtr(),
-                                                              cookedReadData.BufferCurrentPtr(),
-                                                              cookedReadData.BufferCurrentPtr(),
-                                                              &CharsToWrite,
-                                                              &NumSpaces,
-                                                              cookedReadData.OriginalCursorPosition().x,
-                                                              WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
-                                                              &ScrollY));
-                cookedReadData.OriginalCursorPosition().y += ScrollY;
-                cookedReadData.VisibleCharCount() += NumSpaces;
+                UpdateCommandLine(cookedReadData, previous, cookedReadData.VisibleCharCount());
                 // update reported cursor position
-                if (ScrollY != 0)
-                {
-                    cursorPosition.x = 0;
-                    cursorPosition.y += ScrollY;
-                }
-                else
-                {
-                    cursorPosition.x += 1;
-                }
+                cursorPosition = cookedReadData.ScreenInfo().GetTextBuffer().GetCursor().GetPosition();
             }
             cookedReadData.SetBufferCurrentPtr(cookedReadData.BufferCurrentPtr() + 1);
         }
@@ -897,28 +907,19 @@ til::point CommandLine::_moveCursorRight(COOKED_READ_DATA& cookedReadData) noexc
 // - cookedReadData - The cooked read data to operate on
 void CommandLine::_insertCtrlZ(COOKED_READ_DATA& cookedReadData) noexcept
 {
-    size_t NumSpaces = 0;
-
+    const std::wstring_view previous{ cookedReadData.BufferStartPtr(), cookedReadData.InsertionPoint() };
     *cookedReadData.BufferCurrentPtr() = (WCHAR)0x1a; // ctrl-z
     cookedReadData.BytesRead() += sizeof(WCHAR);
     cookedReadData.InsertionPoint()++;
+    cookedReadData.SetBufferCurrentPtr(cookedReadData.BufferCurrentPtr() + 1);
     if (cookedReadData.IsEchoInput())
     {
-        til::CoordType ScrollY = 0;
-        auto CharsToWrite = sizeof(WCHAR);
-        FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                                      cookedReadData.BufferStartPtr(),
-                                                      cookedReadData.BufferCurrentPtr(),
-                                                      cookedReadData.BufferCurrentPtr(),
-                                                      &CharsToWrite,
-                                                      &NumSpaces,
-                                                      cookedReadData.OriginalCursorPosition().x,
-                                                      WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
-                                                      &ScrollY));
-        cookedReadData.OriginalCursorPosition().y += ScrollY;
-        cookedReadData.VisibleCharCount() += NumSpaces;
+        UpdateCommandLine(cookedReadData, previous, cookedReadData.VisibleCharCount());
+        if (!cookedReadData.AtEol())
+        {
+            MoveCursorToInsertionPoint(cookedReadData);
+        }
     }
-    cookedReadData.SetBufferCurrentPtr(cookedReadData.BufferCurrentPtr() + 1);
 }
 
 // Routine Description:
@@ -942,33 +943,24 @@ void CommandLine::_fillPromptWithPreviousCommandFragment(COOKED_READ_DATA& cooke
 {
     if (cookedReadData.HasHistory())
     {
-        size_t NumSpaces, cchCount;
-
         const auto LastCommand = cookedReadData.History().GetLastCommand();
         if (!LastCommand.empty() && LastCommand.size() > cookedReadData.InsertionPoint())
         {
-            cchCount = LastCommand.size() - cookedReadData.InsertionPoint();
+            const std::wstring_view previous{ cookedReadData.BufferStartPtr(), cookedReadData.InsertionPoint() };
+            const auto cchCount = LastCommand.size() - cookedReadData.InsertionPoint();
             const auto bufferSpan = cookedReadData.SpanAtPointer();
             std::copy_n(LastCommand.cbegin() + cookedReadData.InsertionPoint(), cchCount, bufferSpan.begin());
             cookedReadData.InsertionPoint() += cchCount;
-            cchCount *= sizeof(WCHAR);
             cookedReadData.BytesRead() = std::max(LastCommand.size() * sizeof(wchar_t), cookedReadData.BytesRead());
+            cookedReadData.SetBufferCurrentPtr(cookedReadData.BufferCurrentPtr() + cchCount);
             if (cookedReadData.IsEchoInput())
             {
-                til::CoordType ScrollY = 0;
-                FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                                              cookedReadData.BufferStartPtr(),
-                                                              cookedReadData.BufferCurrentPtr(),
-                                                              cookedReadData.BufferCurrentPtr(),
-                                                              &cchCount,
-                                                              &NumSpaces,
-                                                              cookedReadData.OriginalCursorPosition().x,
-                                                              WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
-                                                              &ScrollY));
-                cookedReadData.OriginalCursorPosition().y += ScrollY;
-                cookedReadData.VisibleCharCount() += NumSpaces;
+                UpdateCommandLine(cookedReadData, previous, cookedReadData.VisibleCharCount());
+                if (!cookedReadData.AtEol())
+                {
+                    MoveCursorToInsertionPoint(cookedReadData);
+                }
             }
-            cookedReadData.SetBufferCurrentPtr(cookedReadData.BufferCurrentPtr() + cchCount / sizeof(WCHAR));
         }
     }
 }
@@ -993,26 +985,14 @@ til::point CommandLine::_cycleMatchingCommandHistoryToPrompt(COOKED_READ_DATA& c
             // save cursor position
             const auto CurrentPos = cookedReadData.InsertionPoint();
 
-            DeleteCommandLine(cookedReadData, true);
+            const std::wstring previous{ cookedReadData.BufferStartPtr(), cookedReadData.BytesRead() / sizeof(WCHAR) };
+            const auto previousVisibleCharCount = cookedReadData.VisibleCharCount();
+            cookedReadData.Erase();
             THROW_IF_FAILED(cookedReadData.History().RetrieveNth((SHORT)index,
                                                                  cookedReadData.SpanWholeBuffer(),
                                                                  cookedReadData.BytesRead()));
             FAIL_FAST_IF(!(cookedReadData.BufferStartPtr() == cookedReadData.BufferCurrentPtr()));
-            if (cookedReadData.IsEchoInput())
-            {
-                til::CoordType ScrollY = 0;
-                FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                                              cookedReadData.BufferStartPtr(),
-                                                              cookedReadData.BufferCurrentPtr(),
-                                                              cookedReadData.BufferCurrentPtr(),
-                                                              &cookedReadData.BytesRead(),
-                                                              &cookedReadData.VisibleCharCount(),
-                                                              cookedReadData.OriginalCursorPosition().x,
-                                                              WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
-                                                              &ScrollY));
-                cookedReadData.OriginalCursorPosition().y += ScrollY;
-                cursorPosition.y += ScrollY;
-            }
+            cursorPosition.y += UpdateCommandLine(cookedReadData, previous, previousVisibleCharCount);
 
             // restore cursor position
             cookedReadData.SetBufferCurrentPtr(cookedReadData.BufferStartPtr() + CurrentPos);
@@ -1036,11 +1016,8 @@ til::point CommandLine::DeleteFromRightOfCursor(COOKED_READ_DATA& cookedReadData
 
     if (!cookedReadData.AtEol())
     {
-        // Delete commandline.
-        // clang-format off
-#pragma prefast(suppress: __WARNING_BUFFER_OVERFLOW, "Not sure why prefast is getting confused here")
-        // clang-format on
-        DeleteCommandLine(cookedReadData, false);
+        // Everything before the deleted char stays where it is on screen.
+        const std::wstring_view previous{ cookedReadData.BufferStartPtr(), cookedReadData.InsertionPoint() };
 
         // Delete char.
         cookedReadData.BytesRead() -= sizeof(WCHAR);
@@ -1054,18 +1031,7 @@ til::point CommandLine::DeleteFromRightOfCursor(COOKED_READ_DATA& cookedReadData
         }
 
         // Write commandline.
-        if (cookedReadData.IsEchoInput())
-        {
-            FAIL_FAST_IF_NTSTATUS_FAILED(WriteCharsLegacy(cookedReadData.ScreenInfo(),
-                                                          cookedReadData.BufferStartPtr(),
-                                                          cookedReadData.BufferStartPtr(),
-                                                          cookedReadData.BufferStartPtr(),
-                                                          &cookedReadData.BytesRead(),
-                                                          &cookedReadData.VisibleCharCount(),
-                                                          cookedReadData.OriginalCursorPosition().x,
-                                                          WC_DESTRUCTIVE_BACKSPACE | WC_KEEP_CURSOR_VISIBLE | WC_PRINTABLE_CONTROL_CHARS,
-                                                          nullptr));
-        }
+        UpdateCommandLine(cookedReadData, previous, cookedReadData.VisibleCharCount());
 
         // restore cursor position
         const auto sScreenBufferSizeX = cookedReadData.ScreenInfo().GetBufferSize().Width();
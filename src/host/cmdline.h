@@ -130,6 +130,16 @@ void DeleteCommandLine(COOKED_READ_DATA& cookedReadData, const bool fUpdateField
 
 void RedrawCommandLine(COOKED_READ_DATA& cookedReadData);
 
+til::CoordType UpdateCommandLine(COOKED_READ_DATA& cookedReadData,
+                                 const std::wstring_view previous,
+                                 const size_t previousVisibleCharCount) noexcept;
+
+til::CoordType UpdateCommandLine(COOKED_READ_DATA& cookedReadData,
+                                 const std::wstring_view previous,
+                                 const size_t previousVisibleCharCount,
+                                 const size_t currentLength,
+                                 const DWORD dwFlags) noexcept;
+
 // Values for WriteChars(), WriteCharsLegacy() dwFlags
 #define WC_DESTRUCTIVE_BACKSPACE 0x01
 #define WC_KEEP_CURSOR_VISIBLE 0x02
@@ -302,7 +302,7 @@ void InputBuffer::ReinitializeInputBuffer()
 // - None
 void InputBuffer::WakeUpReadersWaitingForData()
 {
-    WaitQueue.NotifyWaiters(false);
+    WaitQueue.NotifyWaiters(false, ConsoleWaitReason::InputAvailable);
 }
 
 // Routine Description:
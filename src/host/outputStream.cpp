@@ -306,7 +306,7 @@ void ConhostInternalGetSet::SetWorkingDirectory(const std::wstring_view /*uri*/)
 }
 
 // Routine Description:
-// - Plays a single MIDI note, blocking for the duration.
+// - Queues a single MIDI note to be played asynchronously.
 // Arguments:
 // - noteNumber - The MIDI note number to be played (0 - 127).
 // - velocity - The force with which the note should be played (0 - 127).
@@ -315,15 +315,21 @@ void ConhostInternalGetSet::SetWorkingDirectory(const std::wstring_view /*uri*/)
 // - true if successful. false otherwise.
 void ConhostInternalGetSet::PlayMidiNote(const int noteNumber, const int velocity, const std::chrono::microseconds duration)
 {
-    // Unlock the console, so the UI doesn't hang while we're busy.
-    UnlockConsole();
-
-    // This call will block for the duration, unless shutdown early.
+    // This only queues the note, so we don't need to unlock the console.
     const auto windowHandle = ServiceLocator::LocateConsoleWindow()->GetWindowHandle();
     auto& midiAudio = ServiceLocator::LocateGlobals().getConsoleInformation().GetMidiAudio();
     midiAudio.PlayNote(windowHandle, noteNumber, velocity, std::chrono::duration_cast<std::chrono::milliseconds>(duration));
+}
 
-    LockConsole();
+// Routine Description:
+// - Discards any MIDI notes that are still waiting to be played.
+// Arguments:
+// - <none>
+// Return value:
+// - <none>
+void ConhostInternalGetSet::FlushMidiNotes()
+{
+    ServiceLocator::LocateGlobals().getConsoleInformation().GetMidiAudio().Flush();
 }
 
 // Routine Description:
@@ -443,6 +449,11 @@ void ConhostInternalGetSet::NotifyBufferRotation(const int delta)
     }
 }
 
+void ConhostInternalGetSet::NotifyScrollbackErased()
+{
+    // Not needed for conhost.
+}
+
 void ConhostInternalGetSet::MarkPrompt(const Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark& /*mark*/)
 {
     // Not implemented for conhost.
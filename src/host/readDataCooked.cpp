@@ -708,35 +708,32 @@ bool COOKED_READ_DATA::ProcessInput(const wchar_t wchOrig,
             CursorPosition = _screenInfo.GetTextBuffer().GetCursor().GetPosition();
             CursorPosition.x = (til::CoordType)(CursorPosition.x + NumSpaces);
 
-            // clear the current command line from the screen
-            // clang-format off
-#pragma prefast(suppress: __WARNING_BUFFER_OVERFLOW, "Not sure why prefast doesn't like this call.")
-            // clang-format on
-            DeleteCommandLine(*this, FALSE);
-
-            // write the new command line to the screen
-            NumToWrite = _bytesRead;
+            // everything in front of the edit is still on the screen as-is
+            size_t unchanged;
+            if (wch == UNICODE_BACKSPACE && _processedInput)
+            {
+                unchanged = _currentPosition;
+            }
+            else if (wch == UNICODE_CARRIAGERETURN)
+            {
+                unchanged = _bytesRead / sizeof(WCHAR) - 1;
+            }
+            else
+            {
+                unchanged = _currentPosition - 1;
+            }
 
+            // rewrite the remainder of the command line on the screen
             DWORD dwFlags = WC_DESTRUCTIVE_BACKSPACE | WC_PRINTABLE_CONTROL_CHARS;
             if (wch == UNICODE_CARRIAGERETURN)
             {
                 dwFlags |= WC_KEEP_CURSOR_VISIBLE;
             }
-            status = WriteCharsLegacy(_screenInfo,
-                                      _backupLimit,
-                                      _backupLimit,
-                                      _backupLimit,
-                                      &NumToWrite,
-                                      &_visibleCharCount,
-                                      _originalCursorPosition.x,
-                                      dwFlags,
-                                      &ScrollY);
-            if (FAILED_NTSTATUS(status))
-            {
-                RIPMSG1(RIP_WARNING, "WriteCharsLegacy failed 0x%x", status);
-                _bytesRead = 0;
-                return true;
-            }
+            ScrollY = UpdateCommandLine(*this,
+                                        { _backupLimit, unchanged },
+                                        _visibleCharCount,
+                                        _bytesRead / sizeof(WCHAR),
+                                        dwFlags);
 
             // update cursor position
             if (wch != UNICODE_CARRIAGERETURN)
@@ -755,7 +752,6 @@ bool COOKED_READ_DATA::ProcessInput(const wchar_t wchOrig,
                 }
 
                 // adjust cursor position for WriteChars
-                _originalCursorPosition.y += ScrollY;
                 CursorPosition.y += ScrollY;
                 status = AdjustCursorPosition(_screenInfo, CursorPosition, TRUE, nullptr);
                 if (FAILED_NTSTATUS(status))
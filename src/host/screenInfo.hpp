@@ -44,6 +44,7 @@ Revision History:
 #include "../renderer/inc/FontInfo.hpp"
 #include "../renderer/inc/FontInfoDesired.hpp"
 
+#include "../types/inc/convert.hpp"
 #include "../types/inc/Viewport.hpp"
 class ConversionAreaInfo; // forward decl window. circular reference
 
@@ -171,6 +172,11 @@ private:
 public:
     SCREEN_INFORMATION* Next;
     BYTE WriteConsoleDbcsLeadByte[2];
+    // Per-handle conversion state for WriteConsoleA. The buffer is reused
+    // across calls, so that steady streams of output don't allocate.
+    til::u8state WriteConsoleUtf8State;
+    SbcsDecoder WriteConsoleSbcsDecoder;
+    std::wstring WriteConsoleConversionBuffer;
     BYTE FillOutDbcsLeadChar;
 
     // non ownership pointer
@@ -616,6 +616,6 @@ void UnblockWriteConsole(const DWORD dwReason)
     if (WI_AreAllFlagsClear(gci.Flags, (CONSOLE_SUSPENDED | CONSOLE_SELECTING | CONSOLE_SCROLLBAR_TRACKING)))
     {
         // There is no longer any reason to suspend output, so unblock it.
-        gci.OutputQueue.NotifyWaiters(true);
+        gci.OutputQueue.NotifyWaiters(true, ConsoleWaitReason::OutputUnblocked);
     }
 }
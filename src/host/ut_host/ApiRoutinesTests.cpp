@@ -8,6 +8,7 @@
 #include "CommonState.hpp"
 
 #include "ApiRoutines.h"
+#include "VtApiRoutines.h"
 #include "getset.h"
 #include "dbcs.h"
 #include "misc.h"
@@ -866,4 +867,73 @@ class ApiRoutinesTests
 
         ValidateComplexScreen(si, background, fill, scrollRect, Viewport::FromInclusive(scroll), destination, clipViewport);
     }
+
+    TEST_METHOD(VtApiCoalescesPassthroughWrites)
+    {
+        Log::Comment(L"Passthrough output from consecutive API calls should be combined into few pipe writes.");
+
+        wil::unique_handle pipeReadSide;
+        wil::unique_hfile pipeWriteSide;
+        VERIFY_WIN32_BOOL_SUCCEEDED(CreatePipe(&pipeReadSide, &pipeWriteSide, nullptr, 0));
+
+        // The in-process pipe stand-in: drain it on a separate thread so that our writes never block.
+        std::atomic<size_t> bytesRead{ 0 };
+        std::thread reader{ [&]() {
+            char buffer[4096];
+            DWORD read = 0;
+            while (ReadFile(pipeReadSide.get(), &buffer[0], sizeof(buffer), &read, nullptr) && read)
+            {
+                bytesRead += read;
+            }
+        } };
+
+        auto engine = std::make_unique<Microsoft::Console::Render::Xterm256Engine>(std::move(pipeWriteSide), Viewport::FromDimensions({ 80, 32 }));
+        auto vtapi = std::make_unique<VtApiRoutines>();
+        vtapi->m_pVtEngine = engine.get();
+        vtapi->m_pUsualRoutines = _pApiRoutines;
+
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& si = gci.GetActiveOutputBuffer();
+        std::unique_ptr<IWaitRoutine> waiter;
+        size_t read = 0;
+
+        {
+            // Hold the lock like the flush timer would, so that it can't interfere with our counting.
+            gci.LockConsole();
+            auto unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+
+            Log::Comment(L"Small writes stay pending until the client reads.");
+            for (auto i = 0; i < 100; ++i)
+            {
+                VERIFY_SUCCEEDED(vtapi->WriteConsoleWImpl(si, L"0123456789abcdef", read, false, waiter));
+                VERIFY_ARE_EQUAL(16u, read);
+            }
+            VERIFY_ARE_EQUAL(0u, vtapi->m_pipeWrites);
+
+            ULONG events = 0;
+            VERIFY_SUCCEEDED(vtapi->GetNumberOfConsoleInputEventsImpl(*gci.pInputBuffer, events));
+            VERIFY_ARE_EQUAL(1u, vtapi->m_pipeWrites);
+
+            Log::Comment(L"Large volumes of output are flushed whenever the threshold is reached.");
+            vtapi->m_pipeWrites = 0;
+            constexpr size_t megabyte = 1024 * 1024;
+            for (size_t i = 0; i < megabyte / 16; ++i)
+            {
+                VERIFY_SUCCEEDED(vtapi->WriteConsoleWImpl(si, L"0123456789abcdef", read, false, waiter));
+            }
+            vtapi->FlushPending();
+
+            Log::Comment(NoThrowString().Format(L"Pipe writes per MB: %zu (previously %zu)", vtapi->m_pipeWrites, megabyte / 16));
+            VERIFY_IS_LESS_THAN_OR_EQUAL(vtapi->m_pipeWrites, megabyte / VtApiRoutines::s_flushThreshold + 1);
+
+            // This write is still pending when the routines are destroyed below.
+            VERIFY_SUCCEEDED(vtapi->WriteConsoleWImpl(si, L"0123456789abcdef", read, false, waiter));
+        }
+
+        Log::Comment(L"Pending output is written when the routines are destroyed.");
+        vtapi.reset();
+        engine.reset();
+        reader.join();
+        VERIFY_ARE_EQUAL(101u * 16u + 1024u * 1024u, bytesRead.load());
+    }
 };
@@ -8,6 +8,8 @@
 #include "CommonState.hpp"
 
 #include "../../interactivity/inc/ServiceLocator.hpp"
+#include "../../renderer/base/Renderer.hpp"
+#include "../../renderer/vt/Xterm256Engine.hpp"
 
 #include "../cmdline.h"
 
@@ -15,6 +17,7 @@ using namespace WEX::Common;
 using namespace WEX::Logging;
 using namespace WEX::TestExecution;
 using Microsoft::Console::Interactivity::ServiceLocator;
+using Microsoft::Console::Render::Xterm256Engine;
 
 constexpr size_t PROMPT_SIZE = 512;
 
@@ -467,6 +470,135 @@ class CommandLineTests
         VerifyPromptText(cookedReadData, L"Indestructible");
     }
 
+    TEST_METHOD(HistoryCyclingOnlyRewritesChangedTail)
+    {
+        auto buffer = std::make_unique<wchar_t[]>(PROMPT_SIZE);
+        VERIFY_IS_NOT_NULL(buffer.get());
+
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& textBuffer = gci.GetActiveOutputBuffer().GetTextBuffer();
+        auto& cookedReadData = gci.CookedReadData();
+        InitCookedReadData(cookedReadData, m_pHistory, buffer.get(), PROMPT_SIZE);
+
+        const auto width = textBuffer.GetSize().Width();
+        const std::wstring longCommand = L"echo " + std::wstring(width, L'x');
+        VERIFY_SUCCEEDED(m_pHistory->Add(L"echo hi", false));
+        VERIFY_SUCCEEDED(m_pHistory->Add(longCommand, false));
+
+        auto& commandLine = CommandLine::Instance();
+
+        Log::Comment(L"The long command wraps onto the second row.");
+        commandLine._processHistoryCycling(cookedReadData, CommandHistory::SearchDirection::Previous);
+        VerifyPromptText(cookedReadData, longCommand);
+        VERIFY_ARE_EQUAL(longCommand.size(), cookedReadData.VisibleCharCount());
+        VERIFY_ARE_EQUAL(std::wstring(5, L'x'), textBuffer.GetRowByOffset(1).GetText().substr(0, 5));
+
+        Log::Comment(L"Cycling to the shorter command must blank the rest of both rows.");
+        commandLine._processHistoryCycling(cookedReadData, CommandHistory::SearchDirection::Previous);
+        VerifyPromptText(cookedReadData, L"echo hi");
+        VERIFY_ARE_EQUAL(7u, cookedReadData.VisibleCharCount());
+        VERIFY_ARE_EQUAL(L"echo hi" + std::wstring(width - 7, L' '), textBuffer.GetRowByOffset(0).GetText());
+        VERIFY_ARE_EQUAL(std::wstring(width, L' '), textBuffer.GetRowByOffset(1).GetText());
+        VERIFY_ARE_EQUAL(til::point(7, 0), textBuffer.GetCursor().GetPosition());
+
+        Log::Comment(L"And back again, rewriting only what follows the shared \"echo \" prefix.");
+        commandLine._processHistoryCycling(cookedReadData, CommandHistory::SearchDirection::Next);
+        VerifyPromptText(cookedReadData, longCommand);
+        VERIFY_ARE_EQUAL(longCommand.substr(0, width), textBuffer.GetRowByOffset(0).GetText());
+        VERIFY_ARE_EQUAL(std::wstring(5, L'x') + std::wstring(width - 5, L' '), textBuffer.GetRowByOffset(1).GetText());
+        VERIFY_ARE_EQUAL(til::point(5, 1), textBuffer.GetCursor().GetPosition());
+    }
+
+    TEST_METHOD(EditsOnlyEmitChangedTail)
+    {
+        auto& g = ServiceLocator::LocateGlobals();
+        auto& gci = g.getConsoleInformation();
+
+        Log::Comment(L"Recreate the screen buffer with a renderer, so that edits get painted.");
+        m_state->CleanupCookedReadData();
+        m_state->CleanupGlobalScreenBuffer();
+        m_state->PrepareGlobalRenderer();
+        m_state->PrepareGlobalScreenBuffer();
+        m_state->PrepareCookedReadData();
+
+        size_t bytesWritten = 0;
+        std::unique_ptr<Xterm256Engine> engine;
+        const auto restore = wil::scope_exit([&]() {
+            m_state->CleanupCookedReadData();
+            m_state->CleanupGlobalScreenBuffer();
+            m_state->CleanupGlobalRenderer();
+            m_state->PrepareGlobalScreenBuffer();
+            m_state->PrepareCookedReadData();
+        });
+        engine = std::make_unique<Xterm256Engine>(wil::unique_hfile{ INVALID_HANDLE_VALUE }, gci.GetActiveOutputBuffer().GetViewport());
+        engine->SetTestCallback([&](const char* const, const size_t cch) {
+            bytesWritten += cch;
+            return true;
+        });
+        g.pRender->AddRenderEngine(engine.get());
+
+        // Paints a frame and returns the number of bytes of VT it produced.
+        const auto paint = [&]() {
+            bytesWritten = 0;
+            VERIFY_SUCCEEDED(g.pRender->PaintFrame());
+            return bytesWritten;
+        };
+
+        auto buffer = std::make_unique<wchar_t[]>(PROMPT_SIZE);
+        VERIFY_IS_NOT_NULL(buffer.get());
+        auto& textBuffer = gci.GetActiveOutputBuffer().GetTextBuffer();
+        auto& cookedReadData = gci.CookedReadData();
+        InitCookedReadData(cookedReadData, m_pHistory, buffer.get(), PROMPT_SIZE);
+        cookedReadData._insertMode = true;
+
+        const auto width = textBuffer.GetSize().Width();
+        const auto text = L"echo " + std::wstring(2 * width, L'x');
+        VERIFY_ARE_EQUAL(text.size(), cookedReadData.Write(text));
+        paint();
+
+        auto& commandLine = CommandLine::Instance();
+        NTSTATUS status;
+
+        Log::Comment(L"Erasing and redrawing the command line, which is what every edit used to do, repaints all three rows.");
+        commandLine.Hide(false);
+        commandLine.Show();
+        const auto redrawBytes = paint();
+        Log::Comment(NoThrowString().Format(L"Full redraw: %zu bytes", redrawBytes));
+        VERIFY_IS_GREATER_THAN(redrawBytes, text.size());
+
+        for (auto i = 0; i < 3; i++)
+        {
+            VERIFY_NT_SUCCESS(commandLine.ProcessCommandLine(cookedReadData, VK_LEFT, 0));
+        }
+        paint();
+
+        Log::Comment(L"Inserting a character near the end only repaints the end.");
+        cookedReadData.ProcessInput(L'y', 0, status);
+        const auto insertBytes = paint();
+        Log::Comment(NoThrowString().Format(L"Insert: %zu bytes", insertBytes));
+        VerifyPromptText(cookedReadData, text.substr(0, text.size() - 3) + L"yxxx");
+        VERIFY_IS_LESS_THAN(insertBytes * 10, redrawBytes);
+
+        Log::Comment(L"So does erasing it again.");
+        cookedReadData.ProcessInput(UNICODE_BACKSPACE, 0, status);
+        const auto backspaceBytes = paint();
+        Log::Comment(NoThrowString().Format(L"Backspace: %zu bytes", backspaceBytes));
+        VerifyPromptText(cookedReadData, text);
+        VERIFY_IS_LESS_THAN(backspaceBytes * 10, redrawBytes);
+
+        Log::Comment(L"And deleting the character to the right of the cursor.");
+        VERIFY_NT_SUCCESS(commandLine.ProcessCommandLine(cookedReadData, VK_DELETE, 0));
+        const auto deleteBytes = paint();
+        Log::Comment(NoThrowString().Format(L"Delete: %zu bytes", deleteBytes));
+        VerifyPromptText(cookedReadData, text.substr(0, text.size() - 1));
+        VERIFY_IS_LESS_THAN(deleteBytes * 10, redrawBytes);
+
+        Log::Comment(L"The screen still shows the complete command line.");
+        VERIFY_ARE_EQUAL(text.substr(0, width), textBuffer.GetRowByOffset(0).GetText());
+        VERIFY_ARE_EQUAL(text.substr(width, width), textBuffer.GetRowByOffset(1).GetText());
+        VERIFY_ARE_EQUAL(std::wstring(4, L'x') + std::wstring(width - 4, L' '), textBuffer.GetRowByOffset(2).GetText());
+    }
+
     TEST_METHOD(CmdlineCtrlHomeFullwidthChars)
     {
         Log::Comment(L"Set up buffers, create cooked read data, get screen information.");
@@ -0,0 +1,144 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "CommonState.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+using Microsoft::Console::Interactivity::ServiceLocator;
+
+class ProcessListTests
+{
+    CommonState* m_state;
+
+    TEST_CLASS(ProcessListTests);
+
+    TEST_CLASS_SETUP(ClassSetup)
+    {
+        m_state = new CommonState();
+        return true;
+    }
+
+    TEST_CLASS_CLEANUP(ClassCleanup)
+    {
+        delete m_state;
+        return true;
+    }
+
+    // Build systems attach hundreds of processes to a single console. These IDs are
+    // far above what the OS hands out, so OpenProcess fails for them, which is fine.
+    static constexpr DWORD FirstProcessId = 0x40000000;
+    static constexpr size_t ProcessCount = 512;
+    static constexpr size_t ProcessesPerGroup = 4;
+
+    static DWORD _ProcessId(const size_t index)
+    {
+        return gsl::narrow_cast<DWORD>(FirstProcessId + index * 4);
+    }
+
+    // Like a build tool and the compilers it spawns, every group is led by its first process.
+    static ULONG _GroupId(const size_t index)
+    {
+        return _ProcessId(index - index % ProcessesPerGroup);
+    }
+
+    TEST_METHOD(AttachManyProcesses)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& list = gci.ProcessHandleList;
+
+        gci.LockConsole();
+        auto Unlock = wil::scope_exit([&] { gci.UnlockConsole(); });
+
+        Log::Comment(NoThrowString().Format(L"Attach %zu processes in groups of %zu.", ProcessCount, ProcessesPerGroup));
+        std::vector<ConsoleProcessHandle*> processes;
+        for (size_t i = 0; i < ProcessCount; i++)
+        {
+            ConsoleProcessHandle* process = nullptr;
+            VERIFY_ARE_EQUAL(S_OK, list.AllocProcessData(_ProcessId(i), 0, _GroupId(i), &process));
+            VERIFY_IS_NOT_NULL(process);
+            processes.push_back(process);
+        }
+
+        Log::Comment(L"Attaching a known process again must return the existing entry.");
+        VERIFY_ARE_EQUAL(S_FALSE, list.AllocProcessData(_ProcessId(0), 0, _GroupId(0), nullptr));
+
+        Log::Comment(L"Every process can be found by its ID and every group by its leader.");
+        for (size_t i = 0; i < ProcessCount; i++)
+        {
+            VERIFY_ARE_EQUAL(processes[i], list.FindProcessInList(_ProcessId(i)));
+            VERIFY_ARE_EQUAL(processes[i - i % ProcessesPerGroup], list.FindProcessByGroupId(_GroupId(i)));
+        }
+        VERIFY_IS_NULL(list.FindProcessInList(_ProcessId(ProcessCount)));
+        VERIFY_IS_NULL(list.FindProcessByGroupId(1));
+        VERIFY_ARE_EQUAL(processes.front(), list.GetOldestProcess());
+
+        Log::Comment(L"The process list is reported from newest to oldest.");
+        std::vector<DWORD> processIds(ProcessCount);
+        auto count = processIds.size();
+        VERIFY_SUCCEEDED(list.GetProcessList(processIds.data(), &count));
+        VERIFY_ARE_EQUAL(ProcessCount, count);
+        for (size_t i = 0; i < ProcessCount; i++)
+        {
+            VERIFY_ARE_EQUAL(_ProcessId(ProcessCount - 1 - i), processIds[i]);
+        }
+
+        Log::Comment(L"Termination records limited to a group only contain its members, oldest first.");
+        std::vector<ConsoleProcessTerminationRecord> records;
+        VERIFY_SUCCEEDED(list.GetTerminationRecordsByGroupId(_GroupId(ProcessesPerGroup), false, records));
+        VERIFY_ARE_EQUAL(ProcessesPerGroup, records.size());
+        for (size_t i = 0; i < ProcessesPerGroup; i++)
+        {
+            VERIFY_ARE_EQUAL(_ProcessId(ProcessesPerGroup + i), records[i].dwProcessID);
+        }
+        VERIFY_SUCCEEDED(list.GetTerminationRecordsByGroupId(0, false, records));
+        VERIFY_ARE_EQUAL(ProcessCount, records.size());
+
+        Log::Comment(L"Detach the first process of every group. The group is then found by its next member.");
+        for (size_t i = 0; i < ProcessCount; i += ProcessesPerGroup)
+        {
+            list.FreeProcessData(processes[i]);
+        }
+        for (size_t i = 0; i < ProcessCount; i++)
+        {
+            const auto detached = i % ProcessesPerGroup == 0;
+            VERIFY_ARE_EQUAL(detached ? nullptr : processes[i], list.FindProcessInList(_ProcessId(i)));
+            VERIFY_ARE_EQUAL(processes[i - i % ProcessesPerGroup + 1], list.FindProcessByGroupId(_GroupId(i)));
+        }
+        VERIFY_ARE_EQUAL(processes[1], list.GetOldestProcess());
+
+        Log::Comment(L"Measure the lookups that every client request and every control event goes through.");
+        static constexpr size_t LookupCount = 1000000;
+        const auto start = std::chrono::steady_clock::now();
+        size_t found = 0;
+        for (size_t i = 0; i < LookupCount; i++)
+        {
+            found += list.FindProcessInList(_ProcessId(i % ProcessCount)) != nullptr;
+            found += list.FindProcessByGroupId(_GroupId(i % ProcessCount)) != nullptr;
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        Log::Comment(NoThrowString().Format(L"%.1f ns per lookup with %zu processes attached.",
+                                            elapsed.count() / (LookupCount * 2),
+                                            ProcessCount - ProcessCount / ProcessesPerGroup));
+        VERIFY_ARE_EQUAL(LookupCount * 2 - LookupCount / ProcessesPerGroup, found);
+
+        Log::Comment(L"Detach everything else.");
+        for (size_t i = 0; i < ProcessCount; i++)
+        {
+            if (i % ProcessesPerGroup != 0)
+            {
+                list.FreeProcessData(processes[i]);
+            }
+        }
+        VERIFY_IS_TRUE(list.IsEmpty());
+        for (size_t i = 0; i < ProcessCount; i += ProcessesPerGroup)
+        {
+            VERIFY_IS_NULL(list.FindProcessByGroupId(_GroupId(i)));
+        }
+    }
+};
@@ -162,6 +162,7 @@ class ScreenBufferTests
 
     TEST_METHOD(BackspaceDefaultAttrs);
     TEST_METHOD(BackspaceDefaultAttrsWriteCharsLegacy);
+    TEST_METHOD(WriteCharsLegacyFastPathMatchesSlowPath);
 
     TEST_METHOD(BackspaceDefaultAttrsInPrompt);
 
@@ -2914,6 +2915,97 @@ void ScreenBufferTests::BackspaceDefaultAttrsWriteCharsLegacy()
     VERIFY_ARE_EQUAL(magenta, renderSettings.GetAttributeColors(attrB).second);
 }
 
+void ScreenBufferTests::WriteCharsLegacyFastPathMatchesSlowPath()
+{
+    BEGIN_TEST_METHOD_PROPERTIES()
+        TEST_METHOD_PROPERTY(L"Data:writeCharsLegacyMode", L"{0, 1, 2, 3, 4, 5, 6, 7}")
+        TEST_METHOD_PROPERTY(L"Data:wrapAtEOL", L"{false, true}")
+    END_TEST_METHOD_PROPERTIES();
+
+    DWORD writeCharsLegacyMode;
+    VERIFY_SUCCEEDED(TestData::TryGetValue(L"writeCharsLegacyMode", writeCharsLegacyMode));
+    bool wrapAtEOL;
+    VERIFY_SUCCEEDED(TestData::TryGetValue(L"wrapAtEOL", wrapAtEOL));
+
+    auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer().GetActiveBuffer();
+    auto& textBuffer = si.GetTextBuffer();
+    auto& cursor = textBuffer.GetCursor();
+    const auto width = textBuffer.GetSize().Width();
+
+    WI_UpdateFlag(si.OutputMode, ENABLE_WRAP_AT_EOL_OUTPUT, wrapAtEOL);
+    const auto restore = wil::scope_exit([&] {
+        WI_SetFlag(si.OutputMode, ENABLE_WRAP_AT_EOL_OUTPUT);
+        SetWriteCharsLegacyFastPath(true);
+    });
+
+    // Wide glyphs that the text below partially overwrites.
+    std::wstring background(width / 2, L'\x30a2');
+
+    // A mix of printable ASCII runs and everything that needs special handling:
+    // BS, TAB, CR, LF, BEL, other control characters, wide glyphs and runs longer than a line.
+    std::wstring text{ L"x Hello\tWorld\r\nFoo\b\bBar\a baz \x01\x1f\x7f qux \x30ab\x30ad\r\n" };
+    text.append(gsl::narrow_cast<size_t>(width) + 7, L'a');
+    text.append(L"\n\tindented\b\b\b\b\b\b\b\b\b\b\r");
+    text.append(gsl::narrow_cast<size_t>(width) - 3, L'b');
+    text.append(L"\x30ab\x30ad end");
+
+    struct Snapshot
+    {
+        std::vector<std::wstring> text;
+        std::vector<std::vector<TextAttribute>> attrs;
+        std::vector<bool> wrapped;
+        til::point cursor;
+        size_t spaces = 0;
+    };
+
+    const auto write = [&](const bool fastPath) {
+        SetWriteCharsLegacyFastPath(fastPath);
+        textBuffer.Reset();
+        cursor.SetPosition({ 0, 0 });
+
+        // Pre-fill a few rows with wide glyphs, starting at an odd column
+        // so that the text's edges bisect them.
+        for (til::CoordType y = 0; y < 6; ++y)
+        {
+            size_t cb = background.size() * sizeof(wchar_t);
+            cursor.SetPosition({ 1, y });
+            VERIFY_NT_SUCCESS(WriteCharsLegacy(si, background.data(), background.data(), background.data(), &cb, nullptr, 1, 0, nullptr));
+        }
+        cursor.SetPosition({ 3, 0 });
+
+        si.SetAttributes(TextAttribute{ FOREGROUND_RED | BACKGROUND_BLUE });
+
+        Snapshot snapshot;
+        size_t cb = text.size() * sizeof(wchar_t);
+        VERIFY_NT_SUCCESS(WriteCharsLegacy(si, text.data(), text.data(), text.data(), &cb, &snapshot.spaces, cursor.GetPosition().x, writeCharsLegacyMode, nullptr));
+        VERIFY_ARE_EQUAL(text.size() * sizeof(wchar_t), cb);
+
+        for (til::CoordType y = 0; y < 8; ++y)
+        {
+            const auto& row = textBuffer.GetRowByOffset(y);
+            snapshot.text.emplace_back(row.GetText());
+            snapshot.attrs.emplace_back(row.AttrBegin(), row.AttrEnd());
+            snapshot.wrapped.emplace_back(row.WasWrapForced());
+        }
+        snapshot.cursor = cursor.GetPosition();
+        return snapshot;
+    };
+
+    const auto expected = write(false);
+    const auto actual = write(true);
+
+    VERIFY_ARE_EQUAL(expected.cursor, actual.cursor);
+    VERIFY_ARE_EQUAL(expected.spaces, actual.spaces);
+    for (size_t y = 0; y < expected.text.size(); ++y)
+    {
+        Log::Comment(NoThrowString().Format(L"Comparing row %zu", y));
+        VERIFY_ARE_EQUAL(expected.text[y], actual.text[y]);
+        VERIFY_ARE_EQUAL(expected.wrapped[y], actual.wrapped[y]);
+        VERIFY_IS_TRUE(expected.attrs[y] == actual.attrs[y]);
+    }
+}
+
 void ScreenBufferTests::BackspaceDefaultAttrsInPrompt()
 {
     // Tests MSFT:19853701 - when you edit the prompt line at a bash prompt,
@@ -158,4 +158,98 @@ class SearchTests
         Search s(gci.renderData, L"\x304b", Search::Direction::Backward, Search::Sensitivity::CaseInsensitive);
         DoFoundChecks(s, coordStartExpected, -1);
     }
+
+    TEST_METHOD(FindAllInRowsMatchesFindNext)
+    {
+        BEGIN_TEST_METHOD_PROPERTIES()
+            TEST_METHOD_PROPERTY(L"Data:chunkRows", L"{1, 2, 1000}")
+        END_TEST_METHOD_PROPERTIES();
+
+        int chunkRows;
+        VERIFY_SUCCEEDED(TestData::TryGetValue(L"chunkRows", chunkRows));
+
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        const auto& textBuffer = gci.GetActiveOutputBuffer().GetTextBuffer();
+        const auto height = textBuffer.GetSize().Height();
+
+        for (const auto needle : { L"AB", L"ab", L"\x304b", L"B\x304bC", L"DE" })
+        {
+            Log::Comment(NoThrowString().Format(L"Searching for '%s'", needle));
+
+            std::vector<std::pair<til::point, til::point>> expected;
+            Search s(gci.renderData, needle, Search::Direction::Forward, Search::Sensitivity::CaseInsensitive);
+            while (s.FindNext())
+            {
+                expected.emplace_back(s.GetFoundLocation());
+            }
+
+            // Search the buffer in independent chunks, each with a row of overlap.
+            std::vector<std::pair<til::point, til::point>> actual;
+            for (til::CoordType row = 0; row < height; row += chunkRows)
+            {
+                const auto rows = Search::s_SnapshotRows(textBuffer, row, chunkRows + 1);
+                Search::s_FindAllInRows(rows, row, gsl::narrow<size_t>(chunkRows), needle, Search::Sensitivity::CaseInsensitive, actual);
+            }
+
+            VERIFY_ARE_EQUAL(expected.size(), actual.size());
+            for (size_t i = 0; i < expected.size(); ++i)
+            {
+                VERIFY_ARE_EQUAL(expected[i].first, actual[i].first);
+                VERIFY_ARE_EQUAL(expected[i].second, actual[i].second);
+            }
+        }
+    }
+
+    TEST_METHOD(FindAllRegexInRows)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        const auto& textBuffer = gci.GetActiveOutputBuffer().GetTextBuffer();
+        const auto rows = Search::s_SnapshotRows(textBuffer, 0, textBuffer.GetSize().Height(), true);
+
+        // Every row is "ABかCきDE" followed by spaces, and every odd row wraps into the next one.
+        const auto check = [&](const std::wstring_view pattern, const bool ignoreCase, const std::vector<std::pair<til::point, til::point>>& expected) {
+            Log::Comment(NoThrowString().Format(L"Searching for '%.*s'", gsl::narrow_cast<int>(pattern.size()), pattern.data()));
+
+            std::vector<std::pair<til::point, til::point>> actual;
+            std::vector<std::wstring> matchedText;
+            Search::s_FindAllRegexInRows(rows, 0, til::linear_regex{ pattern, ignoreCase }, actual, &matchedText);
+
+            VERIFY_ARE_EQUAL(expected.size(), actual.size());
+            VERIFY_ARE_EQUAL(expected.size(), matchedText.size());
+            for (size_t i = 0; i < expected.size(); ++i)
+            {
+                VERIFY_ARE_EQUAL(expected[i].first, actual[i].first);
+                VERIFY_ARE_EQUAL(expected[i].second, actual[i].second);
+            }
+        };
+
+        Log::Comment(L"Matches may span rows that wrapped, but not rows that didn't.");
+        check(L"E\\s*A", false, { { { 8, 1 }, { 0, 2 } } });
+
+        Log::Comment(L"^ and $ match at the start and end of logical lines, ignoring unwritten cells.");
+        check(L"^AB", false, { { { 0, 0 }, { 1, 0 } }, { { 0, 1 }, { 1, 1 } }, { { 0, 3 }, { 1, 3 } } });
+        check(L"DE$", false, { { { 7, 0 }, { 8, 0 } }, { { 7, 2 }, { 8, 2 } }, { { 7, 3 }, { 8, 3 } } });
+
+        Log::Comment(L"Offsets are mapped to cells, taking wide glyphs into account.");
+        check(L"\x304b.\x304d", false, { { { 2, 0 }, { 6, 0 } }, { { 2, 1 }, { 6, 1 } }, { { 2, 2 }, { 6, 2 } }, { { 2, 3 }, { 6, 3 } } });
+
+        Log::Comment(L"Case insensitive matching.");
+        check(L"ab", false, {});
+        check(L"ab", true, { { { 0, 0 }, { 1, 0 } }, { { 0, 1 }, { 1, 1 } }, { { 0, 2 }, { 1, 2 } }, { { 0, 3 }, { 1, 3 } } });
+    }
+
+    TEST_METHOD(RegexRunsInLinearTime)
+    {
+        // A backtracking engine takes exponential time to fail matching these.
+        const std::wstring haystack(10000, L'a');
+        for (const auto pattern : { L"(a|aa)*b", L"(a*)*b", L"(a?){50}a{50}b" })
+        {
+            const til::linear_regex regex{ pattern };
+            VERIFY_IS_FALSE(regex.find(haystack).has_value());
+        }
+
+        VERIFY_THROWS(til::linear_regex{ L"(a" }, std::invalid_argument);
+        VERIFY_THROWS(til::linear_regex{ L"\\1" }, std::invalid_argument);
+        VERIFY_THROWS(til::linear_regex{ L"((a{1000}){1000})" }, std::invalid_argument);
+    }
 };
@@ -161,6 +161,13 @@ class TextBufferTests
 
     TEST_METHOD(HyperlinkTrim);
     TEST_METHOD(NoHyperlinkTrim);
+    TEST_METHOD(ScrollbackSpillRoundTrip);
+    TEST_METHOD(ScrollbackSpillReflow);
+    TEST_METHOD(SnapshotRoundTrip);
+    TEST_METHOD(SnapshotRejectsInvalidData);
+    TEST_METHOD(SnapshotRestoreTiming);
+    TEST_METHOD(FillMatchesWriteLine);
+    TEST_METHOD(RowSpanOperations);
 };
 
 void TextBufferTests::TestBufferCreate()
@@ -2819,3 +2826,404 @@ void TextBufferTests::NoHyperlinkTrim()
     VERIFY_ARE_EQUAL(_buffer->GetHyperlinkUriFromId(id), url);
     VERIFY_ARE_EQUAL(_buffer->_hyperlinkCustomIdMap[finalCustomId], id);
 }
+
+// This tests that rows which scroll out of the buffer are spilled and can be restored
+// with their text, attributes, hyperlinks and wrap flag intact.
+void TextBufferTests::ScrollbackSpillRoundTrip()
+{
+    const til::size bufferSize{ 20, 5 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+    _buffer->SetScrollbackSpill(true);
+
+    static constexpr std::wstring_view url{ L"test.url" };
+    static constexpr std::wstring_view text{ L"AB\x304bC" };
+
+    auto& row = _buffer->GetRowByOffset(0);
+    row.ReplaceCharacters(0, 1, L"A");
+    row.ReplaceCharacters(1, 1, L"B");
+    row.ReplaceCharacters(2, 2, L"\x304b");
+    row.ReplaceCharacters(4, 1, L"C");
+    row.SetWrapForced(true);
+
+    const auto id = _buffer->GetHyperlinkId(url, {});
+    _buffer->AddHyperlinkToMap(url, id);
+    TextAttribute linkAttr{ 0x1f };
+    linkAttr.SetHyperlinkId(id);
+    row.ReplaceAttributes(2, 4, linkAttr);
+
+    _buffer->IncrementCircularBuffer();
+    _buffer->IncrementCircularBuffer();
+
+    VERIFY_ARE_EQUAL(2u, _buffer->SpilledRowCount());
+    VERIFY_ARE_EQUAL(text, _buffer->GetSpilledRowText(0));
+    VERIFY_IS_TRUE(_buffer->WasSpilledRowWrapForced(0));
+    VERIFY_ARE_EQUAL(L"", _buffer->GetSpilledRowText(1));
+    VERIFY_IS_FALSE(_buffer->WasSpilledRowWrapForced(1));
+
+    Log::Comment(L"The hyperlink was pruned from the map when its row scrolled out and has to be re-registered.");
+    auto& restored = _buffer->GetRowByOffset(0);
+    _buffer->CopySpilledRow(0, restored);
+    VERIFY_ARE_EQUAL(L"AB\x304bC               ", restored.GetText());
+    VERIFY_IS_TRUE(restored.WasWrapForced());
+    VERIFY_ARE_EQUAL(attr.GetLegacyAttributes(), restored.GetAttrByColumn(1).GetLegacyAttributes());
+    const auto restoredAttr = restored.GetAttrByColumn(3);
+    VERIFY_ARE_EQUAL(linkAttr.GetLegacyAttributes(), restoredAttr.GetLegacyAttributes());
+    VERIFY_IS_TRUE(restoredAttr.IsHyperlink());
+    VERIFY_ARE_EQUAL(url, _buffer->GetHyperlinkUriFromId(restoredAttr.GetHyperlinkId()));
+
+    Log::Comment(L"Disabling the spill discards the spilled rows.");
+    _buffer->SetScrollbackSpill(false);
+    VERIFY_ARE_EQUAL(0u, _buffer->SpilledRowCount());
+}
+
+// This tests that the rows which scroll out of a full buffer while it's reflowed
+// are spilled after the rows that were spilled before the reflow.
+void TextBufferTests::ScrollbackSpillReflow()
+{
+    const til::size bufferSize{ 10, 5 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto oldBuffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+    oldBuffer->SetScrollbackSpill(true);
+
+    oldBuffer->GetRowByOffset(0).ReplaceCharacters(0, 1, L"x");
+    oldBuffer->IncrementCircularBuffer();
+    VERIFY_ARE_EQUAL(1u, oldBuffer->SpilledRowCount());
+
+    // Every row is twice as wide as the new buffer, which
+    // means that half of them can't fit into it anymore.
+    for (til::CoordType y = 0; y < bufferSize.height; ++y)
+    {
+        const auto lower = std::wstring(5, gsl::narrow_cast<wchar_t>(L'a' + y));
+        const auto upper = std::wstring(5, gsl::narrow_cast<wchar_t>(L'A' + y));
+        auto& row = oldBuffer->GetRowByOffset(y);
+        til::CoordType column = 0;
+        for (const auto ch : lower + upper)
+        {
+            row.ReplaceCharacters(column++, 1, { &ch, 1 });
+        }
+    }
+
+    auto newBuffer = std::make_unique<TextBuffer>(til::size{ 5, 5 }, attr, cursorSize, false, _renderer);
+    VERIFY_SUCCEEDED(TextBuffer::Reflow(*oldBuffer, *newBuffer, std::nullopt, std::nullopt));
+
+    Log::Comment(L"The spill moved to the new buffer and contains the rows it discarded during the reflow.");
+    VERIFY_ARE_EQUAL(0u, oldBuffer->SpilledRowCount());
+    VERIFY_IS_GREATER_THAN(newBuffer->SpilledRowCount(), 2u);
+    VERIFY_ARE_EQUAL(L"x", newBuffer->GetSpilledRowText(0));
+    VERIFY_ARE_EQUAL(L"aaaaa", newBuffer->GetSpilledRowText(1));
+    VERIFY_IS_TRUE(newBuffer->WasSpilledRowWrapForced(1));
+    VERIFY_ARE_EQUAL(L"AAAAA", newBuffer->GetSpilledRowText(2));
+}
+
+// This tests that a buffer snapshot restores the rows, spilled rows, hyperlinks and cursor,
+// and that saving into an existing snapshot keeps the spilled rows that are already in it.
+void TextBufferTests::SnapshotRoundTrip()
+{
+    const til::size bufferSize{ 20, 5 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+    _buffer->SetScrollbackSpill(true);
+
+    static constexpr std::wstring_view url{ L"test.url" };
+
+    const auto writeRow = [&](const til::CoordType y, const std::wstring_view& text) {
+        auto& row = _buffer->GetRowByOffset(y);
+        row.ReplaceCharacters(0, 1, text);
+        row.ReplaceCharacters(1, 2, L"\x304b");
+        row.SetWrapForced(true);
+    };
+
+    writeRow(0, L"A");
+    _buffer->IncrementCircularBuffer();
+
+    std::vector<std::byte> snapshot;
+    _buffer->SaveSnapshot(snapshot);
+    const auto firstSize = snapshot.size();
+
+    writeRow(0, L"B");
+    _buffer->IncrementCircularBuffer();
+
+    const auto id = _buffer->GetHyperlinkId(url, {});
+    _buffer->AddHyperlinkToMap(url, id);
+    TextAttribute linkAttr{ 0x1f };
+    linkAttr.SetHyperlinkId(id);
+    auto& row = _buffer->GetRowByOffset(2);
+    row.ReplaceCharacters(4, 1, L"C");
+    row.ReplaceAttributes(4, 5, linkAttr);
+    row.SetLineRendition(LineRendition::DoubleWidth);
+    _buffer->GetCursor().SetPosition({ 5, 2 });
+
+    Log::Comment(L"Saving again only appends the row that was spilled since the last snapshot.");
+    _buffer->SaveSnapshot(snapshot);
+    VERIFY_IS_GREATER_THAN(snapshot.size(), firstSize);
+
+    Log::Comment(L"Restoring into a buffer of a different size resizes it.");
+    auto restored = std::make_unique<TextBuffer>(til::size{ 10, 3 }, attr, cursorSize, false, _renderer);
+    restored->LoadSnapshot(snapshot);
+    VERIFY_ARE_EQUAL(bufferSize, restored->GetSize().Dimensions());
+
+    VERIFY_ARE_EQUAL(2u, restored->SpilledRowCount());
+    VERIFY_ARE_EQUAL(L"A\x304b", restored->GetSpilledRowText(0));
+    VERIFY_ARE_EQUAL(L"B\x304b", restored->GetSpilledRowText(1));
+    VERIFY_IS_TRUE(restored->WasSpilledRowWrapForced(1));
+
+    const auto& restoredRow = restored->GetRowByOffset(2);
+    VERIFY_ARE_EQUAL(_buffer->GetRowByOffset(2).GetText(), restoredRow.GetText());
+    VERIFY_IS_TRUE(restoredRow.GetLineRendition() == LineRendition::DoubleWidth);
+    VERIFY_ARE_EQUAL(attr.GetLegacyAttributes(), restoredRow.GetAttrByColumn(3).GetLegacyAttributes());
+    const auto restoredAttr = restoredRow.GetAttrByColumn(4);
+    VERIFY_IS_TRUE(restoredAttr.IsHyperlink());
+    VERIFY_ARE_EQUAL(url, restored->GetHyperlinkUriFromId(restoredAttr.GetHyperlinkId()));
+    VERIFY_ARE_EQUAL(til::point(5, 2), restored->GetCursor().GetPosition());
+
+    Log::Comment(L"Truncated snapshots are rejected.");
+    const auto truncated = std::span{ snapshot }.first(snapshot.size() - 1);
+    VERIFY_THROWS(restored->LoadSnapshot(truncated), wil::ResultException);
+
+    Log::Comment(L"Spilled rows whose glyphs don't add up to their text are rejected.");
+    {
+        // The glyph table of a spilled row directly precedes its text: "A" is 1 char and 1 column
+        // wide and U+304B is 1 char and 2 columns wide. Claiming that the latter is 2 chars long
+        // would make CopyTo() read past the end of the row's text.
+        static constexpr uint16_t spilledRow[]{ 0x0001, 0x8001, L'A', 0x304b };
+        const auto needle = std::as_bytes(std::span{ spilledRow });
+        auto corrupt = snapshot;
+        const auto glyphs = std::search(corrupt.begin(), corrupt.end(), needle.begin(), needle.end());
+        VERIFY_IS_TRUE(glyphs != corrupt.end());
+        static constexpr uint16_t overlong = 0x8002;
+        memcpy(&*glyphs + sizeof(uint16_t), &overlong, sizeof(overlong));
+        VERIFY_THROWS(restored->LoadSnapshot(corrupt), wil::ResultException);
+    }
+
+    Log::Comment(L"A snapshot of another buffer is rewritten, not appended to.");
+    auto other = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+    other->SetScrollbackSpill(true);
+    other->GetRowByOffset(0).ReplaceCharacters(0, 1, L"Z");
+    other->IncrementCircularBuffer();
+    other->SaveSnapshot(snapshot);
+    restored->LoadSnapshot(snapshot);
+    VERIFY_ARE_EQUAL(1u, restored->SpilledRowCount());
+    VERIFY_ARE_EQUAL(L"Z", restored->GetSpilledRowText(0));
+}
+
+// This tests that snapshots with out-of-range values or dangling hyperlink IDs
+// are rejected and that the buffer is left as it was when that happens.
+void TextBufferTests::SnapshotRejectsInvalidData()
+{
+    const til::size bufferSize{ 10, 2 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    auto source = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, false, _renderer);
+
+    static constexpr std::wstring_view url{ L"test.url" };
+    const auto id = source->GetHyperlinkId(url, {});
+    source->AddHyperlinkToMap(url, id);
+    TextAttribute linkAttr{ 0x1f };
+    linkAttr.SetHyperlinkId(id);
+    auto& row = source->GetRowByOffset(0);
+    row.ReplaceCharacters(0, 1, L"A");
+    row.ReplaceAttributes(0, 1, linkAttr);
+
+    std::vector<std::byte> snapshot;
+    source->SaveSnapshot(snapshot);
+
+    // Offsets into a snapshot without spilled rows, as laid out by SnapshotHeader,
+    // SnapshotBufferHeader and SnapshotRowHeader in textBuffer.cpp.
+    static constexpr size_t bufferHeaderOffset = 48;
+    static constexpr size_t cursorTypeOffset = bufferHeaderOffset + 20;
+    static constexpr size_t hyperlinkMapOffset = bufferHeaderOffset + 36 + sizeof(TextAttribute);
+    static constexpr size_t firstRowOffset = hyperlinkMapOffset + 2 * sizeof(uint16_t) + url.size() * sizeof(wchar_t);
+    static constexpr size_t lineRenditionOffset = firstRowOffset + 4;
+
+    const auto corrupt = [&](const size_t offset, const auto value) {
+        auto copy = snapshot;
+        memcpy(copy.data() + offset, &value, sizeof(value));
+        return copy;
+    };
+
+    auto restored = std::make_unique<TextBuffer>(til::size{ 5, 3 }, attr, cursorSize, false, _renderer);
+    restored->GetRowByOffset(1).ReplaceCharacters(0, 1, L"Z");
+
+    const auto verifyUntouched = [&]() {
+        VERIFY_ARE_EQUAL(til::size(5, 3), restored->GetSize().Dimensions());
+        VERIFY_ARE_EQUAL(L"Z    ", restored->GetRowByOffset(1).GetText());
+    };
+
+    Log::Comment(L"The offsets above match the snapshot.");
+    VERIFY_ARE_EQUAL(static_cast<uint32_t>(source->GetCursor().GetType()), *reinterpret_cast<const uint32_t*>(snapshot.data() + cursorTypeOffset));
+    VERIFY_ARE_EQUAL(id, *reinterpret_cast<const uint16_t*>(snapshot.data() + hyperlinkMapOffset));
+    VERIFY_ARE_EQUAL(gsl::narrow_cast<uint16_t>(bufferSize.width), *reinterpret_cast<const uint16_t*>(snapshot.data() + firstRowOffset));
+
+    Log::Comment(L"An unknown cursor type is rejected.");
+    VERIFY_THROWS(restored->LoadSnapshot(corrupt(cursorTypeOffset, uint32_t{ 6 })), wil::ResultException);
+    verifyUntouched();
+
+    Log::Comment(L"An unknown line rendition is rejected.");
+    VERIFY_THROWS(restored->LoadSnapshot(corrupt(lineRenditionOffset, uint8_t{ 4 })), wil::ResultException);
+    verifyUntouched();
+
+    Log::Comment(L"Attributes that refer to a hyperlink that isn't in the map are rejected.");
+    VERIFY_THROWS(restored->LoadSnapshot(corrupt(hyperlinkMapOffset, gsl::narrow_cast<uint16_t>(id + 1))), wil::ResultException);
+    verifyUntouched();
+
+    Log::Comment(L"A truncated row is rejected, even though all rows before it are fine.");
+    VERIFY_THROWS(restored->LoadSnapshot(std::span{ snapshot }.first(snapshot.size() - 2)), wil::ResultException);
+    verifyUntouched();
+
+    Log::Comment(L"The unmodified snapshot is accepted.");
+    restored->LoadSnapshot(snapshot);
+    VERIFY_ARE_EQUAL(bufferSize, restored->GetSize().Dimensions());
+    VERIFY_ARE_EQUAL(url, restored->GetHyperlinkUriFromId(restored->GetRowByOffset(0).GetAttrByColumn(0).GetHyperlinkId()));
+}
+
+// This measures restoring a snapshot of 100k rows, most of which were spilled,
+// and verifies that they come back intact.
+void TextBufferTests::SnapshotRestoreTiming()
+{
+    static constexpr til::CoordType width = 120;
+    static constexpr til::CoordType height = 10000;
+    static constexpr size_t spilledRows = 90000;
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    const TextAttribute highlight{ 0x1f };
+    auto source = std::make_unique<TextBuffer>(til::size{ width, height }, attr, cursorSize, false, _renderer);
+    source->SetScrollbackSpill(true);
+
+    const auto writeRow = [&](ROW& row, const size_t index) {
+        const auto text = fmt::format(L"{:>8} The quick brown fox jumps over the lazy dog. \x304b\x304c", index);
+        RowWriteState state{ .text = text, .columnLimit = width };
+        row.ReplaceText(state);
+        row.ReplaceAttributes(0, 8, highlight);
+    };
+
+    for (size_t i = 0; i < spilledRows; ++i)
+    {
+        writeRow(source->GetRowByOffset(0), i);
+        source->IncrementCircularBuffer();
+    }
+    for (til::CoordType y = 0; y < height; ++y)
+    {
+        writeRow(source->GetRowByOffset(y), spilledRows + y);
+    }
+
+    std::vector<std::byte> snapshot;
+    source->SaveSnapshot(snapshot);
+
+    auto restored = std::make_unique<TextBuffer>(til::size{ 80, 25 }, attr, cursorSize, false, _renderer);
+    const auto start = std::chrono::steady_clock::now();
+    restored->LoadSnapshot(snapshot);
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    Log::Comment(NoThrowString().Format(L"Restored %zu rows (%zu KiB) in %.1f ms.",
+                                        spilledRows + height,
+                                        snapshot.size() / 1024,
+                                        elapsed.count()));
+
+    VERIFY_ARE_EQUAL(spilledRows, restored->SpilledRowCount());
+    for (const auto index : { size_t{ 0 }, spilledRows / 2, spilledRows - 1 })
+    {
+        VERIFY_ARE_EQUAL(source->GetSpilledRowText(index), restored->GetSpilledRowText(index));
+    }
+    for (const auto y : { 0, height / 2, height - 1 })
+    {
+        const auto& expected = source->GetRowByOffset(y);
+        const auto& actual = restored->GetRowByOffset(y);
+        VERIFY_ARE_EQUAL(expected.GetText(), actual.GetText());
+        VERIFY_ARE_EQUAL(highlight, actual.GetAttrByColumn(7));
+        VERIFY_ARE_EQUAL(attr, actual.GetAttrByColumn(8));
+    }
+}
+
+// This tests that the TextBuffer::FillRect() fast path produces the same contents
+// as writing the fill character cell by cell, including around wide glyphs.
+void TextBufferTests::FillMatchesWriteLine()
+{
+    const til::size bufferSize{ 10, 3 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x7f };
+    const TextAttribute fillAttr{ 0x1f };
+
+    for (const auto& [left, right] : std::initializer_list<std::pair<til::CoordType, til::CoordType>>{ { 0, 10 }, { 1, 4 }, { 2, 3 }, { 3, 10 }, { 5, 6 } })
+    {
+        Log::Comment(NoThrowString().Format(L"Filling columns %d to %d", left, right));
+
+        TextBuffer expected{ bufferSize, attr, cursorSize, false, _renderer };
+        TextBuffer actual{ bufferSize, attr, cursorSize, false, _renderer };
+        for (auto buffer : { &expected, &actual })
+        {
+            for (til::CoordType y = 0; y < bufferSize.height; ++y)
+            {
+                // Wide glyphs in columns 0-1, 2-3, 4-5 and 6-7.
+                auto& row = buffer->GetRowByOffset(y);
+                for (til::CoordType x = 0; x < 8; x += 2)
+                {
+                    row.ReplaceCharacters(x, 2, L"\x304b");
+                }
+                row.SetWrapForced(true);
+            }
+        }
+
+        const auto fillData = OutputCellIterator{ L'x', fillAttr, gsl::narrow_cast<size_t>(right - left) };
+        for (til::CoordType y = 0; y < 2; ++y)
+        {
+            expected.WriteLine(fillData, { left, y }, false);
+        }
+        actual.FillRect({ left, 0, right, 2 }, L'x', fillAttr);
+
+        for (til::CoordType y = 0; y < bufferSize.height; ++y)
+        {
+            const auto& expectedRow = expected.GetRowByOffset(y);
+            const auto& actualRow = actual.GetRowByOffset(y);
+            VERIFY_ARE_EQUAL(expectedRow.GetText(), actualRow.GetText());
+            VERIFY_ARE_EQUAL(expectedRow.WasWrapForced(), actualRow.WasWrapForced());
+            VERIFY_ARE_EQUAL(expectedRow.WasDoubleBytePadded(), actualRow.WasDoubleBytePadded());
+            for (til::CoordType x = 0; x < bufferSize.width; ++x)
+            {
+                VERIFY_IS_TRUE(expectedRow.DbcsAttrAt(x) == actualRow.DbcsAttrAt(x));
+                VERIFY_ARE_EQUAL(expectedRow.GetAttrByColumn(x), actualRow.GetAttrByColumn(x));
+            }
+        }
+    }
+}
+
+// This tests the span based ROW primitives used by the rectangular area operations.
+void TextBufferTests::RowSpanOperations()
+{
+    const til::size bufferSize{ 10, 1 };
+    const UINT cursorSize = 12;
+    const TextAttribute attr{ 0x07 };
+    TextBuffer buffer{ bufferSize, attr, cursorSize, false, _renderer };
+
+    // "a", a wide glyph in columns 1-2, "b", followed by spaces.
+    auto& row = buffer.GetRowByOffset(0);
+    row.ReplaceCharacters(0, 1, L"a");
+    row.ReplaceCharacters(1, 2, L"\x304b");
+    row.ReplaceCharacters(3, 1, L"b");
+
+    Log::Comment(L"GetText() with a column range includes every intersecting glyph once.");
+    VERIFY_ARE_EQUAL(L"a\x304bb", row.GetText(0, 4));
+    VERIFY_ARE_EQUAL(L"\x304b", row.GetText(2, 3));
+    VERIFY_ARE_EQUAL(L"a\x304b", row.GetText(0, 2));
+    VERIFY_ARE_EQUAL(L"", row.GetText(5, 5));
+    VERIFY_ARE_EQUAL(L"   ", row.GetText(7, 20));
+
+    Log::Comment(L"TransformAttributes() applies the change to every run in the range.");
+    row.ReplaceAttributes(2, 4, TextAttribute{ 0x17 });
+    row.TransformAttributes(1, 6, [](TextAttribute& a) { a.SetUnderlined(true); });
+
+    auto underlined = TextAttribute{ 0x07 };
+    underlined.SetUnderlined(true);
+    auto underlinedBlue = TextAttribute{ 0x17 };
+    underlinedBlue.SetUnderlined(true);
+
+    VERIFY_ARE_EQUAL(attr, row.GetAttrByColumn(0));
+    VERIFY_ARE_EQUAL(underlined, row.GetAttrByColumn(1));
+    VERIFY_ARE_EQUAL(underlinedBlue, row.GetAttrByColumn(2));
+    VERIFY_ARE_EQUAL(underlinedBlue, row.GetAttrByColumn(3));
+    VERIFY_ARE_EQUAL(underlined, row.GetAttrByColumn(5));
+    VERIFY_ARE_EQUAL(attr, row.GetAttrByColumn(6));
+    VERIFY_ARE_EQUAL(5u, row.Attributes().runs().size());
+}
@@ -0,0 +1,350 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "CommonState.hpp"
+
+#include "../server/DeviceComm.h"
+#include "../server/WaitBlock.h"
+#include "../server/WaitQueue.h"
+
+#include "../interactivity/inc/ServiceLocator.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+using Microsoft::Console::Interactivity::ServiceLocator;
+
+namespace
+{
+    // Satisfied waits are completed through the global device comm. This one only counts them.
+    class MockDeviceComm final : public IDeviceComm
+    {
+    public:
+        [[nodiscard]] HRESULT SetServerInformation(_In_ CD_IO_SERVER_INFORMATION* const /*pServerInfo*/) const override { return E_NOTIMPL; }
+        [[nodiscard]] HRESULT ReadIo(_In_opt_ PCONSOLE_API_MSG const /*pReplyMsg*/, _Out_ CONSOLE_API_MSG* const /*pMessage*/) const override { return E_NOTIMPL; }
+        [[nodiscard]] HRESULT CompleteIo(_In_ CD_IO_COMPLETE* const /*pCompletion*/) const override
+        {
+            completed++;
+            return S_OK;
+        }
+        [[nodiscard]] HRESULT ReadInput(_In_ CD_IO_OPERATION* const /*pIoOperation*/) const override { return E_NOTIMPL; }
+        [[nodiscard]] HRESULT WriteOutput(_In_ CD_IO_OPERATION* const /*pIoOperation*/) const override { return E_NOTIMPL; }
+        [[nodiscard]] HRESULT AllowUIAccess() const override { return E_NOTIMPL; }
+        [[nodiscard]] ULONG_PTR PutHandle(const void* /*handle*/) override { return 0; }
+        [[nodiscard]] void* GetHandle(ULONG_PTR /*handleId*/) const override { return nullptr; }
+        [[nodiscard]] HRESULT GetServerHandle(_Out_ HANDLE* pHandle) const override
+        {
+            *pHandle = nullptr;
+            return E_NOTIMPL;
+        }
+
+        mutable size_t completed = 0;
+    };
+
+    // Records the order in which waits are notified. Like the real ones, it's
+    // always satisfied when the queue it's in goes away, and otherwise once it's ready.
+    class MockWaitRoutine final : public IWaitRoutine
+    {
+    public:
+        MockWaitRoutine(std::vector<int>& notified, const int id) noexcept :
+            IWaitRoutine{ ReplyDataType::Read },
+            _notified{ notified },
+            _id{ id }
+        {
+        }
+
+        void MigrateUserBuffersOnTransitionToBackgroundWait(const void* /*oldBuffer*/, void* /*newBuffer*/) override
+        {
+        }
+
+        bool Notify(const WaitTerminationReason TerminationReason,
+                    const bool /*fIsUnicode*/,
+                    _Out_ NTSTATUS* const pReplyStatus,
+                    _Out_ size_t* const pNumBytes,
+                    _Out_ DWORD* const pControlKeyState,
+                    _Out_ void* const /*pOutputData*/) override
+        {
+            _notified.push_back(_id);
+            if (onNotify)
+            {
+                onNotify();
+            }
+
+            *pReplyStatus = STATUS_SUCCESS;
+            *pNumBytes = 0;
+            *pControlKeyState = 0;
+            return ready || WI_IsFlagSet(TerminationReason, WaitTerminationReason::ThreadDying);
+        }
+
+        bool ready = false;
+        std::function<void()> onNotify;
+
+    private:
+        std::vector<int>& _notified;
+        int _id;
+    };
+}
+
+class WaitQueueTests
+{
+    CommonState* m_state;
+    MockDeviceComm* m_deviceComm;
+    IDeviceComm* m_previousDeviceComm;
+    std::vector<int> m_notified;
+
+    TEST_CLASS(WaitQueueTests);
+
+    TEST_CLASS_SETUP(ClassSetup)
+    {
+        m_state = new CommonState();
+        return true;
+    }
+
+    TEST_CLASS_CLEANUP(ClassCleanup)
+    {
+        delete m_state;
+        return true;
+    }
+
+    TEST_METHOD_SETUP(MethodSetup)
+    {
+        auto& g = ServiceLocator::LocateGlobals();
+        m_deviceComm = new MockDeviceComm();
+        m_previousDeviceComm = std::exchange(g.pDeviceComm, m_deviceComm);
+        m_notified.clear();
+        return true;
+    }
+
+    TEST_METHOD_CLEANUP(MethodCleanup)
+    {
+        auto& g = ServiceLocator::LocateGlobals();
+        g.pDeviceComm = m_previousDeviceComm;
+        delete m_deviceComm;
+        return true;
+    }
+
+    struct Wait
+    {
+        ConsoleWaitBlock* block;
+        MockWaitRoutine* waiter;
+    };
+
+    // This does what ConsoleWaitBlock::s_CreateWait does, minus looking up the queues through the message's handles.
+    Wait _CreateWait(ConsoleWaitQueue& processQueue, ConsoleWaitQueue& objectQueue, const ULONG apiNumber, const int id)
+    {
+        CONSOLE_API_MSG message;
+        message.msgHeader.ApiNumber = apiNumber;
+
+        const auto waiter = new MockWaitRoutine(m_notified, id);
+        const auto block = new ConsoleWaitBlock(&processQueue, &objectQueue, &message, waiter);
+        processQueue._Enqueue(block->_processLink);
+        objectQueue._Enqueue(block->_objectLink);
+        return { block, waiter };
+    }
+
+    // Returns the blocks in one of the lists of a queue, in order, and checks that the list is consistent while doing so.
+    static std::vector<ConsoleWaitBlock*> _BlocksIn(const ConsoleWaitQueue& queue, const ConsoleWaitReason reason)
+    {
+        std::vector<ConsoleWaitBlock*> blocks;
+        const auto& head = til::at(queue._blocks, static_cast<size_t>(reason));
+        for (auto link = head.next; link != &head; link = link->next)
+        {
+            VERIFY_ARE_EQUAL(link, link->next->prev);
+            blocks.push_back(link->block);
+        }
+        VERIFY_ARE_EQUAL(&head, head.next->prev);
+        return blocks;
+    }
+
+    TEST_METHOD(LinkInsertAndUnlink)
+    {
+        ConsoleWaitLink head;
+        std::array<ConsoleWaitLink, 3> links;
+
+        Log::Comment(L"An empty list head and an unlinked node point to themselves.");
+        VERIFY_IS_FALSE(head.IsLinked());
+        VERIFY_ARE_EQUAL(&head, head.prev);
+        VERIFY_ARE_EQUAL(&head, head.next);
+
+        Log::Comment(L"Inserting before the head appends to the tail.");
+        for (auto& link : links)
+        {
+            link.InsertBefore(head);
+        }
+        VERIFY_IS_TRUE(head.IsLinked());
+        VERIFY_ARE_EQUAL(&links[0], head.next);
+        VERIFY_ARE_EQUAL(&links[1], links[0].next);
+        VERIFY_ARE_EQUAL(&links[2], links[1].next);
+        VERIFY_ARE_EQUAL(&head, links[2].next);
+        VERIFY_ARE_EQUAL(&links[2], head.prev);
+        VERIFY_ARE_EQUAL(&links[1], links[2].prev);
+        VERIFY_ARE_EQUAL(&links[0], links[1].prev);
+        VERIFY_ARE_EQUAL(&head, links[0].prev);
+
+        Log::Comment(L"Unlinking from the middle joins the neighbors and resets the node.");
+        links[1].Unlink();
+        VERIFY_IS_FALSE(links[1].IsLinked());
+        VERIFY_ARE_EQUAL(&links[1], links[1].prev);
+        VERIFY_ARE_EQUAL(&links[2], links[0].next);
+        VERIFY_ARE_EQUAL(&links[0], links[2].prev);
+
+        Log::Comment(L"Unlinking an unlinked node does nothing.");
+        links[1].Unlink();
+        VERIFY_ARE_EQUAL(&links[2], links[0].next);
+
+        Log::Comment(L"Inserting before another node inserts in the middle.");
+        links[1].InsertBefore(links[2]);
+        VERIFY_ARE_EQUAL(&links[1], links[0].next);
+        VERIFY_ARE_EQUAL(&links[2], links[1].next);
+
+        Log::Comment(L"Unlinking the first and last node leaves the list empty.");
+        links[0].Unlink();
+        links[2].Unlink();
+        VERIFY_ARE_EQUAL(&links[1], head.next);
+        VERIFY_ARE_EQUAL(&links[1], head.prev);
+        links[1].Unlink();
+        VERIFY_IS_FALSE(head.IsLinked());
+        VERIFY_ARE_EQUAL(&head, head.prev);
+    }
+
+    TEST_METHOD(NotifyInCreationOrder)
+    {
+        ConsoleWaitQueue processQueue;
+        ConsoleWaitQueue objectQueue;
+
+        const auto first = _CreateWait(processQueue, objectQueue, API_NUMBER_READCONSOLE, 1);
+        const auto second = _CreateWait(processQueue, objectQueue, API_NUMBER_READCONSOLE, 2);
+        const auto third = _CreateWait(processQueue, objectQueue, API_NUMBER_READCONSOLE, 3);
+        VERIFY_IS_TRUE(_BlocksIn(objectQueue, ConsoleWaitReason::InputAvailable) == std::vector{ first.block, second.block, third.block });
+        VERIFY_IS_TRUE(_BlocksIn(processQueue, ConsoleWaitReason::InputAvailable) == std::vector{ first.block, second.block, third.block });
+
+        Log::Comment(L"Notifying one waiter only visits the oldest one, even if it keeps waiting.");
+        VERIFY_IS_FALSE(objectQueue.NotifyWaiters(false));
+        VERIFY_IS_TRUE(m_notified == std::vector{ 1 });
+
+        Log::Comment(L"Notifying all of them visits each once, in order. Satisfied ones are removed.");
+        m_notified.clear();
+        second.waiter->ready = true;
+        VERIFY_IS_TRUE(objectQueue.NotifyWaiters(true));
+        VERIFY_IS_TRUE(m_notified == std::vector({ 1, 2, 3 }));
+        VERIFY_ARE_EQUAL(1u, m_deviceComm->completed);
+        VERIFY_IS_TRUE(_BlocksIn(objectQueue, ConsoleWaitReason::InputAvailable) == std::vector{ first.block, third.block });
+        VERIFY_IS_TRUE(_BlocksIn(processQueue, ConsoleWaitReason::InputAvailable) == std::vector{ first.block, third.block });
+
+        Log::Comment(L"New waits go to the tail.");
+        const auto fourth = _CreateWait(processQueue, objectQueue, API_NUMBER_READCONSOLE, 4);
+        VERIFY_IS_TRUE(_BlocksIn(objectQueue, ConsoleWaitReason::InputAvailable) == std::vector{ first.block, third.block, fourth.block });
+    }
+
+    TEST_METHOD(NotifyAllWakesReadersBeforeWriters)
+    {
+        ConsoleWaitQueue processQueue;
+        ConsoleWaitQueue objectQueue;
+
+        const auto write1 = _CreateWait(processQueue, objectQueue, API_NUMBER_WRITECONSOLE, 1);
+        const auto read2 = _CreateWait(processQueue, objectQueue, API_NUMBER_READCONSOLE, 2);
+        const auto write3 = _CreateWait(processQueue, objectQueue, API_NUMBER_WRITECONSOLE, 3);
+        const auto read4 = _CreateWait(processQueue, objectQueue, API_NUMBER_GETCONSOLEINPUT, 4);
+        VERIFY_IS_TRUE(_BlocksIn(objectQueue, ConsoleWaitReason::InputAvailable) == std::vector{ read2.block, read4.block });
+        VERIFY_IS_TRUE(_BlocksIn(objectQueue, ConsoleWaitReason::OutputUnblocked) == std::vector{ write1.block, write3.block });
+
+        Log::Comment(L"All InputAvailable waiters are notified before any OutputUnblocked one.");
+        VERIFY_IS_FALSE(objectQueue.NotifyWaiters(true));
+        VERIFY_IS_TRUE(m_notified == std::vector({ 2, 4, 1, 3 }));
+
+        Log::Comment(L"Notifying one waiter picks the oldest one of the first reason that has any.");
+        m_notified.clear();
+        VERIFY_IS_FALSE(objectQueue.NotifyWaiters(false));
+        VERIFY_IS_TRUE(m_notified == std::vector{ 2 });
+
+        Log::Comment(L"Notifying by reason doesn't visit the other waiters.");
+        m_notified.clear();
+        write1.waiter->ready = true;
+        write3.waiter->ready = true;
+        VERIFY_IS_TRUE(objectQueue.NotifyWaiters(true, ConsoleWaitReason::OutputUnblocked));
+        VERIFY_IS_TRUE(m_notified == std::vector({ 1, 3 }));
+        VERIFY_IS_FALSE(objectQueue.HasWaiters(ConsoleWaitReason::OutputUnblocked));
+        VERIFY_IS_FALSE(processQueue.HasWaiters(ConsoleWaitReason::OutputUnblocked));
+        VERIFY_IS_TRUE(objectQueue.HasWaiters(ConsoleWaitReason::InputAvailable));
+
+        Log::Comment(L"Once a reason has no waiters left, notifying one waiter skips to the next reason.");
+        m_notified.clear();
+        read2.waiter->ready = true;
+        read4.waiter->ready = true;
+        VERIFY_IS_TRUE(objectQueue.NotifyWaiters(true, ConsoleWaitReason::InputAvailable));
+        const auto write5 = _CreateWait(processQueue, objectQueue, API_NUMBER_WRITECONSOLE, 5);
+        m_notified.clear();
+        VERIFY_IS_FALSE(objectQueue.NotifyWaiters(false));
+        VERIFY_IS_TRUE(m_notified == std::vector{ 5 });
+        VERIFY_IS_TRUE(_BlocksIn(processQueue, ConsoleWaitReason::OutputUnblocked) == std::vector{ write5.block });
+    }
+
+    TEST_METHOD(UnlinkDuringNotification)
+    {
+        ConsoleWaitQueue processQueue;
+        ConsoleWaitQueue objectQueue;
+
+        Log::Comment(L"Every satisfied block unlinks itself while the list is being walked.");
+        std::vector<Wait> waits;
+        for (auto id = 1; id <= 5; id++)
+        {
+            waits.emplace_back(_CreateWait(processQueue, objectQueue, API_NUMBER_READCONSOLE, id));
+            waits.back().waiter->ready = true;
+        }
+        VERIFY_IS_TRUE(objectQueue.NotifyWaiters(true));
+        VERIFY_IS_TRUE(m_notified == std::vector({ 1, 2, 3, 4, 5 }));
+        VERIFY_ARE_EQUAL(5u, m_deviceComm->completed);
+        VERIFY_IS_FALSE(objectQueue.HasWaiters(ConsoleWaitReason::InputAvailable));
+        VERIFY_IS_FALSE(processQueue.HasWaiters(ConsoleWaitReason::InputAvailable));
+
+        Log::Comment(L"A waiter may remove a block that was already visited while it's being notified.");
+        m_notified.clear();
+        const auto first = _CreateWait(processQueue, objectQueue, API_NUMBER_READCONSOLE, 1);
+        const auto second = _CreateWait(processQueue, objectQueue, API_NUMBER_READCONSOLE, 2);
+        const auto third = _CreateWait(processQueue, objectQueue, API_NUMBER_READCONSOLE, 3);
+        second.waiter->onNotify = [&]() {
+            delete first.block;
+        };
+        const auto notified = objectQueue.NotifyWaiters(true);
+        second.waiter->onNotify = nullptr;
+        VERIFY_IS_FALSE(notified);
+        VERIFY_IS_TRUE(m_notified == std::vector({ 1, 2, 3 }));
+        VERIFY_IS_TRUE(_BlocksIn(objectQueue, ConsoleWaitReason::InputAvailable) == std::vector{ second.block, third.block });
+        VERIFY_IS_TRUE(_BlocksIn(processQueue, ConsoleWaitReason::InputAvailable) == std::vector{ second.block, third.block });
+    }
+
+    TEST_METHOD(DeleteRemovesFromBothQueues)
+    {
+        ConsoleWaitQueue processQueue1;
+        ConsoleWaitQueue processQueue2;
+        ConsoleWaitQueue objectQueue;
+
+        const auto wait1 = _CreateWait(processQueue1, objectQueue, API_NUMBER_READCONSOLE, 1);
+        const auto wait2 = _CreateWait(processQueue2, objectQueue, API_NUMBER_READCONSOLE, 2);
+        const auto wait3 = _CreateWait(processQueue1, objectQueue, API_NUMBER_READCONSOLE, 3);
+        VERIFY_IS_TRUE(_BlocksIn(processQueue1, ConsoleWaitReason::InputAvailable) == std::vector{ wait1.block, wait3.block });
+        VERIFY_IS_TRUE(_BlocksIn(processQueue2, ConsoleWaitReason::InputAvailable) == std::vector{ wait2.block });
+
+        Log::Comment(L"Deleting a block removes it from its process and its object queue.");
+        delete wait1.block;
+        VERIFY_IS_TRUE(_BlocksIn(processQueue1, ConsoleWaitReason::InputAvailable) == std::vector{ wait3.block });
+        VERIFY_IS_TRUE(_BlocksIn(objectQueue, ConsoleWaitReason::InputAvailable) == std::vector{ wait2.block, wait3.block });
+
+        Log::Comment(L"A block satisfied through its process queue is removed from the object queue as well.");
+        wait3.waiter->ready = true;
+        VERIFY_IS_TRUE(processQueue1.NotifyWaiters(true));
+        VERIFY_IS_FALSE(processQueue1.HasWaiters(ConsoleWaitReason::InputAvailable));
+        VERIFY_IS_TRUE(_BlocksIn(objectQueue, ConsoleWaitReason::InputAvailable) == std::vector{ wait2.block });
+
+        Log::Comment(L"A block satisfied through its object queue is removed from the process queue as well.");
+        wait2.waiter->ready = true;
+        VERIFY_IS_TRUE(objectQueue.NotifyWaiters(true));
+        VERIFY_IS_FALSE(objectQueue.HasWaiters(ConsoleWaitReason::InputAvailable));
+        VERIFY_IS_FALSE(processQueue2.HasWaiters(ConsoleWaitReason::InputAvailable));
+        VERIFY_IS_TRUE(m_notified == std::vector({ 3, 2 }));
+    }
+};
@@ -0,0 +1,1045 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#pragma once
+
+namespace til
+{
+    // A regular expression engine whose run time is guaranteed to be linear in the
+    // length of the searched text, no matter the pattern. std::wregex is a backtracking
+    // engine and patterns like "(a|aa)*b" make it take exponential time (or overflow
+    // its stack), which we can't allow for patterns typed by the user.
+    //
+    // The pattern is compiled once into a Thompson NFA which is then simulated with a
+    // "Pike VM": all possible states are advanced in lock step, one code point at a time,
+    // and each state is visited at most once per position. Match priorities follow
+    // ECMAScript: the leftmost match wins, and greedy/lazy quantifiers are respected.
+    //
+    // Supported syntax:
+    // * literals, ".", "[...]" and "[^...]" with ranges
+    // * \d \D \w \W \s \S \b \B \t \n \r \f \v \0 \xHH \uHHHH and escaped punctuation
+    // * "^" and "$" (which match at the start and end of the searched text)
+    // * "(...)" and "(?:...)" (neither captures), "|"
+    // * "*", "+", "?", "{n}", "{n,}", "{n,m}" and their lazy "?" variants
+    // Back-references and lookarounds are deliberately unsupported, because they
+    // can't be implemented in linear time.
+    class linear_regex
+    {
+    public:
+        linear_regex() = default;
+
+        // Throws std::invalid_argument if the pattern is malformed or too large.
+        explicit linear_regex(const std::wstring_view pattern, const bool ignoreCase = false) :
+            _ignoreCase{ ignoreCase }
+        {
+            _parser parser{ *this, pattern };
+            const auto root = parser.parse();
+
+            _program.reserve(_nodes.size() + 1);
+            _emit(root);
+            _push({ _op::match });
+
+            if (const auto& first = _program.front(); first.code == _op::character && !_ignoreCase && first.x <= 0xFFFF)
+            {
+                _firstChar = static_cast<wchar_t>(first.x);
+            }
+
+            // The syntax tree is only needed for compiling the program.
+            _nodes = {};
+        }
+
+        bool empty() const noexcept
+        {
+            return _program.empty();
+        }
+
+        // Finds the leftmost match in text that starts at or after offset.
+        // Returns the [begin, end) UTF-16 offsets of the match. Matches may be empty.
+        std::optional<std::pair<size_t, size_t>> find(const std::wstring_view text, size_t offset = 0) const
+        {
+            if (_program.empty() || offset > text.size())
+            {
+                return std::nullopt;
+            }
+
+            std::optional<std::pair<size_t, size_t>> match;
+            std::vector<_thread> current;
+            std::vector<_thread> next;
+            std::vector<uint32_t> stack;
+            // _marks[pc] == generation if pc was already added for the current position.
+            std::vector<size_t> marks(_program.size());
+            size_t generation = 1;
+
+            for (auto pos = offset;;)
+            {
+                // Threads that started earlier take priority, which is why the
+                // thread starting at this position is added last. Once we've got
+                // a match we only need to see if any earlier thread can extend it.
+                if (!match)
+                {
+                    // If no thread is alive and every match starts with the same
+                    // character, we can skip straight to its next occurrence.
+                    if (current.empty() && _firstChar)
+                    {
+                        const auto next = text.find(*_firstChar, pos);
+                        if (next == std::wstring_view::npos)
+                        {
+                            break;
+                        }
+                        if (next != pos)
+                        {
+                            pos = next;
+                            ++generation;
+                        }
+                    }
+
+                    _addThread(current, marks, generation, stack, 0, pos, text, pos);
+                }
+
+                char32_t cp = 0;
+                size_t width = 0;
+                if (pos < text.size())
+                {
+                    std::tie(cp, width) = _decode(text, pos);
+                }
+
+                // Once all threads died we're done, unless there's no match yet
+                // and we can try again starting at the next position.
+                if (current.empty() && (match || !width))
+                {
+                    break;
+                }
+
+                ++generation;
+                next.clear();
+
+                for (const auto& thread : current)
+                {
+                    const auto& inst = _program[thread.pc];
+                    if (inst.code == _op::match)
+                    {
+                        // All remaining threads have a lower priority than this one.
+                        match.emplace(thread.start, pos);
+                        break;
+                    }
+                    if (width && _consumes(inst, cp))
+                    {
+                        _addThread(next, marks, generation, stack, thread.pc + 1, thread.start, text, pos + width);
+                    }
+                }
+
+                if (!width)
+                {
+                    break;
+                }
+
+                pos += width;
+                std::swap(current, next);
+            }
+
+            return match;
+        }
+
+    private:
+        static constexpr uint32_t _unbounded = UINT32_MAX;
+        // Limits the size of the compiled program and the nesting of the pattern,
+        // as otherwise a short pattern like "(((a{1000}){1000}){1000})" would be
+        // enough to exhaust the memory, or the stack during parsing.
+        static constexpr size_t _maxProgramSize = 64 * 1024;
+        static constexpr size_t _maxRepeatCount = 1000;
+        static constexpr size_t _maxNesting = 200;
+
+        enum class _op : uint8_t
+        {
+            character,
+            any,
+            set,
+            split,
+            jump,
+            line_begin,
+            line_end,
+            word_boundary,
+            not_word_boundary,
+            match,
+        };
+
+        // For split, x is the preferred target and y the alternative.
+        // For jump, x is the target. For character and set, x is the value.
+        struct _instruction
+        {
+            _op code;
+            uint32_t x = 0;
+            uint32_t y = 0;
+        };
+
+        enum _class : uint8_t
+        {
+            _classDigit = 1 << 0,
+            _classWord = 1 << 1,
+            _classSpace = 1 << 2,
+        };
+
+        struct _set
+        {
+            std::vector<std::pair<char32_t, char32_t>> ranges;
+            uint8_t classes = 0;
+            uint8_t negatedClasses = 0;
+            bool negated = false;
+        };
+
+        enum class _node_type : uint8_t
+        {
+            empty,
+            leaf,
+            concat,
+            alternate,
+            repeat,
+        };
+
+        struct _node
+        {
+            _node_type type = _node_type::empty;
+            // For leaves: the instruction to emit.
+            _instruction leaf{ _op::match };
+            // For repeats: the bounds and whether the quantifier is greedy.
+            // The first child is emitted for the min required iterations and the
+            // second one for the optional iterations (see _parser::repetition).
+            uint32_t min = 0;
+            uint32_t max = 0;
+            bool greedy = true;
+            std::vector<size_t> children;
+        };
+
+        struct _thread
+        {
+            uint32_t pc;
+            size_t start;
+        };
+
+        struct _parser
+        {
+            // The paths through a node in the order of their priority, split around the first
+            // path that matches the empty string: "before" and "after" match the non-empty
+            // paths that come before and after it. Empty paths are all the same in a node
+            // without assertions, which is why only the first one of them is relevant.
+            struct parts_t
+            {
+                std::optional<size_t> before;
+                bool nullable = false;
+                std::optional<size_t> after;
+            };
+
+            linear_regex& re;
+            std::wstring_view pattern;
+            size_t pos = 0;
+            size_t depth = 0;
+            std::vector<std::optional<parts_t>> partsCache;
+
+            size_t parse()
+            {
+                const auto root = alternation();
+                if (pos != pattern.size())
+                {
+                    fail("unmatched ')'");
+                }
+                return root;
+            }
+
+            [[noreturn]] static void fail(const char* message)
+            {
+                throw std::invalid_argument{ message };
+            }
+
+            bool done() const noexcept
+            {
+                return pos >= pattern.size();
+            }
+
+            wchar_t peek() const noexcept
+            {
+                return done() ? L'\0' : pattern[pos];
+            }
+
+            bool accept(const wchar_t ch) noexcept
+            {
+                if (!done() && pattern[pos] == ch)
+                {
+                    ++pos;
+                    return true;
+                }
+                return false;
+            }
+
+            char32_t next()
+            {
+                if (done())
+                {
+                    fail("unexpected end of pattern");
+                }
+                const auto [cp, width] = _decode(pattern, pos);
+                pos += width;
+                return cp;
+            }
+
+            size_t add(_node node)
+            {
+                // Rewriting nullable loops (see repetition()) may copy parts of the pattern.
+                if (re._nodes.size() >= _maxProgramSize)
+                {
+                    fail("pattern is too large");
+                }
+                re._nodes.emplace_back(std::move(node));
+                return re._nodes.size() - 1;
+            }
+
+            size_t leaf(const _op code, const uint32_t x = 0)
+            {
+                _node node;
+                node.type = _node_type::leaf;
+                node.leaf = { code, x };
+                return add(std::move(node));
+            }
+
+            size_t alternation()
+            {
+                if (++depth > _maxNesting)
+                {
+                    fail("pattern is nested too deeply");
+                }
+
+                _node node;
+                node.type = _node_type::alternate;
+                node.children.emplace_back(concatenation());
+                while (accept(L'|'))
+                {
+                    node.children.emplace_back(concatenation());
+                }
+
+                --depth;
+                return node.children.size() == 1 ? node.children.front() : add(std::move(node));
+            }
+
+            size_t concatenation()
+            {
+                _node node;
+                node.type = _node_type::concat;
+                while (!done() && peek() != L'|' && peek() != L')')
+                {
+                    node.children.emplace_back(repetition());
+                }
+                return add(std::move(node));
+            }
+
+            size_t repetition()
+            {
+                const auto atom = this->atom();
+                uint32_t min = 0;
+                uint32_t max = 0;
+
+                if (accept(L'*'))
+                {
+                    max = _unbounded;
+                }
+                else if (accept(L'+'))
+                {
+                    min = 1;
+                    max = _unbounded;
+                }
+                else if (accept(L'?'))
+                {
+                    max = 1;
+                }
+                else if (!bounds(min, max))
+                {
+                    return atom;
+                }
+
+                const auto greedy = !accept(L'?');
+
+                // ECMAScript rejects optional iterations that match the empty string and
+                // backtracks into the body instead. For instance "(x??){0,2}" matches "xx".
+                // We get the same result by only allowing the paths through the body that
+                // consume something for the optional iterations. Bodies with assertions in
+                // them are left as is, because their empty paths aren't interchangeable.
+                auto optional = atom;
+                if (max > min && nullable(atom) && !hasAssertion(atom))
+                {
+                    const auto p = parts(atom);
+                    if (const auto nonEmpty = alternate(p.before, p.after))
+                    {
+                        optional = *nonEmpty;
+                    }
+                    else
+                    {
+                        // The body only ever matches the empty string, so there's nothing to repeat.
+                        max = min;
+                    }
+                }
+
+                return repeat(atom, optional, min, max, greedy);
+            }
+
+            size_t repeat(const size_t required, const size_t optional, const uint32_t min, const uint32_t max, const bool greedy)
+            {
+                _node node;
+                node.type = _node_type::repeat;
+                node.min = min;
+                node.max = max;
+                node.greedy = greedy;
+                node.children = { required, optional };
+                return add(std::move(node));
+            }
+
+            size_t concat(const size_t a, const size_t b)
+            {
+                _node node;
+                node.type = _node_type::concat;
+                node.children = { a, b };
+                return add(std::move(node));
+            }
+
+            std::optional<size_t> concat(const std::optional<size_t> a, const size_t b)
+            {
+                return a ? std::optional{ concat(*a, b) } : std::nullopt;
+            }
+
+            std::optional<size_t> alternate(const std::optional<size_t> a, const std::optional<size_t> b)
+            {
+                if (!a || !b)
+                {
+                    return a ? a : b;
+                }
+                _node node;
+                node.type = _node_type::alternate;
+                node.children = { *a, *b };
+                return add(std::move(node));
+            }
+
+            bool nullable(const size_t index) const
+            {
+                const auto& node = re._nodes[index];
+                switch (node.type)
+                {
+                case _node_type::leaf:
+                    return node.leaf.code != _op::character && node.leaf.code != _op::any && node.leaf.code != _op::set;
+                case _node_type::concat:
+                    return std::all_of(node.children.begin(), node.children.end(), [&](const auto child) { return nullable(child); });
+                case _node_type::alternate:
+                    return std::any_of(node.children.begin(), node.children.end(), [&](const auto child) { return nullable(child); });
+                case _node_type::repeat:
+                    return node.min == 0 || nullable(node.children.front());
+                default:
+                    return true;
+                }
+            }
+
+            bool hasAssertion(const size_t index) const
+            {
+                const auto& node = re._nodes[index];
+                if (node.type == _node_type::leaf)
+                {
+                    return nullable(index);
+                }
+                if (node.type == _node_type::repeat)
+                {
+                    // The optional iterations are derived from the required ones.
+                    return hasAssertion(node.children.front());
+                }
+                return std::any_of(node.children.begin(), node.children.end(), [&](const auto child) { return hasAssertion(child); });
+            }
+
+            // Returns the parts of a node without assertions. This creates new nodes,
+            // so the result may contain copies of the node's children.
+            parts_t parts(const size_t index)
+            {
+                // Nodes never change once they're added, so the parts can be cached.
+                if (index < partsCache.size() && partsCache[index])
+                {
+                    return *partsCache[index];
+                }
+                const auto result = computeParts(index);
+                partsCache.resize(std::max(partsCache.size(), index + 1));
+                partsCache[index] = result;
+                return result;
+            }
+
+            parts_t computeParts(const size_t index)
+            {
+                // add() may reallocate _nodes, so we can't hold on to a reference.
+                const auto node = re._nodes[index];
+                switch (node.type)
+                {
+                case _node_type::leaf:
+                    return { index, false, std::nullopt };
+                case _node_type::alternate:
+                {
+                    parts_t result;
+                    for (const auto child : node.children)
+                    {
+                        const auto p = parts(child);
+                        if (result.nullable)
+                        {
+                            result.after = alternate(result.after, alternate(p.before, p.after));
+                        }
+                        else
+                        {
+                            result.before = alternate(result.before, p.before);
+                            if (p.nullable)
+                            {
+                                result.nullable = true;
+                                result.after = p.after;
+                            }
+                            else
+                            {
+                                result.before = alternate(result.before, p.after);
+                            }
+                        }
+                    }
+                    return result;
+                }
+                case _node_type::concat:
+                    return concatParts(node.children, std::nullopt);
+                case _node_type::repeat:
+                {
+                    const auto required = node.children.front();
+                    const auto optional = node.children.back();
+
+                    // The optional iterations only consist of non-empty paths (see repetition()),
+                    // so their only empty path is the one that skips them. The non-empty paths
+                    // of "o{0,k}" are those of "o o{0,k-1}", and they come first if it's greedy.
+                    std::optional<std::pair<size_t, parts_t>> tail;
+                    if (node.max > node.min)
+                    {
+                        const auto count = node.max == _unbounded ? _unbounded : node.max - node.min;
+                        const auto all = repeat(optional, optional, 0, count, node.greedy);
+                        const auto next = count == _unbounded ? all : repeat(optional, optional, 0, count - 1, node.greedy);
+                        const auto nonEmpty = concat(optional, next);
+                        tail.emplace(all, node.greedy ? parts_t{ nonEmpty, true, std::nullopt } : parts_t{ std::nullopt, true, nonEmpty });
+                    }
+
+                    const std::vector<size_t> copies(node.min, required);
+                    return concatParts(copies, std::move(tail));
+                }
+                default:
+                    return { std::nullopt, true, std::nullopt };
+                }
+            }
+
+            // Returns the parts of the concatenation of the given nodes and an optional tail.
+            parts_t concatParts(const std::vector<size_t>& children, std::optional<std::pair<size_t, parts_t>> tail)
+            {
+                // The paths of "a b" are ordered by the path through a first, and then by the path
+                // through b. With a = [a1, empty, a2] and b = [b1, empty, b2], the non-empty ones are:
+                // a1 b, b1, (empty), b2, a2 b
+                auto rest = tail ? std::optional{ tail->first } : std::nullopt;
+                auto result = tail ? tail->second : parts_t{ std::nullopt, true, std::nullopt };
+                for (auto it = children.rbegin(); it != children.rend(); ++it)
+                {
+                    const auto child = *it;
+                    if (!rest)
+                    {
+                        result = parts(child);
+                        rest = child;
+                        continue;
+                    }
+
+                    const auto p = parts(child);
+                    if (p.nullable)
+                    {
+                        result.before = alternate(concat(p.before, *rest), result.before);
+                        result.after = alternate(result.after, concat(p.after, *rest));
+                    }
+                    else
+                    {
+                        result = { concat(child, *rest), false, std::nullopt };
+                    }
+                    rest = concat(child, *rest);
+                }
+                return result;
+            }
+
+            // Parses "{n}", "{n,}" or "{n,m}". Anything else is a literal "{", like in ECMAScript.
+            bool bounds(uint32_t& min, uint32_t& max)
+            {
+                const auto start = pos;
+                if (!accept(L'{'))
+                {
+                    return false;
+                }
+
+                const auto number = [&](uint32_t& value) {
+                    const auto begin = pos;
+                    size_t result = 0;
+                    while (!done() && peek() >= L'0' && peek() <= L'9')
+                    {
+                        result = std::min<size_t>(result * 10 + (peek() - L'0'), _maxRepeatCount + 1);
+                        ++pos;
+                    }
+                    if (pos == begin)
+                    {
+                        return false;
+                    }
+                    value = static_cast<uint32_t>(result);
+                    return true;
+                };
+
+                if (number(min))
+                {
+                    max = min;
+                    if (accept(L','))
+                    {
+                        max = _unbounded;
+                        number(max);
+                    }
+                    if (accept(L'}'))
+                    {
+                        if (min > _maxRepeatCount || (max != _unbounded && max > _maxRepeatCount))
+                        {
+                            fail("repeat count is too large");
+                        }
+                        if (min > max)
+                        {
+                            fail("numbers out of order in {} quantifier");
+                        }
+                        return true;
+                    }
+                }
+
+                pos = start;
+                return false;
+            }
+
+            size_t atom()
+            {
+                const auto ch = next();
+                switch (ch)
+                {
+                case L'(':
+                {
+                    if (accept(L'?') && !accept(L':'))
+                    {
+                        fail("unsupported group");
+                    }
+                    const auto inner = alternation();
+                    if (!accept(L')'))
+                    {
+                        fail("missing ')'");
+                    }
+                    return inner;
+                }
+                case L'[':
+                    return set();
+                case L'.':
+                    return leaf(_op::any);
+                case L'^':
+                    return leaf(_op::line_begin);
+                case L'$':
+                    return leaf(_op::line_end);
+                case L'*':
+                case L'+':
+                case L'?':
+                    fail("nothing to repeat");
+                case L'\\':
+                    return escape();
+                default:
+                    return leaf(_op::character, re._fold(ch));
+                }
+            }
+
+            size_t escape()
+            {
+                const auto ch = next();
+                switch (ch)
+                {
+                case L'b':
+                    return leaf(_op::word_boundary);
+                case L'B':
+                    return leaf(_op::not_word_boundary);
+                case L'd':
+                case L'D':
+                case L'w':
+                case L'W':
+                case L's':
+                case L'S':
+                {
+                    _set set;
+                    classEscape(ch, set);
+                    return leaf(_op::set, re._addSet(std::move(set)));
+                }
+                default:
+                    return leaf(_op::character, re._fold(characterEscape(ch)));
+                }
+            }
+
+            // Adds the class for \d, \D, \w, \W, \s or \S to the given set.
+            static void classEscape(const char32_t ch, _set& set) noexcept
+            {
+                const auto lower = ch | 0x20;
+                const uint8_t cls = lower == U'd' ? _classDigit : lower == U'w' ? _classWord :
+                                                                                    _classSpace;
+                if (ch == lower)
+                {
+                    set.classes |= cls;
+                }
+                else
+                {
+                    set.negatedClasses |= cls;
+                }
+            }
+
+            char32_t characterEscape(const char32_t ch)
+            {
+                switch (ch)
+                {
+                case U't':
+                    return U'\t';
+                case U'n':
+                    return U'\n';
+                case U'r':
+                    return U'\r';
+                case U'f':
+                    return U'\f';
+                case U'v':
+                    return U'\v';
+                case U'0':
+                    return U'\0';
+                case U'x':
+                    return hex(2);
+                case U'u':
+                    return hex(4);
+                default:
+                    // Any other escaped letter or digit is most likely a feature we don't support
+                    // (like a back-reference), so we refuse it instead of silently matching it literally.
+                    if ((ch >= U'a' && ch <= U'z') || (ch >= U'A' && ch <= U'Z') || (ch >= U'0' && ch <= U'9'))
+                    {
+                        fail("unsupported escape sequence");
+                    }
+                    return ch;
+                }
+            }
+
+            char32_t hex(const size_t digits)
+            {
+                char32_t value = 0;
+                for (size_t i = 0; i < digits; ++i)
+                {
+                    const auto ch = next();
+                    uint32_t digit = 0;
+                    if (ch >= U'0' && ch <= U'9')
+                    {
+                        digit = ch - U'0';
+                    }
+                    else if ((ch | 0x20) >= U'a' && (ch | 0x20) <= U'f')
+                    {
+                        digit = (ch | 0x20) - U'a' + 10;
+                    }
+                    else
+                    {
+                        fail("invalid hexadecimal escape sequence");
+                    }
+                    value = value * 16 + digit;
+                }
+                return value;
+            }
+
+            size_t set()
+            {
+                _set set;
+                set.negated = accept(L'^');
+
+                // A "]" right at the start is a literal, like in most engines but unlike ECMAScript,
+                // where "[]" would never match. That's rather useless in a search box.
+                for (auto first = true; first || !accept(L']'); first = false)
+                {
+                    auto lo = next();
+                    if (lo == U'\\')
+                    {
+                        const auto ch = next();
+                        if ((ch | 0x20) == U'd' || (ch | 0x20) == U'w' || (ch | 0x20) == U's')
+                        {
+                            classEscape(ch, set);
+                            continue;
+                        }
+                        lo = ch == U'b' ? U'\b' : characterEscape(ch);
+                    }
+
+                    auto hi = lo;
+                    if (peek() == L'-' && pos + 1 < pattern.size() && pattern[pos + 1] != L']')
+                    {
+                        ++pos;
+                        hi = next();
+                        if (hi == U'\\')
+                        {
+                            hi = characterEscape(next());
+                        }
+                        if (hi < lo)
+                        {
+                            fail("range out of order in character class");
+                        }
+                    }
+
+                    set.ranges.emplace_back(lo, hi);
+                }
+
+                return leaf(_op::set, re._addSet(std::move(set)));
+            }
+        };
+
+        // Decodes the code point at the given offset. Unpaired surrogates are returned as is.
+        static std::pair<char32_t, size_t> _decode(const std::wstring_view text, const size_t pos) noexcept
+        {
+            const char32_t ch = text[pos];
+            if (ch >= 0xD800 && ch <= 0xDBFF && pos + 1 < text.size())
+            {
+                const char32_t trail = text[pos + 1];
+                if (trail >= 0xDC00 && trail <= 0xDFFF)
+                {
+                    return { 0x10000 + ((ch - 0xD800) << 10) + (trail - 0xDC00), 2 };
+                }
+            }
+            return { ch, 1 };
+        }
+
+        static bool _isWord(const char32_t ch) noexcept
+        {
+            return (ch >= U'0' && ch <= U'9') || (ch >= U'a' && ch <= U'z') || (ch >= U'A' && ch <= U'Z') || ch == U'_';
+        }
+
+        static bool _inClasses(const uint8_t classes, const char32_t ch) noexcept
+        {
+            return ((classes & _classDigit) && ch >= U'0' && ch <= U'9') ||
+                   ((classes & _classWord) && _isWord(ch)) ||
+                   ((classes & _classSpace) && (ch == U' ' || (ch >= U'\t' && ch <= U'\r') || ch == 0xA0 || ch == 0x3000 || ch == 0xFEFF));
+        }
+
+        static char32_t _lower(const char32_t ch) noexcept
+        {
+            return ch <= 0xFFFF ? static_cast<char32_t>(std::towlower(static_cast<wint_t>(ch))) : ch;
+        }
+
+        static char32_t _upper(const char32_t ch) noexcept
+        {
+            return ch <= 0xFFFF ? static_cast<char32_t>(std::towupper(static_cast<wint_t>(ch))) : ch;
+        }
+
+        char32_t _fold(const char32_t ch) const noexcept
+        {
+            return _ignoreCase ? _lower(ch) : ch;
+        }
+
+        bool _setContains(const _set& set, const char32_t ch) const noexcept
+        {
+            const auto test = [&](const char32_t c) {
+                if (_inClasses(set.classes, c) || (set.negatedClasses && !_inClasses(set.negatedClasses, c)))
+                {
+                    return true;
+                }
+                for (const auto& [lo, hi] : set.ranges)
+                {
+                    if (c >= lo && c <= hi)
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            };
+
+            const auto contained = test(ch) || (_ignoreCase && (test(_lower(ch)) || test(_upper(ch))));
+            return contained != set.negated;
+        }
+
+        bool _consumes(const _instruction& inst, const char32_t ch) const noexcept
+        {
+            switch (inst.code)
+            {
+            case _op::character:
+                return _fold(ch) == inst.x;
+            case _op::any:
+                return true;
+            case _op::set:
+                return _setContains(_sets[inst.x], ch);
+            default:
+                return false;
+            }
+        }
+
+        static bool _isWordBoundary(const std::wstring_view text, const size_t pos) noexcept
+        {
+            // Word characters are all ASCII, so we don't need to decode surrogate pairs here.
+            const auto before = pos > 0 && _isWord(text[pos - 1]);
+            const auto after = pos < text.size() && _isWord(text[pos]);
+            return before != after;
+        }
+
+        // Adds the thread for pc and all threads reachable from it without consuming
+        // any input to the list, in order of their priority. Each pc is only added
+        // once per position, which is what guarantees the linear run time.
+        void _addThread(std::vector<_thread>& list, std::vector<size_t>& marks, const size_t generation, std::vector<uint32_t>& stack, const uint32_t pc, const size_t start, const std::wstring_view text, const size_t pos) const
+        {
+            stack.push_back(pc);
+            while (!stack.empty())
+            {
+                const auto current = stack.back();
+                stack.pop_back();
+
+                if (marks[current] == generation)
+                {
+                    continue;
+                }
+                marks[current] = generation;
+
+                const auto& inst = _program[current];
+                switch (inst.code)
+                {
+                case _op::jump:
+                    stack.push_back(inst.x);
+                    break;
+                case _op::split:
+                    stack.push_back(inst.y);
+                    stack.push_back(inst.x);
+                    break;
+                case _op::line_begin:
+                    if (pos == 0)
+                    {
+                        stack.push_back(current + 1);
+                    }
+                    break;
+                case _op::line_end:
+                    if (pos == text.size())
+                    {
+                        stack.push_back(current + 1);
+                    }
+                    break;
+                case _op::word_boundary:
+                case _op::not_word_boundary:
+                    if (_isWordBoundary(text, pos) == (inst.code == _op::word_boundary))
+                    {
+                        stack.push_back(current + 1);
+                    }
+                    break;
+                default:
+                    list.push_back({ current, start });
+                    break;
+                }
+            }
+        }
+
+        uint32_t _addSet(_set set)
+        {
+            _sets.emplace_back(std::move(set));
+            return static_cast<uint32_t>(_sets.size() - 1);
+        }
+
+        uint32_t _push(const _instruction inst)
+        {
+            if (_program.size() >= _maxProgramSize)
+            {
+                throw std::invalid_argument{ "pattern is too large" };
+            }
+            _program.emplace_back(inst);
+            return static_cast<uint32_t>(_program.size() - 1);
+        }
+
+        uint32_t _pc() const noexcept
+        {
+            return static_cast<uint32_t>(_program.size());
+        }
+
+        void _emit(const size_t index)
+        {
+            // _nodes may not be modified while we hold this reference.
+            const auto& node = _nodes[index];
+            switch (node.type)
+            {
+            case _node_type::empty:
+                break;
+            case _node_type::leaf:
+                _push(node.leaf);
+                break;
+            case _node_type::concat:
+                for (const auto child : node.children)
+                {
+                    _emit(child);
+                }
+                break;
+            case _node_type::alternate:
+            {
+                //     split L1, L2
+                // L1: <child 0>
+                //     jump end
+                // L2: split L3, L4
+                // ...
+                std::vector<uint32_t> jumps;
+                for (size_t i = 0; i < node.children.size(); ++i)
+                {
+                    if (i + 1 == node.children.size())
+                    {
+                        _emit(node.children[i]);
+                        break;
+                    }
+
+                    const auto split = _push({ _op::split, _pc() + 1 });
+                    _emit(node.children[i]);
+                    jumps.emplace_back(_push({ _op::jump }));
+                    _program[split].y = _pc();
+                }
+                for (const auto jump : jumps)
+                {
+                    _program[jump].x = _pc();
+                }
+                break;
+            }
+            case _node_type::repeat:
+            {
+                for (uint32_t i = 0; i < node.min; ++i)
+                {
+                    _emit(node.children.front());
+                }
+
+                const auto child = node.children.back();
+                if (node.max == _unbounded)
+                {
+                    // L1: split L2, end
+                    // L2: <child>
+                    //     jump L1
+                    const auto split = _push({ _op::split });
+                    _emit(child);
+                    _push({ _op::jump, split });
+                    _setSplit(split, split + 1, _pc(), node.greedy);
+                }
+                else
+                {
+                    // Each optional copy may be skipped, which ends the repetition:
+                    //     split L1, end
+                    // L1: <child>
+                    //     split L2, end
+                    // L2: <child>
+                    std::vector<uint32_t> splits;
+                    for (auto i = node.min; i < node.max; ++i)
+                    {
+                        splits.emplace_back(_push({ _op::split }));
+                        _emit(child);
+                    }
+                    for (const auto split : splits)
+                    {
+                        _setSplit(split, split + 1, _pc(), node.greedy);
+                    }
+                }
+                break;
+            }
+            }
+        }
+
+        void _setSplit(const uint32_t split, const uint32_t body, const uint32_t skip, const bool greedy) noexcept
+        {
+            _program[split].x = greedy ? body : skip;
+            _program[split].y = greedy ? skip : body;
+        }
+
+        std::vector<_instruction> _program;
+        std::vector<_set> _sets;
+        std::vector<_node> _nodes;
+        std::optional<wchar_t> _firstChar;
+        bool _ignoreCase = false;
+    };
+}
@@ -1813,6 +1813,173 @@ class UiaTextRangeTests
         }
     }
 
+    TEST_METHOD(AttributeRunsMatchCells)
+    {
+        // FindAttribute and GetAttributeValue test whole runs of attributes at once.
+        // This verifies that they produce the same results as testing each cell individually.
+        TextAttribute italicAttr;
+        italicAttr.SetItalic(true);
+        for (til::CoordType y = 0; y < 4; ++y)
+        {
+            auto& row = _pTextBuffer->GetRowByOffset(y);
+            for (til::CoordType x = 0; x < row.size(); ++x)
+            {
+                if ((x / (y + 2)) % 2 == 0)
+                {
+                    row.ReplaceAttributes(x, x + 1, italicAttr);
+                }
+            }
+        }
+
+        const auto isItalic = [&](const til::point pos) {
+            return _pTextBuffer->GetRowByOffset(pos.y).GetAttrByColumn(pos.x).IsItalic();
+        };
+
+        VARIANT var{};
+        var.vt = VT_BOOL;
+        var.boolVal = true;
+
+        const std::pair<til::point, til::point> ranges[]{
+            { { 0, 0 }, { 5, 0 } },
+            { { 1, 0 }, { 2, 0 } },
+            { { 3, 1 }, { 10, 2 } },
+            { { 5, 0 }, { 0, 4 } },
+            { { 79, 2 }, { 1, 3 } },
+        };
+        for (const auto& [start, end] : ranges)
+        {
+            Log::Comment(NoThrowString().Format(L"Range (%d,%d) to (%d,%d)", start.x, start.y, end.x, end.y));
+
+            Microsoft::WRL::ComPtr<UiaTextRange> utr;
+            THROW_IF_FAILED(Microsoft::WRL::MakeAndInitialize<UiaTextRange>(&utr, _pUiaData, &_dummyProvider, start, end));
+            const auto bufferSize = _pTextBuffer->GetSize();
+            const auto inclusiveEnd = utr->_getInclusiveEnd();
+
+            for (const auto searchBackwards : { false, true })
+            {
+                // Find the first contiguous run of italic cells, cell by cell.
+                std::optional<til::point> expectedFirst;
+                std::optional<til::point> expectedLast;
+                auto pos = searchBackwards ? inclusiveEnd : start;
+                for (;;)
+                {
+                    if (isItalic(pos))
+                    {
+                        expectedFirst = expectedFirst.value_or(pos);
+                        expectedLast = pos;
+                    }
+                    else if (expectedFirst)
+                    {
+                        break;
+                    }
+                    if (pos == (searchBackwards ? start : inclusiveEnd))
+                    {
+                        break;
+                    }
+                    searchBackwards ? bufferSize.DecrementInBounds(pos) : bufferSize.IncrementInBounds(pos);
+                }
+
+                Microsoft::WRL::ComPtr<ITextRangeProvider> result;
+                VERIFY_SUCCEEDED(utr->FindAttribute(UIA_IsItalicAttributeId, var, searchBackwards, result.GetAddressOf()));
+                VERIFY_ARE_EQUAL(expectedFirst.has_value(), result != nullptr);
+                if (result)
+                {
+                    auto expectedStart = searchBackwards ? *expectedLast : *expectedFirst;
+                    auto expectedEnd = searchBackwards ? *expectedFirst : *expectedLast;
+                    bufferSize.IncrementInBounds(expectedEnd, true);
+
+                    const auto resultUtr = static_cast<UiaTextRange*>(result.Get());
+                    VERIFY_ARE_EQUAL(expectedStart, resultUtr->_start);
+                    VERIFY_ARE_EQUAL(expectedEnd, resultUtr->_end);
+                }
+            }
+
+            // GetAttributeValue checks the cells up to, but not including, the inclusive end.
+            auto expectedMixed = false;
+            for (auto pos = start; pos != inclusiveEnd; bufferSize.IncrementInBounds(pos))
+            {
+                expectedMixed |= isItalic(pos) != isItalic(start);
+            }
+
+            VARIANT result;
+            VERIFY_SUCCEEDED(utr->GetAttributeValue(UIA_IsItalicAttributeId, &result));
+            if (expectedMixed)
+            {
+                Microsoft::WRL::ComPtr<IUnknown> mixedVal;
+                THROW_IF_FAILED(UiaGetReservedMixedAttributeValue(&mixedVal));
+                VERIFY_ARE_EQUAL(VT_UNKNOWN, result.vt);
+                VERIFY_ARE_EQUAL(mixedVal.Get(), result.punkVal);
+            }
+            else
+            {
+                VERIFY_ARE_EQUAL(VT_BOOL, result.vt);
+                VERIFY_ARE_EQUAL(isItalic(start), result.boolVal != VARIANT_FALSE);
+            }
+        }
+    }
+
+    TEST_METHOD(AttributeQueriesOnFullBuffer)
+    {
+        // Screen readers query attributes over large ranges. Use a buffer with the default
+        // history size, filled with text, and log how long the queries over all of it take.
+        static constexpr til::CoordType bufferHeight = 9001;
+        _state->CleanupNewTextBufferInfo();
+        _state->CleanupGlobalScreenBuffer();
+        _state->PrepareGlobalScreenBuffer(CommonState::s_csWindowWidth, CommonState::s_csWindowHeight, CommonState::s_csBufferWidth, bufferHeight);
+        _state->PrepareNewTextBufferInfo(false, CommonState::s_csBufferWidth, bufferHeight);
+
+        auto& gci = Microsoft::Console::Interactivity::ServiceLocator::LocateGlobals().getConsoleInformation();
+        _pScreenInfo = &gci.GetActiveOutputBuffer();
+        _pTextBuffer = &_pScreenInfo->GetTextBuffer();
+
+        // Alternate between two colors, so that every row has plenty of runs,
+        // while the font weight is the same everywhere except for the very last cell.
+        // This forces both queries to look at the entire buffer.
+        const TextAttribute greenAttr{ FOREGROUND_GREEN };
+        for (til::CoordType y = 0; y < bufferHeight; ++y)
+        {
+            auto& row = _pTextBuffer->GetRowByOffset(y);
+            row.FillCharacters(0, row.size(), L'X');
+            for (til::CoordType x = 0; x < row.size(); x += 8)
+            {
+                row.ReplaceAttributes(x, x + 4, greenAttr);
+            }
+        }
+
+        // The range ends (exclusively) at the start of the last row.
+        const til::point lastCell{ CommonState::s_csBufferWidth - 1, bufferHeight - 2 };
+        TextAttribute intenseAttr;
+        intenseAttr.SetIntense(true);
+        _pTextBuffer->GetRowByOffset(lastCell.y).ReplaceAttributes(lastCell.x, lastCell.x + 1, intenseAttr);
+
+        Microsoft::WRL::ComPtr<UiaTextRange> utr;
+        THROW_IF_FAILED(Microsoft::WRL::MakeAndInitialize<UiaTextRange>(&utr, _pUiaData, &_dummyProvider, til::point{ 0, 0 }, til::point{ 0, bufferHeight - 1 }));
+
+        VARIANT var{};
+        var.vt = VT_I4;
+        var.lVal = FW_BOLD;
+
+        const auto findStart = std::chrono::steady_clock::now();
+        Microsoft::WRL::ComPtr<ITextRangeProvider> found;
+        VERIFY_SUCCEEDED(utr->FindAttribute(UIA_FontWeightAttributeId, var, false, found.GetAddressOf()));
+        const auto findDuration = std::chrono::steady_clock::now() - findStart;
+
+        VERIFY_IS_NOT_NULL(found.Get());
+        VERIFY_ARE_EQUAL(lastCell, static_cast<UiaTextRange*>(found.Get())->_start);
+
+        // GetAttributeValue doesn't look at the inclusive end, which is the intense cell.
+        const auto getStart = std::chrono::steady_clock::now();
+        VARIANT result;
+        VERIFY_SUCCEEDED(utr->GetAttributeValue(UIA_FontWeightAttributeId, &result));
+        const auto getDuration = std::chrono::steady_clock::now() - getStart;
+        VERIFY_ARE_EQUAL(VT_I4, result.vt);
+        VERIFY_ARE_EQUAL(FW_NORMAL, result.lVal);
+
+        Log::Comment(NoThrowString().Format(L"FindAttribute: %lldus, GetAttributeValue: %lldus",
+                                            std::chrono::duration_cast<std::chrono::microseconds>(findDuration).count(),
+                                            std::chrono::duration_cast<std::chrono::microseconds>(getDuration).count()));
+    }
+
     TEST_METHOD(BlockRange)
     {
         // This test replicates GH#7960.
@@ -76,14 +76,10 @@ namespace
 #pragma pack(pop)
 }
 
-FontResource::FontResource(const std::span<const uint16_t> bitPattern,
-                           const til::size sourceSize,
-                           const til::size targetSize,
-                           const size_t centeringHint) :
-    _bitPattern{ bitPattern.begin(), bitPattern.end() },
-    _sourceSize{ sourceSize },
-    _targetSize{ targetSize },
-    _centeringHint{ centeringHint }
+FontResource::FontResource(const std::shared_ptr<const SoftFont>& softFont,
+                           const til::size targetSize) :
+    _softFont{ softFont },
+    _targetSize{ targetSize }
 {
 }
 
@@ -98,7 +94,7 @@ void FontResource::SetTargetSize(const til::size targetSize)
 
 FontResource::operator HFONT()
 {
-    if (!_fontHandle && !_bitPattern.empty())
+    if (!_fontHandle && _softFont)
     {
         _regenerateFont();
     }
@@ -146,11 +142,12 @@ void FontResource::_regenerateFont()
         fontResource.dfCharTable[i].geWidth = targetWidth;
     }
 
-    // Raster fonts aren't generally scalable, so we need to resize the bit
-    // patterns for the character glyphs to the requested target size, and
-    // copy the results into the resource structure.
+    // Raster fonts aren't generally scalable, so we need the glyphs resized
+    // to the requested target size, which the soft font has most likely
+    // already done for us, and copy the results into the resource structure.
+    const auto mask = _softFont->GetMask(_targetSize, false);
     auto fontResourceSpan = std::span<byte>(fontResourceBuffer);
-    _resizeBitPattern(fontResourceSpan.subspan(fontResource.dfBitsOffset));
+    _packGlyphs(*mask, fontResourceSpan.subspan(fontResource.dfBitsOffset));
 
     DWORD fontCount = 0;
     _resourceHandle.reset(AddFontMemResourceEx(&fontResource, fontResourceSize, nullptr, &fontCount));
@@ -169,113 +166,33 @@ void FontResource::_regenerateFont()
     LOG_HR_IF_NULL(E_FAIL, _fontHandle.get());
 }
 
-void FontResource::_resizeBitPattern(std::span<byte> targetBuffer)
+void FontResource::_packGlyphs(const SoftFont::Mask& mask, std::span<byte> targetBuffer)
 {
-    auto sourceWidth = _sourceSize.width;
-    auto targetWidth = _targetSize.width;
-    const auto sourceHeight = _sourceSize.height;
+    const auto targetWidth = _targetSize.width;
     const auto targetHeight = _targetSize.height;
-
-    // If the text in the font is not perfectly centered, the _centeringHint
-    // gives us the offset needed to correct that misalignment. So to ensure
-    // that any inserted or deleted columns are evenly spaced around the center
-    // point of the glyphs, we need to adjust the source and target widths by
-    // that amount (proportionally) before calculating the scaling increments.
-    targetWidth -= std::lround((double)_centeringHint * targetWidth / sourceWidth);
-    sourceWidth -= gsl::narrow_cast<int>(_centeringHint);
-
-    // The way the scaling works is by iterating over the target range, and
-    // calculating the source offsets that correspond to each target position.
-    // We achieve that by incrementing the source offset every iteration by an
-    // integer value that is the quotient of the source and target dimensions.
-    // Because this is an integer division, we're going to be off by a certain
-    // fraction on each iteration, so we need to keep track of that accumulated
-    // error using the modulus of the division. Once the error total exceeds
-    // the target dimension (more or less), we add another pixel to compensate
-    // for the error, and reset the error total.
-    const auto createIncrementFunction = [](const auto sourceDimension, const auto targetDimension) {
-        const auto increment = sourceDimension / targetDimension;
-        const auto errorIncrement = sourceDimension % targetDimension * 2;
-        const auto errorThreshold = targetDimension * 2 - std::min(sourceDimension, targetDimension);
-        const auto errorReset = targetDimension * 2;
-
-        return [=](auto& errorTotal) {
-            errorTotal += errorIncrement;
-            if (errorTotal > errorThreshold)
-            {
-                errorTotal -= errorReset;
-                return increment + 1;
-            }
-            return increment;
-        };
-    };
-    const auto columnIncrement = createIncrementFunction(sourceWidth, targetWidth);
-    const auto lineIncrement = createIncrementFunction(sourceHeight, targetHeight);
-
-    // Once we've calculated the scaling increments, taking the centering hint
-    // into account, we reset the target width back to its original value.
-    targetWidth = _targetSize.width;
+    const auto glyphCount = std::min(CHAR_COUNT, _softFont->GlyphCount());
 
     auto targetBufferPointer = targetBuffer.begin();
-    for (auto ch = 0; ch < CHAR_COUNT; ch++)
+    for (size_t ch = 0; ch < glyphCount; ch++)
     {
-        // Bits are read from the source from left to right - MSB to LSB. The source
-        // column is a single bit representing the 1-based position. The reason for
-        // this will become clear in the mask calculation below.
-        auto sourceColumn = 1 << 16;
-        auto sourceColumnError = 0;
+        const auto glyph = mask.Glyph(ch);
 
         // The target format expects the character bitmaps to be laid out in columns
-        // of 8 bits. So we generate 8 bits from each scanline until we've covered
-        // the full target height. Then we start again from the top with the next 8
-        // bits of the line, until we've covered the full target width.
+        // of 8 bits. So we generate 8 bits from each line of the mask until we've
+        // covered the full target height. Then we start again from the top with the
+        // next 8 pixels of the line, until we've covered the full target width.
         for (auto targetX = 0; targetX < targetWidth; targetX += 8)
         {
-            auto sourceLine = std::next(_bitPattern.begin(), ch * sourceHeight);
-            auto sourceLineError = 0;
-
-            // Since we're going to be reading from the same horizontal offset for each
-            // target line, we save the state here so we can reset it every iteration.
-            const auto initialSourceColumn = sourceColumn;
-            const auto initialSourceColumnError = sourceColumnError;
-
             for (auto targetY = 0; targetY < targetHeight; targetY++)
             {
-                sourceColumn = initialSourceColumn;
-                sourceColumnError = initialSourceColumnError;
-
-                // For a particular target line, we calculate the span of source lines from
-                // which it is derived, then OR those values together. We don't want the
-                // source value to be zero, though, so we must read at least one line.
-                const auto lineSpan = lineIncrement(sourceLineError);
-                auto sourceValue = 0;
-                for (auto i = 0; i < std::max(lineSpan, 1); i++)
-                {
-                    sourceValue |= sourceLine[i];
-                }
-                std::advance(sourceLine, lineSpan);
-
-                // From the combined value of the source lines, we now need to extract eight
-                // bits to make up the next byte in the target at the current X offset.
+                const auto line = glyph.subspan(gsl::narrow_cast<size_t>(targetY) * targetWidth, targetWidth);
                 byte targetValue = 0;
                 for (auto targetBit = 0; targetBit < 8; targetBit++)
                 {
                     targetValue <<= 1;
                     if (targetX + targetBit < targetWidth)
                     {
-                        // As with the line iteration, we first need to calculate the span of source
-                        // columns from which the target bit is derived. We shift our source column
-                        // position right by that amount to determine the next column position, then
-                        // subtract those two values to obtain a mask. For example, if we're reading
-                        // from columns 6 to 3 (exclusively), the initial column position is 1<<6,
-                        // the next column position is 1<<3, so the mask is 64-8=56, or 00111000.
-                        // Again we don't want this mask to be zero, so if the span is zero, we need
-                        // to shift an additional bit to make sure we cover at least one column.
-                        const auto columnSpan = columnIncrement(sourceColumnError);
-                        const auto nextSourceColumn = sourceColumn >> columnSpan;
-                        const auto sourceMask = sourceColumn - (nextSourceColumn >> (columnSpan ? 0 : 1));
-                        sourceColumn = nextSourceColumn;
-                        targetValue |= (sourceValue & sourceMask) ? 1 : 0;
+                        targetValue |= til::at(line, targetX + targetBit) ? 1 : 0;
                     }
                 }
                 *(targetBufferPointer++) = targetValue;
@@ -35,9 +35,7 @@ HRESULT RenderEngineBase::NotifyNewText(const std::wstring_view /*newText*/) noe
     return S_FALSE;
 }
 
-HRESULT RenderEngineBase::UpdateSoftFont(const std::span<const uint16_t> /*bitPattern*/,
-                                         const til::size /*cellSize*/,
-                                         const size_t /*centeringHint*/) noexcept
+HRESULT RenderEngineBase::UpdateSoftFont(const std::shared_ptr<const SoftFont>& /*softFont*/) noexcept
 {
     return S_FALSE;
 }
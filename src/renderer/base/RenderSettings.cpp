@@ -295,7 +295,10 @@ std::pair<COLORREF, COLORREF> RenderSettings::GetAttributeColorsWithAlpha(const
 //   renderer if there are blinking cells currently in view.
 // Arguments:
 // - renderer: the renderer that will be redrawn.
-void RenderSettings::ToggleBlinkRendition(Renderer& renderer) noexcept
+// Return Value:
+// - false if nothing is blinking anymore, in which case the caller may stop
+//   calling this method until ShouldResumeBlinking() returns true.
+bool RenderSettings::ToggleBlinkRendition(Renderer& renderer) noexcept
 try
 {
     if (GetRenderMode(Mode::BlinkAllowed))
@@ -306,6 +309,20 @@ try
         _blinkCycle = (_blinkCycle + 1) % 4;
         // ... and two of those four render the blink attributes as faint.
         _blinkShouldBeFaint = _blinkCycle >= 2;
+        // If we're back at the start of the cycle and no blinking cells have
+        // been painted since the last redraw, there's nothing left to blink.
+        // The blink attributes are currently rendered normally, so it's safe
+        // to stop the timer here, until the renderer comes across them again.
+        if (!_blinkIsInUse && _blinkCycle == 0)
+        {
+            if (!_blinkIsIdle)
+            {
+                _blinkIsIdle = true;
+                _blinkIdlePeriod++;
+            }
+            return false;
+        }
+        _blinkIsIdle = false;
         // Every two cycles (when the state changes), we need to trigger a
         // redraw, but only if there are actually blink attributes in use.
         if (_blinkIsInUse && _blinkCycle % 2 == 0)
@@ -315,6 +332,26 @@ try
             _blinkIsInUse = false;
             renderer.TriggerRedrawAll();
         }
+        return true;
     }
+    return false;
+}
+CATCH_LOG_RETURN_FALSE()
+
+// Routine Description:
+// - Returns true if blinking cells have been painted after ToggleBlinkRendition()
+//   reported that nothing is blinking anymore. This keeps returning true until
+//   the blink timer calls ToggleBlinkRendition() again, so callers that only
+//   want to restart the timer once should compare GetBlinkIdlePeriod() as well.
+bool RenderSettings::ShouldResumeBlinking() const noexcept
+{
+    return _blinkIsIdle && _blinkIsInUse;
+}
+
+// Routine Description:
+// - Returns a number that changes every time ToggleBlinkRendition()
+//   reports that nothing is blinking anymore.
+uint32_t RenderSettings::GetBlinkIdlePeriod() const noexcept
+{
+    return _blinkIdlePeriod;
 }
-CATCH_LOG()
@@ -0,0 +1,306 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "../inc/SoftFont.hpp"
+
+using namespace Microsoft::Console::Render;
+
+// Each scanline of the bit pattern is a 16-bit value, with the leftmost pixel in the MSB.
+static constexpr til::CoordType PATTERN_WIDTH = 16;
+
+// Generations are unique across all soft fonts, starting at 1.
+static std::atomic<uint64_t> s_nextGeneration{ 1 };
+
+namespace
+{
+    // The weights with which a range of source pixels contribute to a target pixel.
+    struct Contribution
+    {
+        til::CoordType first;
+        std::vector<float> weights;
+    };
+
+    // Routine Description:
+    // - Calculates which source pixels contribute to every target pixel when scaling by the given
+    //   factor, using a box filter. In other words, each target pixel is the average of the source
+    //   pixels it covers, weighted by how much of them it covers.
+    // Arguments:
+    // - targetSize - The number of target pixels.
+    // - scale - The ratio of the target to the source size.
+    // - sourceSize - The number of source pixels. Source pixels past the edge are clamped to it.
+    std::vector<Contribution> boxFilter(const til::CoordType targetSize, const float scale, const til::CoordType sourceSize)
+    {
+        std::vector<Contribution> contributions(targetSize);
+        for (til::CoordType target = 0; target < targetSize; target++)
+        {
+            const auto begin = target / scale;
+            const auto end = (target + 1) / scale;
+            const auto first = static_cast<til::CoordType>(std::floor(begin));
+            const auto last = static_cast<til::CoordType>(std::ceil(end));
+
+            auto& contribution = contributions[target];
+            contribution.first = first;
+            for (auto source = first; source < last; source++)
+            {
+                const auto overlap = std::min(end, source + 1.0f) - std::max(begin, static_cast<float>(source));
+                contribution.weights.emplace_back(overlap / (end - begin));
+            }
+
+            // Fold the weights of pixels past the edges into the edge pixels.
+            while (contribution.first < 0 && contribution.weights.size() > 1)
+            {
+                contribution.weights[1] += contribution.weights[0];
+                contribution.weights.erase(contribution.weights.begin());
+                contribution.first++;
+            }
+            while (contribution.first + gsl::narrow_cast<til::CoordType>(contribution.weights.size()) > sourceSize && contribution.weights.size() > 1)
+            {
+                const auto overflow = contribution.weights.back();
+                contribution.weights.pop_back();
+                contribution.weights.back() += overflow;
+            }
+            contribution.first = std::clamp(contribution.first, 0, sourceSize - 1);
+        }
+        return contributions;
+    }
+}
+
+std::span<const uint8_t> SoftFont::Mask::Glyph(const size_t glyphNumber) const noexcept
+{
+    const auto glyphSize = gsl::narrow_cast<size_t>(cellSize.area());
+    if (glyphSize == 0 || (glyphNumber + 1) * glyphSize > coverage.size())
+    {
+        return {};
+    }
+    return { coverage.data() + glyphNumber * glyphSize, glyphSize };
+}
+
+// Routine Description:
+// - Decodes the given bit pattern into the pixels that all masks are generated from.
+// Arguments:
+// - bitPattern - An array of scanlines representing all the glyphs in the font.
+// - sourceSize - The cell size for an individual glyph.
+// - centeringHint - The horizontal extent that glyphs are offset from center.
+SoftFont::SoftFont(const std::span<const uint16_t> bitPattern,
+                   const til::size sourceSize,
+                   const size_t centeringHint) :
+    _generation{ s_nextGeneration.fetch_add(1, std::memory_order_relaxed) },
+    _sourceSize{ sourceSize },
+    _centeringHint{ centeringHint },
+    _glyphCount{ sourceSize.height > 0 ? bitPattern.size() / sourceSize.height : 0 }
+{
+    _pixels.resize(_glyphCount * _sourceSize.height * PATTERN_WIDTH);
+
+    auto dst = _pixels.begin();
+    for (const auto scanline : bitPattern.first(_glyphCount * _sourceSize.height))
+    {
+        for (auto x = 0; x < PATTERN_WIDTH; x++)
+        {
+            *dst++ = (scanline << x) & 0x8000 ? 0xFF : 0x00;
+        }
+    }
+}
+
+uint64_t SoftFont::Generation() const noexcept
+{
+    return _generation;
+}
+
+til::size SoftFont::SourceSize() const noexcept
+{
+    return _sourceSize;
+}
+
+size_t SoftFont::GlyphCount() const noexcept
+{
+    return _glyphCount;
+}
+
+// Routine Description:
+// - Returns all glyphs of the font scaled to the given cell size. The mask is only
+//   rasterized the first time it's requested and served from the cache afterwards.
+// - This may be called from any thread.
+// Arguments:
+// - cellSize - The size of a glyph in the mask.
+// - antialiased - Whether the glyphs should be smoothed when scaled.
+//   Otherwise every target pixel is either fully on or off.
+// Return Value:
+// - The mask. It's immutable and can be held on to for as long as needed.
+std::shared_ptr<const SoftFont::Mask> SoftFont::GetMask(const til::size cellSize, const bool antialiased) const
+{
+    const std::scoped_lock lock{ _mutex };
+
+    const auto it = std::find_if(_masks.begin(), _masks.end(), [&](const auto& mask) {
+        return mask->cellSize == cellSize && mask->antialiased == antialiased;
+    });
+    if (it != _masks.end())
+    {
+        std::rotate(_masks.begin(), it, it + 1);
+        return _masks.front();
+    }
+
+    auto mask = std::make_shared<Mask>();
+    mask->cellSize = cellSize;
+    mask->antialiased = antialiased;
+    if (cellSize && _sourceSize && _glyphCount)
+    {
+        mask->coverage.resize(_glyphCount * cellSize.area<size_t>());
+        antialiased ? _scaleAntialiased(*mask) : _scaleAliased(*mask);
+    }
+
+    if (_masks.size() >= MaxCachedMasks)
+    {
+        _masks.pop_back();
+    }
+    _masks.emplace(_masks.begin(), std::move(mask));
+    return _masks.front();
+}
+
+uint8_t SoftFont::_sourcePixel(const size_t glyphNumber, const til::CoordType x, const til::CoordType y) const noexcept
+{
+    return til::at(_pixels, (glyphNumber * _sourceSize.height + y) * PATTERN_WIDTH + x);
+}
+
+// Routine Description:
+// - Scales the glyphs to the mask's cell size without any smoothing. This is suitable
+//   for raster fonts and preserves the blocky look of the original glyphs.
+void SoftFont::_scaleAliased(Mask& mask) const
+{
+    auto sourceWidth = _sourceSize.width;
+    auto targetWidth = mask.cellSize.width;
+    const auto sourceHeight = _sourceSize.height;
+    const auto targetHeight = mask.cellSize.height;
+
+    // If the text in the font is not perfectly centered, the _centeringHint
+    // gives us the offset needed to correct that misalignment. So to ensure
+    // that any inserted or deleted columns are evenly spaced around the center
+    // point of the glyphs, we need to adjust the source and target widths by
+    // that amount (proportionally) before calculating the scaling increments.
+    targetWidth -= std::lround((double)_centeringHint * targetWidth / sourceWidth);
+    sourceWidth -= gsl::narrow_cast<int>(_centeringHint);
+
+    // The way the scaling works is by iterating over the target range, and
+    // calculating the source offsets that correspond to each target position.
+    // We achieve that by incrementing the source offset every iteration by an
+    // integer value that is the quotient of the source and target dimensions.
+    // Because this is an integer division, we're going to be off by a certain
+    // fraction on each iteration, so we need to keep track of that accumulated
+    // error using the modulus of the division. Once the error total exceeds
+    // the target dimension (more or less), we add another pixel to compensate
+    // for the error, and reset the error total.
+    //
+    // Each target pixel is then derived from the span of source pixels between
+    // the current and the next offset, by ORing them together. We don't want
+    // the span to be empty, though, so we always read at least one pixel.
+    const auto calculateSpans = [](const auto sourceDimension, const auto targetDimension, const auto targetCount, const auto sourceLimit) {
+        const auto increment = sourceDimension / targetDimension;
+        const auto errorIncrement = sourceDimension % targetDimension * 2;
+        const auto errorThreshold = targetDimension * 2 - std::min(sourceDimension, targetDimension);
+        const auto errorReset = targetDimension * 2;
+
+        std::vector<std::pair<til::CoordType, til::CoordType>> spans(targetCount);
+        auto errorTotal = 0;
+        auto offset = 0;
+        for (auto& span : spans)
+        {
+            auto step = increment;
+            errorTotal += errorIncrement;
+            if (errorTotal > errorThreshold)
+            {
+                errorTotal -= errorReset;
+                step++;
+            }
+            span = { std::min(offset, sourceLimit), std::min(offset + std::max(step, 1), sourceLimit) };
+            offset += step;
+        }
+        return spans;
+    };
+    // Once we've calculated the scaling increments, taking the centering hint
+    // into account, we generate the spans for the original target width.
+    const auto columnSpans = calculateSpans(sourceWidth, targetWidth, mask.cellSize.width, PATTERN_WIDTH);
+    const auto lineSpans = calculateSpans(sourceHeight, targetHeight, targetHeight, sourceHeight);
+
+    auto target = mask.coverage.begin();
+    for (size_t glyphNumber = 0; glyphNumber < _glyphCount; glyphNumber++)
+    {
+        for (const auto& [lineBegin, lineEnd] : lineSpans)
+        {
+            for (const auto& [columnBegin, columnEnd] : columnSpans)
+            {
+                uint8_t value = 0;
+                for (auto y = lineBegin; y < lineEnd; y++)
+                {
+                    for (auto x = columnBegin; x < columnEnd; x++)
+                    {
+                        value |= _sourcePixel(glyphNumber, x, y);
+                    }
+                }
+                *target++ = value;
+            }
+        }
+    }
+}
+
+// Routine Description:
+// - Scales the glyphs to the mask's cell size, averaging the source pixels that each
+//   target pixel covers (a box filter). The glyphs are scaled relative to their top left
+//   corner and the horizontal scale takes the centering hint into account, the same way
+//   the aliased scaler does. Pixels past the right and bottom edge repeat the edge pixels.
+// - The scaling is done in two passes, horizontally into a temporary buffer of floats
+//   and then vertically. The inner loop of the vertical pass runs over contiguous
+//   memory without any dependencies between iterations, so it can be vectorized.
+void SoftFont::_scaleAntialiased(Mask& mask) const
+{
+    const auto sourceWidth = _sourceSize.width;
+    const auto sourceHeight = _sourceSize.height;
+    const auto targetWidth = mask.cellSize.width;
+    const auto targetHeight = mask.cellSize.height;
+
+    const auto targetCenteringHint = std::lround((float)_centeringHint * targetWidth / sourceWidth);
+    const auto xScale = gsl::narrow_cast<float>(targetWidth - targetCenteringHint) / (sourceWidth - gsl::narrow_cast<int>(_centeringHint));
+    const auto yScale = gsl::narrow_cast<float>(targetHeight) / sourceHeight;
+
+    const auto columns = boxFilter(targetWidth, xScale, std::min(sourceWidth, PATTERN_WIDTH));
+    const auto lines = boxFilter(targetHeight, yScale, sourceHeight);
+
+    std::vector<float> horizontal(gsl::narrow_cast<size_t>(targetWidth) * sourceHeight);
+    std::vector<float> vertical(targetWidth);
+
+    auto target = mask.coverage.begin();
+    for (size_t glyphNumber = 0; glyphNumber < _glyphCount; glyphNumber++)
+    {
+        auto dst = horizontal.begin();
+        for (auto y = 0; y < sourceHeight; y++)
+        {
+            for (const auto& column : columns)
+            {
+                auto value = 0.0f;
+                auto x = column.first;
+                for (const auto weight : column.weights)
+                {
+                    value += weight * _sourcePixel(glyphNumber, x++, y);
+                }
+                *dst++ = value;
+            }
+        }
+
+        for (const auto& line : lines)
+        {
+            std::fill(vertical.begin(), vertical.end(), 0.0f);
+            auto y = line.first;
+            for (const auto weight : line.weights)
+            {
+                const auto src = horizontal.data() + gsl::narrow_cast<size_t>(y++) * targetWidth;
+                for (auto x = 0; x < targetWidth; x++)
+                {
+                    vertical[x] += weight * src[x];
+                }
+            }
+            for (const auto value : vertical)
+            {
+                *target++ = gsl::narrow_cast<uint8_t>(std::clamp(std::lround(value), 0l, 255l));
+            }
+        }
+    }
+}
@@ -3,6 +3,7 @@
 
 #include "precomp.h"
 #include "renderer.hpp"
+#include "../inc/SoftFont.hpp"
 
 #pragma hdrstop
 
@@ -157,6 +158,18 @@ try
     // 2. Paint Rows of Text
     _PaintBufferOutput(pEngine);
 
+    // If we just painted blinking cells while the blink timer was stopped, it needs to be restarted.
+    // Until the timer ticks again, every frame would ask for that, but once is enough.
+    if (_pfnBlinkingResumed && _renderSettings.ShouldResumeBlinking())
+    {
+        const auto idlePeriod = _renderSettings.GetBlinkIdlePeriod();
+        if (_blinkResumedIdlePeriod != idlePeriod)
+        {
+            _blinkResumedIdlePeriod = idlePeriod;
+            _pfnBlinkingResumed();
+        }
+    }
+
     // 3. Paint overlays that reside above the text buffer
     _PaintOverlays(pEngine);
 
@@ -553,9 +566,13 @@ void Renderer::UpdateSoftFont(const std::span<const uint16_t> bitPattern, const
     const auto softFontCharCount = cellSize.height ? bitPattern.size() / cellSize.height : 0;
     _lastSoftFontChar = _firstSoftFontChar + softFontCharCount - 1;
 
+    // The font is rasterized once for every cell size and antialiasing mode
+    // it's drawn with, and those masks are shared between all the engines.
+    const auto softFont = softFontCharCount ? std::make_shared<const SoftFont>(bitPattern, cellSize, centeringHint) : nullptr;
+
     FOREACH_ENGINE(pEngine)
     {
-        LOG_IF_FAILED(pEngine->UpdateSoftFont(bitPattern, cellSize, centeringHint));
+        LOG_IF_FAILED(pEngine->UpdateSoftFont(softFont));
     }
     TriggerRedrawAll();
 }
@@ -1357,6 +1374,19 @@ void Renderer::SetRendererEnteredErrorStateCallback(std::function<void()> pfn)
     _pfnRendererEnteredErrorState = std::move(pfn);
 }
 
+// Method Description:
+// - Registers a callback for when blinking cells were painted after the
+//   owner of the blink timer stopped it, because nothing was blinking anymore.
+//   The callback is called with the console lock held.
+// Arguments:
+// - pfn: the callback
+// Return Value:
+// - <none>
+void Renderer::SetBlinkingResumedCallback(std::function<void()> pfn)
+{
+    _pfnBlinkingResumed = std::move(pfn);
+}
+
 // Method Description:
 // - Attempts to restart the renderer.
 void Renderer::ResetErrorStateAndResume()
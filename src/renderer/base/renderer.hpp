@@ -87,6 +87,7 @@ namespace Microsoft::Console::Render
         void SetBackgroundColorChangedCallback(std::function<void()> pfn);
         void SetFrameColorChangedCallback(std::function<void()> pfn);
         void SetRendererEnteredErrorStateCallback(std::function<void()> pfn);
+        void SetBlinkingResumedCallback(std::function<void()> pfn);
         void ResetErrorStateAndResume();
 
         void UpdateHyperlinkHoveredId(uint16_t id) noexcept;
@@ -130,6 +131,8 @@ namespace Microsoft::Console::Render
         std::function<void()> _pfnBackgroundColorChanged;
         std::function<void()> _pfnFrameColorChanged;
         std::function<void()> _pfnRendererEnteredErrorState;
+        std::function<void()> _pfnBlinkingResumed;
+        std::optional<uint32_t> _blinkResumedIdlePeriod;
         bool _destructing = false;
         bool _forceUpdateViewport = true;
 
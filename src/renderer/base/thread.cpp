@@ -5,6 +5,7 @@
 #include "thread.hpp"
 
 #include "renderer.hpp"
+#include "../inc/WakeupCounter.hpp"
 
 #pragma hdrstop
 
@@ -210,6 +211,8 @@ DWORD WINAPI RenderThread::_ThreadProc()
 
         ResetEvent(_hPaintCompletedEvent);
 
+        WakeupCounter::Increment();
+
         _pRenderer->WaitUntilCanRender();
         LOG_IF_FAILED(_pRenderer->PaintFrame());
 
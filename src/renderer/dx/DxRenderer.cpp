@@ -2273,19 +2273,15 @@ void DxEngine::UpdateHyperlinkHoveredId(const uint16_t hoveredId) noexcept
 }
 
 // Routine Description:
-// - This method will replace the active soft font with the given bit pattern.
+// - This method will replace the active soft font with the given one.
 // Arguments:
-// - bitPattern - An array of scanlines representing all the glyphs in the font.
-// - cellSize - The cell size for an individual glyph.
-// - centeringHint - The horizontal extent that glyphs are offset from center.
+// - softFont - The new soft font, or nullptr if the soft font was reset.
 // Return Value:
 // - S_OK if successful. E_FAIL if there was an error.
-HRESULT DxEngine::UpdateSoftFont(const std::span<const uint16_t> bitPattern,
-                                 const til::size cellSize,
-                                 const size_t centeringHint) noexcept
+HRESULT DxEngine::UpdateSoftFont(const std::shared_ptr<const SoftFont>& softFont) noexcept
 try
 {
-    _softFont.SetFont(bitPattern, cellSize, _fontRenderData->GlyphCell(), centeringHint);
+    _softFont.SetFont(softFont, _fontRenderData->GlyphCell());
     return S_OK;
 }
 CATCH_RETURN();
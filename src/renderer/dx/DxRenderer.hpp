@@ -89,9 +89,7 @@ namespace Microsoft::Console::Render
 
         [[nodiscard]] HRESULT ScrollFrame() noexcept override;
 
-        [[nodiscard]] HRESULT UpdateSoftFont(const std::span<const uint16_t> bitPattern,
-                                             const til::size cellSize,
-                                             const size_t centeringHint) noexcept override;
+        [[nodiscard]] HRESULT UpdateSoftFont(const std::shared_ptr<const SoftFont>& softFont) noexcept override;
 
         [[nodiscard]] HRESULT PrepareRenderInfo(const RenderFrameInfo& info) noexcept override;
 
@@ -15,116 +15,48 @@ using Microsoft::WRL::ComPtr;
 
 // The soft font is rendered into a bitmap laid out in a 12x8 grid, which is
 // enough space for the 96 characters expected in the font, and which minimizes
-// the dimensions for a typical 2:1 cell size. Each position in the grid is
-// surrounded by a 2 pixel border which helps avoid bleed across the character
-// boundaries when the output is scaled.
+// the dimensions for a typical 2:1 cell size. The glyphs are taken from a mask
+// that the SoftFont has already scaled to the target size, so they're drawn
+// 1:1 and there's no need for any padding to avoid bleed between them.
 
 constexpr size_t BITMAP_GRID_WIDTH = 12;
 constexpr size_t BITMAP_GRID_HEIGHT = 8;
-constexpr size_t PADDING = 2;
-
-constexpr auto ANTIALIASED_INTERPOLATION = D2D1_SCALE_INTERPOLATION_MODE_HIGH_QUALITY_CUBIC;
-constexpr auto ALIASED_INTERPOLATION = D2D1_SCALE_INTERPOLATION_MODE_NEAREST_NEIGHBOR;
 
 DxSoftFont::DxSoftFont() noexcept :
-    _centeringHint{},
-    _interpolation{ ANTIALIASED_INTERPOLATION },
+    _antialiased{ true },
     _colorMatrix{}
 {
     _colorMatrix.m[0][3] = 1;
 }
 
-void DxSoftFont::SetFont(const std::span<const uint16_t> bitPattern,
-                         const til::size sourceSize,
-                         const til::size targetSize,
-                         const size_t centeringHint)
+void DxSoftFont::SetFont(const std::shared_ptr<const SoftFont>& softFont,
+                         const til::size targetSize)
 {
     Reset();
 
-    // If the font is being reset, just free up the memory and return.
-    if (bitPattern.empty())
-    {
-        _bitmapBits.clear();
-        return;
-    }
-
-    const auto maxGlyphCount = BITMAP_GRID_WIDTH * BITMAP_GRID_HEIGHT;
-    _glyphCount = std::min<size_t>(bitPattern.size() / sourceSize.height, maxGlyphCount);
-    _sourceSize = sourceSize;
+    // If the font is being reset, this releases our reference to it.
+    _softFont = softFont;
     _targetSize = targetSize;
-    _centeringHint = centeringHint;
-
-    const auto bitmapWidth = BITMAP_GRID_WIDTH * (_sourceSize.width + PADDING * 2);
-    const auto bitmapHeight = BITMAP_GRID_HEIGHT * (_sourceSize.height + PADDING * 2);
-    _bitmapBits = std::vector<byte>(bitmapWidth * bitmapHeight);
-    _bitmapSize = { gsl::narrow_cast<UINT32>(bitmapWidth), gsl::narrow_cast<UINT32>(bitmapHeight) };
-
-    const auto bitmapScanline = [=](const auto lineNumber) noexcept {
-        return _bitmapBits.begin() + lineNumber * bitmapWidth;
-    };
-
-    // The source bitPattern is just a list of the scanlines making up the
-    // glyphs one after the other, but we want to lay them out in a grid, so
-    // we need to process each glyph individually.
-    auto srcPointer = bitPattern.begin();
-    for (auto glyphNumber = 0u; glyphNumber < _glyphCount; glyphNumber++)
-    {
-        // We start by calculating the position in the bitmap where the glyph
-        // needs to be stored.
-        const auto xOffset = _xOffsetForGlyph<size_t>(glyphNumber);
-        const auto yOffset = _yOffsetForGlyph<size_t>(glyphNumber);
-        auto dstPointer = bitmapScanline(yOffset) + xOffset;
-        for (auto y = 0; y < sourceSize.height; y++)
-        {
-            // Then for each scanline in the source, we need to expand the bits
-            // into 8-bit values. For every bit that is set we write out an FF
-            // value, and if not set, we write out 00. In the end, all we care
-            // about is a single red component for the R8_UNORM bitmap format,
-            // since we'll later remap that to RGBA with a color matrix.
-            auto srcBits = *(srcPointer++);
-            for (auto x = 0; x < sourceSize.width; x++)
-            {
-                const auto srcBitIsSet = (srcBits & 0x8000) != 0;
-                *(dstPointer++) = srcBitIsSet ? 0xFF : 0x00;
-                srcBits <<= 1;
-            }
-            // When glyphs in this bitmap are output, they will typically need
-            // to scaled, and this can result in some bleed from the surrounding
-            // pixels. So to keep the borders clean, we pad the areas to the left
-            // and right by repeating the first and last pixels of each scanline.
-            std::fill_n(dstPointer, PADDING, til::at(dstPointer, -1));
-            dstPointer -= sourceSize.width;
-            std::fill_n(dstPointer - PADDING, PADDING, til::at(dstPointer, 0));
-            dstPointer += bitmapWidth;
-        }
-    }
-
-    // In the same way that we padded the left and right of each glyph in the
-    // code above, we also need to pad the top and bottom. But in this case we
-    // can simply do a whole row of glyphs from the grid at the same time.
-    for (auto gridRow = 0u; gridRow < BITMAP_GRID_HEIGHT; gridRow++)
-    {
-        const auto rowOffset = _yOffsetForGlyph<size_t>(gridRow);
-        const auto rowTop = bitmapScanline(rowOffset);
-        const auto rowBottom = bitmapScanline(rowOffset + _sourceSize.height - 1);
-        for (auto i = 1; i <= PADDING; i++)
-        {
-            std::copy_n(rowTop, bitmapWidth, rowTop - i * bitmapWidth);
-            std::copy_n(rowBottom, bitmapWidth, rowBottom + i * bitmapWidth);
-        }
-    }
 }
 
 HRESULT DxSoftFont::SetTargetSize(const til::size targetSize)
 {
-    _targetSize = targetSize;
-    return _scaleEffect ? _scaleEffect->SetValue(D2D1_SCALE_PROP_SCALE, _scaleForTargetSize()) : S_OK;
+    if (_targetSize != targetSize)
+    {
+        _targetSize = targetSize;
+        _bitmap.Reset();
+    }
+    return S_OK;
 }
 
 HRESULT DxSoftFont::SetAntialiasing(const bool antialiased)
 {
-    _interpolation = (antialiased ? ANTIALIASED_INTERPOLATION : ALIASED_INTERPOLATION);
-    return _scaleEffect ? _scaleEffect->SetValue(D2D1_SCALE_PROP_INTERPOLATION_MODE, _interpolation) : S_OK;
+    if (_antialiased != antialiased)
+    {
+        _antialiased = antialiased;
+        _bitmap.Reset();
+    }
+    return S_OK;
 }
 
 HRESULT DxSoftFont::SetColor(const D2D1_COLOR_F& color)
@@ -159,7 +91,7 @@ HRESULT DxSoftFont::Draw(const DrawingContext& drawingContext,
     d2dContext->PushAxisAlignedClip(rect, D2D1_ANTIALIAS_MODE_ALIASED);
     auto resetClippingRect = wil::scope_exit([&]() noexcept { d2dContext->PopAxisAlignedClip(); });
 
-    // The bitmap and associated scaling/coloring effects are created on demand
+    // The bitmap and associated coloring effect are created on demand
     // so we need make sure they're generated now.
     RETURN_IF_FAILED(_createResources(d2dContext.Get()));
 
@@ -176,7 +108,6 @@ HRESULT DxSoftFont::Draw(const DrawingContext& drawingContext,
         const auto x = _xOffsetForGlyph<float>(glyphNumber);
         const auto y = _yOffsetForGlyph<float>(glyphNumber);
         const auto sourceRect = D2D1_RECT_F{ x, y, x + _targetSize.width, y + _targetSize.height };
-        LOG_IF_FAILED(_scaleEffect->SetValue(D2D1_SCALE_PROP_CENTER_POINT, D2D1::Point2F(x, y)));
         d2dContext->DrawImage(_colorEffect.Get(), targetPoint, sourceRect);
         targetPoint.x += _targetSize.width;
     }
@@ -188,7 +119,6 @@ HRESULT DxSoftFont::Draw(const DrawingContext& drawingContext,
 void DxSoftFont::Reset()
 {
     _colorEffect.Reset();
-    _scaleEffect.Reset();
     _bitmap.Reset();
 }
 
@@ -196,23 +126,11 @@ HRESULT DxSoftFont::_createResources(gsl::not_null<ID2D1DeviceContext*> d2dConte
 {
     if (!_bitmap)
     {
-        D2D1_BITMAP_PROPERTIES bitmapProperties{};
-        bitmapProperties.pixelFormat.format = DXGI_FORMAT_R8_UNORM;
-        bitmapProperties.pixelFormat.alphaMode = D2D1_ALPHA_MODE_IGNORE;
-        const auto bitmapPitch = gsl::narrow_cast<UINT32>(_bitmapSize.width);
-        RETURN_IF_FAILED(d2dContext->CreateBitmap(_bitmapSize, _bitmapBits.data(), bitmapPitch, bitmapProperties, _bitmap.GetAddressOf()));
-    }
-
-    if (!_scaleEffect)
-    {
-        RETURN_IF_FAILED(d2dContext->CreateEffect(CLSID_D2D1Scale, _scaleEffect.GetAddressOf()));
-        RETURN_IF_FAILED(_scaleEffect->SetValue(D2D1_SCALE_PROP_INTERPOLATION_MODE, _interpolation));
-        RETURN_IF_FAILED(_scaleEffect->SetValue(D2D1_SCALE_PROP_SCALE, _scaleForTargetSize()));
-        _scaleEffect->SetInput(0, _bitmap.Get());
+        RETURN_IF_FAILED(_createBitmap(d2dContext));
 
         if (_colorEffect)
         {
-            _colorEffect->SetInputEffect(0, _scaleEffect.Get());
+            _colorEffect->SetInput(0, _bitmap.Get());
         }
     }
 
@@ -220,37 +138,65 @@ HRESULT DxSoftFont::_createResources(gsl::not_null<ID2D1DeviceContext*> d2dConte
     {
         RETURN_IF_FAILED(d2dContext->CreateEffect(CLSID_D2D1ColorMatrix, _colorEffect.GetAddressOf()));
         RETURN_IF_FAILED(_colorEffect->SetValue(D2D1_COLORMATRIX_PROP_COLOR_MATRIX, _colorMatrix));
-        _colorEffect->SetInputEffect(0, _scaleEffect.Get());
+        _colorEffect->SetInput(0, _bitmap.Get());
     }
 
     return S_OK;
 }
 
-D2D1_VECTOR_2F DxSoftFont::_scaleForTargetSize() const noexcept
+HRESULT DxSoftFont::_createBitmap(gsl::not_null<ID2D1DeviceContext*> d2dContext)
+try
 {
-    // If the text in the font is not perfectly centered, the _centeringHint
-    // gives us the offset needed to correct that misalignment. So to ensure
-    // the scaling is evenly balanced around the center point of the glyphs,
-    // we can use that hint to adjust the dimensions of our source and target
-    // widths when calculating the horizontal scale.
-    const auto targetCenteringHint = std::lround((float)_centeringHint * _targetSize.width / _sourceSize.width);
-    const auto xScale = gsl::narrow_cast<float>(_targetSize.width - targetCenteringHint) / (_sourceSize.width - _centeringHint);
-    const auto yScale = gsl::narrow_cast<float>(_targetSize.height) / _sourceSize.height;
-    return D2D1::Vector2F(xScale, yScale);
+    RETURN_HR_IF_NULL(E_UNEXPECTED, _softFont);
+    RETURN_HR_IF(E_UNEXPECTED, !_targetSize);
+
+    // The mask is shared with the other engines, so if they're drawing at the
+    // same size, the glyphs will already have been scaled and we just copy them.
+    const auto mask = _softFont->GetMask(_targetSize, _antialiased);
+    const auto maxGlyphCount = BITMAP_GRID_WIDTH * BITMAP_GRID_HEIGHT;
+    const auto glyphCount = std::min(_softFont->GlyphCount(), maxGlyphCount);
+    const auto glyphWidth = _targetSize.narrow_width<size_t>();
+    const auto glyphHeight = _targetSize.narrow_height<size_t>();
+
+    const auto bitmapWidth = BITMAP_GRID_WIDTH * glyphWidth;
+    const auto bitmapHeight = BITMAP_GRID_HEIGHT * glyphHeight;
+    auto bitmapBits = std::vector<byte>(bitmapWidth * bitmapHeight);
+
+    // The mask is just a list of the glyphs one after the other, but we want
+    // to lay them out in a grid, so we need to copy each glyph individually.
+    // All we care about is a single red component for the R8_UNORM bitmap
+    // format, since we'll later remap that to RGBA with a color matrix.
+    for (size_t glyphNumber = 0; glyphNumber < glyphCount; glyphNumber++)
+    {
+        const auto glyph = mask->Glyph(glyphNumber);
+        const auto xOffset = _xOffsetForGlyph<size_t>(glyphNumber);
+        const auto yOffset = _yOffsetForGlyph<size_t>(glyphNumber);
+        for (size_t y = 0; y < glyphHeight; y++)
+        {
+            const auto line = glyph.subspan(y * glyphWidth, glyphWidth);
+            std::copy(line.begin(), line.end(), bitmapBits.begin() + (yOffset + y) * bitmapWidth + xOffset);
+        }
+    }
+
+    D2D1_BITMAP_PROPERTIES bitmapProperties{};
+    bitmapProperties.pixelFormat.format = DXGI_FORMAT_R8_UNORM;
+    bitmapProperties.pixelFormat.alphaMode = D2D1_ALPHA_MODE_IGNORE;
+    const auto bitmapSize = D2D1_SIZE_U{ gsl::narrow_cast<UINT32>(bitmapWidth), gsl::narrow_cast<UINT32>(bitmapHeight) };
+    const auto bitmapPitch = bitmapSize.width;
+    return d2dContext->CreateBitmap(bitmapSize, bitmapBits.data(), bitmapPitch, bitmapProperties, _bitmap.ReleaseAndGetAddressOf());
 }
+CATCH_RETURN();
 
 template<typename T>
 T DxSoftFont::_xOffsetForGlyph(const size_t glyphNumber) const noexcept
 {
     const auto xOffsetInGrid = glyphNumber / BITMAP_GRID_HEIGHT;
-    const auto paddedGlyphWidth = _sourceSize.width + PADDING * 2;
-    return gsl::narrow_cast<T>(xOffsetInGrid * paddedGlyphWidth + PADDING);
+    return gsl::narrow_cast<T>(xOffsetInGrid * _targetSize.width);
 }
 
 template<typename T>
 T DxSoftFont::_yOffsetForGlyph(const size_t glyphNumber) const noexcept
 {
     const auto yOffsetInGrid = glyphNumber % BITMAP_GRID_HEIGHT;
-    const auto paddedGlyphHeight = _sourceSize.height + PADDING * 2;
-    return gsl::narrow_cast<T>(yOffsetInGrid * paddedGlyphHeight + PADDING);
+    return gsl::narrow_cast<T>(yOffsetInGrid * _targetSize.height);
 }
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "../inc/Cluster.hpp"
+#include "../inc/SoftFont.hpp"
 
 #include <vector>
 #include <d2d1_1.h>
@@ -18,10 +19,8 @@ namespace Microsoft::Console::Render
     {
     public:
         DxSoftFont() noexcept;
-        void SetFont(const std::span<const uint16_t> bitPattern,
-                     const til::size sourceSize,
-                     const til::size targetSize,
-                     const size_t centeringHint);
+        void SetFont(const std::shared_ptr<const SoftFont>& softFont,
+                     const til::size targetSize);
         HRESULT SetTargetSize(const til::size targetSize);
         HRESULT SetAntialiasing(const bool antialiased);
         HRESULT SetColor(const D2D1_COLOR_F& color);
@@ -33,22 +32,17 @@ namespace Microsoft::Console::Render
 
     private:
         HRESULT _createResources(gsl::not_null<ID2D1DeviceContext*> d2dContext);
-        D2D1_VECTOR_2F _scaleForTargetSize() const noexcept;
+        HRESULT _createBitmap(gsl::not_null<ID2D1DeviceContext*> d2dContext);
         template<typename T>
         T _xOffsetForGlyph(const size_t glyphNumber) const noexcept;
         template<typename T>
         T _yOffsetForGlyph(const size_t glyphNumber) const noexcept;
 
-        size_t _glyphCount;
-        til::size _sourceSize;
+        std::shared_ptr<const SoftFont> _softFont;
         til::size _targetSize;
-        size_t _centeringHint;
-        D2D1_SCALE_INTERPOLATION_MODE _interpolation;
+        bool _antialiased;
         D2D1_MATRIX_5X4_F _colorMatrix;
-        D2D1_SIZE_U _bitmapSize;
-        std::vector<byte> _bitmapBits;
         ::Microsoft::WRL::ComPtr<ID2D1Bitmap> _bitmap;
-        ::Microsoft::WRL::ComPtr<ID2D1Effect> _scaleEffect;
         ::Microsoft::WRL::ComPtr<ID2D1Effect> _colorEffect;
     };
 }
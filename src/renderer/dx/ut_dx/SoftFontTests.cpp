@@ -0,0 +1,211 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../../inc/SoftFont.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+using namespace Microsoft::Console::Render;
+
+class SoftFontTests
+{
+    TEST_CLASS(SoftFontTests);
+
+    // Returns a bit pattern that only uses the leftmost sourceWidth pixels of each scanline.
+    static std::vector<uint16_t> _makeBitPattern(const size_t glyphCount, const til::size sourceSize)
+    {
+        std::vector<uint16_t> bitPattern(glyphCount * sourceSize.height);
+        const auto widthMask = gsl::narrow_cast<uint16_t>(0xFFFF << (16 - sourceSize.width));
+        for (size_t i = 0; i < bitPattern.size(); i++)
+        {
+            bitPattern[i] = gsl::narrow_cast<uint16_t>((i + 1) * 0x9E37 & widthMask);
+        }
+        return bitPattern;
+    }
+
+    // This is the scaler that FontResource used before soft fonts were shared between
+    // engines, except that it returns one value per pixel instead of packing the bits.
+    static std::vector<uint8_t> _scaleLikeFontResource(const std::vector<uint16_t>& bitPattern,
+                                                       const til::size sourceSize,
+                                                       const til::size targetSize,
+                                                       const size_t centeringHint)
+    {
+        auto sourceWidth = sourceSize.width;
+        auto targetWidth = targetSize.width;
+        const auto sourceHeight = sourceSize.height;
+        const auto targetHeight = targetSize.height;
+
+        targetWidth -= std::lround((double)centeringHint * targetWidth / sourceWidth);
+        sourceWidth -= gsl::narrow_cast<int>(centeringHint);
+
+        const auto createIncrementFunction = [](const auto sourceDimension, const auto targetDimension) {
+            const auto increment = sourceDimension / targetDimension;
+            const auto errorIncrement = sourceDimension % targetDimension * 2;
+            const auto errorThreshold = targetDimension * 2 - std::min(sourceDimension, targetDimension);
+            const auto errorReset = targetDimension * 2;
+
+            return [=](auto& errorTotal) {
+                errorTotal += errorIncrement;
+                if (errorTotal > errorThreshold)
+                {
+                    errorTotal -= errorReset;
+                    return increment + 1;
+                }
+                return increment;
+            };
+        };
+        const auto columnIncrement = createIncrementFunction(sourceWidth, targetWidth);
+        const auto lineIncrement = createIncrementFunction(sourceHeight, targetHeight);
+
+        targetWidth = targetSize.width;
+
+        const auto glyphCount = bitPattern.size() / sourceHeight;
+        std::vector<uint8_t> pixels(glyphCount * targetSize.area<size_t>());
+        auto target = pixels.begin();
+        for (size_t ch = 0; ch < glyphCount; ch++)
+        {
+            auto sourceLine = std::next(bitPattern.begin(), ch * sourceHeight);
+            auto sourceLineError = 0;
+            for (auto targetY = 0; targetY < targetHeight; targetY++)
+            {
+                const auto lineSpan = lineIncrement(sourceLineError);
+                auto sourceValue = 0;
+                for (auto i = 0; i < std::max(lineSpan, 1); i++)
+                {
+                    sourceValue |= sourceLine[i];
+                }
+                std::advance(sourceLine, lineSpan);
+
+                auto sourceColumn = 1 << 16;
+                auto sourceColumnError = 0;
+                for (auto targetX = 0; targetX < targetWidth; targetX++)
+                {
+                    const auto columnSpan = columnIncrement(sourceColumnError);
+                    const auto nextSourceColumn = sourceColumn >> columnSpan;
+                    const auto sourceMask = sourceColumn - (nextSourceColumn >> (columnSpan ? 0 : 1));
+                    sourceColumn = nextSourceColumn;
+                    *target++ = (sourceValue & sourceMask) ? 0xFF : 0x00;
+                }
+            }
+        }
+        return pixels;
+    }
+
+    TEST_METHOD(AliasedMatchesFontResource)
+    {
+        // The FontResource scaler took a single pixel, instead of the remaining ones, whenever
+        // a span ran past the end of the scanline. That only happens for glyphs that are almost
+        // 16 pixels wide with a large centering hint, so those aren't compared here.
+        for (auto sourceWidth = 5; sourceWidth <= 15; sourceWidth++)
+        {
+            for (const auto sourceHeight : { 1, 6, 12, 16 })
+            {
+                for (size_t centeringHint = 0; centeringHint <= 1; centeringHint++)
+                {
+                    const til::size sourceSize{ sourceWidth, sourceHeight };
+                    const auto bitPattern = _makeBitPattern(3, sourceSize);
+                    const SoftFont softFont{ bitPattern, sourceSize, centeringHint };
+
+                    for (auto targetWidth = 3; targetWidth <= 24; targetWidth++)
+                    {
+                        for (auto targetHeight = 1; targetHeight <= 3 * sourceHeight; targetHeight += 5)
+                        {
+                            const til::size targetSize{ targetWidth, targetHeight };
+                            const auto expected = _scaleLikeFontResource(bitPattern, sourceSize, targetSize, centeringHint);
+                            const auto mask = softFont.GetMask(targetSize, false);
+                            if (expected != mask->coverage)
+                            {
+                                VERIFY_FAIL(NoThrowString().Format(L"%dx%d (hint %zu) scaled to %dx%d", sourceWidth, sourceHeight, centeringHint, targetWidth, targetHeight));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        Log::Comment(L"A span past the end of the scanline covers the pixels that are left.");
+        const std::vector<uint16_t> bitPattern{ 0x0002 };
+        const SoftFont softFont{ bitPattern, { 15, 1 }, 2 };
+        const auto mask = softFont.GetMask({ 4, 1 }, false);
+        VERIFY_IS_TRUE(mask->coverage == std::vector<uint8_t>({ 0x00, 0x00, 0x00, 0xFF }));
+    }
+
+    TEST_METHOD(AntialiasedFoldsEdges)
+    {
+        Log::Comment(L"Target pixels are the average of the source pixels they cover.");
+        {
+            const std::vector<uint16_t> bitPattern{ 0x8000 };
+            const SoftFont softFont{ bitPattern, { 2, 1 }, 0 };
+            const auto mask = softFont.GetMask({ 1, 1 }, true);
+            VERIFY_IS_TRUE(mask->coverage == std::vector<uint8_t>({ 128 }));
+        }
+
+        Log::Comment(L"Pixels past the right and bottom edge repeat the edge, so a solid glyph stays solid.");
+        {
+            const std::vector<uint16_t> bitPattern(12, 0xFFC0);
+            const SoftFont softFont{ bitPattern, { 10, 12 }, 1 };
+            for (const auto targetSize : { til::size{ 3, 5 }, til::size{ 7, 13 }, til::size{ 13, 27 }, til::size{ 25, 45 } })
+            {
+                const auto mask = softFont.GetMask(targetSize, true);
+                VERIFY_ARE_EQUAL(targetSize.area<size_t>(), mask->coverage.size());
+                VERIFY_IS_TRUE(std::ranges::all_of(mask->coverage, [](const auto value) { return value == 0xFF; }));
+            }
+        }
+
+        Log::Comment(L"An integer scale of a column at the edge doesn't bleed into its neighbors.");
+        {
+            const std::vector<uint16_t> bitPattern(4, 0x1000);
+            const SoftFont softFont{ bitPattern, { 4, 4 }, 0 };
+            const auto mask = softFont.GetMask({ 8, 6 }, true);
+            const std::array<uint8_t, 8> expected{ 0, 0, 0, 0, 0, 0, 0xFF, 0xFF };
+            for (size_t y = 0; y < 6; y++)
+            {
+                const auto line = mask->Glyph(0).subspan(y * 8, 8);
+                VERIFY_IS_TRUE(std::ranges::equal(expected, line));
+            }
+        }
+    }
+
+    TEST_METHOD(ReusesCachedMasks)
+    {
+        const til::size sourceSize{ 10, 12 };
+        const auto bitPattern = _makeBitPattern(4, sourceSize);
+        const SoftFont softFont{ bitPattern, sourceSize, 0 };
+
+        Log::Comment(L"Requesting the same mask again doesn't rasterize it again.");
+        const auto aliased = softFont.GetMask({ 20, 24 }, false);
+        VERIFY_ARE_EQUAL(aliased.get(), softFont.GetMask({ 20, 24 }, false).get());
+
+        Log::Comment(L"Aliased and antialiased masks are cached separately.");
+        const auto antialiased = softFont.GetMask({ 20, 24 }, true);
+        VERIFY_ARE_NOT_EQUAL(aliased.get(), antialiased.get());
+        VERIFY_ARE_EQUAL(antialiased.get(), softFont.GetMask({ 20, 24 }, true).get());
+
+        Log::Comment(L"Up to MaxCachedMasks masks are kept.");
+        std::vector<std::shared_ptr<const SoftFont::Mask>> masks;
+        for (til::CoordType i = 0; i < gsl::narrow_cast<til::CoordType>(SoftFont::MaxCachedMasks); i++)
+        {
+            masks.emplace_back(softFont.GetMask({ 5 + i, 12 }, false));
+        }
+        for (til::CoordType i = 0; i < gsl::narrow_cast<til::CoordType>(SoftFont::MaxCachedMasks); i++)
+        {
+            VERIFY_ARE_EQUAL(masks[i].get(), softFont.GetMask({ 5 + i, 12 }, false).get());
+        }
+
+        Log::Comment(L"Beyond that, the least recently used one is dropped.");
+        // Using the first mask once more makes the second one the least recently used.
+        VERIFY_ARE_EQUAL(masks[0].get(), softFont.GetMask({ 5, 12 }, false).get());
+        const auto extra = softFont.GetMask({ 30, 36 }, false);
+        VERIFY_ARE_EQUAL(masks[0].get(), softFont.GetMask({ 5, 12 }, false).get());
+        VERIFY_ARE_NOT_EQUAL(masks[1].get(), softFont.GetMask({ 6, 12 }, false).get());
+
+        Log::Comment(L"A dropped mask is rasterized again with the same result.");
+        VERIFY_IS_TRUE(masks[1]->coverage == softFont.GetMask({ 6, 12 }, false)->coverage);
+    }
+};
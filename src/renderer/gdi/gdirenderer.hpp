@@ -66,9 +66,7 @@ namespace Microsoft::Console::Render
                                                    const bool isSettingDefaultBrushes) noexcept override;
         [[nodiscard]] HRESULT UpdateFont(const FontInfoDesired& FontInfoDesired,
                                          _Out_ FontInfo& FontInfo) noexcept override;
-        [[nodiscard]] HRESULT UpdateSoftFont(const std::span<const uint16_t> bitPattern,
-                                             const til::size cellSize,
-                                             const size_t centeringHint) noexcept override;
+        [[nodiscard]] HRESULT UpdateSoftFont(const std::shared_ptr<const SoftFont>& softFont) noexcept override;
         [[nodiscard]] HRESULT UpdateDpi(const int iDpi) noexcept override;
         [[nodiscard]] HRESULT UpdateViewport(const til::inclusive_rect& srNewViewport) noexcept override;
 
@@ -433,16 +433,12 @@ GdiEngine::~GdiEngine()
 }
 
 // Routine Description:
-// - This method will replace the active soft font with the given bit pattern.
+// - This method will replace the active soft font with the given one.
 // Arguments:
-// - bitPattern - An array of scanlines representing all the glyphs in the font.
-// - cellSize - The cell size for an individual glyph.
-// - centeringHint - The horizontal extent that glyphs are offset from center.
+// - softFont - The new soft font, or nullptr if the soft font was reset.
 // Return Value:
 // - S_OK if successful. E_FAIL if there was an error.
-[[nodiscard]] HRESULT GdiEngine::UpdateSoftFont(const std::span<const uint16_t> bitPattern,
-                                                const til::size cellSize,
-                                                const size_t centeringHint) noexcept
+[[nodiscard]] HRESULT GdiEngine::UpdateSoftFont(const std::shared_ptr<const SoftFont>& softFont) noexcept
 {
     // If we previously called SelectFont(_hdcMemoryContext, _softFont), it will
     // still hold a reference to the _softFont object we're planning to overwrite.
@@ -453,8 +449,8 @@ GdiEngine::~GdiEngine()
         _lastFontType = FontType::Default;
     }
 
-    // Create a new font resource with the updated pattern, or delete if empty.
-    _softFont = FontResource{ bitPattern, cellSize, _GetFontSize(), centeringHint };
+    // Create a new font resource with the updated font, or delete if null.
+    _softFont = FontResource{ softFont, _GetFontSize() };
 
     return S_OK;
 }
@@ -7,10 +7,13 @@ Module Name:
 
 Abstract:
 - This manages the construction of in-memory font resources for the VT soft fonts.
+- The glyphs are taken from the aliased masks of the shared SoftFont.
 --*/
 
 #pragma once
 
+#include "SoftFont.hpp"
+
 namespace wil
 {
     typedef unique_any<HANDLE, decltype(&::RemoveFontMemResourceEx), ::RemoveFontMemResourceEx> unique_hfontresource;
@@ -21,10 +24,8 @@ namespace Microsoft::Console::Render
     class FontResource
     {
     public:
-        FontResource(const std::span<const uint16_t> bitPattern,
-                     const til::size sourceSize,
-                     const til::size targetSize,
-                     const size_t centeringHint);
+        FontResource(const std::shared_ptr<const SoftFont>& softFont,
+                     const til::size targetSize);
         FontResource() = default;
         ~FontResource() = default;
         FontResource& operator=(FontResource&&) = default;
@@ -33,12 +34,10 @@ namespace Microsoft::Console::Render
 
     private:
         void _regenerateFont();
-        void _resizeBitPattern(std::span<byte> targetBuffer);
+        void _packGlyphs(const SoftFont::Mask& mask, std::span<byte> targetBuffer);
 
-        std::vector<uint16_t> _bitPattern;
-        til::size _sourceSize;
+        std::shared_ptr<const SoftFont> _softFont;
         til::size _targetSize;
-        size_t _centeringHint{ 0 };
         wil::unique_hfontresource _resourceHandle;
         wil::unique_hfont _fontHandle;
     };
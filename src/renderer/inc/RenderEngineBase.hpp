@@ -30,9 +30,7 @@ namespace Microsoft::Console::Render
 
         [[nodiscard]] HRESULT NotifyNewText(const std::wstring_view newText) noexcept override;
 
-        [[nodiscard]] HRESULT UpdateSoftFont(const std::span<const uint16_t> bitPattern,
-                                             const til::size cellSize,
-                                             const size_t centeringHint) noexcept override;
+        [[nodiscard]] HRESULT UpdateSoftFont(const std::shared_ptr<const SoftFont>& softFont) noexcept override;
 
         [[nodiscard]] HRESULT PrepareRenderInfo(const RenderFrameInfo& info) noexcept override;
 
@@ -42,7 +42,9 @@ namespace Microsoft::Console::Render
         size_t GetColorAliasIndex(const ColorAlias alias) const noexcept;
         std::pair<COLORREF, COLORREF> GetAttributeColors(const TextAttribute& attr) const noexcept;
         std::pair<COLORREF, COLORREF> GetAttributeColorsWithAlpha(const TextAttribute& attr) const noexcept;
-        void ToggleBlinkRendition(class Renderer& renderer) noexcept;
+        bool ToggleBlinkRendition(class Renderer& renderer) noexcept;
+        bool ShouldResumeBlinking() const noexcept;
+        uint32_t GetBlinkIdlePeriod() const noexcept;
 
     private:
         til::enumset<Mode> _renderMode{ Mode::BlinkAllowed, Mode::IntenseIsBright };
@@ -51,6 +53,8 @@ namespace Microsoft::Console::Render
         std::array<std::array<COLORREF, 19>, 19> _adjustedForegroundColors;
         size_t _blinkCycle = 0;
         mutable bool _blinkIsInUse = false;
+        bool _blinkIsIdle = true;
+        uint32_t _blinkIdlePeriod = 0;
         bool _blinkShouldBeFaint = false;
     };
 }
@@ -0,0 +1,70 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- SoftFont.hpp
+
+Abstract:
+- This holds a VT soft font (DECDLD) in a form that can be shared by all render engines.
+- The bit pattern is decoded once when the font is created. Engines then request masks,
+  which contain the glyphs scaled to a particular cell size, as 8-bit coverage values.
+  Masks are rasterized on first use and cached per cell size, so that redrawing the
+  screen or switching back and forth between font sizes doesn't rasterize them again.
+- A new SoftFont (with a new generation) is created whenever the font changes.
+--*/
+
+#pragma once
+
+#include <mutex>
+
+namespace Microsoft::Console::Render
+{
+    class SoftFont
+    {
+    public:
+        // All glyphs of the font, scaled to the cell size. Each glyph is stored as
+        // cellSize.width * cellSize.height coverage values, row by row, where 0 is
+        // the background and 255 the foreground. Aliased masks only contain 0 and 255.
+        struct Mask
+        {
+            til::size cellSize;
+            bool antialiased = false;
+            std::vector<uint8_t> coverage;
+
+            std::span<const uint8_t> Glyph(const size_t glyphNumber) const noexcept;
+        };
+
+        // A font is usually only ever displayed at a few sizes at a time (for
+        // instance one per engine), but the user may zoom in and out, too.
+        static constexpr size_t MaxCachedMasks = 4;
+
+        SoftFont(const std::span<const uint16_t> bitPattern,
+                 const til::size sourceSize,
+                 const size_t centeringHint);
+
+        uint64_t Generation() const noexcept;
+        til::size SourceSize() const noexcept;
+        size_t GlyphCount() const noexcept;
+
+        std::shared_ptr<const Mask> GetMask(const til::size cellSize, const bool antialiased) const;
+
+    private:
+        void _scaleAliased(Mask& mask) const;
+        void _scaleAntialiased(Mask& mask) const;
+        uint8_t _sourcePixel(const size_t glyphNumber, const til::CoordType x, const til::CoordType y) const noexcept;
+
+        uint64_t _generation;
+        til::size _sourceSize;
+        size_t _centeringHint;
+        size_t _glyphCount;
+        // The decoded bit pattern with one byte (0 or 255) per pixel. Each scanline is
+        // 16 pixels wide, regardless of the source width, because that's how many bits
+        // the scaler may look at (see _scaleAliased).
+        std::vector<uint8_t> _pixels;
+
+        mutable std::mutex _mutex;
+        // The most recently used mask comes first.
+        mutable std::vector<std::shared_ptr<const Mask>> _masks;
+    };
+}
@@ -0,0 +1,74 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- WakeupCounter.hpp
+
+Abstract:
+- A process-wide counter of how often the terminal wakes up to do work,
+  for instance to paint a frame or to blink the cursor. An idle terminal
+  should ideally not wake up at all, so this is used to measure how close
+  we get to that. If a reporter is set, it periodically receives the rate.
+--*/
+
+#pragma once
+
+namespace Microsoft::Console::Render
+{
+    class WakeupCounter
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+        // Receives the average number of wakeups per second since the last report.
+        using Reporter = void (*)(double wakeupsPerSecond) noexcept;
+
+        static constexpr clock::duration ReportInterval = std::chrono::seconds{ 1 };
+
+        // Counts a wakeup. This is also what drives the reporter, at most once per
+        // ReportInterval, from whichever thread happens to be awake at the time.
+        // That way measuring the wakeups doesn't cause any of its own.
+        static void Increment() noexcept
+        {
+            const auto count = _count.fetch_add(1, std::memory_order_relaxed) + 1;
+            if (const auto reporter = _reporter.load(std::memory_order_relaxed))
+            {
+                _report(reporter, count);
+            }
+        }
+
+        static void SetReporter(const Reporter reporter) noexcept
+        {
+            _reporter.store(reporter, std::memory_order_relaxed);
+        }
+
+    private:
+        static void _report(const Reporter reporter, const uint64_t count) noexcept
+        {
+            const auto now = clock::now().time_since_epoch().count();
+            auto last = _lastReportTime.load(std::memory_order_relaxed);
+            if (now - last < ReportInterval.count())
+            {
+                return;
+            }
+            // If another thread is reporting right now, this wakeup is part of its report.
+            if (!_lastReportTime.compare_exchange_strong(last, now, std::memory_order_relaxed))
+            {
+                return;
+            }
+
+            const auto lastCount = _lastReportCount.exchange(count, std::memory_order_relaxed);
+            // The first wakeup only starts the measurement.
+            if (last != 0)
+            {
+                const std::chrono::duration<double> elapsed = clock::duration{ now - last };
+                reporter((count - lastCount) / elapsed.count());
+            }
+        }
+
+        static inline std::atomic<uint64_t> _count{ 0 };
+        static inline std::atomic<Reporter> _reporter{ nullptr };
+        static inline std::atomic<clock::rep> _lastReportTime{ 0 };
+        static inline std::atomic<uint64_t> _lastReportCount{ 0 };
+    };
+}
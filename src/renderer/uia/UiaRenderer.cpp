@@ -20,6 +20,11 @@ UiaEngine::UiaEngine(IUiaEventDispatcher* dispatcher) :
     _textBufferChanged{ false },
     _cursorChanged{ false },
     _isEnabled{ true },
+    _newOmittedOutput{ 0 },
+    _queuedOmittedOutput{ 0 },
+    _maxQueuedOutput{ s_defaultMaxQueuedOutput },
+    _notificationInterval{ s_defaultNotificationInterval },
+    _lastNotification{},
     _prevSelection{},
     _prevCursorRegion{},
     RenderEngineBase()
@@ -50,6 +55,45 @@ UiaEngine::UiaEngine(IUiaEventDispatcher* dispatcher) :
     return S_OK;
 }
 
+// Routine Description:
+// - Sets the maximum number of characters of new output we hold on to between
+//   two notifications. Once exceeded, the oldest output is discarded, since an
+//   automation client can't meaningfully read out text that scrolled by that fast.
+// Arguments:
+// - maxQueuedOutput - the number of characters to retain. Must be non-zero.
+// Return Value:
+// - <none>
+void UiaEngine::SetMaxQueuedOutput(const size_t maxQueuedOutput) noexcept
+{
+    _maxQueuedOutput = std::max<size_t>(1, maxQueuedOutput);
+}
+
+// Routine Description:
+// - Sets the minimum time between two new output notifications. Any output
+//   that arrives in the meantime is merged into the next notification.
+// Arguments:
+// - interval - the notification cadence. Zero notifies on every frame.
+// Return Value:
+// - <none>
+void UiaEngine::SetNotificationInterval(const std::chrono::milliseconds interval) noexcept
+{
+    _notificationInterval.store(std::max(interval, std::chrono::milliseconds::zero()), std::memory_order_relaxed);
+}
+
+// Routine Description:
+// - Sets the function that asks the renderer for another frame. If output is
+//   held back due to the notification interval, we call it once the interval
+//   has passed, so that the output gets announced even if nothing else changes.
+//   Without it, held back output is announced with the next frame.
+// Arguments:
+// - pfn - the callback. It's called on a threadpool thread.
+// Return Value:
+// - <none>
+void UiaEngine::SetRedrawCallback(std::function<void()> pfn) noexcept
+{
+    _pfnRedraw = std::move(pfn);
+}
+
 // Routine Description:
 // - Notifies us that the console has changed the character region specified.
 // - NOTE: This typically triggers on cursor or text buffer changes
@@ -173,8 +217,26 @@ try
 {
     if (!newText.empty())
     {
-        _newOutput.append(newText);
+        // A single write larger than our budget supersedes everything before it.
+        // Leave room for the line break we append below.
+        if (newText.size() >= _maxQueuedOutput)
+        {
+            const auto kept = _maxQueuedOutput - 1;
+            _newOmittedOutput += _newOutput.size() + newText.size() - kept;
+            _newOutput.assign(newText.substr(newText.size() - kept));
+        }
+        else
+        {
+            _newOutput.append(newText);
+        }
         _newOutput.push_back(L'\n');
+
+        // Let the buffer grow to twice the budget before trimming it back down,
+        // so that the cost of discarding old output is amortized across writes.
+        if (_newOutput.size() > 2 * _maxQueuedOutput)
+        {
+            _newOmittedOutput += _TrimOutput(_newOutput);
+        }
         _textBufferChanged = true;
     }
     return S_OK;
@@ -230,8 +292,23 @@ CATCH_LOG_RETURN_HR(E_FAIL);
     // so present can work on the copy while another
     // thread might start filling the next "frame"
     // worth of text data.
-    std::swap(_queuedOutput, _newOutput);
-    _newOutput.clear();
+    // If the previous frame's output hasn't been announced yet, because we're
+    // rate limited, merge this frame's output into it instead of replacing it.
+    try
+    {
+        if (_queuedOutput.empty())
+        {
+            std::swap(_queuedOutput, _newOutput);
+        }
+        else
+        {
+            _queuedOutput.append(_newOutput);
+        }
+        _newOutput.clear();
+        _queuedOmittedOutput += std::exchange(_newOmittedOutput, 0);
+        _queuedOmittedOutput += _TrimOutput(_queuedOutput);
+    }
+    CATCH_LOG();
     return S_OK;
 }
 
@@ -279,29 +356,115 @@ void UiaEngine::WaitUntilCanRender() noexcept
         }
         CATCH_LOG();
     }
-    try
+
+    // Only notify about new output once per _notificationInterval. Until then the
+    // output stays queued and EndPaint() keeps merging newer output into it.
+    // A single redraw is scheduled for when the interval has passed to flush it.
+    const auto now = std::chrono::steady_clock::now();
+    const auto interval = _notificationInterval.load(std::memory_order_relaxed);
+    if (!_queuedOutput.empty() && now - _lastNotification < interval)
+    {
+        _ScheduleRedraw(interval - (now - _lastNotification));
+    }
+    else if (!_queuedOutput.empty())
     {
-        // The speech API is limited to 1000 characters at a time.
-        // Break up the output into 1000 character chunks to ensure
-        // the output isn't cut off.
-        static constexpr size_t sapiLimit{ 1000 };
-        const std::wstring_view output{ _queuedOutput };
-        for (size_t offset = 0; offset < output.size(); offset += sapiLimit)
+        try
         {
-            _dispatcher->NotifyNewOutput(output.substr(offset, sapiLimit));
+            // Let the client know that it missed some output,
+            // instead of silently jumping ahead to the latest output.
+            if (_queuedOmittedOutput)
+            {
+                _dispatcher->NotifyOutputOmitted(_queuedOmittedOutput);
+            }
+
+            // The speech API is limited to 1000 characters at a time.
+            // Break up the output into 1000 character chunks to ensure
+            // the output isn't cut off.
+            static constexpr size_t sapiLimit{ 1000 };
+            const std::wstring_view output{ _queuedOutput };
+            for (size_t offset = 0; offset < output.size(); offset += sapiLimit)
+            {
+                _dispatcher->NotifyNewOutput(output.substr(offset, sapiLimit));
+            }
         }
+        CATCH_LOG();
+
+        _lastNotification = now;
+        _queuedOutput.clear();
+        _queuedOmittedOutput = 0;
     }
-    CATCH_LOG();
 
     _selectionChanged = false;
     _textBufferChanged = false;
     _cursorChanged = false;
     _isPainting = false;
-    _queuedOutput.clear();
 
     return S_OK;
 }
 
+// Routine Description:
+// - Asks the renderer for a single frame after the given delay, which
+//   announces the output that couldn't be announced yet due to the
+//   notification interval. Scheduling it again replaces the previous one.
+// Arguments:
+// - delay - the time until the output can be announced.
+// Return Value:
+// - <none>
+void UiaEngine::_ScheduleRedraw(const std::chrono::steady_clock::duration delay) noexcept
+{
+    if (!_pfnRedraw)
+    {
+        return;
+    }
+
+    if (!_redrawTimer)
+    {
+        _redrawTimer.reset(CreateThreadpoolTimer(&_RedrawTimerCallback, this, nullptr));
+        if (!_redrawTimer)
+        {
+            LOG_LAST_ERROR();
+            return;
+        }
+    }
+
+    using filetime_duration = std::chrono::duration<int64_t, std::ratio<1, 10000000>>;
+    // A negative FILETIME is a due time relative to now, in 100ns steps.
+    // Round up, so that the interval has surely passed when we're called.
+    auto dueTime = -std::chrono::ceil<filetime_duration>(delay).count();
+    SetThreadpoolTimer(_redrawTimer.get(), reinterpret_cast<FILETIME*>(&dueTime), 0, 0);
+}
+
+void __stdcall UiaEngine::_RedrawTimerCallback(PTP_CALLBACK_INSTANCE /*instance*/, PVOID context, PTP_TIMER /*timer*/) noexcept
+try
+{
+    static_cast<UiaEngine*>(context)->_pfnRedraw();
+}
+CATCH_LOG()
+
+// Routine Description:
+// - Discards all but the most recent _maxQueuedOutput characters of the given
+//   output. If possible, the cut is moved forward to the next line break, so
+//   that automation clients don't start reading in the middle of a line.
+// Arguments:
+// - output - the output buffer to trim in place.
+// Return Value:
+// - The number of characters that were discarded.
+size_t UiaEngine::_TrimOutput(std::wstring& output) const
+{
+    if (output.size() <= _maxQueuedOutput)
+    {
+        return 0;
+    }
+
+    auto cut = output.size() - _maxQueuedOutput;
+    if (const auto lf = output.find(L'\n', cut); lf != std::wstring::npos && lf + 1 < output.size())
+    {
+        cut = lf + 1;
+    }
+    output.erase(0, cut);
+    return cut;
+}
+
 // Routine Description:
 // - This is currently unused.
 // Arguments:
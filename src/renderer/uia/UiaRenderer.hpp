@@ -20,6 +20,14 @@ Author(s):
 #include "../../types/IUiaEventDispatcher.h"
 #include "../../types/inc/Viewport.hpp"
 
+// fwdecl unittest classes
+#ifdef UNIT_TESTING
+namespace ControlUnitTests
+{
+    class UiaEngineTests;
+};
+#endif
+
 namespace Microsoft::Console::Render
 {
     class UiaEngine final : public RenderEngineBase
@@ -33,6 +41,16 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT Enable() noexcept override;
         [[nodiscard]] HRESULT Disable() noexcept;
 
+        // Output notifications are coalesced: only the most recent
+        // maxQueuedOutput characters are retained between notifications
+        // and NotifyNewOutput is raised at most once per interval.
+        void SetMaxQueuedOutput(const size_t maxQueuedOutput) noexcept;
+        void SetNotificationInterval(const std::chrono::milliseconds interval) noexcept;
+
+        // Called from a threadpool thread once output that was held back
+        // due to the notification interval is ready to be announced.
+        void SetRedrawCallback(std::function<void()> pfn) noexcept;
+
         // IRenderEngine Members
         [[nodiscard]] HRESULT StartPaint() noexcept override;
         [[nodiscard]] HRESULT EndPaint() noexcept override;
@@ -65,17 +83,43 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT _DoUpdateTitle(const std::wstring_view newTitle) noexcept override;
 
     private:
+        static constexpr size_t s_defaultMaxQueuedOutput{ 4000 };
+        static constexpr std::chrono::milliseconds s_defaultNotificationInterval{ 100 };
+
+        static void __stdcall _RedrawTimerCallback(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_TIMER timer) noexcept;
+
+        size_t _TrimOutput(std::wstring& output) const;
+        void _ScheduleRedraw(const std::chrono::steady_clock::duration delay) noexcept;
+
         bool _isEnabled;
         bool _isPainting;
         bool _selectionChanged;
         bool _textBufferChanged;
         bool _cursorChanged;
+        // _newOutput and _newOmittedOutput are only used under the console lock.
+        // EndPaint() moves them into _queuedOutput and _queuedOmittedOutput,
+        // which are only used by the render thread.
         std::wstring _newOutput;
+        size_t _newOmittedOutput;
         std::wstring _queuedOutput;
+        size_t _queuedOmittedOutput;
+        size_t _maxQueuedOutput;
+        // Present() runs outside of the console lock, unlike the setter.
+        std::atomic<std::chrono::milliseconds> _notificationInterval;
+        std::chrono::steady_clock::time_point _lastNotification;
 
         Microsoft::Console::Types::IUiaEventDispatcher* _dispatcher;
 
         std::vector<til::rect> _prevSelection;
         til::rect _prevCursorRegion;
+
+        // _redrawTimer must be ordered after _pfnRedraw, because
+        // destroying the timer waits for its callback to finish.
+        std::function<void()> _pfnRedraw;
+        wil::unique_threadpool_timer _redrawTimer;
+
+#ifdef UNIT_TESTING
+        friend class ControlUnitTests::UiaEngineTests;
+#endif
     };
 }
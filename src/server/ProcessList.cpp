@@ -40,7 +40,27 @@ using namespace Microsoft::Console::Interactivity;
     try
     {
         pProcessData = std::make_unique<ConsoleProcessHandle>(dwProcessId, dwThreadId, ulProcessGroupId);
+
+        // If any of the insertions fail, the previous ones are undone,
+        // so that the list and its indexes can't get out of sync.
         _processes.emplace_back(pProcessData.get());
+        auto removeFromList = wil::scope_exit([&]() noexcept { _processes.pop_back(); });
+
+        _processesById.emplace(dwProcessId, pProcessData.get());
+        auto removeFromIds = wil::scope_exit([&]() noexcept { _processesById.erase(dwProcessId); });
+
+        auto& group = _processesByGroupId[ulProcessGroupId];
+        auto removeEmptyGroup = wil::scope_exit([&]() noexcept {
+            if (group.empty())
+            {
+                _processesByGroupId.erase(ulProcessGroupId);
+            }
+        });
+        group.emplace_back(pProcessData.get());
+
+        removeEmptyGroup.release();
+        removeFromIds.release();
+        removeFromList.release();
     }
     CATCH_RETURN();
 
@@ -59,10 +79,23 @@ void ConsoleProcessList::FreeProcessData(_In_ ConsoleProcessHandle* const pProce
 {
     assert(ServiceLocator::LocateGlobals().getConsoleInformation().IsConsoleLocked());
 
-    const auto it = std::ranges::find(_processes, pProcessData);
-    if (it != _processes.end())
+    const auto itId = _processesById.find(pProcessData->dwProcessId);
+    if (itId != _processesById.end() && itId->second == pProcessData)
     {
-        _processes.erase(it);
+        _processesById.erase(itId);
+
+        const auto itGroup = _processesByGroupId.find(pProcessData->_ulProcessGroupId);
+        if (itGroup != _processesByGroupId.end())
+        {
+            auto& group = itGroup->second;
+            group.erase(std::find(group.begin(), group.end(), pProcessData));
+            if (group.empty())
+            {
+                _processesByGroupId.erase(itGroup);
+            }
+        }
+
+        _processes.erase(std::ranges::find(_processes, pProcessData));
         delete pProcessData;
     }
     else
@@ -84,15 +117,8 @@ ConsoleProcessHandle* ConsoleProcessList::FindProcessInList(const DWORD dwProces
 {
     assert(ServiceLocator::LocateGlobals().getConsoleInformation().IsConsoleLocked());
 
-    for (const auto& p : _processes)
-    {
-        if (p->dwProcessId == dwProcessId)
-        {
-            return p;
-        }
-    }
-
-    return nullptr;
+    const auto it = _processesById.find(dwProcessId);
+    return it != _processesById.end() ? it->second : nullptr;
 }
 
 // Routine Description:
@@ -105,15 +131,20 @@ ConsoleProcessHandle* ConsoleProcessList::FindProcessByGroupId(_In_ ULONG ulProc
 {
     assert(ServiceLocator::LocateGlobals().getConsoleInformation().IsConsoleLocked());
 
-    for (const auto& p : _processes)
-    {
-        if (p->_ulProcessGroupId == ulProcessGroupId)
-        {
-            return p;
-        }
-    }
+    const auto group = _FindGroup(ulProcessGroupId);
+    return group ? group->front() : nullptr;
+}
 
-    return nullptr;
+// Routine Description:
+// - Locates the processes belonging to the given group.
+// Arguments:
+// - ulProcessGroupId - Group to search for in the list
+// Return Value:
+// - Pointer to the processes of the group in the order they attached. nullptr if the group has no processes.
+const til::small_vector<ConsoleProcessHandle*, 1>* ConsoleProcessList::_FindGroup(const ULONG ulProcessGroupId) const
+{
+    const auto it = _processesByGroupId.find(ulProcessGroupId);
+    return it != _processesByGroupId.end() && !it->second.empty() ? &it->second : nullptr;
 }
 
 // Routine Description:
@@ -211,35 +242,39 @@ ConsoleProcessHandle* ConsoleProcessList::GetOldestProcess() const
     {
         termRecords.clear();
 
-        // Dig through known processes looking for a match
-        for (const auto& p : _processes)
+        // If a limit was specified, only the processes of that group get a termination record.
+        std::span<ConsoleProcessHandle* const> processes = _processes;
+        if (dwLimitingProcessId)
         {
-            // If no limit was specified OR if we have a match, generate a new termination record.
-            if (!dwLimitingProcessId ||
-                p->_ulProcessGroupId == dwLimitingProcessId)
+            const auto group = _FindGroup(dwLimitingProcessId);
+            processes = group ? std::span{ group->data(), group->size() } : std::span<ConsoleProcessHandle* const>{};
+        }
+
+        termRecords.reserve(processes.size());
+
+        for (const auto& p : processes)
+        {
+            // If we're hard closing the window, increment the counter.
+            if (fCtrlClose)
             {
-                // If we're hard closing the window, increment the counter.
-                if (fCtrlClose)
-                {
-                    p->_ulTerminateCount++;
-                }
-
-                wil::unique_handle process;
-                // If the duplicate failed, the best we can do is to skip including the process in the list and hope it goes away.
-                LOG_IF_WIN32_BOOL_FALSE(DuplicateHandle(GetCurrentProcess(),
-                                                        p->_hProcess.get(),
-                                                        GetCurrentProcess(),
-                                                        &process,
-                                                        0,
-                                                        0,
-                                                        DUPLICATE_SAME_ACCESS));
-
-                termRecords.emplace_back(ConsoleProcessTerminationRecord{
-                    .hProcess = std::move(process),
-                    .dwProcessID = p->dwProcessId,
-                    .ulTerminateCount = p->_ulTerminateCount,
-                });
+                p->_ulTerminateCount++;
             }
+
+            wil::unique_handle process;
+            // If the duplicate failed, the best we can do is to skip including the process in the list and hope it goes away.
+            LOG_IF_WIN32_BOOL_FALSE(DuplicateHandle(GetCurrentProcess(),
+                                                    p->_hProcess.get(),
+                                                    GetCurrentProcess(),
+                                                    &process,
+                                                    0,
+                                                    0,
+                                                    DUPLICATE_SAME_ACCESS));
+
+            termRecords.emplace_back(ConsoleProcessTerminationRecord{
+                .hProcess = std::move(process),
+                .dwProcessID = p->dwProcessId,
+                .ulTerminateCount = p->_ulTerminateCount,
+            });
         }
 
         return S_OK;
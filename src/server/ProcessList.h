@@ -19,6 +19,8 @@ Revision History:
 
 #include "ProcessHandle.h"
 
+#include <til/small_vector.h>
+
 // this structure is used to store relevant information from the console for ctrl processing so we can do it without
 // holding the console lock.
 struct ConsoleProcessTerminationRecord
@@ -58,7 +60,14 @@ public:
     bool IsEmpty() const;
 
 private:
+    // All processes in the order they attached. The maps below index into it, so that
+    // finding a client doesn't scale with the number of processes attached to the console.
     std::vector<ConsoleProcessHandle*> _processes;
+    std::unordered_map<DWORD, ConsoleProcessHandle*> _processesById;
+    // The processes of each group, also in the order they attached. Most groups have a single member.
+    std::unordered_map<ULONG, til::small_vector<ConsoleProcessHandle*, 1>> _processesByGroupId;
+
+    const til::small_vector<ConsoleProcessHandle*, 1>* _FindGroup(const ULONG ulProcessGroupId) const;
 
     void _ModifyProcessForegroundRights(const HANDLE hProcess, const bool fForeground) const;
 };
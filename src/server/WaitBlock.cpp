@@ -16,7 +16,7 @@
 // Routine Description:
 // - Initializes a ConsoleWaitBlock
 // - ConsoleWaitBlocks will mostly self-manage their position in their two queues.
-// - They will be pushed into the tail and the resulting iterator stored for constant deletion time later.
+// - They will be linked into the tail of each queue through the links they embed, for constant deletion time later.
 // Arguments:
 // - pProcessQueue - The queue attached to the client process ID that requested this action
 // - pObjectQueue - The queue attached to the console object that will service the action when data arrives
@@ -29,8 +29,12 @@ ConsoleWaitBlock::ConsoleWaitBlock(_In_ ConsoleWaitQueue* const pProcessQueue,
     _pProcessQueue(THROW_HR_IF_NULL(E_INVALIDARG, pProcessQueue)),
     _pObjectQueue(THROW_HR_IF_NULL(E_INVALIDARG, pObjectQueue)),
     _WaitReplyMessage(*pWaitReplyMessage),
+    _waitReason(s_GetWaitReason(pWaitReplyMessage)),
     _pWaiter(THROW_HR_IF_NULL(E_INVALIDARG, pWaiter))
 {
+    _processLink.block = this;
+    _objectLink.block = this;
+
     // MSFT-33127449, GH#9692
     // Until there's a "Wait", there's only one API message inflight at a time. In our
     // quest for performance, we put that single API message in charge of its own
@@ -66,15 +70,42 @@ ConsoleWaitBlock::ConsoleWaitBlock(_In_ ConsoleWaitQueue* const pProcessQueue,
 
 // Routine Description:
 // - Destroys a ConsolewaitBlock
-// - On deletion, ConsoleWaitBlocks will erase themselves from the process and object queues in
-//   constant time with the iterator acquired on construction.
+// - On deletion, ConsoleWaitBlocks will unlink themselves from the process and object queues in
+//   constant time.
 ConsoleWaitBlock::~ConsoleWaitBlock()
 {
-    _pProcessQueue->_blocks.erase(_itProcessQueue);
-    _pObjectQueue->_blocks.erase(_itObjectQueue);
+    _processLink.Unlink();
+    _objectLink.Unlink();
     delete _pWaiter;
 }
 
+// Routine Description:
+// - Determines what a wait for the given API message is waiting for.
+// Arguments:
+// - pWaitReplyMessage - The API message that is about to be deferred.
+// Return Value:
+// - The reason the message is waiting. Only reads and writes can wait.
+ConsoleWaitReason ConsoleWaitBlock::s_GetWaitReason(const CONSOLE_API_MSG* const pWaitReplyMessage)
+{
+    switch (pWaitReplyMessage->msgHeader.ApiNumber)
+    {
+    case API_NUMBER_GETCONSOLEINPUT:
+    case API_NUMBER_READCONSOLE:
+        return ConsoleWaitReason::InputAvailable;
+    case API_NUMBER_WRITECONSOLE:
+        return ConsoleWaitReason::OutputUnblocked;
+    default:
+        THROW_HR(E_NOTIMPL); // we shouldn't be getting a wait on API numbers we don't support.
+    }
+}
+
+// Routine Description:
+// - Retrieves what this block is waiting for.
+ConsoleWaitReason ConsoleWaitBlock::GetWaitReason() const noexcept
+{
+    return _waitReason;
+}
+
 // Routine Description:
 // - Creates and enqueues a new wait for later callback when a routine cannot be serviced at this time.
 // - Will extract the process ID and the target object, enqueuing in both to know when to callback
@@ -105,10 +136,6 @@ ConsoleWaitBlock::~ConsoleWaitBlock()
                                           pObjectQueue,
                                           pWaitReplyMessage,
                                           pWaiter);
-
-        // Set the iterators on the wait block so that it can remove itself later.
-        pWaitBlock->_itProcessQueue = pProcessQueue->_blocks.insert(pProcessQueue->_blocks.end(), pWaitBlock);
-        pWaitBlock->_itObjectQueue = pObjectQueue->_blocks.insert(pObjectQueue->_blocks.end(), pWaitBlock);
     }
     catch (...)
     {
@@ -117,6 +144,11 @@ ConsoleWaitBlock::~ConsoleWaitBlock()
         return hr;
     }
 
+    // Link the block into the tail of both queues so that it can remove itself later.
+    // This can't fail, as the links are part of the block.
+    pProcessQueue->_Enqueue(pWaitBlock->_processLink);
+    pObjectQueue->_Enqueue(pWaitBlock->_objectLink);
+
     return S_OK;
 }
 
@@ -21,10 +21,54 @@ Revision History:
 #include "IWaitRoutine.h"
 #include "WaitTerminationReason.h"
 
-#include <list>
-
+class ConsoleWaitBlock;
 class ConsoleWaitQueue;
 
+// What a wait block is waiting for. Queues keep a separate list of blocks for
+// each reason, so that waking one kind of waiter doesn't walk past the others.
+enum class ConsoleWaitReason
+{
+    InputAvailable = 0, // ReadConsole and ReadConsoleInput/PeekConsoleInput
+    OutputUnblocked = 1, // WriteConsole while output is suspended
+};
+
+inline constexpr size_t ConsoleWaitReasonCount = 2;
+
+// A node of an intrusive, circular, doubly linked list. Each wait block embeds
+// one for each of the two queues it belongs to, so that enqueueing and dequeueing
+// a block never allocates. An unlinked node (and an empty list head) points to itself.
+struct ConsoleWaitLink
+{
+    ConsoleWaitLink() noexcept = default;
+    ConsoleWaitLink(const ConsoleWaitLink&) = delete;
+    ConsoleWaitLink& operator=(const ConsoleWaitLink&) = delete;
+
+    ConsoleWaitLink* prev = this;
+    ConsoleWaitLink* next = this;
+    ConsoleWaitBlock* block = nullptr;
+
+    bool IsLinked() const noexcept
+    {
+        return next != this;
+    }
+
+    void InsertBefore(ConsoleWaitLink& other) noexcept
+    {
+        prev = other.prev;
+        next = &other;
+        other.prev->next = this;
+        other.prev = this;
+    }
+
+    void Unlink() noexcept
+    {
+        prev->next = next;
+        next->prev = prev;
+        prev = this;
+        next = this;
+    }
+};
+
 class ConsoleWaitBlock
 {
 public:
@@ -32,6 +76,8 @@ public:
 
     bool Notify(const WaitTerminationReason TerminationReason);
 
+    ConsoleWaitReason GetWaitReason() const noexcept;
+
     [[nodiscard]] static HRESULT s_CreateWait(_Inout_ CONSOLE_API_MSG* const pWaitReplymessage,
                                               _In_ IWaitRoutine* const pWaiter);
 
@@ -41,13 +87,20 @@ private:
                      const CONSOLE_API_MSG* const pWaitReplyMessage,
                      _In_ IWaitRoutine* const pWaiter);
 
+    static ConsoleWaitReason s_GetWaitReason(const CONSOLE_API_MSG* const pWaitReplyMessage);
+
     ConsoleWaitQueue* const _pProcessQueue;
-    std::_List_const_iterator<std::_List_val<std::_List_simple_types<ConsoleWaitBlock*>>> _itProcessQueue;
+    ConsoleWaitLink _processLink;
 
     ConsoleWaitQueue* const _pObjectQueue;
-    std::_List_const_iterator<std::_List_val<std::_List_simple_types<ConsoleWaitBlock*>>> _itObjectQueue;
+    ConsoleWaitLink _objectLink;
 
     CONSOLE_API_MSG _WaitReplyMessage;
+    const ConsoleWaitReason _waitReason;
 
     IWaitRoutine* const _pWaiter;
+
+#ifdef UNIT_TESTING
+    friend class WaitQueueTests;
+#endif
 };
@@ -11,10 +11,7 @@
 
 // Routine Description:
 // - Instantiates a new ConsoleWaitQueue
-ConsoleWaitQueue::ConsoleWaitQueue() :
-    _blocks()
-{
-}
+ConsoleWaitQueue::ConsoleWaitQueue() = default;
 
 // Routine Description:
 // - Destructs a ConsoleWaitQueue
@@ -67,7 +64,8 @@ bool ConsoleWaitQueue::NotifyWaiters(const bool fNotifyAll)
 // Routine Description:
 // - Instructs this queue to attempt to callback waiting requests and request termination with the given reason
 // Arguments:
-// - fNotifyAll - If true, we will notify all items in the queue. If false, we will only notify the first item.
+// - fNotifyAll - If true, we will notify all items in the queue. If false, we will only notify the first item
+//                of the first wait reason that has any items.
 // - TerminationReason - A reason/message to pass to each waiter signaling it should terminate appropriately.
 // Return Value:
 // - True if any block was successfully notified. False if no blocks were successful.
@@ -76,18 +74,81 @@ bool ConsoleWaitQueue::NotifyWaiters(const bool fNotifyAll,
 {
     auto fResult = false;
 
-    auto it = _blocks.cbegin();
-    while (!_blocks.empty() && it != _blocks.cend())
+    // The lists are visited in the order of ConsoleWaitReason, so when notifying all waiters,
+    // every InputAvailable block is woken before any OutputUnblocked one, regardless of the
+    // order they were created in. This is intentional: the two kinds of waits don't depend
+    // on each other, and only the order within each kind is observable by a client.
+    for (auto& head : _blocks)
     {
-        const auto WaitBlock = (*it);
-        if (nullptr == WaitBlock)
+        if (!head.IsLinked())
+        {
+            continue;
+        }
+
+        if (_NotifyList(head, fNotifyAll, TerminationReason))
+        {
+            fResult = true;
+        }
+
+        if (!fNotifyAll)
         {
             break;
         }
+    }
 
-        const auto nextIt = std::next(it); // we have to capture next before it is potentially erased
+    return fResult;
+}
+
+// Routine Description:
+// - Instructs this queue to attempt to callback only the requests waiting for the given reason.
+// - Blocks waiting for anything else aren't visited at all.
+// Arguments:
+// - fNotifyAll - If true, we will notify all matching items in the queue. If false, we will only notify the first one.
+// - WaitReason - The kind of waiters to notify, for instance readers when input became available.
+// Return Value:
+// - True if any block was successfully notified. False if no blocks were successful.
+bool ConsoleWaitQueue::NotifyWaiters(const bool fNotifyAll,
+                                     const ConsoleWaitReason WaitReason)
+{
+    return _NotifyList(til::at(_blocks, static_cast<size_t>(WaitReason)), fNotifyAll, WaitTerminationReason::NoReason);
+}
+
+// Routine Description:
+// - Checks whether any request in this queue is waiting for the given reason.
+bool ConsoleWaitQueue::HasWaiters(const ConsoleWaitReason WaitReason) const noexcept
+{
+    return til::at(_blocks, static_cast<size_t>(WaitReason)).IsLinked();
+}
+
+// Routine Description:
+// - Links a wait block into the tail of the list for the reason it's waiting for.
+// Arguments:
+// - link - The wait block's link for this queue.
+void ConsoleWaitQueue::_Enqueue(ConsoleWaitLink& link) noexcept
+{
+    link.InsertBefore(til::at(_blocks, static_cast<size_t>(link.block->GetWaitReason())));
+}
+
+// Routine Description:
+// - Attempts to callback the requests in one of the lists of this queue.
+// Arguments:
+// - head - The head of the list to walk.
+// - fNotifyAll - If true, we will notify all items in the list. If false, we will only notify the first item.
+// - TerminationReason - A reason/message to pass to each waiter signaling it should terminate appropriately.
+// Return Value:
+// - True if any block was successfully notified. False if no blocks were successful.
+bool ConsoleWaitQueue::_NotifyList(ConsoleWaitLink& head,
+                                   const bool fNotifyAll,
+                                   const WaitTerminationReason TerminationReason)
+{
+    auto fResult = false;
+
+    auto link = head.next;
+    while (link != &head)
+    {
+        const auto next = link->next; // we have to capture next before it is potentially unlinked
 
-        if (_NotifyBlock(WaitBlock, TerminationReason))
+        if (_NotifyBlock(link->block, TerminationReason))
         {
             fResult = true;
         }
@@ -97,7 +158,7 @@ bool ConsoleWaitQueue::NotifyWaiters(const bool fNotifyAll,
             break;
         }
 
-        it = nextIt;
+        link = next;
     }
 
     return fResult;
@@ -118,7 +179,7 @@ bool ConsoleWaitQueue::_NotifyBlock(_In_ ConsoleWaitBlock* pWaitBlock,
 
     if (fResult)
     {
-        // If it was successful, delete it. (It will remove itself from appropriate queues.)
+        // If it was successful, delete it. (It will unlink itself from the appropriate queues.)
         delete pWaitBlock;
     }
 
@@ -17,8 +17,6 @@ Revision History:
 
 #pragma once
 
-#include <list>
-
 #include "../host/conapi.h"
 
 #include "IWaitRoutine.h"
@@ -32,19 +30,39 @@ public:
 
     ~ConsoleWaitQueue();
 
+    // The list heads point at themselves, so a queue can't be copied or moved.
+    ConsoleWaitQueue(const ConsoleWaitQueue&) = delete;
+    ConsoleWaitQueue& operator=(const ConsoleWaitQueue&) = delete;
+
     bool NotifyWaiters(const bool fNotifyAll);
 
     bool NotifyWaiters(const bool fNotifyAll,
                        const WaitTerminationReason TerminationReason);
 
+    bool NotifyWaiters(const bool fNotifyAll,
+                       const ConsoleWaitReason WaitReason);
+
+    bool HasWaiters(const ConsoleWaitReason WaitReason) const noexcept;
+
     [[nodiscard]] static HRESULT s_CreateWait(_Inout_ CONSOLE_API_MSG* const pWaitReplyMessage,
                                               _In_ IWaitRoutine* const pWaiter);
 
 private:
+    void _Enqueue(ConsoleWaitLink& link) noexcept;
+
+    bool _NotifyList(ConsoleWaitLink& head,
+                     const bool fNotifyAll,
+                     const WaitTerminationReason TerminationReason);
+
     bool _NotifyBlock(_In_ ConsoleWaitBlock* pWaitBlock,
                       const WaitTerminationReason TerminationReason);
 
-    std::list<ConsoleWaitBlock*> _blocks;
+    // One intrusive list of blocks per ConsoleWaitReason, each in the order the blocks were created.
+    std::array<ConsoleWaitLink, ConsoleWaitReasonCount> _blocks;
 
     friend class ConsoleWaitBlock; // Blocks live in multiple queues so we let them manage the lifetime.
+
+#ifdef UNIT_TESTING
+    friend class WaitQueueTests;
+#endif
 };
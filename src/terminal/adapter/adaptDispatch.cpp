@@ -645,13 +645,7 @@ void AdaptDispatch::_FillRect(TextBuffer& textBuffer, const til::rect& fillRect,
 {
     if (fillRect.left < fillRect.right && fillRect.top < fillRect.bottom)
     {
-        const auto fillWidth = gsl::narrow_cast<size_t>(fillRect.right - fillRect.left);
-        const auto fillData = OutputCellIterator{ fillChar, fillAttrs, fillWidth };
-        const auto col = fillRect.left;
-        for (auto row = fillRect.top; row < fillRect.bottom; row++)
-        {
-            textBuffer.WriteLine(fillData, { col, row }, false);
-        }
+        textBuffer.FillRect(fillRect, fillChar, fillAttrs);
         _api.NotifyAccessibilityChange(fillRect);
     }
 }
@@ -793,14 +787,23 @@ void AdaptDispatch::_SelectiveEraseRect(TextBuffer& textBuffer, const til::rect&
         for (auto row = eraseRect.top; row < eraseRect.bottom; row++)
         {
             auto& rowBuffer = textBuffer.GetRowByOffset(row);
-            for (auto col = eraseRect.left; col < eraseRect.right; col++)
+            // Only unprotected cells are affected. Since the protected attribute is stored in
+            // the attribute runs, we can erase the unprotected parts of the row a run at a time.
+            auto col = 0;
+            for (const auto& run : rowBuffer.Attributes().runs())
             {
-                // Only unprotected cells are affected.
-                if (!rowBuffer.GetAttrByColumn(col).IsProtected())
+                const auto begin = std::max(col, eraseRect.left);
+                col += run.length;
+                const auto end = std::min(col, eraseRect.right);
+                if (begin < end && !run.value.IsProtected())
                 {
                     // The text is cleared but the attributes are left as is.
-                    rowBuffer.ClearCell(col);
-                    textBuffer.TriggerRedraw(Viewport::FromCoord({ col, row }));
+                    rowBuffer.FillCharacters(begin, end, L' ');
+                    textBuffer.TriggerRedraw(Viewport::FromExclusive({ begin, row, end, row + 1 }));
+                }
+                if (col >= eraseRect.right)
+                {
+                    break;
                 }
             }
         }
@@ -892,26 +895,25 @@ void AdaptDispatch::_ChangeRectAttributes(TextBuffer& textBuffer, const til::rec
 {
     if (changeRect)
     {
-        for (auto row = changeRect.top; row < changeRect.bottom; row++)
-        {
-            auto& rowBuffer = textBuffer.GetRowByOffset(row);
-            for (auto col = changeRect.left; col < changeRect.right; col++)
+        // The changes only depend on the current attributes of a cell,
+        // so they can be applied to whole attribute runs at once.
+        const auto changeAttributes = [&](TextAttribute& attr) {
+            auto characterAttributes = attr.GetCharacterAttributes();
+            characterAttributes &= changeOps.andAttrMask;
+            characterAttributes ^= changeOps.xorAttrMask;
+            attr.SetCharacterAttributes(characterAttributes);
+            if (changeOps.foreground)
             {
-                auto attr = rowBuffer.GetAttrByColumn(col);
-                auto characterAttributes = attr.GetCharacterAttributes();
-                characterAttributes &= changeOps.andAttrMask;
-                characterAttributes ^= changeOps.xorAttrMask;
-                attr.SetCharacterAttributes(characterAttributes);
-                if (changeOps.foreground)
-                {
-                    attr.SetForeground(*changeOps.foreground);
-                }
-                if (changeOps.background)
-                {
-                    attr.SetBackground(*changeOps.background);
-                }
-                rowBuffer.ReplaceAttributes(col, col + 1, attr);
+                attr.SetForeground(*changeOps.foreground);
             }
+            if (changeOps.background)
+            {
+                attr.SetBackground(*changeOps.background);
+            }
+        };
+        for (auto row = changeRect.top; row < changeRect.bottom; row++)
+        {
+            textBuffer.GetRowByOffset(row).TransformAttributes(changeRect.left, changeRect.right, changeAttributes);
         }
         textBuffer.TriggerRedraw(Viewport::FromExclusive(changeRect));
         _api.NotifyAccessibilityChange(changeRect);
@@ -1281,46 +1283,81 @@ bool AdaptDispatch::RequestChecksumRectangularArea(const VTInt id, const VTInt p
             defaultFgIndex = defaultFgIndex < 16 ? defaultFgIndex : 7;
             defaultBgIndex = defaultBgIndex < 16 ? defaultBgIndex : 0;
 
+            // The algorithm we're using here should match the DEC terminals
+            // for the ASCII and Latin-1 range. Their other character sets
+            // predate Unicode, though, so we'd need a custom mapping table
+            // to lookup the correct checksums. Considering this is only for
+            // testing at the moment, that doesn't seem worth the effort.
+            // That said, I've made a special allowance for U+2426,
+            // since that is widely used in a lot of character sets.
+            //
+            // Both sums are written as plain loops over contiguous
+            // memory, so that the compiler can vectorize them.
+            const auto sumCharacters = [](const std::wstring_view chars) noexcept {
+                uint16_t sum = 0;
+                uint16_t symbolCount = 0;
+                for (const auto ch : chars)
+                {
+                    sum += ch;
+                    symbolCount += ch == L'\u2426';
+                }
+                return gsl::narrow_cast<uint16_t>(sum - symbolCount * (L'\u2426' - 0x1B));
+            };
+
+            // Since we're attempting to match the DEC checksum algorithm,
+            // the only attributes affecting the checksum are the ones that
+            // were supported by DEC terminals.
+            // For the same reason, we only care about the eight basic ANSI
+            // colors, although technically we also report the 8-16 index
+            // range. Everything else gets mapped to the default colors.
+            const auto sumAttributes = [&](const TextAttribute& attr) {
+                const auto colorIndex = [](const auto color, const auto defaultIndex) {
+                    return color.IsLegacy() ? color.GetIndex() : defaultIndex;
+                };
+                const auto fgIndex = colorIndex(attr.GetForeground(), defaultFgIndex);
+                const auto bgIndex = colorIndex(attr.GetBackground(), defaultBgIndex);
+                auto sum = gsl::narrow_cast<uint16_t>((fgIndex << 4) + bgIndex);
+                sum += attr.IsProtected() ? 0x04 : 0;
+                sum += attr.IsInvisible() ? 0x08 : 0;
+                sum += attr.IsUnderlined() ? 0x10 : 0;
+                sum += attr.IsReverseVideo() ? 0x20 : 0;
+                sum += attr.IsBlinking() ? 0x40 : 0;
+                sum += attr.IsIntense() ? 0x80 : 0;
+                return sum;
+            };
+
             const auto& textBuffer = _api.GetTextBuffer();
             const auto eraseRect = _CalculateRectArea(top, left, bottom, right, textBuffer.GetSize().Dimensions());
             for (auto row = eraseRect.top; row < eraseRect.bottom; row++)
             {
-                for (auto col = eraseRect.left; col < eraseRect.right; col++)
+                const auto& rowBuffer = textBuffer.GetRowByOffset(row);
+
+                checksum -= sumCharacters(rowBuffer.GetText(eraseRect.left, eraseRect.right));
+                // GetText() contains wide glyphs only once, but every cell counts
+                // towards the checksum, so we add the trailing halves separately.
+                for (auto col = eraseRect.left + 1; col < eraseRect.right; col++)
                 {
-                    // The algorithm we're using here should match the DEC terminals
-                    // for the ASCII and Latin-1 range. Their other character sets
-                    // predate Unicode, though, so we'd need a custom mapping table
-                    // to lookup the correct checksums. Considering this is only for
-                    // testing at the moment, that doesn't seem worth the effort.
-                    const auto cell = textBuffer.GetCellDataAt({ col, row });
-                    for (auto ch : cell->Chars())
+                    if (rowBuffer.DbcsAttrAt(col) == DbcsAttribute::Trailing)
                     {
-                        // That said, I've made a special allowance for U+2426,
-                        // since that is widely used in a lot of character sets.
-                        checksum -= (ch == L'\u2426' ? 0x1B : ch);
+                        checksum -= sumCharacters(rowBuffer.GlyphAt(col));
                     }
+                }
 
-                    // Since we're attempting to match the DEC checksum algorithm,
-                    // the only attributes affecting the checksum are the ones that
-                    // were supported by DEC terminals.
-                    const auto attr = cell->TextAttr();
-                    checksum -= attr.IsProtected() ? 0x04 : 0;
-                    checksum -= attr.IsInvisible() ? 0x08 : 0;
-                    checksum -= attr.IsUnderlined() ? 0x10 : 0;
-                    checksum -= attr.IsReverseVideo() ? 0x20 : 0;
-                    checksum -= attr.IsBlinking() ? 0x40 : 0;
-                    checksum -= attr.IsIntense() ? 0x80 : 0;
-
-                    // For the same reason, we only care about the eight basic ANSI
-                    // colors, although technically we also report the 8-16 index
-                    // range. Everything else gets mapped to the default colors.
-                    const auto colorIndex = [](const auto color, const auto defaultIndex) {
-                        return color.IsLegacy() ? color.GetIndex() : defaultIndex;
-                    };
-                    const auto fgIndex = colorIndex(attr.GetForeground(), defaultFgIndex);
-                    const auto bgIndex = colorIndex(attr.GetBackground(), defaultBgIndex);
-                    checksum -= gsl::narrow_cast<uint16_t>(fgIndex << 4);
-                    checksum -= gsl::narrow_cast<uint16_t>(bgIndex);
+                // The attributes only need to be summed up once per run.
+                auto col = 0;
+                for (const auto& run : rowBuffer.Attributes().runs())
+                {
+                    const auto begin = std::max(col, eraseRect.left);
+                    col += run.length;
+                    const auto end = std::min(col, eraseRect.right);
+                    if (begin < end)
+                    {
+                        checksum -= gsl::narrow_cast<uint16_t>(sumAttributes(run.value) * (end - begin));
+                    }
+                    if (col >= eraseRect.right)
+                    {
+                        break;
+                    }
                 }
             }
         }
@@ -2659,6 +2696,9 @@ bool AdaptDispatch::HardReset()
     _renderer.UpdateSoftFont({}, {}, false);
     _fontBuffer = nullptr;
 
+    // Stop any DECPS notes that are still queued up.
+    _api.FlushMidiNotes();
+
     // Reset internal modes to their initial state
     _modes = {};
 
@@ -2736,6 +2776,9 @@ bool AdaptDispatch::_EraseScrollback()
     _FillRect(textBuffer, { 0, height, bufferSize.width, bufferSize.height }, L' ', {});
     // Also reset the line rendition for all of the cleared rows.
     textBuffer.ResetLineRenditionRange(height, bufferSize.height);
+    // Rows that were spilled to disk are part of the scrollback as well.
+    textBuffer.ClearScrollbackSpill();
+    _api.NotifyScrollbackErased();
     // Move the viewport
     _api.SetViewportPosition({ viewport.left, 0 });
     // Move the cursor to the same relative location.
@@ -651,4 +651,84 @@ public:
         mouseInput->SetInputMode(TerminalInput::Mode::AlternateScroll, true);
         VERIFY_IS_FALSE(mouseInput->HandleMouse({ 0, 0 }, WM_MOUSEWHEEL, noModifierKeys, WHEEL_DELTA, {}));
     }
+
+    TEST_METHOD(MotionCoalescingTests)
+    {
+        Log::Comment(L"Starting test...");
+        const short noModifierKeys = 0;
+
+        std::vector<std::wstring> reports;
+        const auto createInput = [&](const bool coalesce) {
+            auto input = std::make_unique<TerminalInput>(nullptr);
+            input->SetTextSender([&](const std::wstring_view sequence) {
+                reports.emplace_back(sequence);
+            });
+            input->SetInputMode(TerminalInput::Mode::AnyEventMouseTracking, true);
+            input->SetInputMode(TerminalInput::Mode::SgrMouseEncoding, true);
+            input->SetMouseMotionCoalescing(coalesce);
+            return input;
+        };
+
+        // We simulate a mouse with a polling rate of 1000Hz, moving across a cell
+        // every other event, for one second. The frames are drawn at 60Hz.
+        static constexpr auto eventsPerSecond = 1000;
+        static constexpr auto eventsPerFrame = eventsPerSecond / 60;
+        const auto moveForOneSecond = [&](TerminalInput& input) {
+            reports.clear();
+            for (auto i = 0; i < eventsPerSecond; i++)
+            {
+                VERIFY_IS_TRUE(input.HandleMouse({ i / 2 % 80, i / 160 }, WM_MOUSEMOVE, noModifierKeys, 0, {}));
+                if (i % eventsPerFrame == eventsPerFrame - 1)
+                {
+                    input.FlushMouseMotion();
+                }
+            }
+            input.FlushMouseMotion();
+        };
+
+        const auto immediateInput = createInput(false);
+        moveForOneSecond(*immediateInput);
+        const auto immediateReports = reports;
+        Log::Comment(NoThrowString().Format(L"Without coalescing: %zu reports per second", immediateReports.size()));
+        VERIFY_ARE_EQUAL(static_cast<size_t>(eventsPerSecond / 2), immediateReports.size());
+
+        const auto coalescedInput = createInput(true);
+        moveForOneSecond(*coalescedInput);
+        const auto coalescedReports = reports;
+        Log::Comment(NoThrowString().Format(L"With coalescing: %zu reports per second", coalescedReports.size()));
+        VERIFY_IS_LESS_THAN_OR_EQUAL(coalescedReports.size(), static_cast<size_t>(eventsPerSecond / eventsPerFrame + 1));
+        VERIFY_ARE_EQUAL(immediateReports.back(), coalescedReports.back(), L"The final position must be reported.");
+
+        Log::Comment(L"Motion followed by a button press is reported in order.");
+        reports.clear();
+        VERIFY_IS_TRUE(immediateInput->HandleMouse({ 5, 5 }, WM_MOUSEMOVE, noModifierKeys, 0, {}));
+        VERIFY_IS_TRUE(immediateInput->HandleMouse({ 5, 5 }, WM_LBUTTONDOWN, noModifierKeys, 0, {}));
+        const auto expectedReports = reports;
+        VERIFY_ARE_EQUAL(size_t{ 2 }, expectedReports.size());
+
+        reports.clear();
+        VERIFY_IS_TRUE(coalescedInput->HandleMouse({ 3, 5 }, WM_MOUSEMOVE, noModifierKeys, 0, {}));
+        VERIFY_IS_TRUE(coalescedInput->HandleMouse({ 4, 5 }, WM_MOUSEMOVE, noModifierKeys, 0, {}));
+        VERIFY_IS_TRUE(coalescedInput->HandleMouse({ 5, 5 }, WM_MOUSEMOVE, noModifierKeys, 0, {}));
+        VERIFY_IS_TRUE(coalescedInput->HasPendingMouseMotion());
+        VERIFY_IS_TRUE(reports.empty());
+        VERIFY_IS_TRUE(coalescedInput->HandleMouse({ 5, 5 }, WM_LBUTTONDOWN, noModifierKeys, 0, {}));
+        VERIFY_IS_FALSE(coalescedInput->HasPendingMouseMotion());
+        VERIFY_IS_TRUE(expectedReports == reports);
+
+        Log::Comment(L"Motion followed by a key press is reported in order.");
+        reports.clear();
+        VERIFY_IS_TRUE(coalescedInput->HandleMouse({ 6, 6 }, WM_MOUSEMOVE, noModifierKeys, 0, {}));
+        const KeyEvent keyEvent(true, 1ui16, static_cast<WORD>('A'), 0ui16, L'a', 0);
+        VERIFY_IS_TRUE(coalescedInput->HandleKey(&keyEvent));
+        VERIFY_ARE_EQUAL(size_t{ 2 }, reports.size());
+        VERIFY_ARE_EQUAL(L"a", reports.back());
+
+        Log::Comment(L"Pending motion is dropped when mouse mode is turned off.");
+        reports.clear();
+        VERIFY_IS_TRUE(coalescedInput->HandleMouse({ 7, 7 }, WM_MOUSEMOVE, noModifierKeys, 0, {}));
+        coalescedInput->SetInputMode(TerminalInput::Mode::AnyEventMouseTracking, false);
+        coalescedInput->FlushMouseMotion();
+        VERIFY_IS_TRUE(reports.empty());
+    }
 };
@@ -215,6 +215,11 @@ public:
         Log::Comment(L"PlayMidiNote MOCK called...");
     }
 
+    void FlushMidiNotes() override
+    {
+        Log::Comment(L"FlushMidiNotes MOCK called...");
+    }
+
     bool IsConsolePty() const override
     {
         Log::Comment(L"IsConsolePty MOCK called...");
@@ -231,6 +236,11 @@ public:
         Log::Comment(L"NotifyBufferRotation MOCK called...");
     }
 
+    void NotifyScrollbackErased() override
+    {
+        Log::Comment(L"NotifyScrollbackErased MOCK called...");
+    }
+
     void MarkPrompt(const Microsoft::Console::VirtualTerminal::DispatchTypes::ScrollMark& /*mark*/) override
     {
         Log::Comment(L"MarkPrompt MOCK called...");
@@ -47,6 +47,7 @@ public:
     TEST_METHOD(CtrlNumTest);
     TEST_METHOD(BackarrowKeyModeTest);
     TEST_METHOD(AutoRepeatModeTest);
+    TEST_METHOD(TextSenderMatchesKeyEvents);
 
     wchar_t GetModifierChar(const bool fShift, const bool fAlt, const bool fCtrl)
     {
@@ -907,3 +908,70 @@ void InputTest::AutoRepeatModeTest()
     repeatKey('C', L'c', 5);
     VERIFY_ARE_EQUAL(L"aaaaabbbbbccccc", receivedChars);
 }
+
+void InputTest::TextSenderMatchesKeyEvents()
+{
+    Log::Comment(L"Sending the same keys with and without a text sender should produce the same sequences.");
+
+    auto eventChars = std::wstring{};
+    TerminalInput eventInput{ [&](auto& inEvents) {
+        for (auto& record : IInputEvent::ToInputRecords(inEvents))
+        {
+            eventChars.push_back(record.Event.KeyEvent.uChar.UnicodeChar);
+        }
+    } };
+
+    auto textChars = std::wstring{};
+    TerminalInput textInput{ nullptr };
+    textInput.SetTextSender([&](const std::wstring_view sequence) {
+        textChars.append(sequence);
+    });
+
+    struct TestKey
+    {
+        WORD vkey;
+        wchar_t ch;
+        DWORD modifiers;
+    };
+    static constexpr std::array keys{
+        TestKey{ VK_UP, 0, 0 },
+        TestKey{ VK_UP, 0, SHIFT_PRESSED | LEFT_CTRL_PRESSED },
+        TestKey{ VK_F5, 0, LEFT_ALT_PRESSED },
+        TestKey{ VK_F12, 0, SHIFT_PRESSED | LEFT_ALT_PRESSED | LEFT_CTRL_PRESSED },
+        TestKey{ VK_DELETE, 0, LEFT_CTRL_PRESSED },
+        TestKey{ VK_TAB, L'\t', SHIFT_PRESSED },
+        TestKey{ VK_BACK, L'\x08', LEFT_ALT_PRESSED },
+        TestKey{ 'A', L'a', 0 },
+        TestKey{ 'A', L'a', LEFT_ALT_PRESSED },
+        TestKey{ 'A', 0, LEFT_ALT_PRESSED | LEFT_CTRL_PRESSED },
+        TestKey{ VK_SPACE, L' ', LEFT_CTRL_PRESSED },
+    };
+
+    const auto sendKeys = [&]() {
+        for (const auto& key : keys)
+        {
+            eventChars.clear();
+            textChars.clear();
+
+            auto irTest = INPUT_RECORD{ 0 };
+            irTest.EventType = KEY_EVENT;
+            irTest.Event.KeyEvent.bKeyDown = TRUE;
+            irTest.Event.KeyEvent.wRepeatCount = 1;
+            irTest.Event.KeyEvent.wVirtualKeyCode = key.vkey;
+            irTest.Event.KeyEvent.uChar.UnicodeChar = key.ch;
+            irTest.Event.KeyEvent.dwControlKeyState = key.modifiers;
+            auto keyEvent = IInputEvent::Create(irTest);
+
+            VERIFY_ARE_EQUAL(eventInput.HandleKey(keyEvent.get()), textInput.HandleKey(keyEvent.get()));
+            VERIFY_ARE_EQUAL(eventChars, textChars, NoThrowString().Format(L"vkey: 0x%x, modifiers: 0x%x", key.vkey, key.modifiers));
+        }
+    };
+
+    Log::Comment(L"Default input mode");
+    sendKeys();
+
+    Log::Comment(L"Win32 input mode");
+    eventInput.SetInputMode(TerminalInput::Mode::Win32, true);
+    textInput.SetInputMode(TerminalInput::Mode::Win32, true);
+    sendKeys();
+}
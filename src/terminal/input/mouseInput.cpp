@@ -286,6 +286,54 @@ bool TerminalInput::IsTrackingMouseInput() const noexcept
     return _inputMode.any(Mode::DefaultMouseTracking, Mode::ButtonEventMouseTracking, Mode::AnyEventMouseTracking);
 }
 
+// Routine Description:
+// - Enables or disables the coalescing of mouse motion reports. When enabled, a motion
+//   report isn't sent right away. It's held back until FlushMouseMotion() is called,
+//   usually once per frame, and replaced if the mouse moves to another cell in the
+//   meantime. This way a high polling rate mouse doesn't flood the connection with
+//   reports that the application can't keep up with anyway.
+// - Any other input (buttons, the wheel, keys and focus changes) flushes the pending
+//   report first, so that the order of events is preserved.
+// Parameters:
+// - enabled - true to coalesce motion reports, false to send them immediately.
+// Return value:
+// - <none>
+void TerminalInput::SetMouseMotionCoalescing(const bool enabled) noexcept
+{
+    if (!enabled)
+    {
+        FlushMouseMotion();
+    }
+    _coalesceMouseMotion = enabled;
+}
+
+// Routine Description:
+// - Returns true if there's a motion report waiting to be sent by FlushMouseMotion().
+bool TerminalInput::HasPendingMouseMotion() const noexcept
+{
+    return !_mouseInputState.pendingMotion.empty();
+}
+
+// Routine Description:
+// - Sends the motion report that has been held back by the coalescing, if any.
+// Parameters:
+// - <none>
+// Return value:
+// - <none>
+void TerminalInput::FlushMouseMotion() noexcept
+{
+    if (!_mouseInputState.pendingMotion.empty())
+    {
+        // The application may have turned off mouse mode in the meantime,
+        // in which case it's no longer expecting the report.
+        if (IsTrackingMouseInput())
+        {
+            _SendInputSequence(_mouseInputState.pendingMotion);
+        }
+        _mouseInputState.pendingMotion.clear();
+    }
+}
+
 // Routine Description:
 // - Attempt to handle the given mouse coordinates and windows button as a VT-style mouse event.
 //     If the event should be transmitted in the selected mouse mode, then we'll try and
@@ -304,6 +352,12 @@ bool TerminalInput::HandleMouse(const til::point position,
                                 const short delta,
                                 const MouseButtonState state)
 {
+    // Anything but motion must not overtake a pending motion report.
+    if (!_isHoverMsg(button))
+    {
+        FlushMouseMotion();
+    }
+
     if (Utils::Sign(delta) != Utils::Sign(_mouseInputState.accumulatedDelta))
     {
         // This works for wheel and non-wheel events and transitioning between wheel/non-wheel.
@@ -401,7 +455,15 @@ bool TerminalInput::HandleMouse(const til::point position,
 
                 if (success)
                 {
-                    _SendInputSequence(sequence);
+                    if (isHover && _coalesceMouseMotion)
+                    {
+                        // Only the most recent position is of interest.
+                        _mouseInputState.pendingMotion = std::move(sequence);
+                    }
+                    else
+                    {
+                        _SendInputSequence(sequence);
+                    }
                     success = true;
                 }
                 if (_inputMode.any(Mode::ButtonEventMouseTracking, Mode::AnyEventMouseTracking))
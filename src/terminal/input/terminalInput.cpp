@@ -21,6 +21,17 @@ TerminalInput::TerminalInput(_In_ std::function<void(std::deque<std::unique_ptr<
     _pfnWriteEvents = pfn;
 }
 
+// Routine Description:
+// - Sets a function that receives the generated sequences as text. Once set, it's used
+//   in place of the key event callback, which avoids allocating an event per character
+//   for hosts that pass the input straight along to a connection, like the Terminal.
+// Arguments:
+// - pfn - The function to call with each sequence. The view is only valid for the duration of the call.
+void TerminalInput::SetTextSender(std::function<void(std::wstring_view)> pfn) noexcept
+{
+    _pfnWriteText = std::move(pfn);
+}
+
 struct TermKeyMap
 {
     const WORD vkey;
@@ -235,10 +246,21 @@ static constexpr std::array<TermKeyMap, 11> s_simpleModifiedKeyMapping{
     // TermKeyMap{ VK_ESCAPE, ALT_PRESSED, L""}, This is another Windows system shortcut for switching windows.
 };
 
-const wchar_t* const CTRL_SLASH_SEQUENCE = L"\x1f";
-const wchar_t* const CTRL_QUESTIONMARK_SEQUENCE = L"\x7F";
-const wchar_t* const CTRL_ALT_SLASH_SEQUENCE = L"\x1b\x1f";
-const wchar_t* const CTRL_ALT_QUESTIONMARK_SEQUENCE = L"\x1b\x7F";
+static constexpr std::wstring_view CTRL_SLASH_SEQUENCE = L"\x1f";
+static constexpr std::wstring_view CTRL_QUESTIONMARK_SEQUENCE = L"\x7F";
+static constexpr std::wstring_view CTRL_ALT_SLASH_SEQUENCE = L"\x1b\x1f";
+static constexpr std::wstring_view CTRL_ALT_QUESTIONMARK_SEQUENCE = L"\x1b\x7F";
+
+// The longest sequence in s_modifierKeyMapping, so that the modified
+// sequences can be assembled on the stack.
+static constexpr auto s_maxModifiedSequenceLength = [] {
+    size_t length = 0;
+    for (const auto& map : s_modifierKeyMapping)
+    {
+        length = std::max(length, map.sequence.size());
+    }
+    return length;
+}();
 
 void TerminalInput::SetInputMode(const Mode mode, const bool enabled) noexcept
 {
@@ -361,8 +383,6 @@ static std::optional<const TermKeyMap> _searchKeyMapping(const KeyEvent& keyEven
     return std::nullopt;
 }
 
-typedef std::function<void(const std::wstring_view)> InputSender;
-
 // Routine Description:
 // - Searches the s_modifierKeyMapping for a entry corresponding to this key event.
 //      Changes the second to last byte to correspond to the currently pressed modifier keys
@@ -372,7 +392,8 @@ typedef std::function<void(const std::wstring_view)> InputSender;
 // - sender - Function to use to dispatch translated event
 // Return Value:
 // - True if there was a match to a key translation, and we successfully modified and sent it to the input
-static bool _searchWithModifier(const KeyEvent& keyEvent, InputSender sender)
+template<typename Sender>
+static bool _searchWithModifier(const KeyEvent& keyEvent, const Sender& sender)
 {
     auto success = false;
 
@@ -383,12 +404,14 @@ static bool _searchWithModifier(const KeyEvent& keyEvent, InputSender sender)
         const auto& v = match.value();
         if (!v.sequence.empty())
         {
-            std::wstring modified{ v.sequence }; // Make a copy so we can modify it.
+            // Make a copy so we can modify it.
+            std::array<wchar_t, s_maxModifiedSequenceLength> modified;
+            std::copy(v.sequence.begin(), v.sequence.end(), modified.begin());
             const auto shift = keyEvent.IsShiftPressed();
             const auto alt = keyEvent.IsAltPressed();
             const auto ctrl = keyEvent.IsCtrlPressed();
-            modified.at(modified.size() - 2) = L'1' + (shift ? 1 : 0) + (alt ? 2 : 0) + (ctrl ? 4 : 0);
-            sender(modified);
+            til::at(modified, v.sequence.size() - 2) = L'1' + (shift ? 1 : 0) + (alt ? 2 : 0) + (ctrl ? 4 : 0);
+            sender(std::wstring_view{ modified.data(), v.sequence.size() });
             success = true;
         }
     }
@@ -491,9 +514,10 @@ static bool _searchWithModifier(const KeyEvent& keyEvent, InputSender sender)
 // - sender - Function to use to dispatch translated event
 // Return Value:
 // - True if there was a match to a key translation, and we successfully sent it to the input
+template<typename Sender>
 static bool _translateDefaultMapping(const KeyEvent& keyEvent,
                                      const std::span<const TermKeyMap> keyMapping,
-                                     InputSender sender)
+                                     const Sender& sender)
 {
     const auto match = _searchKeyMapping(keyEvent, keyMapping);
     if (match)
@@ -523,6 +547,9 @@ bool TerminalInput::HandleKey(const IInputEvent* const pInEvent)
         return false;
     }
 
+    // A pending mouse motion report must be sent before any key sequences.
+    FlushMouseMotion();
+
     // GH#11682: If this was a focus event, we can handle this. Steal the
     // focused state, and return true if we're actually in focus event mode.
     if (pInEvent->EventType() == InputEventType::FocusEvent)
@@ -552,8 +579,8 @@ bool TerminalInput::HandleKey(const IInputEvent* const pInEvent)
     // Only do this if win32-input-mode support isn't manually disabled.
     if (_inputMode.test(Mode::Win32) && !_forceDisableWin32InputMode)
     {
-        const auto seq = _GenerateWin32KeySequence(keyEvent);
-        _SendInputSequence(seq);
+        fmt::basic_memory_buffer<wchar_t, 64> buffer;
+        _SendInputSequence(_GenerateWin32KeySequence(keyEvent, buffer));
         return true;
     }
 
@@ -730,6 +757,8 @@ bool TerminalInput::HandleKey(const IInputEvent* const pInEvent)
 
 bool TerminalInput::HandleFocus(const bool focused) noexcept
 {
+    FlushMouseMotion();
+
     const auto enabled{ _inputMode.test(Mode::FocusEvent) };
     if (enabled)
     {
@@ -778,6 +807,13 @@ void TerminalInput::_SendChar(const wchar_t ch)
 // - None
 void TerminalInput::_SendEscapedInputSequence(const wchar_t wch) const
 {
+    if (_pfnWriteText)
+    {
+        const std::array<wchar_t, 2> sequence{ L'\x1b', wch };
+        _SendInputSequence({ sequence.data(), sequence.size() });
+        return;
+    }
+
     try
     {
         std::deque<std::unique_ptr<IInputEvent>> inputEvents;
@@ -793,6 +829,14 @@ void TerminalInput::_SendEscapedInputSequence(const wchar_t wch) const
 
 void TerminalInput::_SendNullInputSequence(const DWORD controlKeyState) const
 {
+    // The text sender has no notion of the modifier keys,
+    // so the sequence is just the null character itself.
+    if (_pfnWriteText)
+    {
+        _SendInputSequence({ L"\0", 1 });
+        return;
+    }
+
     try
     {
         std::deque<std::unique_ptr<IInputEvent>> inputEvents;
@@ -816,6 +860,12 @@ void TerminalInput::_SendInputSequence(const std::wstring_view sequence) const n
     {
         try
         {
+            if (_pfnWriteText)
+            {
+                _pfnWriteText(sequence);
+                return;
+            }
+
             std::deque<std::unique_ptr<IInputEvent>> inputEvents;
             for (const auto& wch : sequence)
             {
@@ -834,9 +884,11 @@ void TerminalInput::_SendInputSequence(const std::wstring_view sequence) const n
 // - Synthesize a win32-input-mode sequence for the given keyevent.
 // Arguments:
 // - key: the KeyEvent to serialize.
+// - buffer: receives the sequence. Its inline storage is large enough for any
+//   sequence, so this doesn't allocate.
 // Return Value:
-// - the formatted string representation of this key
-std::wstring TerminalInput::_GenerateWin32KeySequence(const KeyEvent& key)
+// - the formatted string representation of this key, pointing into buffer
+std::wstring_view TerminalInput::_GenerateWin32KeySequence(const KeyEvent& key, fmt::basic_memory_buffer<wchar_t, 64>& buffer)
 {
     // Sequences are formatted as follows:
     //
@@ -849,11 +901,14 @@ std::wstring TerminalInput::_GenerateWin32KeySequence(const KeyEvent& key)
     //      Kd: the value of bKeyDown - either a '0' or '1'. If omitted, defaults to '0'.
     //      Cs: the value of dwControlKeyState - any number. If omitted, defaults to '0'.
     //      Rc: the value of wRepeatCount - any number. If omitted, defaults to '1'.
-    return fmt::format(FMT_COMPILE(L"\x1b[{};{};{};{};{};{}_"),
-                       key.GetVirtualKeyCode(),
-                       key.GetVirtualScanCode(),
-                       static_cast<int>(key.GetCharData()),
-                       key.IsKeyDown() ? 1 : 0,
-                       key.GetActiveModifierKeys(),
-                       key.GetRepeatCount());
+    buffer.clear();
+    fmt::format_to(std::back_inserter(buffer),
+                   FMT_COMPILE(L"\x1b[{};{};{};{};{};{}_"),
+                   key.GetVirtualKeyCode(),
+                   key.GetVirtualScanCode(),
+                   static_cast<int>(key.GetCharData()),
+                   key.IsKeyDown() ? 1 : 0,
+                   key.GetActiveModifierKeys(),
+                   key.GetRepeatCount());
+    return { buffer.data(), buffer.size() };
 }
@@ -24,6 +24,8 @@ namespace Microsoft::Console::VirtualTerminal
     public:
         TerminalInput(_In_ std::function<void(std::deque<std::unique_ptr<IInputEvent>>&)> pfn);
 
+        void SetTextSender(std::function<void(std::wstring_view)> pfn) noexcept;
+
         TerminalInput() = delete;
         TerminalInput(const TerminalInput& old) = default;
         TerminalInput(TerminalInput&& moved) = default;
@@ -80,6 +82,10 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool IsTrackingMouseInput() const noexcept;
         bool ShouldSendAlternateScroll(const unsigned int button, const short delta) const noexcept;
+
+        void SetMouseMotionCoalescing(const bool enabled) noexcept;
+        bool HasPendingMouseMotion() const noexcept;
+        void FlushMouseMotion() noexcept;
 #pragma endregion
 
 #pragma region MouseInputState Management
@@ -90,6 +96,9 @@ namespace Microsoft::Console::VirtualTerminal
 
     private:
         std::function<void(std::deque<std::unique_ptr<IInputEvent>>&)> _pfnWriteEvents;
+        // If set, sequences are passed along as text instead of being
+        // converted into key events first. See SetTextSender().
+        std::function<void(std::wstring_view)> _pfnWriteText;
 
         // storage location for the leading surrogate of a utf-16 surrogate pair
         std::optional<wchar_t> _leadingSurrogate;
@@ -103,7 +112,7 @@ namespace Microsoft::Console::VirtualTerminal
         void _SendNullInputSequence(const DWORD dwControlKeyState) const;
         void _SendInputSequence(const std::wstring_view sequence) const noexcept;
         void _SendEscapedInputSequence(const wchar_t wch) const;
-        static std::wstring _GenerateWin32KeySequence(const KeyEvent& key);
+        static std::wstring_view _GenerateWin32KeySequence(const KeyEvent& key, fmt::basic_memory_buffer<wchar_t, 64>& buffer);
 
 #pragma region MouseInputState Management
         // These methods are defined in mouseInputState.cpp
@@ -113,9 +122,13 @@ namespace Microsoft::Console::VirtualTerminal
             til::point lastPos{ -1, -1 };
             unsigned int lastButton{ 0 };
             int accumulatedDelta{ 0 };
+            // The most recent motion report, if motion is being coalesced
+            // and it hasn't been sent yet. See FlushMouseMotion().
+            std::wstring pendingMotion;
         };
 
         MouseInputState _mouseInputState;
+        bool _coalesceMouseMotion{ false };
 #pragma endregion
 
 #pragma region MouseInput
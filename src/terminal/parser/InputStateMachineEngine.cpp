@@ -31,11 +31,6 @@ static constexpr std::array<CsiToVkey, 10> s_csiMap = {
     CsiToVkey{ CsiActionCodes::CSI_F4, VK_F4 }
 };
 
-static bool operator==(const CsiToVkey& pair, const VTID id) noexcept
-{
-    return pair.action == id;
-}
-
 struct GenericToVkey
 {
     GenericKeyIdentifiers identifier;
@@ -59,11 +54,6 @@ static constexpr std::array<GenericToVkey, 14> s_genericMap = {
     GenericToVkey{ GenericKeyIdentifiers::F12, VK_F12 },
 };
 
-static bool operator==(const GenericToVkey& pair, const GenericKeyIdentifiers identifier) noexcept
-{
-    return pair.identifier == identifier;
-}
-
 struct Ss3ToVkey
 {
     Ss3ActionCodes action;
@@ -83,11 +73,29 @@ static constexpr std::array<Ss3ToVkey, 10> s_ss3Map = {
     Ss3ToVkey{ Ss3ActionCodes::SS3_F4, VK_F4 },
 };
 
-static bool operator==(const Ss3ToVkey& pair, const Ss3ActionCodes code) noexcept
+// The maps above remain the single source of truth for which sequences we
+// translate into keys, but searching them linearly for every key press is
+// wasteful. Instead we expand them at compile time into tables that are
+// indexed directly by the final character (or the generic key identifier).
+// A vkey of 0 marks an index that doesn't map to any key.
+template<size_t Size, typename Pair, size_t N, typename Projection>
+static constexpr std::array<short, Size> s_MakeVkeyTable(const std::array<Pair, N>& map, Projection key)
 {
-    return pair.action == code;
+    std::array<short, Size> table{};
+    for (const auto& pair : map)
+    {
+        // at() fails to compile if a key doesn't fit into the table.
+        table.at(static_cast<size_t>(key(pair))) = pair.vkey;
+    }
+    return table;
 }
 
+static constexpr auto s_csiVkeys = s_MakeVkeyTable<128>(s_csiMap, [](const auto& pair) { return pair.action; });
+static constexpr auto s_genericVkeys = s_MakeVkeyTable<32>(s_genericMap, [](const auto& pair) { return pair.identifier; });
+static constexpr auto s_ss3Vkeys = s_MakeVkeyTable<128>(s_ss3Map, [](const auto& pair) { return pair.action; });
+
+static_assert(s_csiVkeys.at('A') == VK_UP && s_genericVkeys.at(24) == VK_F12 && s_ss3Vkeys.at('S') == VK_F4);
+
 InputStateMachineEngine::InputStateMachineEngine(std::unique_ptr<IInteractDispatch> pDispatch) :
     InputStateMachineEngine(std::move(pDispatch), false)
 {
@@ -979,16 +987,9 @@ bool InputStateMachineEngine::_UpdateSGRMouseButtonState(const VTID id,
 // true iff we found the key
 bool InputStateMachineEngine::_GetGenericVkey(const GenericKeyIdentifiers identifier, short& vkey) const
 {
-    vkey = 0;
-
-    const auto mapping = std::find(s_genericMap.cbegin(), s_genericMap.cend(), identifier);
-    if (mapping != s_genericMap.end())
-    {
-        vkey = mapping->vkey;
-        return true;
-    }
-
-    return false;
+    const auto index = static_cast<size_t>(identifier);
+    vkey = index < s_genericVkeys.size() ? til::at(s_genericVkeys, index) : 0;
+    return vkey != 0;
 }
 
 // Method Description:
@@ -1000,16 +1001,10 @@ bool InputStateMachineEngine::_GetGenericVkey(const GenericKeyIdentifiers identi
 // true iff we found the key
 bool InputStateMachineEngine::_GetCursorKeysVkey(const VTID id, short& vkey) const
 {
-    vkey = 0;
-
-    const auto mapping = std::find(s_csiMap.cbegin(), s_csiMap.cend(), id);
-    if (mapping != s_csiMap.end())
-    {
-        vkey = mapping->vkey;
-        return true;
-    }
-
-    return false;
+    // Sequences with intermediates have an id beyond the table and are never keys.
+    const auto index = static_cast<uint64_t>(id);
+    vkey = index < s_csiVkeys.size() ? til::at(s_csiVkeys, index) : 0;
+    return vkey != 0;
 }
 
 // Method Description:
@@ -1021,16 +1016,9 @@ bool InputStateMachineEngine::_GetCursorKeysVkey(const VTID id, short& vkey) con
 // true iff we found the key
 bool InputStateMachineEngine::_GetSs3KeysVkey(const wchar_t wch, short& vkey) const
 {
-    vkey = 0;
-
-    const auto mapping = std::find(s_ss3Map.cbegin(), s_ss3Map.cend(), (Ss3ActionCodes)wch);
-    if (mapping != s_ss3Map.end())
-    {
-        vkey = mapping->vkey;
-        return true;
-    }
-
-    return false;
+    const auto index = static_cast<size_t>(wch);
+    vkey = index < s_ss3Vkeys.size() ? til::at(s_ss3Vkeys, index) : 0;
+    return vkey != 0;
 }
 
 // Method Description:
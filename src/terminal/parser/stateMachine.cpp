@@ -10,17 +10,24 @@
 using namespace Microsoft::Console::VirtualTerminal;
 
 //Takes ownership of the pEngine.
-StateMachine::StateMachine(std::unique_ptr<IStateMachineEngine> engine, const bool isEngineForInput) :
+// The upstream resource is where the parser's pool gets its memory from, which is
+// only ever the heap outside of tests.
+StateMachine::StateMachine(std::unique_ptr<IStateMachineEngine> engine,
+                           const bool isEngineForInput,
+                           std::pmr::memory_resource* const upstream) :
     _engine(std::move(engine)),
     _isEngineForInput(isEngineForInput),
     _state(VTStates::Ground),
     _trace(Microsoft::Console::VirtualTerminal::ParserTracing()),
-    _parameters{},
+    _pool{ upstream },
+    _parameters{ &_pool },
     _parameterLimitReached(false),
-    _oscString{},
+    _oscString{ &_pool },
     _cachedSequence{ std::nullopt },
     _processingIndividually(false)
 {
+    // Reserving the maximum up front means that parameters are never reallocated.
+    _parameters.reserve(MAX_PARAMETER_COUNT);
     _ActionClear();
 }
 
@@ -1977,7 +1984,7 @@ void StateMachine::ProcessString(const std::wstring_view string)
             // will be dealt with as soon as it is received.
             if (!_cachedSequence)
             {
-                _cachedSequence.emplace(std::wstring{});
+                _cachedSequence.emplace(&_pool);
             }
 
             auto& cachedSequence = *_cachedSequence;
@@ -45,7 +45,9 @@ namespace Microsoft::Console::VirtualTerminal
             StateMachine(std::move(engine), std::is_same_v<T, class InputStateMachineEngine>)
         {
         }
-        StateMachine(std::unique_ptr<IStateMachineEngine> engine, const bool isEngineForInput);
+        StateMachine(std::unique_ptr<IStateMachineEngine> engine,
+                     const bool isEngineForInput,
+                     std::pmr::memory_resource* const upstream = til::pmr::get_default_resource());
 
         enum class Mode : size_t
         {
@@ -191,16 +193,23 @@ namespace Microsoft::Console::VirtualTerminal
             return _currentString.substr(_runOffset, _runSize);
         }
 
+        // The parameters, OSC string and cached sequence are cleared after every
+        // sequence, and this pool recycles their storage for the next one. That
+        // way escape-dense output doesn't go to the heap once the pool is warm.
+        // It's important the pool is declared first so it's constructed before
+        // and destroyed after the containers that use it.
+        std::pmr::unsynchronized_pool_resource _pool;
+
         VTIDBuilder _identifier;
-        std::vector<VTParameter> _parameters;
+        std::pmr::vector<VTParameter> _parameters;
         bool _parameterLimitReached;
 
-        std::wstring _oscString;
+        std::pmr::wstring _oscString;
         VTInt _oscParameter;
 
         IStateMachineEngine::StringHandler _dcsStringHandler;
 
-        std::optional<std::wstring> _cachedSequence;
+        std::optional<std::pmr::wstring> _cachedSequence;
 
         // This is tracked per state machine instance so that separate calls to Process*
         //   can start and finish a sequence.
@@ -135,6 +135,30 @@ public:
     std::wstring dcsDataString;
 };
 
+// Forwards to the default resource, counting how often the parser goes to it.
+class CountingMemoryResource : public std::pmr::memory_resource
+{
+public:
+    size_t allocations = 0;
+
+private:
+    void* do_allocate(const size_t bytes, const size_t align) override
+    {
+        allocations++;
+        return til::pmr::get_default_resource()->allocate(bytes, align);
+    }
+
+    void do_deallocate(void* const ptr, const size_t bytes, const size_t align) override
+    {
+        til::pmr::get_default_resource()->deallocate(ptr, bytes, align);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
 class Microsoft::Console::VirtualTerminal::StateMachineTest
 {
     TEST_CLASS(StateMachineTest);
@@ -157,6 +181,8 @@ class Microsoft::Console::VirtualTerminal::StateMachineTest
     TEST_METHOD(PassThroughUnhandledSplitAcrossWrites);
 
     TEST_METHOD(DcsDataStringsReceivedByHandler);
+
+    TEST_METHOD(SequencesDontAllocateOnceWarm);
 };
 
 void StateMachineTest::TwoStateMachinesDoNotInterfereWithEachOther()
@@ -337,3 +363,34 @@ void StateMachineTest::DcsDataStringsReceivedByHandler()
     // Verify the control characters were executed (if expected).
     VERIFY_ARE_EQUAL(expectedExecuted, engine.executed);
 }
+
+void StateMachineTest::SequencesDontAllocateOnceWarm()
+{
+    CountingMemoryResource upstream;
+    StateMachine machine{ std::make_unique<TestStateMachineEngine>(), false, &upstream };
+
+    // A mix of escape-dense output: SGR with many parameters, an OSC title,
+    // cursor movement, the maximum number of parameters, and a sequence
+    // that's split across writes, which has to be cached in the meantime.
+    const auto processSequences = [&]() {
+        machine.ProcessString(L"\x1b[1;2;3;4;5;6;7;8m\x1b]0;A window title\x07\x1b[?25l\x1b[38;2;10;20;30mtext\x1b[12;34H");
+        machine.ProcessString(L"\x1b[1;2;3;4;5;6;7;8;9;10;11;12;13;14;15;16;17;18;19;20;21;22;23;24;25;26;27;28;29;30;31;32;33m");
+        machine.ProcessString(L"\x1b]8;;https://example.com/a/rather/long/link\x1b\\link\x1b]8;;\x1b\\");
+        machine.ProcessString(L"\x1b[?12");
+        machine.ProcessString(L"34h");
+    };
+
+    Log::Comment(L"Warming up the parser's pool");
+    processSequences();
+    const auto warmAllocations = upstream.allocations;
+    Log::Comment(NoThrowString().Format(L"Allocations while warming up: %zu", warmAllocations));
+
+    constexpr auto iterations = 1000;
+    for (auto i = 0; i < iterations; i++)
+    {
+        processSequences();
+    }
+
+    Log::Comment(NoThrowString().Format(L"Allocations for %d more iterations: %zu", iterations, upstream.allocations - warmAllocations));
+    VERIFY_ARE_EQUAL(warmAllocations, upstream.allocations);
+}
@@ -0,0 +1,111 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include <regex>
+#include <til/regex.h>
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class RegexTests
+{
+    TEST_CLASS(RegexTests);
+
+    using match = std::optional<std::pair<size_t, size_t>>;
+
+    static match _find(const std::wstring_view pattern, const std::wstring_view text, const size_t offset = 0)
+    {
+        return til::linear_regex{ pattern }.find(text, offset);
+    }
+
+    static match _findWithStd(const std::wstring_view pattern, const std::wstring_view text)
+    {
+        const std::wregex re{ pattern.begin(), pattern.end() };
+        std::match_results<std::wstring_view::const_iterator> m;
+        if (!std::regex_search(text.begin(), text.end(), m, re))
+        {
+            return std::nullopt;
+        }
+        const auto begin = gsl::narrow_cast<size_t>(m.position(0));
+        return std::pair{ begin, begin + gsl::narrow_cast<size_t>(m.length(0)) };
+    }
+
+    static void _verifyMatch(const match& expected, const match& actual)
+    {
+        VERIFY_ARE_EQUAL(expected.has_value(), actual.has_value());
+        if (expected && actual)
+        {
+            VERIFY_ARE_EQUAL(expected->first, actual->first);
+            VERIFY_ARE_EQUAL(expected->second, actual->second);
+        }
+    }
+
+    static void _verifySameAsStd(const std::wstring_view pattern, const std::initializer_list<std::wstring_view> texts)
+    {
+        for (const auto text : texts)
+        {
+            Log::Comment(NoThrowString().Format(L"'%.*s' in '%.*s'", gsl::narrow_cast<int>(pattern.size()), pattern.data(), gsl::narrow_cast<int>(text.size()), text.data()));
+            _verifyMatch(_findWithStd(pattern, text), _find(pattern, text));
+        }
+    }
+
+    TEST_METHOD(BoundedRepetition)
+    {
+        _verifySameAsStd(L"a{2}", { L"", L"a", L"aa", L"baaab" });
+        _verifySameAsStd(L"a{2,}", { L"", L"a", L"aa", L"baaaab" });
+        _verifySameAsStd(L"x{1,}y", { L"y", L"xy", L"xxxy", L"xxx" });
+        _verifySameAsStd(L"b{0,}", { L"", L"b", L"abbb" });
+        _verifySameAsStd(L"a{1,3}", { L"", L"a", L"aaaaa" });
+        _verifySameAsStd(L"a{1,3}?", { L"aaa" });
+        _verifySameAsStd(L"a{2,}?b", { L"aaab", L"ab" });
+        _verifySameAsStd(L"(ab){2,3}", { L"ababababab", L"abab", L"ab" });
+
+        Log::Comment(L"Anything that isn't a valid quantifier is a literal '{'.");
+        _verifyMatch(std::pair{ size_t{ 0 }, size_t{ 5 } }, _find(L"a{,2}", L"a{,2}"));
+        _verifyMatch(std::pair{ size_t{ 0 }, size_t{ 3 } }, _find(L"a{1", L"a{1"));
+
+        Log::Comment(L"Invalid bounds are rejected.");
+        VERIFY_THROWS(til::linear_regex{ L"a{2,1}" }, std::invalid_argument);
+        VERIFY_THROWS(til::linear_regex{ L"a{1001}" }, std::invalid_argument);
+    }
+
+    TEST_METHOD(NullableLoops)
+    {
+        // ECMAScript rejects optional iterations that match the empty string and
+        // backtracks into the loop body instead. These are the results that a
+        // conforming engine, like the one in any web browser, returns.
+        _verifyMatch(std::pair{ size_t{ 0 }, size_t{ 1 } }, _find(L"(x??)*", L"x"));
+        _verifyMatch(std::pair{ size_t{ 0 }, size_t{ 1 } }, _find(L"(x??)+", L"x"));
+        _verifyMatch(std::pair{ size_t{ 0 }, size_t{ 2 } }, _find(L"(x??){0,2}", L"xxx"));
+        _verifyMatch(std::pair{ size_t{ 0 }, size_t{ 1 } }, _find(L"(y??x??){0,2}", L"y"));
+        _verifyMatch(std::pair{ size_t{ 0 }, size_t{ 3 } }, _find(L"(|x){0,2}(?:x?){2}", L"xxxy"));
+        _verifyMatch(std::pair{ size_t{ 0 }, size_t{ 0 } }, _find(L"(){0,3}", L"x"));
+
+        Log::Comment(L"Loops whose body can match the empty string agree with std::wregex where it isn't ambiguous.");
+        _verifySameAsStd(L"(a|)*b", { L"aab", L"b", L"c" });
+        _verifySameAsStd(L"(a*)*b", { L"aaab", L"b" });
+        _verifySameAsStd(L"(a?b?)*c", { L"ababc", L"bbac", L"c" });
+        _verifySameAsStd(L"(x?y?){0,3}z", { L"xyxz", L"yyyyz" });
+
+        Log::Comment(L"Deeply nested nullable loops still compile.");
+        _verifyMatch(std::pair{ size_t{ 0 }, size_t{ 2 } }, _find(L"((((((x?y?)*)*)*)*)*)*", L"xy"));
+    }
+
+    TEST_METHOD(FirstCharacterSkip)
+    {
+        // Patterns that start with a literal character skip straight to its next occurrence.
+        _verifySameAsStd(L"needle", { L"", L"haystack", L"hay needle stack", L"nnneedle", L"needl" });
+        _verifySameAsStd(L"ab*c", { L"aaaac", L"xxabbbxxabc", L"xxabbb" });
+        _verifySameAsStd(L"a|b", { L"xxxb", L"xxxa" });
+
+        Log::Comment(L"The skip must respect the offset the search starts at.");
+        _verifyMatch(std::pair{ size_t{ 6 }, size_t{ 9 } }, _find(L"abc", L"abc...abc", 1));
+        _verifyMatch(std::nullopt, _find(L"abc", L"abc...abc", 7));
+
+        Log::Comment(L"Surrogate pairs after the first character are decoded as usual.");
+        _verifyMatch(std::pair{ size_t{ 3 }, size_t{ 7 } }, _find(L"a.b", L"xyza\xD83D\xDE00" L"b"));
+    }
+};
@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+// TEST TOOL PublicTerminalCoreBench
+// Compares the output throughput of PublicTerminalCore's UTF-16 export (TerminalSendOutput)
+// with the UTF-8 exports (TerminalSendOutputUtf8 and TerminalSendOutputUtf8Batch).
+// The input is read from a simulated pipe in chunks of UTF-8, the way a host
+// would receive it from a process. For TerminalSendOutput the host has to convert
+// and null-terminate each chunk first, which is included in the measurement.
+// Usage: PublicTerminalCoreBench.exe [megabytes of output] [chunk size in bytes]
+
+#include <Windows.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Keep in sync with HwndTerminal.hpp
+typedef struct _TerminalOutputChunk
+{
+    const char* Data;
+    size_t Length;
+} TerminalOutputChunk;
+
+extern "C" {
+__declspec(dllimport) HRESULT _stdcall CreateTerminal(HWND parentHwnd, _Out_ void** hwnd, _Out_ void** terminal);
+__declspec(dllimport) void _stdcall TerminalSendOutput(void* terminal, LPCWSTR data);
+__declspec(dllimport) void _stdcall TerminalSendOutputUtf8(void* terminal, const char* data, size_t length);
+__declspec(dllimport) void _stdcall TerminalSendOutputUtf8Batch(void* terminal, const TerminalOutputChunk* chunks, size_t count);
+__declspec(dllimport) void _stdcall DestroyTerminal(void* terminal);
+};
+
+// How many chunks a host would typically have queued up when it gets around to writing them.
+static constexpr size_t BatchSize = 16;
+
+// Splits the output into chunks of about the given size. Chunks end on character
+// boundaries, so that the UTF-16 path can convert each one on its own.
+static std::vector<std::string_view> SplitIntoChunks(const std::string_view output, const size_t chunkSize)
+{
+    std::vector<std::string_view> chunks;
+    for (size_t offset = 0; offset < output.size();)
+    {
+        auto end = std::min(offset + chunkSize, output.size());
+        while (end < output.size() && end > offset + 1 && (output[end] & 0b1100'0000) == 0b1000'0000)
+        {
+            --end;
+        }
+        chunks.emplace_back(output.substr(offset, end - offset));
+        offset = end;
+    }
+    return chunks;
+}
+
+template<typename Func>
+static double Measure(Func&& func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int wmain(int argc, wchar_t* argv[])
+{
+    const size_t megabytes = argc > 1 ? std::wcstoul(argv[1], nullptr, 10) : 64;
+    const size_t chunkSize = argc > 2 ? std::wcstoul(argv[2], nullptr, 10) : 4096;
+
+    // A mix of plain ASCII, colored text and non-ASCII characters, like the output of a build or a "ls".
+    std::string output;
+    while (output.size() < megabytes * 1024 * 1024)
+    {
+        output.append("src/cascadia/PublicTerminalCore/HwndTerminal.cpp(42): \x1b[32msucceeded\x1b[m \xc3\xa9\xc3\xa8 \xe2\x94\x80\xe2\x94\x80 \xe6\xbc\xa2\xe5\xad\x97\r\n");
+    }
+    const auto chunks = SplitIntoChunks(output, chunkSize);
+
+    const auto parent = CreateWindowExW(0, L"STATIC", L"PublicTerminalCoreBench", WS_OVERLAPPEDWINDOW, 0, 0, 800, 600, nullptr, nullptr, nullptr, nullptr);
+    if (!parent)
+    {
+        std::printf("failed to create the parent window\n");
+        return 1;
+    }
+
+    const auto run = [&](const char* name, auto&& write) {
+        void* hwnd = nullptr;
+        void* terminal = nullptr;
+        if (FAILED(CreateTerminal(parent, &hwnd, &terminal)))
+        {
+            std::printf("%-28s failed to create the terminal\n", name);
+            return;
+        }
+
+        const auto seconds = Measure([&]() { write(terminal); });
+        std::printf("%-28s %10.3f %10.1f\n", name, seconds * 1000.0, output.size() / seconds / (1024.0 * 1024.0));
+
+        DestroyTerminal(terminal);
+    };
+
+    std::printf("%zu MiB in %zu chunks of up to %zu bytes\n", megabytes, chunks.size(), chunkSize);
+    std::printf("%-28s %10s %10s\n", "export", "time [ms]", "MiB/s");
+
+    run("TerminalSendOutput", [&](void* terminal) {
+        for (const auto chunk : chunks)
+        {
+            const auto length = MultiByteToWideChar(CP_UTF8, 0, chunk.data(), static_cast<int>(chunk.size()), nullptr, 0);
+            std::wstring text(static_cast<size_t>(length), L'\0');
+            MultiByteToWideChar(CP_UTF8, 0, chunk.data(), static_cast<int>(chunk.size()), text.data(), length);
+            TerminalSendOutput(terminal, text.c_str());
+        }
+    });
+
+    run("TerminalSendOutputUtf8", [&](void* terminal) {
+        for (const auto chunk : chunks)
+        {
+            TerminalSendOutputUtf8(terminal, chunk.data(), chunk.size());
+        }
+    });
+
+    run("TerminalSendOutputUtf8Batch", [&](void* terminal) {
+        std::vector<TerminalOutputChunk> batch;
+        batch.reserve(BatchSize);
+        for (size_t i = 0; i < chunks.size(); i += BatchSize)
+        {
+            batch.clear();
+            for (size_t j = i; j < std::min(i + BatchSize, chunks.size()); j++)
+            {
+                batch.push_back({ chunks[j].data(), chunks[j].size() });
+            }
+            TerminalSendOutputUtf8Batch(terminal, batch.data(), batch.size());
+        }
+    });
+
+    DestroyWindow(parent);
+    return 0;
+}
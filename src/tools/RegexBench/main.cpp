@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+// TEST TOOL RegexBench
+// Compares the performance of til::linear_regex, which the search box uses for
+// regex searches, with std::wregex, on ordinary and on adversarial patterns.
+// Usage: RegexBench.exe [haystack length]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cwctype>
+#include <optional>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include <til/regex.h>
+
+struct Case
+{
+    const wchar_t* name;
+    const wchar_t* pattern;
+    std::wstring haystack;
+    // Whether std::wregex is expected to blow up on this case.
+    bool adversarial;
+};
+
+template<typename Func>
+static double Measure(Func&& func)
+{
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Counts all non-overlapping matches, like the search box does.
+static size_t CountLinear(const til::linear_regex& re, const std::wstring_view haystack)
+{
+    size_t count = 0;
+    for (size_t offset = 0; offset <= haystack.size();)
+    {
+        const auto match = re.find(haystack, offset);
+        if (!match)
+        {
+            break;
+        }
+        ++count;
+        offset = std::max(match->second, match->first + 1);
+    }
+    return count;
+}
+
+static size_t CountStd(const std::wregex& re, const std::wstring& haystack)
+{
+    return static_cast<size_t>(std::distance(std::wsregex_iterator{ haystack.begin(), haystack.end(), re }, std::wsregex_iterator{}));
+}
+
+int wmain(int argc, wchar_t* argv[])
+{
+    const size_t length = argc > 1 ? std::wcstoul(argv[1], nullptr, 10) : 1000000;
+
+    std::wstring prose;
+    while (prose.size() < length)
+    {
+        prose.append(L"The quick brown fox jumps over the lazy dog at https://example.com/path?id=42 on 2023-01-31. ");
+    }
+    prose.resize(length);
+
+    const std::vector<Case> cases{
+        { L"literal", L"lazy dog", prose, false },
+        { L"class", L"[0-9]{4}-[0-9]{2}-[0-9]{2}", prose, false },
+        { L"url", L"https?://[\\w./?=&-]+", prose, false },
+        { L"alternation", L"\\b(fox|dog|cat)\\b", prose, false },
+        // These take exponential time in a backtracking engine, so
+        // we only give std::wregex a dozen or two characters.
+        { L"nested star", L"(a*)*b", std::wstring(12, L'a'), true },
+        { L"alternation star", L"(a|aa)*b", std::wstring(24, L'a'), true },
+        { L"nested star (long)", L"(a*)*b", std::wstring(length, L'a'), true },
+    };
+
+    std::printf("%-20s %12s %12s %10s\n", "case", "linear [ms]", "wregex [ms]", "matches");
+
+    for (const auto& c : cases)
+    {
+        size_t linearCount = 0;
+        const til::linear_regex linear{ c.pattern };
+        const auto linearTime = Measure([&]() { linearCount = CountLinear(linear, c.haystack); });
+
+        // std::wregex either takes too long or overflows its stack
+        // on adversarial patterns with a long haystack. Skip those.
+        if (c.adversarial && c.haystack.size() > 64)
+        {
+            std::printf("%-20ls %12.3f %12s %10zu\n", c.name, linearTime, "skipped", linearCount);
+            continue;
+        }
+
+        size_t stdCount = 0;
+        double stdTime = 0;
+        try
+        {
+            const std::wregex std{ c.pattern };
+            stdTime = Measure([&]() { stdCount = CountStd(std, c.haystack); });
+        }
+        catch (const std::regex_error&)
+        {
+            std::printf("%-20ls %12.3f %12s %10zu\n", c.name, linearTime, "failed", linearCount);
+            continue;
+        }
+
+        std::printf("%-20ls %12.3f %12.3f %10zu%s\n", c.name, linearTime, stdTime, linearCount, linearCount == stdCount ? "" : " (mismatch!)");
+    }
+
+    return 0;
+}
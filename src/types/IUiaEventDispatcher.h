@@ -25,5 +25,6 @@ namespace Microsoft::Console::Types
         virtual void SignalTextChanged() = 0;
         virtual void SignalCursorChanged() = 0;
         virtual void NotifyNewOutput(std::wstring_view newOutput) = 0;
+        virtual void NotifyOutputOmitted(size_t omittedLength) = 0;
     };
 }
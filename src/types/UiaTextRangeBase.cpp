@@ -15,6 +15,71 @@ static constexpr long _RemoveAlpha(COLORREF color) noexcept
     return color & 0x00ffffff;
 }
 
+// Calls func(begin, end, attr) for every run of identical attributes in the cells from first to last (both inclusive).
+// The cells are visited in the same order as a TextBufferCellIterator limited to the given viewport would,
+// or in reverse if searchBackwards is set. begin and end are the first and last cell of a run in that order.
+// Iterating over whole runs of ROW attributes is a lot faster than testing each cell individually.
+// The walk stops early if func returns false.
+template<typename Func>
+static void _ForEachAttributeRun(const TextBuffer& buffer, const Viewport& viewport, const til::point first, const til::point last, const bool searchBackwards, Func&& func)
+{
+    const auto left = viewport.Left();
+    const auto right = viewport.RightInclusive();
+    const auto step = searchBackwards ? -1 : 1;
+
+    for (auto y = first.y;; y += step)
+    {
+        // The range of columns to visit in this row, in ascending order.
+        auto begin = y == first.y ? first.x : (searchBackwards ? right : left);
+        auto end = y == last.y ? last.x : (searchBackwards ? left : right);
+        if (searchBackwards)
+        {
+            std::swap(begin, end);
+        }
+
+        const auto& runs = buffer.GetRowByOffset(y).Attributes().runs();
+        if (!searchBackwards)
+        {
+            til::CoordType runBegin = 0;
+            for (const auto& run : runs)
+            {
+                const auto runEnd = runBegin + run.length - 1;
+                if (runBegin > end)
+                {
+                    break;
+                }
+                if (runEnd >= begin && !func(til::point{ std::max(runBegin, begin), y }, til::point{ std::min(runEnd, end), y }, run.value))
+                {
+                    return;
+                }
+                runBegin = runEnd + 1;
+            }
+        }
+        else
+        {
+            til::CoordType runEnd = buffer.GetRowByOffset(y).size() - 1;
+            for (auto it = runs.rbegin(); it != runs.rend(); ++it)
+            {
+                const auto runBegin = runEnd - it->length + 1;
+                if (runEnd < begin)
+                {
+                    break;
+                }
+                if (runBegin <= end && !func(til::point{ std::min(runEnd, end), y }, til::point{ std::max(runBegin, begin), y }, it->value))
+                {
+                    return;
+                }
+                runEnd = runBegin - 1;
+            }
+        }
+
+        if (y == last.y)
+        {
+            break;
+        }
+    }
+}
+
 // degenerate range constructor.
 #pragma warning(suppress : 26434) // WRL RuntimeClassInitialize base is a no-op and we need this for MakeAndInitialize
 HRESULT UiaTextRangeBase::RuntimeClassInitialize(_In_ Render::IRenderData* pData, _In_ IRawElementProviderSimple* const pProvider, _In_ std::wstring_view wordDelimiters) noexcept
@@ -500,40 +565,10 @@ try
     //       We'll do some post-processing to fix this on the way out.
     std::optional<til::point> resultFirstAnchor;
     std::optional<til::point> resultSecondAnchor;
-    const auto attemptUpdateAnchors = [=, &resultFirstAnchor, &resultSecondAnchor](const TextBufferCellIterator iter) {
-        const auto attrFound{ _verifyAttr(attributeId, val, iter->TextAttr()).value() };
-        if (attrFound)
-        {
-            // populate the first anchor if it's not populated.
-            // otherwise, populate the second anchor.
-            if (!resultFirstAnchor.has_value())
-            {
-                resultFirstAnchor = iter.Pos();
-                resultSecondAnchor = iter.Pos();
-            }
-            else
-            {
-                resultSecondAnchor = iter.Pos();
-            }
-        }
-        return attrFound;
-    };
 
-    // Start/End for the direction to perform the search in
-    // We need searchEnd to be exclusive. This allows the for-loop below to
-    // iterate up until the exclusive searchEnd, and not attempt to read the
-    // data at that position.
+    // Start/End for the direction to perform the search in. Both are inclusive.
     const auto searchStart{ searchBackwards ? inclusiveEnd : _start };
     const auto searchEndInclusive{ searchBackwards ? _start : inclusiveEnd };
-    auto searchEndExclusive{ searchEndInclusive };
-    if (searchBackwards)
-    {
-        bufferSize.DecrementInBounds(searchEndExclusive, true);
-    }
-    else
-    {
-        bufferSize.IncrementInBounds(searchEndExclusive, true);
-    }
 
     // Iterate from searchStart to searchEnd in the buffer.
     // If we find the attribute we're looking for, we update resultFirstAnchor/SecondAnchor appropriately.
@@ -547,27 +582,27 @@ try
         const auto height{ std::abs(inclusiveEnd.y - _start.y + 1) };
         viewportRange = Viewport::FromDimensions({ originX, originY }, width, height);
     }
-    auto iter{ buffer.GetCellDataAt(searchStart, viewportRange) };
-    const auto iterStep{ searchBackwards ? -1 : 1 };
-    for (; iter && iter.Pos() != searchEndExclusive; iter += iterStep)
+    // A degenerate range has nothing to search through (its inclusive end precedes its start).
+    if (searchBackwards ? searchStart >= searchEndInclusive : searchStart <= searchEndInclusive)
     {
-        if (!attemptUpdateAnchors(iter) && resultFirstAnchor.has_value() && resultSecondAnchor.has_value())
-        {
-            // Exit the loop early if...
-            // - the cell we're looking at doesn't have the attr we're looking for
-            // - the anchors have been populated
-            // This means that we've found a contiguous range where the text attribute was found.
-            // No point in searching through the rest of the search space.
-            // TLDR: keep updating the second anchor and make the range wider until the attribute changes.
-            break;
-        }
-    }
+        _ForEachAttributeRun(buffer, viewportRange, searchStart, searchEndInclusive, searchBackwards, [&](const til::point begin, const til::point end, const TextAttribute& attr) {
+            if (!_verifyAttr(attributeId, val, attr).value())
+            {
+                // Stop once we've found a contiguous range where the text attribute was found.
+                // No point in searching through the rest of the search space.
+                // TLDR: keep updating the second anchor and make the range wider until the attribute changes.
+                return !resultFirstAnchor.has_value();
+            }
 
-    // Corner case: we couldn't actually move the searchEnd to make it exclusive
-    // (i.e. DecrementInBounds on Origin doesn't move it)
-    if (searchEndInclusive == searchEndExclusive)
-    {
-        attemptUpdateAnchors(iter);
+            // populate the first anchor if it's not populated.
+            // otherwise, extend the second anchor.
+            if (!resultFirstAnchor.has_value())
+            {
+                resultFirstAnchor = begin;
+            }
+            resultSecondAnchor = end;
+            return true;
+        });
     }
 
     // If a result was found, populate ppRetVal with the UiaTextRange
@@ -806,18 +841,25 @@ try
         const auto height{ std::abs(inclusiveEnd.y - _start.y + 1) };
         viewportRange = Viewport::FromDimensions({ originX, originY }, width, height);
     }
-    auto iter{ buffer.GetCellDataAt(_start, viewportRange) };
-    for (; iter && iter.Pos() != inclusiveEnd; ++iter)
+    // NOTE: This checks the cells up to, but not including, the inclusive end.
+    auto last{ inclusiveEnd };
+    auto mixed{ false };
+    if (_start != inclusiveEnd && viewportRange.DecrementInBounds(last))
     {
-        if (!_verifyAttr(attributeId, *pRetVal, iter->TextAttr()).value())
-        {
-            // The value of the specified attribute varies over the text range
-            // return UiaGetReservedMixedAttributeValue.
-            // Source: https://docs.microsoft.com/en-us/windows/win32/api/uiautomationcore/nf-uiautomationcore-itextrangeprovider-getattributevalue
-            pRetVal->vt = VT_UNKNOWN;
-            UiaTracing::TextRange::GetAttributeValue(*this, attributeId, *pRetVal, UiaTracing::AttributeType::Mixed);
-            return UiaGetReservedMixedAttributeValue(&pRetVal->punkVal);
-        }
+        _ForEachAttributeRun(buffer, viewportRange, _start, last, false, [&](const til::point, const til::point, const TextAttribute& attr) {
+            mixed = !_verifyAttr(attributeId, *pRetVal, attr).value();
+            return !mixed;
+        });
+    }
+
+    if (mixed)
+    {
+        // The value of the specified attribute varies over the text range
+        // return UiaGetReservedMixedAttributeValue.
+        // Source: https://docs.microsoft.com/en-us/windows/win32/api/uiautomationcore/nf-uiautomationcore-itextrangeprovider-getattributevalue
+        pRetVal->vt = VT_UNKNOWN;
+        UiaTracing::TextRange::GetAttributeValue(*this, attributeId, *pRetVal, UiaTracing::AttributeType::Mixed);
+        return UiaGetReservedMixedAttributeValue(&pRetVal->punkVal);
     }
 
     UiaTracing::TextRange::GetAttributeValue(*this, attributeId, *pRetVal);
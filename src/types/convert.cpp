@@ -130,6 +130,100 @@
     return cchTarget;
 }
 
+// Routine Description:
+// - Prepares the lookup table for the given codepage. The table is only rebuilt
+//   if the codepage differs from the one used during the last call.
+// Arguments:
+// - codepage - Windows Code Page representing the multibyte source text
+// Return Value:
+// - true if the codepage is a single-byte codepage and Decode() can be used.
+[[nodiscard]] bool SbcsDecoder::Initialize(const UINT codepage) noexcept
+{
+    if (_codepage == codepage)
+    {
+        return _valid;
+    }
+
+    _codepage = codepage;
+    _valid = false;
+
+    // Codepages like 50220 consist of single bytes, but are stateful. Those report a MaxCharSize > 1.
+    CPINFO info{};
+    if (codepage == CP_UTF8 || !GetCPInfo(codepage, &info) || info.MaxCharSize != 1)
+    {
+        return false;
+    }
+
+    std::array<char, 256> bytes{};
+    for (size_t i = 0; i < bytes.size(); ++i)
+    {
+        til::at(bytes, i) = static_cast<char>(i);
+    }
+
+    if (MultiByteToWideChar(codepage, 0, bytes.data(), gsl::narrow_cast<int>(bytes.size()), _table.data(), gsl::narrow_cast<int>(_table.size())) != gsl::narrow_cast<int>(_table.size()))
+    {
+        return false;
+    }
+
+    // Most, but not all (EBCDIC for instance), single-byte codepages map ASCII onto itself.
+    // For those we can skip the table lookup and widen the bytes directly.
+    _asciiCompatible = true;
+    for (size_t i = 0; i < 0x80; ++i)
+    {
+        if (til::at(_table, i) != static_cast<wchar_t>(i))
+        {
+            _asciiCompatible = false;
+            break;
+        }
+    }
+
+    _valid = true;
+    return true;
+}
+
+// Routine Description:
+// - Converts the given text into UTF-16. Initialize() must have returned true.
+// Arguments:
+// - source - View of multibyte characters of source text
+// - dest - Buffer that receives exactly source.size() UTF-16 characters
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. Use span instead (bounds.1).
+void SbcsDecoder::Decode(const std::string_view source, wchar_t* dest) const noexcept
+{
+    auto it = reinterpret_cast<const uint8_t*>(source.data());
+    const auto end = it + source.size();
+
+#if defined(_M_AMD64) || defined(_M_IX86)
+    if (_asciiCompatible)
+    {
+        // Build logs and similar output are predominantly ASCII. We check 16 bytes at a time
+        // for any with their high bit set and if there are none, we zero-extend them to UTF-16.
+        const auto zero = _mm_setzero_si128();
+        for (; end - it >= 16; it += 16, dest += 16)
+        {
+            const auto vec = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+            if (_mm_movemask_epi8(vec) != 0)
+            {
+                for (auto i = 0; i < 16; ++i)
+                {
+                    dest[i] = til::at(_table, it[i]);
+                }
+                continue;
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_unpacklo_epi8(vec, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 8), _mm_unpackhi_epi8(vec, zero));
+        }
+    }
+#endif
+
+    for (; it != end; ++it, ++dest)
+    {
+        *dest = til::at(_table, *it);
+    }
+}
+#pragma warning(pop)
+
 wchar_t Utf16ToUcs2(const std::wstring_view charData)
 {
     THROW_HR_IF(E_INVALIDARG, charData.empty());
@@ -14,6 +14,7 @@ Author:
 --*/
 
 #pragma once
+#include <array>
 #include <string>
 #include <string_view>
 
@@ -34,3 +35,19 @@ enum class CodepointWidth : BYTE
                                      const std::wstring_view source);
 
 wchar_t Utf16ToUcs2(const std::wstring_view charData);
+
+// Converts text in a single-byte codepage (like 437 or 1252) to UTF-16 through a
+// 256-entry lookup table, which is built once per codepage. Unlike ConvertToW this
+// never allocates: every input byte produces exactly one output character.
+class SbcsDecoder
+{
+public:
+    [[nodiscard]] bool Initialize(const UINT codepage) noexcept;
+    void Decode(const std::string_view source, wchar_t* dest) const noexcept;
+
+private:
+    UINT _codepage = 0;
+    bool _valid = false;
+    bool _asciiCompatible = false;
+    std::array<wchar_t, 256> _table{};
+};
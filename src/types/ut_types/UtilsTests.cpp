@@ -7,6 +7,7 @@
 
 #include "../inc/utils.hpp"
 #include "../inc/colorTable.hpp"
+#include "../inc/convert.hpp"
 #include <conattrs.hpp>
 
 using namespace WEX::Common;
@@ -33,6 +34,8 @@ class UtilsTests
     TEST_METHOD(TestTrimTrailingWhitespace);
     TEST_METHOD(TestDontTrimTrailingWhitespace);
 
+    TEST_METHOD(TestSbcsDecoder);
+
     void _VerifyXTermColorResult(const std::wstring_view wstr, DWORD colorValue);
     void _VerifyXTermColorInvalid(const std::wstring_view wstr);
 };
@@ -546,3 +549,41 @@ void UtilsTests::TestDontTrimTrailingWhitespace()
     // * trim when there's a tab followed by only whitespace
     // * not trim then there's a tab in the middle, and the string ends in whitespace
 }
+
+void UtilsTests::TestSbcsDecoder()
+{
+    BEGIN_TEST_METHOD_PROPERTIES()
+        TEST_METHOD_PROPERTY(L"Data:codepage", L"{437, 850, 1252, 37}")
+    END_TEST_METHOD_PROPERTIES()
+
+    DWORD codepage;
+    VERIFY_SUCCEEDED(TestData::TryGetValue(L"codepage", codepage));
+
+    SbcsDecoder decoder;
+    VERIFY_IS_TRUE(decoder.Initialize(codepage));
+
+    // Every byte value, followed by long runs of ASCII with the occasional
+    // high byte, so that both the vectorized and the table path are exercised.
+    std::string input;
+    for (auto i = 0; i < 256; ++i)
+    {
+        input.push_back(static_cast<char>(i));
+    }
+    for (auto i = 0; i < 1000; ++i)
+    {
+        input.push_back(static_cast<char>(i % 97 == 0 ? 0x80 + i % 128 : ' ' + i % 95));
+    }
+
+    // Try every alignment of the input relative to the 16 byte blocks.
+    for (size_t offset = 0; offset < 16; ++offset)
+    {
+        const auto source = std::string_view{ input }.substr(offset);
+        std::wstring actual(source.size(), L'\0');
+        decoder.Decode(source, actual.data());
+        VERIFY_ARE_EQUAL(ConvertToW(codepage, source), actual);
+    }
+
+    Log::Comment(L"Multi-byte codepages aren't supported by the decoder.");
+    VERIFY_IS_FALSE(decoder.Initialize(CP_UTF8));
+    VERIFY_IS_FALSE(decoder.Initialize(932));
+}